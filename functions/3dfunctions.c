@@ -14,9 +14,15 @@
 #include <string.h>         // Required for: memcmp(), strlen()
 #include <math.h>           // Required for: sinf(), cosf(), sqrtf(), fabsf()
 
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // Required for: SSE2 cubicmap row emission
+#endif
+
+#include "timer.c"          // Required for: GetTimerSeconds()
+
 // Generate a cubes mesh from pixel data
-// NOTE: Vertex data is uploaded to GPU
-Mesh GenMeshCubicmapEx(Image cubicmap, Vector3 cubeSize)
+// NOTE: Vertex data is only generated in RAM, not uploaded to GPU
+Mesh GenMeshCubicmapData(Image cubicmap, Vector3 cubeSize)
 {
     #define COLOR_EQUAL(col1, col2) ((col1.r == col2.r)&&(col1.g == col2.g)&&(col1.b == col2.b)&&(col1.a == col2.a))
     #define GRAY_131  (Color){ 131, 131, 131, 255 }
@@ -28,7 +34,8 @@ Mesh GenMeshCubicmapEx(Image cubicmap, Vector3 cubeSize)
     Color *pixels = LoadImageColors(cubicmap);
 
     // NOTE: Max possible number of triangles numCubes*(12 triangles by cube)
-    int maxTriangles = cubicmap.width * cubicmap.height * 12;
+    // NOTE: Sizes are computed in 64-bit, width*height*12*3*sizeof(Vector3) overflows int above ~2k x 2k maps
+    size_t maxTriangles = (size_t)cubicmap.width*cubicmap.height*12;
 
     int vCounter = 0;       // Used to count vertices
     int tcCounter = 0;      // Used to count texcoords
@@ -1291,9 +1298,9 @@ Mesh GenMeshCubicmapEx(Image cubicmap, Vector3 cubeSize)
     mesh.vertexCount = vCounter;
     mesh.triangleCount = vCounter/3;
 
-    mesh.vertices = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
-    mesh.normals = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
-    mesh.texcoords = (float *)RL_MALLOC(mesh.vertexCount*2*sizeof(float));
+    mesh.vertices = (float *)RL_MALLOC((size_t)mesh.vertexCount*3*sizeof(float));
+    mesh.normals = (float *)RL_MALLOC((size_t)mesh.vertexCount*3*sizeof(float));
+    mesh.texcoords = (float *)RL_MALLOC((size_t)mesh.vertexCount*2*sizeof(float));
     mesh.colors = NULL;
 
     int fCounter = 0;
@@ -1334,8 +1341,1068 @@ Mesh GenMeshCubicmapEx(Image cubicmap, Vector3 cubeSize)
 
     UnloadImageColors(pixels);   // Unload pixels color data
 
+    return mesh;
+}
+
+// Generate a cubes mesh from pixel data
+// NOTE: Vertex data is uploaded to GPU
+Mesh GenMeshCubicmapEx(Image cubicmap, Vector3 cubeSize)
+{
+    Mesh mesh = GenMeshCubicmapData(cubicmap, cubeSize);
+
     // Upload vertex data to GPU (static mesh)
     UploadMesh(&mesh, false);
 
     return mesh;
 }
+
+// Cubicmap cell grid: floor and ceiling height of every cell as 8-bit values (0..255 of cubeSize.y)
+// NOTE: A cell is solid where floor >= ceiling, open cells have floor 0 and ceiling 255
+typedef struct CubicmapGrid {
+    int width;
+    int height;
+    unsigned char *floor;       // Floor height per cell
+    unsigned char *ceiling;     // Ceiling height per cell
+    Vector3 cubeSize;
+} CubicmapGrid;
+
+typedef enum {
+    CUBICMAP_LEGACY_COLORS = 0, // Fixed gray classes: WHITE, GRAY, DARKGRAY, GRAY_131, DARKGRAY_81, BLACK
+    CUBICMAP_HEIGHT_CHANNELS    // R: floor height, G: ceiling drop from the top (0 = full height room)
+} CubicmapGridMode;
+
+// Get floor/ceiling heights of a legacy cubicmap color
+static void GetCubicmapLegacyCell(Color color, unsigned char *floor, unsigned char *ceiling)
+{
+    #define COLOR_EQUAL(col1, col2) ((col1.r == col2.r)&&(col1.g == col2.g)&&(col1.b == col2.b)&&(col1.a == col2.a))
+    #define GRAY_131  (Color){ 131, 131, 131, 255 }
+    #define DARKGRAY_81  (Color){ 81, 81, 81, 255 }
+
+    *floor = 0;
+    *ceiling = 255;
+
+    if (COLOR_EQUAL(color, WHITE)) { *floor = 255; *ceiling = 255; }
+    else if (COLOR_EQUAL(color, GRAY)) *floor = 128;            // Half height floor block
+    else if (COLOR_EQUAL(color, DARKGRAY)) *floor = 64;         // Quarter height floor block
+    else if (COLOR_EQUAL(color, GRAY_131)) *ceiling = 128;      // Ceiling block down to half height
+    else if (COLOR_EQUAL(color, DARKGRAY_81)) *ceiling = 64;    // Ceiling block down to quarter height
+}
+
+// Get floor/ceiling heights of a cubicmap color for a grid mode
+static void GetCubicmapCell(Color color, int mode, unsigned char *floor, unsigned char *ceiling)
+{
+    if (mode == CUBICMAP_HEIGHT_CHANNELS)
+    {
+        *floor = color.r;
+        *ceiling = 255 - color.g;
+        if (*ceiling < *floor) *ceiling = *floor;
+    }
+    else GetCubicmapLegacyCell(color, floor, ceiling);
+}
+
+// Cubicmap row source: map pixels are read one row at a time, so big maps never need a fully decoded image
+// NOTE: Rows are requested in increasing order, readRow() fills width pixels and returns false on read error
+
+typedef bool (*CubicmapRowCallback)(void *userData, int y, Color *pixels);
+
+typedef struct CubicmapRowSource {
+    int width;
+    int height;
+    CubicmapRowCallback readRow;
+    void *userData;
+} CubicmapRowSource;
+
+// Cubicmap row file state (binary PPM/PGM)
+typedef struct CubicmapRowFile {
+    FILE *file;
+    int width;
+    int channels;               // 3 for PPM (P6), 1 for PGM (P5)
+    long dataOffset;            // First pixel byte
+    int nextRow;                // Row at the current file position
+} CubicmapRowFile;
+
+// Read image row, R8G8B8A8 rows are copied directly
+static bool ReadCubicmapImageRow(void *userData, int y, Color *pixels)
+{
+    const Image *image = (const Image *)userData;
+
+    if (image->format == PIXELFORMAT_UNCOMPRESSED_R8G8B8A8) memcpy(pixels, (const unsigned char *)image->data + (size_t)y*image->width*4, (size_t)image->width*4);
+    else for (int x = 0; x < image->width; x++) pixels[x] = GetImageColor(*image, x, y);
+
+    return true;
+}
+
+// Get row source reading an image, image must stay loaded while the source is used
+CubicmapRowSource GetCubicmapImageRows(const Image *image)
+{
+    CubicmapRowSource source = { 0 };
+
+    if (image->data == NULL) return source;
+
+    source.width = image->width;
+    source.height = image->height;
+    source.readRow = ReadCubicmapImageRow;
+    source.userData = (void *)image;
+
+    return source;
+}
+
+// Read file row, gray or RGB bytes are expanded to colors in place (backwards, destination is never behind source)
+static bool ReadCubicmapFileRow(void *userData, int y, Color *pixels)
+{
+    CubicmapRowFile *rowFile = (CubicmapRowFile *)userData;
+    size_t rowBytes = (size_t)rowFile->width*rowFile->channels;
+    unsigned char *bytes = (unsigned char *)pixels;
+
+    if ((y != rowFile->nextRow) && (fseek(rowFile->file, rowFile->dataOffset + (long)(y*rowBytes), SEEK_SET) != 0)) return false;
+    if (fread(bytes, 1, rowBytes, rowFile->file) != rowBytes) return false;
+
+    rowFile->nextRow = y + 1;
+
+    for (int x = rowFile->width - 1; x >= 0; x--)
+    {
+        const unsigned char *src = &bytes[(size_t)x*rowFile->channels];
+        Color color = (rowFile->channels == 3)? (Color){ src[0], src[1], src[2], 255 } : (Color){ src[0], src[0], src[0], 255 };
+
+        pixels[x] = color;
+    }
+
+    return true;
+}
+
+// Open binary PPM (P6) or PGM (P5) file with 8-bit samples as row source, rows are read on demand
+// NOTE: Source must be closed with CloseCubicmapRowFile(), width is 0 if the file can't be read
+CubicmapRowSource OpenCubicmapRowFile(const char *fileName)
+{
+    CubicmapRowSource source = { 0 };
+    FILE *file = fopen(fileName, "rb");
+
+    if (file == NULL)
+    {
+        TRACELOG(LOG_WARNING, "CUBICMAP: [%s] Failed to open map file", fileName);
+        return source;
+    }
+
+    // Header: magic, width, height and max value, separated by whitespace or comment lines, then one whitespace byte
+    char magic[3] = { 0 };
+    int header[3] = { 0 };
+    bool valid = (fread(magic, 1, 2, file) == 2) && (magic[0] == 'P') && ((magic[1] == '5') || (magic[1] == '6'));
+
+    for (int i = 0; valid && (i < 3); i++)
+    {
+        int c = fgetc(file);
+        while ((c == '#') || (c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'))
+        {
+            if (c == '#') while ((c != '\n') && (c != EOF)) c = fgetc(file);
+            c = fgetc(file);
+        }
+
+        while ((c >= '0') && (c <= '9') && (header[i] < 65536)) { header[i] = header[i]*10 + (c - '0'); c = fgetc(file); }
+        valid = (header[i] > 0) && ((c == ' ') || (c == '\t') || (c == '\r') || (c == '\n'));
+    }
+
+    if (!valid || (header[2] != 255))
+    {
+        TRACELOG(LOG_WARNING, "CUBICMAP: [%s] Map file is not a binary 8-bit PPM/PGM", fileName);
+        fclose(file);
+        return source;
+    }
+
+    CubicmapRowFile *rowFile = (CubicmapRowFile *)RL_CALLOC(1, sizeof(CubicmapRowFile));
+    rowFile->file = file;
+    rowFile->width = header[0];
+    rowFile->channels = (magic[1] == '6')? 3 : 1;
+    rowFile->dataOffset = ftell(file);
+
+    source.width = header[0];
+    source.height = header[1];
+    source.readRow = ReadCubicmapFileRow;
+    source.userData = rowFile;
+
+    TRACELOG(LOG_INFO, "CUBICMAP: [%s] Map file opened [%i x %i], rows read on demand", fileName, source.width, source.height);
+
+    return source;
+}
+
+// Close row source file
+void CloseCubicmapRowFile(CubicmapRowSource *source)
+{
+    CubicmapRowFile *rowFile = (CubicmapRowFile *)source->userData;
+
+    if (rowFile != NULL)
+    {
+        fclose(rowFile->file);
+        RL_FREE(rowFile);
+    }
+
+    memset(source, 0, sizeof(CubicmapRowSource));
+}
+
+// Load cubicmap cell grid from a row source, only one row of pixels is decoded at a time
+// NOTE: Grid data is NULL if the source fails
+CubicmapGrid LoadCubicmapGridRows(CubicmapRowSource source, Vector3 cubeSize, int mode)
+{
+    CubicmapGrid grid = { 0 };
+
+    if ((source.readRow == NULL) || (source.width <= 0) || (source.height <= 0)) return grid;
+
+    size_t cellCount = (size_t)source.width*source.height;
+    Color *pixels = (Color *)RL_MALLOC((size_t)source.width*sizeof(Color));
+
+    grid.width = source.width;
+    grid.height = source.height;
+    grid.cubeSize = cubeSize;
+    grid.floor = (unsigned char *)RL_MALLOC(cellCount);
+    grid.ceiling = (unsigned char *)RL_MALLOC(cellCount);
+
+    for (int y = 0; y < source.height; y++)
+    {
+        if (!source.readRow(source.userData, y, pixels))
+        {
+            TRACELOG(LOG_WARNING, "CUBICMAP: Failed to read map row %i", y);
+            RL_FREE(grid.floor);
+            RL_FREE(grid.ceiling);
+            grid = (CubicmapGrid){ 0 };
+            break;
+        }
+
+        size_t first = (size_t)y*source.width;
+        for (int x = 0; x < source.width; x++) GetCubicmapCell(pixels[x], mode, &grid.floor[first + x], &grid.ceiling[first + x]);
+    }
+
+    RL_FREE(pixels);
+
+    return grid;
+}
+
+// Load cubicmap cell grid from image pixels
+CubicmapGrid LoadCubicmapGrid(Image cubicmap, Vector3 cubeSize, int mode)
+{
+    return LoadCubicmapGridRows(GetCubicmapImageRows(&cubicmap), cubeSize, mode);
+}
+
+// Unload cubicmap cell grid
+void UnloadCubicmapGrid(CubicmapGrid *grid)
+{
+    RL_FREE(grid->floor);
+    RL_FREE(grid->ceiling);
+
+    grid->floor = NULL;
+    grid->ceiling = NULL;
+}
+
+// Get floor/ceiling of a cell, cells outside of the grid are open space
+static void GetCubicmapGridCell(const CubicmapGrid *grid, int x, int z, int *floor, int *ceiling)
+{
+    if ((x < 0) || (z < 0) || (x >= grid->width) || (z >= grid->height))
+    {
+        *floor = 0;
+        *ceiling = 255;
+    }
+    else
+    {
+        *floor = grid->floor[(size_t)z*grid->width + x];
+        *ceiling = grid->ceiling[(size_t)z*grid->width + x];
+    }
+}
+
+// Vertex emission paths of the cubicmap grid generator, all paths generate bit-exact output
+typedef enum {
+    CUBICMAP_EMIT_SCALAR = 0,   // One float at a time
+    CUBICMAP_EMIT_SSE2,         // Row faces 16 cells and corners 4 cells at a time, quads written with 128-bit stores
+    CUBICMAP_EMIT_AVX2,         // Row faces 16 cells (SSE2) and corners 8 cells at a time, quads written with 128-bit stores
+    CUBICMAP_EMIT_AUTO          // Best path supported by the running CPU
+} CubicmapEmitPath;
+
+// Face bits of a cell, in emission order: outer roof, outer bottom, inner floor, inner ceiling,
+// then lower and upper span of the +X, -X, +Z, -Z sides (side s span k is bit CUBICMAP_FACE_SIDES + s*2 + k)
+#define CUBICMAP_FACE_ROOF          0x01
+#define CUBICMAP_FACE_BOTTOM        0x02
+#define CUBICMAP_FACE_FLOOR         0x04
+#define CUBICMAP_FACE_CEILING       0x08
+#define CUBICMAP_FACE_SIDES         4
+
+// Corner coordinates and faces of a row of cells
+typedef struct CubicmapRow {
+    float *x0;                  // Cell min X
+    float *x1;                  // Cell max X
+    float *floorY;              // Cell floor height
+    float *ceilingY;            // Cell ceiling height
+    unsigned short *faces;      // Cell face bits
+    float z0;                   // Row min Z
+    float z1;                   // Row max Z
+} CubicmapRow;
+
+// Get face bits of a cell from its heights and neighbour heights
+// NOTE: Side faces are only generated where this cell solid part faces neighbour open space
+static unsigned short GetCubicmapCellFaces(const CubicmapGrid *grid, int x, int z)
+{
+    // Side neighbours: +X, -X, +Z, -Z
+    static const int sideDx[4] = { 1, -1, 0, 0 };
+    static const int sideDz[4] = { 0, 0, 1, -1 };
+
+    int floor, ceiling;
+    GetCubicmapGridCell(grid, x, z, &floor, &ceiling);
+
+    bool solid = (floor >= ceiling);
+    unsigned short faces = 0;
+
+    // Horizontal faces: outer roof and bottom where the cell has solid parts, inner floor and ceiling where open
+    if (solid || (ceiling < 255)) faces |= CUBICMAP_FACE_ROOF;
+    if (solid || (floor > 0)) faces |= CUBICMAP_FACE_BOTTOM;
+    if (!solid) faces |= CUBICMAP_FACE_FLOOR | CUBICMAP_FACE_CEILING;
+
+    // Side faces: this cell solid intervals [0, floor] and [ceiling, 255] clipped to neighbour open interval,
+    // solid cells are a single [0, 255] interval
+    for (int side = 0; side < 4; side++)
+    {
+        int nFloor, nCeiling;
+        GetCubicmapGridCell(grid, x + sideDx[side], z + sideDz[side], &nFloor, &nCeiling);
+
+        int lowerTop = solid? nCeiling : ((floor < nCeiling)? floor : nCeiling);
+        int upperBottom = (ceiling > nFloor)? ceiling : nFloor;
+
+        if (lowerTop > nFloor) faces |= 1 << (CUBICMAP_FACE_SIDES + side*2);
+        if (!solid && (nCeiling > upperBottom)) faces |= 1 << (CUBICMAP_FACE_SIDES + side*2 + 1);
+    }
+
+    return faces;
+}
+
+// Get number of vertices generated by the face bits of a cell
+static int GetCubicmapFaceVertexCount(unsigned short faces)
+{
+    static const unsigned char nibbleBits[16] = { 0, 1, 1, 2, 1, 2, 2, 3, 1, 2, 2, 3, 2, 3, 3, 4 };
+
+    return 6*(nibbleBits[faces & 0xf] + nibbleBits[(faces >> 4) & 0xf] + nibbleBits[faces >> 8]);
+}
+
+#if defined(__SSE2__)
+// Compute face bits of row cells 16 at a time with unsigned byte min/max and saturated subtraction,
+// cells on the grid border (outside neighbours) and remainder are done by the scalar code
+static void GetCubicmapRowFacesSSE2(const CubicmapGrid *grid, int z, int first, int count, unsigned short *faces)
+{
+    const __m128i zero = _mm_setzero_si128();
+    const __m128i full = _mm_set1_epi8((char)255);
+    const unsigned char *floor = &grid->floor[(size_t)z*grid->width];
+    const unsigned char *ceiling = &grid->ceiling[(size_t)z*grid->width];
+
+    int x = first;
+    for (; (x < first + count) && (x < 1); x++) faces[x] = GetCubicmapCellFaces(grid, x, z);
+
+    for (; (x + 16 <= first + count) && (x + 16 < grid->width); x += 16)
+    {
+        __m128i f = _mm_loadu_si128((const __m128i *)&floor[x]);
+        __m128i c = _mm_loadu_si128((const __m128i *)&ceiling[x]);
+        __m128i solid = _mm_cmpeq_epi8(_mm_subs_epu8(c, f), zero);
+
+        // Neighbours: +X, -X, +Z, -Z, rows outside the grid are open space
+        __m128i nFloor[4], nCeiling[4];
+        nFloor[0] = _mm_loadu_si128((const __m128i *)&floor[x + 1]);
+        nCeiling[0] = _mm_loadu_si128((const __m128i *)&ceiling[x + 1]);
+        nFloor[1] = _mm_loadu_si128((const __m128i *)&floor[x - 1]);
+        nCeiling[1] = _mm_loadu_si128((const __m128i *)&ceiling[x - 1]);
+        nFloor[2] = (z + 1 < grid->height)? _mm_loadu_si128((const __m128i *)&floor[x + grid->width]) : zero;
+        nCeiling[2] = (z + 1 < grid->height)? _mm_loadu_si128((const __m128i *)&ceiling[x + grid->width]) : full;
+        nFloor[3] = (z > 0)? _mm_loadu_si128((const __m128i *)&floor[x - grid->width]) : zero;
+        nCeiling[3] = (z > 0)? _mm_loadu_si128((const __m128i *)&ceiling[x - grid->width]) : full;
+
+        // Low byte holds bits 0..7, high byte bits 8..15
+        __m128i low = _mm_andnot_si128(_mm_andnot_si128(solid, _mm_cmpeq_epi8(c, full)), _mm_set1_epi8(CUBICMAP_FACE_ROOF));
+        low = _mm_or_si128(low, _mm_andnot_si128(_mm_andnot_si128(solid, _mm_cmpeq_epi8(f, zero)), _mm_set1_epi8(CUBICMAP_FACE_BOTTOM)));
+        low = _mm_or_si128(low, _mm_andnot_si128(solid, _mm_set1_epi8(CUBICMAP_FACE_FLOOR | CUBICMAP_FACE_CEILING)));
+        __m128i high = zero;
+
+        for (int side = 0; side < 4; side++)
+        {
+            int bit = CUBICMAP_FACE_SIDES + side*2;
+            __m128i lowerTop = _mm_or_si128(_mm_and_si128(solid, nCeiling[side]), _mm_andnot_si128(solid, _mm_min_epu8(f, nCeiling[side])));
+            __m128i upperBottom = _mm_max_epu8(c, nFloor[side]);
+            __m128i lower = _mm_andnot_si128(_mm_cmpeq_epi8(_mm_subs_epu8(lowerTop, nFloor[side]), zero), _mm_set1_epi8((char)(1 << (bit & 7))));
+            __m128i upper = _mm_andnot_si128(_mm_or_si128(solid, _mm_cmpeq_epi8(_mm_subs_epu8(nCeiling[side], upperBottom), zero)), _mm_set1_epi8((char)(2 << (bit & 7))));
+
+            if (bit < 8) low = _mm_or_si128(low, _mm_or_si128(lower, upper));
+            else high = _mm_or_si128(high, _mm_or_si128(lower, upper));
+        }
+
+        _mm_storeu_si128((__m128i *)&faces[x], _mm_unpacklo_epi8(low, high));
+        _mm_storeu_si128((__m128i *)&faces[x + 8], _mm_unpackhi_epi8(low, high));
+    }
+
+    for (; x < first + count; x++) faces[x] = GetCubicmapCellFaces(grid, x, z);
+}
+#endif
+
+// Compute face bits of row cells [first, first + count) with an emission path
+static void GetCubicmapRowFaces(const CubicmapGrid *grid, int z, int first, int count, unsigned short *faces, int path)
+{
+#if defined(__SSE2__)
+    if (path != CUBICMAP_EMIT_SCALAR) { GetCubicmapRowFacesSSE2(grid, z, first, count, faces); return; }
+#endif
+    for (int x = first; x < first + count; x++) faces[x] = GetCubicmapCellFaces(grid, x, z);
+}
+
+// Compute row corners one cell at a time
+static void GetCubicmapRowScalar(const CubicmapGrid *grid, int z, int first, int count, CubicmapRow *row)
+{
+    float w = grid->cubeSize.x;
+    float h2 = grid->cubeSize.y;
+    const unsigned char *floor = &grid->floor[(size_t)z*grid->width];
+    const unsigned char *ceiling = &grid->ceiling[(size_t)z*grid->width];
+
+    for (int x = first; x < first + count; x++)
+    {
+        row->x0[x] = w*((float)x - 0.5f);
+        row->x1[x] = w*((float)x + 0.5f);
+        row->floorY[x] = h2*(float)floor[x]/255.0f;
+        row->ceilingY[x] = h2*(float)ceiling[x]/255.0f;
+    }
+}
+
+#if defined(__SSE2__)
+// Compute row corners 4 cells at a time, remainder is done by the scalar code
+static void GetCubicmapRowSSE2(const CubicmapGrid *grid, int z, int first, int count, CubicmapRow *row)
+{
+    const __m128 w = _mm_set1_ps(grid->cubeSize.x);
+    const __m128 h2 = _mm_set1_ps(grid->cubeSize.y);
+    const __m128 half = _mm_set1_ps(0.5f);
+    const __m128 maxHeight = _mm_set1_ps(255.0f);
+    const __m128i zero = _mm_setzero_si128();
+    const unsigned char *floor = &grid->floor[(size_t)z*grid->width];
+    const unsigned char *ceiling = &grid->ceiling[(size_t)z*grid->width];
+
+    int x = first;
+    for (; x + 4 <= first + count; x += 4)
+    {
+        __m128 fx = _mm_cvtepi32_ps(_mm_setr_epi32(x, x + 1, x + 2, x + 3));
+
+        int floorBytes, ceilingBytes;
+        memcpy(&floorBytes, &floor[x], 4);
+        memcpy(&ceilingBytes, &ceiling[x], 4);
+        __m128 ff = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(floorBytes), zero), zero));
+        __m128 fc = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_unpacklo_epi8(_mm_cvtsi32_si128(ceilingBytes), zero), zero));
+
+        _mm_storeu_ps(&row->x0[x], _mm_mul_ps(w, _mm_sub_ps(fx, half)));
+        _mm_storeu_ps(&row->x1[x], _mm_mul_ps(w, _mm_add_ps(fx, half)));
+        _mm_storeu_ps(&row->floorY[x], _mm_div_ps(_mm_mul_ps(h2, ff), maxHeight));
+        _mm_storeu_ps(&row->ceilingY[x], _mm_div_ps(_mm_mul_ps(h2, fc), maxHeight));
+    }
+
+    for (; x < first + count; x++)
+    {
+        row->x0[x] = grid->cubeSize.x*((float)x - 0.5f);
+        row->x1[x] = grid->cubeSize.x*((float)x + 0.5f);
+        row->floorY[x] = grid->cubeSize.y*(float)floor[x]/255.0f;
+        row->ceilingY[x] = grid->cubeSize.y*(float)ceiling[x]/255.0f;
+    }
+}
+#endif
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+    #define CUBICMAP_AVX2_DISPATCH
+    #include <immintrin.h>      // Required for: AVX2 row corners
+
+// Compute row corners 8 cells at a time, compiled for AVX2 and only called when the CPU supports it
+__attribute__((target("avx2")))
+static void GetCubicmapRowAVX2(const CubicmapGrid *grid, int z, int first, int count, CubicmapRow *row)
+{
+    const __m256 w = _mm256_set1_ps(grid->cubeSize.x);
+    const __m256 h2 = _mm256_set1_ps(grid->cubeSize.y);
+    const __m256 half = _mm256_set1_ps(0.5f);
+    const __m256 maxHeight = _mm256_set1_ps(255.0f);
+    const unsigned char *floor = &grid->floor[(size_t)z*grid->width];
+    const unsigned char *ceiling = &grid->ceiling[(size_t)z*grid->width];
+
+    int x = first;
+    for (; x + 8 <= first + count; x += 8)
+    {
+        __m256 fx = _mm256_cvtepi32_ps(_mm256_add_epi32(_mm256_set1_epi32(x), _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7)));
+        __m256 ff = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&floor[x])));
+        __m256 fc = _mm256_cvtepi32_ps(_mm256_cvtepu8_epi32(_mm_loadl_epi64((const __m128i *)&ceiling[x])));
+
+        _mm256_storeu_ps(&row->x0[x], _mm256_mul_ps(w, _mm256_sub_ps(fx, half)));
+        _mm256_storeu_ps(&row->x1[x], _mm256_mul_ps(w, _mm256_add_ps(fx, half)));
+        _mm256_storeu_ps(&row->floorY[x], _mm256_div_ps(_mm256_mul_ps(h2, ff), maxHeight));
+        _mm256_storeu_ps(&row->ceilingY[x], _mm256_div_ps(_mm256_mul_ps(h2, fc), maxHeight));
+    }
+
+    for (; x < first + count; x++)
+    {
+        row->x0[x] = grid->cubeSize.x*((float)x - 0.5f);
+        row->x1[x] = grid->cubeSize.x*((float)x + 0.5f);
+        row->floorY[x] = grid->cubeSize.y*(float)floor[x]/255.0f;
+        row->ceilingY[x] = grid->cubeSize.y*(float)ceiling[x]/255.0f;
+    }
+}
+#endif
+
+// Check if an emission path can run on this CPU
+bool IsCubicmapEmitPathSupported(int path)
+{
+    switch (path)
+    {
+        case CUBICMAP_EMIT_SCALAR: return true;
+#if defined(__SSE2__)
+        case CUBICMAP_EMIT_SSE2: return true;
+#endif
+#if defined(CUBICMAP_AVX2_DISPATCH)
+        case CUBICMAP_EMIT_AVX2: return __builtin_cpu_supports("avx2");
+#endif
+        default: return false;
+    }
+}
+
+// Get emission path that will actually run for a requested path
+static int ResolveCubicmapEmitPath(int path)
+{
+    if (path == CUBICMAP_EMIT_AUTO) path = IsCubicmapEmitPathSupported(CUBICMAP_EMIT_AVX2)? CUBICMAP_EMIT_AVX2 : IsCubicmapEmitPathSupported(CUBICMAP_EMIT_SSE2)? CUBICMAP_EMIT_SSE2 : CUBICMAP_EMIT_SCALAR;
+    if (!IsCubicmapEmitPathSupported(path)) path = CUBICMAP_EMIT_SCALAR;
+
+    return path;
+}
+
+// Compute corners and faces of row cells [first, first + count) with an emission path
+static void GetCubicmapRow(const CubicmapGrid *grid, int z, int first, int count, CubicmapRow *row, int path)
+{
+    GetCubicmapRowFaces(grid, z, first, count, row->faces, path);
+
+#if defined(CUBICMAP_AVX2_DISPATCH)
+    if (path == CUBICMAP_EMIT_AVX2) { GetCubicmapRowAVX2(grid, z, first, count, row); return; }
+#endif
+#if defined(__SSE2__)
+    if (path == CUBICMAP_EMIT_SSE2) { GetCubicmapRowSSE2(grid, z, first, count, row); return; }
+#endif
+    GetCubicmapRowScalar(grid, z, first, count, row);
+}
+
+// Emit one quad (2 triangles) into float vertex arrays, corners in counter-clockwise order seen from the front
+static void EmitCubicmapQuad(Mesh *mesh, int vCounter, Vector3 p0, Vector3 p1, Vector3 p2, Vector3 p3, Vector3 normal, Vector2 uv0, Vector2 uv1, Vector2 uv2, Vector2 uv3, bool wide)
+{
+    float *vertices = &mesh->vertices[vCounter*3];
+    float *normals = &mesh->normals[vCounter*3];
+    float *uvs = &mesh->texcoords[vCounter*2];
+
+#if defined(__SSE2__)
+    if (wide)
+    {
+        // Whole quad: 18 position floats, 18 normal floats and 12 texcoord floats with 128-bit stores,
+        // vectors are built in registers (no staging array, 128-bit loads of scalar stores stall store forwarding)
+        __m128 n0 = _mm_setr_ps(normal.x, normal.y, normal.z, normal.x);
+        __m128 n1 = _mm_setr_ps(normal.y, normal.z, normal.x, normal.y);
+        __m128 n2 = _mm_setr_ps(normal.z, normal.x, normal.y, normal.z);
+
+        _mm_storeu_ps(&vertices[0], _mm_setr_ps(p0.x, p0.y, p0.z, p1.x));
+        _mm_storeu_ps(&vertices[4], _mm_setr_ps(p1.y, p1.z, p2.x, p2.y));
+        _mm_storeu_ps(&vertices[8], _mm_setr_ps(p2.z, p0.x, p0.y, p0.z));
+        _mm_storeu_ps(&vertices[12], _mm_setr_ps(p2.x, p2.y, p2.z, p3.x));
+        _mm_storel_pi((__m64 *)&vertices[16], _mm_setr_ps(p3.y, p3.z, 0.0f, 0.0f));
+
+        _mm_storeu_ps(&normals[0], n0);
+        _mm_storeu_ps(&normals[4], n1);
+        _mm_storeu_ps(&normals[8], n2);
+        _mm_storeu_ps(&normals[12], n0);
+        _mm_storel_pi((__m64 *)&normals[16], n1);
+
+        _mm_storeu_ps(&uvs[0], _mm_setr_ps(uv0.x, uv0.y, uv1.x, uv1.y));
+        _mm_storeu_ps(&uvs[4], _mm_setr_ps(uv2.x, uv2.y, uv0.x, uv0.y));
+        _mm_storeu_ps(&uvs[8], _mm_setr_ps(uv2.x, uv2.y, uv3.x, uv3.y));
+
+        return;
+    }
+#endif
+
+    float positions[18] = { p0.x, p0.y, p0.z, p1.x, p1.y, p1.z, p2.x, p2.y, p2.z, p0.x, p0.y, p0.z, p2.x, p2.y, p2.z, p3.x, p3.y, p3.z };
+    float texcoords[12] = { uv0.x, uv0.y, uv1.x, uv1.y, uv2.x, uv2.y, uv0.x, uv0.y, uv2.x, uv2.y, uv3.x, uv3.y };
+
+    for (int i = 0; i < 18; i++) vertices[i] = positions[i];
+    for (int i = 0; i < 6; i++)
+    {
+        normals[i*3] = normal.x;
+        normals[i*3 + 1] = normal.y;
+        normals[i*3 + 2] = normal.z;
+    }
+    for (int i = 0; i < 12; i++) uvs[i] = texcoords[i];
+}
+
+// Emit faces of a cell from its row face bits, returns updated vertex counter
+static int EmitCubicmapGridCell(const CubicmapGrid *grid, int x, int z, const CubicmapRow *row, Mesh *mesh, int vCounter, bool wide)
+{
+    // Texture rectangles of the atlas: top-bottom-front-back-right-left (see GenMeshCubicmapData())
+    static const Rectangle rightTexUV = { 0.0f, 0.0f, 0.5f, 0.5f };
+    static const Rectangle leftTexUV = { 0.5f, 0.0f, 0.5f, 0.5f };
+    static const Rectangle frontTexUV = { 0.0f, 0.0f, 0.5f, 0.5f };
+    static const Rectangle backTexUV = { 0.5f, 0.0f, 0.5f, 0.5f };
+    static const Rectangle topTexUV = { 0.0f, 0.5f, 0.5f, 0.5f };
+    static const Rectangle bottomTexUV = { 0.5f, 0.5f, 0.5f, 0.5f };
+
+    // Side neighbours: +X, -X, +Z, -Z
+    static const int sideDx[4] = { 1, -1, 0, 0 };
+    static const int sideDz[4] = { 0, 0, 1, -1 };
+
+    float h2 = grid->cubeSize.y;
+    unsigned short faces = row->faces[x];
+    float x0 = row->x0[x], x1 = row->x1[x], z0 = row->z0, z1 = row->z1;
+    float fy = row->floorY[x], cy = row->ceilingY[x];
+
+    Rectangle uv;
+
+    if (faces & CUBICMAP_FACE_ROOF)
+    {
+        uv = topTexUV;
+        EmitCubicmapQuad(mesh, vCounter, (Vector3){ x0, h2, z0 }, (Vector3){ x0, h2, z1 }, (Vector3){ x1, h2, z1 }, (Vector3){ x1, h2, z0 }, (Vector3){ 0.0f, 1.0f, 0.0f },
+            (Vector2){ uv.x, uv.y }, (Vector2){ uv.x, uv.y + uv.height }, (Vector2){ uv.x + uv.width, uv.y + uv.height }, (Vector2){ uv.x + uv.width, uv.y }, wide);
+        vCounter += 6;
+    }
+
+    if (faces & CUBICMAP_FACE_BOTTOM)
+    {
+        uv = bottomTexUV;
+        EmitCubicmapQuad(mesh, vCounter, (Vector3){ x0, 0.0f, z0 }, (Vector3){ x1, 0.0f, z0 }, (Vector3){ x1, 0.0f, z1 }, (Vector3){ x0, 0.0f, z1 }, (Vector3){ 0.0f, -1.0f, 0.0f },
+            (Vector2){ uv.x + uv.width, uv.y }, (Vector2){ uv.x, uv.y }, (Vector2){ uv.x, uv.y + uv.height }, (Vector2){ uv.x + uv.width, uv.y + uv.height }, wide);
+        vCounter += 6;
+    }
+
+    if (faces & CUBICMAP_FACE_FLOOR)
+    {
+        uv = bottomTexUV;
+        EmitCubicmapQuad(mesh, vCounter, (Vector3){ x0, fy, z0 }, (Vector3){ x0, fy, z1 }, (Vector3){ x1, fy, z1 }, (Vector3){ x1, fy, z0 }, (Vector3){ 0.0f, 1.0f, 0.0f },
+            (Vector2){ uv.x + uv.width, uv.y }, (Vector2){ uv.x + uv.width, uv.y + uv.height }, (Vector2){ uv.x, uv.y + uv.height }, (Vector2){ uv.x, uv.y }, wide);
+        vCounter += 6;
+    }
+
+    if (faces & CUBICMAP_FACE_CEILING)
+    {
+        uv = topTexUV;
+        EmitCubicmapQuad(mesh, vCounter, (Vector3){ x0, cy, z0 }, (Vector3){ x1, cy, z0 }, (Vector3){ x1, cy, z1 }, (Vector3){ x0, cy, z1 }, (Vector3){ 0.0f, -1.0f, 0.0f },
+            (Vector2){ uv.x, uv.y }, (Vector2){ uv.x + uv.width, uv.y }, (Vector2){ uv.x + uv.width, uv.y + uv.height }, (Vector2){ uv.x, uv.y + uv.height }, wide);
+        vCounter += 6;
+    }
+
+    if ((faces >> CUBICMAP_FACE_SIDES) == 0) return vCounter;
+
+    int floor, ceiling;
+    GetCubicmapGridCell(grid, x, z, &floor, &ceiling);
+
+    bool solid = (floor >= ceiling);
+
+    // Side spans, only computed for sides with faces (see GetCubicmapCellFaces())
+    for (int side = 0; side < 4; side++)
+    {
+        int sideFaces = (faces >> (CUBICMAP_FACE_SIDES + side*2)) & 3;
+        if (sideFaces == 0) continue;
+
+        int nFloor, nCeiling;
+        GetCubicmapGridCell(grid, x + sideDx[side], z + sideDz[side], &nFloor, &nCeiling);
+
+        int spans[2][2] = {
+            { nFloor, solid? nCeiling : ((floor < nCeiling)? floor : nCeiling) },
+            { (ceiling > nFloor)? ceiling : nFloor, nCeiling }
+        };
+
+        for (int s = 0; s < 2; s++)
+        {
+            if ((sideFaces & (1 << s)) == 0) continue;
+
+            float y0 = h2*(float)spans[s][0]/255.0f;
+            float y1 = h2*(float)spans[s][1]/255.0f;
+            Vector3 bl, br, normal;
+
+            // Corners as seen from the neighbour cell: bottom-left, going right
+            if (side == 0) { bl = (Vector3){ x1, y0, z1 }; br = (Vector3){ x1, y0, z0 }; normal = (Vector3){ 1.0f, 0.0f, 0.0f }; uv = rightTexUV; }
+            else if (side == 1) { bl = (Vector3){ x0, y0, z0 }; br = (Vector3){ x0, y0, z1 }; normal = (Vector3){ -1.0f, 0.0f, 0.0f }; uv = leftTexUV; }
+            else if (side == 2) { bl = (Vector3){ x0, y0, z1 }; br = (Vector3){ x1, y0, z1 }; normal = (Vector3){ 0.0f, 0.0f, 1.0f }; uv = frontTexUV; }
+            else { bl = (Vector3){ x1, y0, z0 }; br = (Vector3){ x0, y0, z0 }; normal = (Vector3){ 0.0f, 0.0f, -1.0f }; uv = backTexUV; }
+
+            Vector3 tr = (Vector3){ br.x, y1, br.z };
+            Vector3 tl = (Vector3){ bl.x, y1, bl.z };
+
+            EmitCubicmapQuad(mesh, vCounter, bl, br, tr, tl, normal,
+                (Vector2){ uv.x, uv.y + uv.height }, (Vector2){ uv.x + uv.width, uv.y + uv.height }, (Vector2){ uv.x + uv.width, uv.y }, (Vector2){ uv.x, uv.y }, wide);
+            vCounter += 6;
+        }
+    }
+
+    return vCounter;
+}
+
+// Generate mesh from a rectangle of cubicmap grid cells with a specific emission path
+// NOTE: Cells outside the rectangle are only used as neighbours, so adjacent regions don't overlap
+static Mesh GenMeshCubicmapGridRange(const CubicmapGrid *grid, int x0, int z0, int width, int height, int path)
+{
+    Mesh mesh = { 0 };
+
+    path = ResolveCubicmapEmitPath(path);
+
+    bool wide = (path != CUBICMAP_EMIT_SCALAR);
+
+    CubicmapRow row = { 0 };
+    float *rowData = (float *)RL_MALLOC((size_t)grid->width*4*sizeof(float));
+    row.x0 = rowData;
+    row.x1 = rowData + grid->width;
+    row.floorY = rowData + grid->width*2;
+    row.ceilingY = rowData + grid->width*3;
+    row.faces = (unsigned short *)RL_MALLOC((size_t)grid->width*sizeof(unsigned short));
+
+    // First pass counts vertices from face bits, so mesh arrays are allocated once with exact size
+    int vertexCount = 0;
+    for (int z = z0; z < z0 + height; z++)
+    {
+        GetCubicmapRowFaces(grid, z, x0, width, row.faces, path);
+
+        for (int x = x0; x < x0 + width; x++) vertexCount += GetCubicmapFaceVertexCount(row.faces[x]);
+    }
+
+    mesh.vertexCount = vertexCount;
+    mesh.triangleCount = vertexCount/3;
+    mesh.vertices = (float *)RL_MALLOC((size_t)vertexCount*3*sizeof(float));
+    mesh.normals = (float *)RL_MALLOC((size_t)vertexCount*3*sizeof(float));
+    mesh.texcoords = (float *)RL_MALLOC((size_t)vertexCount*2*sizeof(float));
+    mesh.colors = NULL;
+
+    int vCounter = 0;
+    for (int z = z0; z < z0 + height; z++)
+    {
+        row.z0 = grid->cubeSize.z*((float)z - 0.5f);
+        row.z1 = grid->cubeSize.z*((float)z + 0.5f);
+
+        GetCubicmapRow(grid, z, x0, width, &row, path);
+
+        for (int x = x0; x < x0 + width; x++) vCounter = EmitCubicmapGridCell(grid, x, z, &row, &mesh, vCounter, wide);
+    }
+
+    RL_FREE(rowData);
+    RL_FREE(row.faces);
+
+    return mesh;
+}
+
+// Generate mesh from cubicmap cell grid with a specific emission path
+// NOTE: Vertex data is only generated in RAM, not uploaded to GPU
+Mesh GenMeshCubicmapGridDataEx(const CubicmapGrid *grid, int path)
+{
+    return GenMeshCubicmapGridRange(grid, 0, 0, grid->width, grid->height, path);
+}
+
+// Generate mesh from a rectangle of cubicmap grid cells, rectangle is clipped to the grid
+// NOTE: Vertex data is only generated in RAM, not uploaded to GPU, grid is only read (safe to call from worker threads)
+Mesh GenMeshCubicmapGridRegion(const CubicmapGrid *grid, int x0, int z0, int width, int height)
+{
+    if (x0 < 0) { width += x0; x0 = 0; }
+    if (z0 < 0) { height += z0; z0 = 0; }
+    if (x0 + width > grid->width) width = grid->width - x0;
+    if (z0 + height > grid->height) height = grid->height - z0;
+
+    if ((width <= 0) || (height <= 0)) return (Mesh){ 0 };
+
+    return GenMeshCubicmapGridRange(grid, x0, z0, width, height, CUBICMAP_EMIT_AUTO);
+}
+
+// Generate mesh from cubicmap cell grid, a single emitter handles any floor/ceiling combination
+// NOTE: Vertex data is only generated in RAM, not uploaded to GPU
+Mesh GenMeshCubicmapGridData(const CubicmapGrid *grid)
+{
+    return GenMeshCubicmapGridDataEx(grid, CUBICMAP_EMIT_AUTO);
+}
+
+// Generate mesh from cubicmap cell grid
+// NOTE: Vertex data is uploaded to GPU
+Mesh GenMeshCubicmapGrid(const CubicmapGrid *grid)
+{
+    Mesh mesh = GenMeshCubicmapGridData(grid);
+
+    // Upload vertex data to GPU (static mesh)
+    UploadMesh(&mesh, false);
+
+    return mesh;
+}
+
+// Benchmark cubicmap grid emission paths, logs per cell throughput and checks output against the scalar path
+// NOTE: Runs headless, no GPU upload involved, returns the number of paths with mismatching output.
+// Timings include first touch of the freshly allocated mesh arrays (about half of it), tiles reuse their buffers
+int BenchmarkCubicmapGridEmit(const CubicmapGrid *grid, int iterations)
+{
+    static const char *pathNames[3] = { "scalar", "SSE2", "AVX2" };
+    int failures = 0;
+
+    Mesh reference = GenMeshCubicmapGridDataEx(grid, CUBICMAP_EMIT_SCALAR);
+    int cellCount = grid->width*grid->height;
+
+    for (int path = CUBICMAP_EMIT_SCALAR; path <= CUBICMAP_EMIT_AVX2; path++)
+    {
+        if (!IsCubicmapEmitPathSupported(path))
+        {
+            TRACELOG(LOG_INFO, "CUBICMAP: Emit path %s not supported", pathNames[path]);
+            continue;
+        }
+
+        double best = 1e30;
+        bool exact = true;
+
+        for (int i = 0; i < iterations; i++)
+        {
+            double start = GetTimerSeconds();
+            Mesh mesh = GenMeshCubicmapGridDataEx(grid, path);
+            double elapsed = GetTimerSeconds() - start;
+
+            if (elapsed < best) best = elapsed;
+
+            exact = exact && (mesh.vertexCount == reference.vertexCount) &&
+                (memcmp(mesh.vertices, reference.vertices, mesh.vertexCount*3*sizeof(float)) == 0) &&
+                (memcmp(mesh.normals, reference.normals, mesh.vertexCount*3*sizeof(float)) == 0) &&
+                (memcmp(mesh.texcoords, reference.texcoords, mesh.vertexCount*2*sizeof(float)) == 0);
+
+            RL_FREE(mesh.vertices);
+            RL_FREE(mesh.normals);
+            RL_FREE(mesh.texcoords);
+        }
+
+        TRACELOG(exact? LOG_INFO : LOG_WARNING, "CUBICMAP: Emit path %s: %.2f ms, %.2f ns/cell, %.1f Mcells/s, output %s", pathNames[path], best*1000.0,
+            best*1e9/cellCount, cellCount/best*1e-6, exact? "bit-exact" : "MISMATCH");
+        if (!exact) failures++;
+    }
+
+    RL_FREE(reference.vertices);
+    RL_FREE(reference.normals);
+    RL_FREE(reference.texcoords);
+
+    return failures;
+}
+
+// Tiled cubicmap generation: bounded memory for very large maps
+// NOTE: Source rows are read a strip of tile rows at a time and geometry is emitted one tile
+// at a time into fixed size buffers, so peak memory depends on map width and tile size, not map area
+
+#define CUBICMAP_TILE_MAX_SIZE          256         // Max tile size in cells (per side)
+#define CUBICMAP_TILE_MIN_SIZE          8           // Min tile size used to fit the memory budget
+#define CUBICMAP_CELL_MAX_VERTICES      72          // Open cell: 4 horizontal quads + 4 sides x 2 spans, 6 vertices each
+
+typedef struct CubicmapTile {
+    int x;                      // First cell X
+    int z;                      // First cell Z
+    int width;                  // Tile width in cells
+    int height;                 // Tile height in cells
+    BoundingBox bounds;         // Tile bounds in mesh space
+    Mesh mesh;                  // Tile geometry (CPU only)
+} CubicmapTile;
+
+// Tile callback, called for each tile with geometry
+// WARNING: Tile mesh buffers are reused for next tile, upload or copy data before returning
+typedef void (*CubicmapTileCallback)(const CubicmapTile *tile, void *userData);
+
+// Get peak memory used by tiled generation (bytes), row source buffers not included
+long long GetCubicmapTiledMemory(int mapWidth, int tileSize)
+{
+    long long stripBytes = 2LL*(tileSize + 2)*mapWidth;                     // Floor and ceiling of strip rows plus a border row on each side
+    long long pixelBytes = (long long)mapWidth*sizeof(Color);               // One source row of pixels
+    long long rowBytes = 4LL*mapWidth*sizeof(float) + 2LL*mapWidth;        // Row corners and face bits
+    long long tileBytes = (long long)tileSize*tileSize*CUBICMAP_CELL_MAX_VERTICES*8*sizeof(float);  // Positions, normals and texcoords
+
+    return stripBytes + pixelBytes + rowBytes + tileBytes;
+}
+
+// Decode source rows into strip rows of cell heights, rows outside the map are open space
+static bool DecodeCubicmapStrip(CubicmapRowSource source, int mode, int firstRow, int rowCount, unsigned char *floor, unsigned char *ceiling, Color *pixels)
+{
+    for (int r = 0; r < rowCount; r++)
+    {
+        int y = firstRow + r;
+        unsigned char *f = &floor[(size_t)r*source.width];
+        unsigned char *c = &ceiling[(size_t)r*source.width];
+
+        if ((y < 0) || (y >= source.height))
+        {
+            memset(f, 0, source.width);
+            memset(c, 255, source.width);
+        }
+        else
+        {
+            if (!source.readRow(source.userData, y, pixels)) return false;
+
+            for (int x = 0; x < source.width; x++) GetCubicmapCell(pixels[x], mode, &f[x], &c[x]);
+        }
+    }
+
+    return true;
+}
+
+// Generate cubicmap geometry tile by tile from a row source, returns total number of vertices generated (-1 on error)
+// NOTE: tileSize 0 picks the biggest tile fitting memoryBudget (bytes), tiles with no geometry are skipped.
+// Every source row is read once, in increasing order, so file sources are read sequentially
+long long GenMeshCubicmapTiled(CubicmapRowSource source, Vector3 cubeSize, int mode, int tileSize, long long memoryBudget, CubicmapTileCallback callback, void *userData)
+{
+    if ((source.readRow == NULL) || (source.width <= 0) || (source.height <= 0) || (callback == NULL)) return -1;
+
+    // Shrink tiles until working set fits in memory budget
+    if ((tileSize <= 0) || (tileSize > CUBICMAP_TILE_MAX_SIZE)) tileSize = CUBICMAP_TILE_MAX_SIZE;
+    while ((tileSize > CUBICMAP_TILE_MIN_SIZE) && (GetCubicmapTiledMemory(source.width, tileSize) > memoryBudget)) tileSize /= 2;
+
+    long long memory = GetCubicmapTiledMemory(source.width, tileSize);
+    if (memory > memoryBudget) TRACELOG(LOG_WARNING, "CUBICMAP: Memory budget too small for %i cells wide map, using %lli bytes", source.width, memory);
+
+    int path = ResolveCubicmapEmitPath(CUBICMAP_EMIT_AUTO);
+    bool wide = (path != CUBICMAP_EMIT_SCALAR);
+    size_t tileVertices = (size_t)tileSize*tileSize*CUBICMAP_CELL_MAX_VERTICES;
+
+    // Strip grid: tile rows plus one neighbour row above and below, full map width
+    CubicmapGrid strip = { 0 };
+    strip.width = source.width;
+    strip.height = tileSize + 2;
+    strip.cubeSize = cubeSize;
+    strip.floor = (unsigned char *)RL_MALLOC((size_t)strip.width*strip.height);
+    strip.ceiling = (unsigned char *)RL_MALLOC((size_t)strip.width*strip.height);
+    Color *pixels = (Color *)RL_MALLOC((size_t)strip.width*sizeof(Color));
+
+    CubicmapRow row = { 0 };
+    float *rowData = (float *)RL_MALLOC((size_t)strip.width*4*sizeof(float));
+    row.x0 = rowData;
+    row.x1 = rowData + strip.width;
+    row.floorY = rowData + strip.width*2;
+    row.ceilingY = rowData + strip.width*3;
+    row.faces = (unsigned short *)RL_MALLOC((size_t)strip.width*sizeof(unsigned short));
+
+    CubicmapTile tile = { 0 };
+    tile.mesh.vertices = (float *)RL_MALLOC(tileVertices*3*sizeof(float));
+    tile.mesh.normals = (float *)RL_MALLOC(tileVertices*3*sizeof(float));
+    tile.mesh.texcoords = (float *)RL_MALLOC(tileVertices*2*sizeof(float));
+
+    long long totalVertices = 0;
+    int tileCount = 0;
+    bool failed = false;
+
+    for (int z0 = 0; (z0 < source.height) && !failed; z0 += tileSize)
+    {
+        int rows = (z0 + tileSize <= source.height)? tileSize : source.height - z0;
+        size_t rowSize = (size_t)strip.width;
+
+        // Last two rows of the previous strip are the first two rows of this one (border row and first tile row)
+        if (z0 == 0) failed = !DecodeCubicmapStrip(source, mode, -1, rows + 2, strip.floor, strip.ceiling, pixels);
+        else
+        {
+            memmove(strip.floor, strip.floor + tileSize*rowSize, 2*rowSize);
+            memmove(strip.ceiling, strip.ceiling + tileSize*rowSize, 2*rowSize);
+            failed = !DecodeCubicmapStrip(source, mode, z0 + 1, rows, strip.floor + 2*rowSize, strip.ceiling + 2*rowSize, pixels);
+        }
+
+        if (failed)
+        {
+            TRACELOG(LOG_WARNING, "CUBICMAP: Failed to read map rows of tiles at row %i", z0);
+            break;
+        }
+
+        for (int x0 = 0; x0 < source.width; x0 += tileSize)
+        {
+            int columns = (x0 + tileSize <= source.width)? tileSize : source.width - x0;
+            int vCounter = 0;
+
+            for (int r = 1; r <= rows; r++)
+            {
+                // Row corners use map Z, strip row r is map row z0 + r - 1
+                row.z0 = cubeSize.z*((float)(z0 + r - 1) - 0.5f);
+                row.z1 = cubeSize.z*((float)(z0 + r - 1) + 0.5f);
+                GetCubicmapRow(&strip, r, x0, columns, &row, path);
+
+                for (int x = x0; x < x0 + columns; x++) vCounter = EmitCubicmapGridCell(&strip, x, r, &row, &tile.mesh, vCounter, wide);
+            }
+
+            if (vCounter == 0) continue;
+
+            tile.x = x0;
+            tile.z = z0;
+            tile.width = columns;
+            tile.height = rows;
+            tile.bounds.min = (Vector3){ cubeSize.x*((float)x0 - 0.5f), 0.0f, cubeSize.z*((float)z0 - 0.5f) };
+            tile.bounds.max = (Vector3){ cubeSize.x*((float)(x0 + columns) - 0.5f), cubeSize.y, cubeSize.z*((float)(z0 + rows) - 0.5f) };
+            tile.mesh.vertexCount = vCounter;
+            tile.mesh.triangleCount = vCounter/3;
+
+            callback(&tile, userData);
+
+            totalVertices += vCounter;
+            tileCount++;
+        }
+    }
+
+    RL_FREE(tile.mesh.vertices);
+    RL_FREE(tile.mesh.normals);
+    RL_FREE(tile.mesh.texcoords);
+    RL_FREE(rowData);
+    RL_FREE(row.faces);
+    RL_FREE(pixels);
+    RL_FREE(strip.floor);
+    RL_FREE(strip.ceiling);
+
+    if (failed) return -1;
+
+    TRACELOG(LOG_INFO, "CUBICMAP: Tiled generation [%i x %i] done, %i tiles of %i cells, %lli vertices, %lli bytes working set",
+        source.width, source.height, tileCount, tileSize, totalVertices, memory);
+
+    return totalVertices;
+}
+
+// Tiled benchmark state: reference grid and tiles that differ from the grid region mesh
+typedef struct CubicmapTiledCheck {
+    const CubicmapGrid *grid;
+    int tiles;
+    int mismatches;
+} CubicmapTiledCheck;
+
+// Read grid row as height channels colors (R: floor, G: ceiling drop)
+static bool ReadCubicmapGridRow(void *userData, int y, Color *pixels)
+{
+    const CubicmapGrid *grid = ((const CubicmapTiledCheck *)userData)->grid;
+
+    for (int x = 0; x < grid->width; x++)
+    {
+        size_t cell = (size_t)y*grid->width + x;
+        pixels[x] = (Color){ grid->floor[cell], (unsigned char)(255 - grid->ceiling[cell]), 0, 255 };
+    }
+
+    return true;
+}
+
+// Compare a tile with the region mesh generated from the whole grid
+static void CheckCubicmapTile(const CubicmapTile *tile, void *userData)
+{
+    CubicmapTiledCheck *check = (CubicmapTiledCheck *)userData;
+    Mesh region = GenMeshCubicmapGridRegion(check->grid, tile->x, tile->z, tile->width, tile->height);
+
+    bool exact = (region.vertexCount == tile->mesh.vertexCount) &&
+        (memcmp(region.vertices, tile->mesh.vertices, (size_t)region.vertexCount*3*sizeof(float)) == 0) &&
+        (memcmp(region.normals, tile->mesh.normals, (size_t)region.vertexCount*3*sizeof(float)) == 0) &&
+        (memcmp(region.texcoords, tile->mesh.texcoords, (size_t)region.vertexCount*2*sizeof(float)) == 0);
+
+    if (!exact) check->mismatches++;
+    check->tiles++;
+
+    RL_FREE(region.vertices);
+    RL_FREE(region.normals);
+    RL_FREE(region.texcoords);
+}
+
+// Benchmark tiled generation from a row source against whole grid generation, every tile is checked against
+// the region mesh of the grid, returns the number of tiles that differ (plus one if vertex totals differ)
+// NOTE: Runs headless, grid cells must have ceiling >= floor so they round trip through height channels
+int BenchmarkCubicmapTiled(const CubicmapGrid *grid, int tileSize)
+{
+    CubicmapTiledCheck check = { grid, 0, 0 };
+    CubicmapRowSource source = { grid->width, grid->height, ReadCubicmapGridRow, &check };
+
+    double start = GetTimerSeconds();
+    Mesh full = GenMeshCubicmapGridData(grid);
+    double fullTime = GetTimerSeconds() - start;
+
+    start = GetTimerSeconds();
+    long long vertices = GenMeshCubicmapTiled(source, grid->cubeSize, CUBICMAP_HEIGHT_CHANNELS, tileSize, 1LL << 40, CheckCubicmapTile, &check);
+    double tiledTime = GetTimerSeconds() - start;
+
+    int failures = check.mismatches + ((vertices != full.vertexCount)? 1 : 0);
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "CUBICMAP: Tiled [%i x %i] with %i cell tiles (checks included): %.2f ms, %lli bytes working set, whole grid: %.2f ms, %lli bytes mesh, %i of %i tiles differ",
+        grid->width, grid->height, tileSize, tiledTime*1000.0, GetCubicmapTiledMemory(grid->width, tileSize), fullTime*1000.0, (long long)full.vertexCount*8*sizeof(float), check.mismatches, check.tiles);
+
+    RL_FREE(full.vertices);
+    RL_FREE(full.normals);
+    RL_FREE(full.texcoords);
+
+    return failures;
+}
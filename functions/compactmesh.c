@@ -0,0 +1,202 @@
+#include "raylib.h"         // Declares module functions
+#include "rlgl.h"           // Required for: rlLoadVertexArray(), rlSetVertexAttribute(), rlDrawVertexArray()
+#include "raymath.h"        // Required for: MatrixMultiply()
+
+#include <stdlib.h>         // Required for: malloc(), free()
+#include <math.h>           // Required for: roundf(), fabsf()
+
+// Compact map vertex format: 12 bytes per vertex instead of 32
+// NOTE: Positions are int16 in 'unit' steps from the region origin, normals are one of the 6 cube
+// faces, baked light is unorm8 and atlas texcoords are unorm16, compact_map.vs shader decodes them
+
+#ifndef RL_SHORT
+    #define RL_SHORT                0x1402      // GL_SHORT
+#endif
+#ifndef RL_UNSIGNED_SHORT
+    #define RL_UNSIGNED_SHORT       0x1403      // GL_UNSIGNED_SHORT
+#endif
+
+#define COMPACT_POSITION_SUBDIV     8           // Quantization steps per cube on X/Z
+#define COMPACT_HEIGHT_SUBDIV       2040        // Quantization steps per cube on Y (8 steps for each of 255 height levels)
+
+typedef struct CompactMapVertex {
+    short position[3];              // Quantized position, relative to region origin
+    unsigned char face;             // Face/normal index: 0 +X, 1 -X, 2 +Y, 3 -Y, 4 -Z, 5 +Z
+    unsigned char light;            // Baked vertex light (see lightbake.c), unorm8
+    unsigned short texcoord[2];     // Atlas texcoords, unorm16
+} CompactMapVertex;
+
+typedef struct CompactMesh {
+    int vertexCount;
+    Vector3 origin;                 // Region origin, added to decoded positions
+    Vector3 unit;                   // Size of a position quantization step
+    unsigned int vaoId;
+    unsigned int vboId;
+} CompactMesh;
+
+typedef struct CompactMapShader {
+    Shader shader;
+    int originLoc;
+    int unitLoc;
+    int textureLoc;
+    int modelLoc;
+    int clusterGridLoc;             // Clustered point lights (see lightclusters.c)
+    int clusterDepthLoc;
+    int lightDataLoc;
+    int clusterDataLoc;
+    int lightIndicesLoc;
+} CompactMapShader;
+
+// Get cube face index from a (possibly scaled) axis aligned normal
+static unsigned char GetCompactFace(float nx, float ny, float nz)
+{
+    float ax = fabsf(nx), ay = fabsf(ny), az = fabsf(nz);
+
+    if ((ax >= ay) && (ax >= az)) return (nx >= 0.0f)? 0 : 1;
+    if (ay >= az) return (ny >= 0.0f)? 2 : 3;
+    return (nz <= 0.0f)? 4 : 5;
+}
+
+// Get default quantization step for a cubicmap generated with cubeSize
+Vector3 GetCompactMeshUnit(Vector3 cubeSize)
+{
+    return (Vector3){ cubeSize.x/COMPACT_POSITION_SUBDIV, cubeSize.y/COMPACT_HEIGHT_SUBDIV, cubeSize.z/COMPACT_POSITION_SUBDIV };
+}
+
+// Encode float mesh vertices into compact vertices, returns number of positions clamped to int16 range
+int EncodeCompactVertices(const Mesh *mesh, int firstVertex, int vertexCount, Vector3 origin, Vector3 unit, CompactMapVertex *vertices)
+{
+    int clamped = 0;
+
+    for (int i = 0; i < vertexCount; i++)
+    {
+        int v = firstVertex + i;
+        CompactMapVertex *out = &vertices[i];
+
+        for (int k = 0; k < 3; k++)
+        {
+            float o = (k == 0)? origin.x : (k == 1)? origin.y : origin.z;
+            float u = (k == 0)? unit.x : (k == 1)? unit.y : unit.z;
+            float q = roundf((mesh->vertices[v*3 + k] - o)/u);
+
+            if (q < -32768.0f) { q = -32768.0f; clamped++; }
+            if (q > 32767.0f) { q = 32767.0f; clamped++; }
+
+            out->position[k] = (short)q;
+        }
+
+        out->face = (mesh->normals != NULL)? GetCompactFace(mesh->normals[v*3], mesh->normals[v*3 + 1], mesh->normals[v*3 + 2]) : 2;
+        out->light = (mesh->colors != NULL)? mesh->colors[v*4] : 255;
+
+        if (mesh->texcoords != NULL)
+        {
+            out->texcoord[0] = (unsigned short)roundf(Clamp(mesh->texcoords[v*2], 0.0f, 1.0f)*65535.0f);
+            out->texcoord[1] = (unsigned short)roundf(Clamp(mesh->texcoords[v*2 + 1], 0.0f, 1.0f)*65535.0f);
+        }
+        else out->texcoord[0] = out->texcoord[1] = 0;
+    }
+
+    return clamped;
+}
+
+// Upload compact vertices to GPU, vertex data can be freed afterwards
+CompactMesh LoadCompactMesh(const CompactMapVertex *vertices, int vertexCount, Vector3 origin, Vector3 unit)
+{
+    CompactMesh mesh = { 0 };
+
+    mesh.vertexCount = vertexCount;
+    mesh.origin = origin;
+    mesh.unit = unit;
+
+    mesh.vaoId = rlLoadVertexArray();
+    rlEnableVertexArray(mesh.vaoId);
+
+    mesh.vboId = rlLoadVertexBuffer(vertices, vertexCount*sizeof(CompactMapVertex), false);
+
+    // Attribute locations match raylib default shader locations, see shaders/compact_map.vs
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 3, RL_SHORT, false, sizeof(CompactMapVertex), 0);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL, 1, RL_UNSIGNED_BYTE, false, sizeof(CompactMapVertex), 6);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_NORMAL);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 1, RL_UNSIGNED_BYTE, true, sizeof(CompactMapVertex), 7);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR);
+    rlSetVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, RL_UNSIGNED_SHORT, true, sizeof(CompactMapVertex), 8);
+    rlEnableVertexAttribute(RL_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD);
+
+    rlDisableVertexArray();
+
+    return mesh;
+}
+
+// Generate compact mesh from a float mesh (cubicmap meshes), mesh CPU data is not modified
+CompactMesh GenCompactMeshFromMesh(Mesh mesh, Vector3 origin, Vector3 unit)
+{
+    CompactMapVertex *vertices = (CompactMapVertex *)RL_MALLOC(mesh.vertexCount*sizeof(CompactMapVertex));
+
+    int clamped = EncodeCompactVertices(&mesh, 0, mesh.vertexCount, origin, unit, vertices);
+    if (clamped > 0) TRACELOG(LOG_WARNING, "MESH: Compact mesh has %i coordinates out of int16 range, split it in smaller regions", clamped);
+
+    CompactMesh result = LoadCompactMesh(vertices, mesh.vertexCount, origin, unit);
+
+    TRACELOG(LOG_INFO, "MESH: Compact mesh uploaded, %i vertices, %i bytes (float mesh: %i bytes)", mesh.vertexCount,
+        mesh.vertexCount*(int)sizeof(CompactMapVertex), mesh.vertexCount*8*(int)sizeof(float));
+
+    RL_FREE(vertices);
+
+    return result;
+}
+
+// Unload compact mesh from GPU
+void UnloadCompactMesh(CompactMesh mesh)
+{
+    rlUnloadVertexBuffer(mesh.vboId);
+    rlUnloadVertexArray(mesh.vaoId);
+}
+
+// Load shader decoding compact map vertices
+CompactMapShader LoadCompactMapShader(void)
+{
+    CompactMapShader result = { 0 };
+
+    result.shader = LoadShader("shaders/compact_map.vs", "shaders/compact_map.fs");
+    result.originLoc = GetShaderLocation(result.shader, "regionOrigin");
+    result.unitLoc = GetShaderLocation(result.shader, "positionUnit");
+    result.textureLoc = GetShaderLocation(result.shader, "texture0");
+    result.modelLoc = GetShaderLocation(result.shader, "matModel");
+    result.clusterGridLoc = GetShaderLocation(result.shader, "clusterGrid");
+    result.clusterDepthLoc = GetShaderLocation(result.shader, "clusterDepth");
+    result.lightDataLoc = GetShaderLocation(result.shader, "lightData");
+    result.clusterDataLoc = GetShaderLocation(result.shader, "clusterData");
+    result.lightIndicesLoc = GetShaderLocation(result.shader, "lightIndices");
+
+    return result;
+}
+
+// Draw compact mesh with a diffuse texture
+void DrawCompactMesh(CompactMesh mesh, CompactMapShader shader, Texture2D texture, Matrix transform)
+{
+    // Flush pending batched draws, we bind our own vertex array
+    rlDrawRenderBatchActive();
+
+    Matrix matModelViewProjection = MatrixMultiply(MatrixMultiply(transform, rlGetMatrixModelview()), rlGetMatrixProjection());
+    float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+    int textureSlot = 0;
+
+    rlEnableShader(shader.shader.id);
+    rlSetUniformMatrix(shader.shader.locs[SHADER_LOC_MATRIX_MVP], matModelViewProjection);
+    rlSetUniformMatrix(shader.modelLoc, transform);
+    rlSetUniform(shader.originLoc, &mesh.origin, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(shader.unitLoc, &mesh.unit, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(shader.shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(shader.textureLoc, &textureSlot, SHADER_UNIFORM_INT, 1);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(texture.id);
+
+    rlEnableVertexArray(mesh.vaoId);
+    rlDrawVertexArray(0, mesh.vertexCount);
+    rlDisableVertexArray();
+
+    rlDisableTexture();
+    rlDisableShader();
+}
@@ -0,0 +1,452 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: malloc(), free(), rand()
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: sqrtf(), floorf()
+
+// Crowd: many agents steering along a flow field, kept apart with a spatial hash
+// NOTE: Agent data is structure-of-arrays, agents are referenced by dense index and removed
+// with swap-remove (last agent takes the removed index). The spatial hash has one bucket per cubicmap
+// cell, agents stay linked in their bucket and only agents changing cell are relinked each tick.
+// Moves between cells follow NavGrid moves, so walls and too high steps make agents slide.
+
+#define CROWD_MAX_NEIGHBORS     16          // Neighbours considered per agent for steering
+#define CROWD_NONE              -1
+
+typedef struct CrowdSettings {
+    float radius;               // Agent radius (world units)
+    float height;               // Agent height, only used for drawing
+    float maxSpeed;             // Max speed (world units per second)
+    float maxAccel;             // Max acceleration (world units per second^2)
+    float separation;           // Separation steering weight
+    float avoidance;            // Avoidance steering weight
+    float avoidanceTime;        // Time horizon for predicted collisions (seconds)
+} CrowdSettings;
+
+typedef struct Crowd {
+    const CubicmapGrid *grid;
+    Vector3 position;           // Map draw position (cubicmap mesh space offset)
+    CrowdSettings settings;
+    int capacity;
+    int count;
+
+    // Agent data, indexed by [0, count)
+    float *posX;                // World position
+    float *posY;
+    float *posZ;
+    float *velX;                // Velocity on XZ
+    float *velZ;
+    float *steerX;              // New velocity, written by steering and read by integration
+    float *steerZ;
+    int *cell;                  // Current cubicmap cell (z*width + x)
+    int *next;                  // Next agent in bucket list
+    int *prev;                  // Previous agent in bucket list
+
+    int *buckets;               // Cubicmap cell -> first agent, neighbour cells are neighbour buckets
+} Crowd;
+
+// Get default crowd settings
+CrowdSettings GetCrowdDefaults(void)
+{
+    CrowdSettings settings = { 0 };
+
+    settings.radius = 0.35f;
+    settings.height = 1.8f;
+    settings.maxSpeed = 3.0f;
+    settings.maxAccel = 12.0f;
+    settings.separation = 2.0f;
+    settings.avoidance = 1.0f;
+    settings.avoidanceTime = 1.0f;
+
+    return settings;
+}
+
+// Get cubicmap cell coordinates of a world position
+static void GetCrowdCell(const Crowd *crowd, float x, float z, int *cellX, int *cellZ)
+{
+    *cellX = (int)floorf((x - crowd->position.x)/crowd->grid->cubeSize.x + 0.5f);
+    *cellZ = (int)floorf((z - crowd->position.z)/crowd->grid->cubeSize.z + 0.5f);
+}
+
+// Link agent into the bucket of its cell
+static void LinkCrowdAgent(Crowd *crowd, int index)
+{
+    int bucket = crowd->cell[index];
+
+    crowd->prev[index] = CROWD_NONE;
+    crowd->next[index] = crowd->buckets[bucket];
+    if (crowd->buckets[bucket] != CROWD_NONE) crowd->prev[crowd->buckets[bucket]] = index;
+    crowd->buckets[bucket] = index;
+}
+
+// Unlink agent from the bucket of its cell
+static void UnlinkCrowdAgent(Crowd *crowd, int index)
+{
+    if (crowd->prev[index] != CROWD_NONE) crowd->next[crowd->prev[index]] = crowd->next[index];
+    else crowd->buckets[crowd->cell[index]] = crowd->next[index];
+
+    if (crowd->next[index] != CROWD_NONE) crowd->prev[crowd->next[index]] = crowd->prev[index];
+}
+
+// Get floor height of a cell in world units
+static float GetCrowdFloorHeight(const Crowd *crowd, int cell)
+{
+    return crowd->position.y + crowd->grid->floor[cell]*crowd->grid->cubeSize.y/255.0f;
+}
+
+// Load crowd with fixed capacity on a cubicmap grid drawn at position
+Crowd LoadCrowd(const CubicmapGrid *grid, Vector3 position, int capacity, CrowdSettings settings)
+{
+    Crowd crowd = { 0 };
+
+    crowd.grid = grid;
+    crowd.position = position;
+    crowd.settings = settings;
+    crowd.capacity = capacity;
+
+    crowd.posX = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.posY = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.posZ = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.velX = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.velZ = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.steerX = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.steerZ = (float *)RL_MALLOC(capacity*sizeof(float));
+    crowd.cell = (int *)RL_MALLOC(capacity*sizeof(int));
+    crowd.next = (int *)RL_MALLOC(capacity*sizeof(int));
+    crowd.prev = (int *)RL_MALLOC(capacity*sizeof(int));
+
+    // Buckets per cell: no collisions between cells and the 3x3 neighbour buckets are three short rows
+    int bucketCount = grid->width*grid->height;
+    crowd.buckets = (int *)RL_MALLOC(bucketCount*sizeof(int));
+    for (int i = 0; i < bucketCount; i++) crowd.buckets[i] = CROWD_NONE;
+
+    return crowd;
+}
+
+// Unload crowd data
+void UnloadCrowd(Crowd *crowd)
+{
+    RL_FREE(crowd->posX);
+    RL_FREE(crowd->posY);
+    RL_FREE(crowd->posZ);
+    RL_FREE(crowd->velX);
+    RL_FREE(crowd->velZ);
+    RL_FREE(crowd->steerX);
+    RL_FREE(crowd->steerZ);
+    RL_FREE(crowd->cell);
+    RL_FREE(crowd->next);
+    RL_FREE(crowd->prev);
+    RL_FREE(crowd->buckets);
+
+    memset(crowd, 0, sizeof(Crowd));
+}
+
+// Add agent at world position, returns agent index or -1 if crowd is full or position is outside the map
+int AddCrowdAgent(Crowd *crowd, Vector3 position)
+{
+    int cellX, cellZ;
+    GetCrowdCell(crowd, position.x, position.z, &cellX, &cellZ);
+
+    if ((crowd->count == crowd->capacity) || (cellX < 0) || (cellZ < 0) || (cellX >= crowd->grid->width) || (cellZ >= crowd->grid->height)) return -1;
+
+    int index = crowd->count++;
+
+    crowd->posX[index] = position.x;
+    crowd->posZ[index] = position.z;
+    crowd->velX[index] = 0.0f;
+    crowd->velZ[index] = 0.0f;
+    crowd->cell[index] = cellZ*crowd->grid->width + cellX;
+    crowd->posY[index] = GetCrowdFloorHeight(crowd, crowd->cell[index]);
+    LinkCrowdAgent(crowd, index);
+
+    return index;
+}
+
+// Remove agent, last agent is moved to the removed index
+void RemoveCrowdAgent(Crowd *crowd, int index)
+{
+    if ((index < 0) || (index >= crowd->count)) return;
+
+    int last = --crowd->count;
+
+    UnlinkCrowdAgent(crowd, index);
+
+    if (index != last)
+    {
+        UnlinkCrowdAgent(crowd, last);
+
+        crowd->posX[index] = crowd->posX[last];
+        crowd->posY[index] = crowd->posY[last];
+        crowd->posZ[index] = crowd->posZ[last];
+        crowd->velX[index] = crowd->velX[last];
+        crowd->velZ[index] = crowd->velZ[last];
+        crowd->cell[index] = crowd->cell[last];
+
+        LinkCrowdAgent(crowd, index);
+    }
+}
+
+// Get agent world position (feet)
+Vector3 GetCrowdAgentPosition(const Crowd *crowd, int index)
+{
+    return (Vector3){ crowd->posX[index], crowd->posY[index], crowd->posZ[index] };
+}
+
+// Compute new agent velocities: flow field direction plus separation and avoidance of neighbours
+// NOTE: Reads positions and velocities only, so agent order does not change the result
+static void SteerCrowd(Crowd *crowd, const NavFlowField *field, float dt)
+{
+    const CrowdSettings *s = &crowd->settings;
+    int width = crowd->grid->width;
+    float diameter = 2.0f*s->radius;
+    float maxDelta = s->maxAccel*dt;
+
+    for (int i = 0; i < crowd->count; i++)
+    {
+        float px = crowd->posX[i], pz = crowd->posZ[i];
+        float vx = crowd->velX[i], vz = crowd->velZ[i];
+        int cellX = crowd->cell[i]%width, cellZ = crowd->cell[i]/width;
+
+        // Desired velocity from flow field, agents at goal or without a path stop
+        Vector2 direction = (field != NULL)? GetNavFlowDirection(field, cellX, cellZ) : (Vector2){ 0 };
+        float steerX = direction.x*s->maxSpeed - vx;
+        float steerZ = direction.y*s->maxSpeed - vz;
+
+        float separationX = 0.0f, separationZ = 0.0f;
+        float avoidX = 0.0f, avoidZ = 0.0f;
+        int neighbors = 0;
+
+        // Neighbours from the 3x3 cells around, agent radius must stay below cell size
+        for (int dz = -1; (dz <= 1) && (neighbors < CROWD_MAX_NEIGHBORS); dz++)
+        {
+            for (int dx = -1; (dx <= 1) && (neighbors < CROWD_MAX_NEIGHBORS); dx++)
+            {
+                int nx = cellX + dx, nz = cellZ + dz;
+                if ((nx < 0) || (nz < 0) || (nx >= width) || (nz >= crowd->grid->height)) continue;
+
+                int cell = nz*width + nx;
+
+                for (int j = crowd->buckets[cell]; (j != CROWD_NONE) && (neighbors < CROWD_MAX_NEIGHBORS); j = crowd->next[j])
+                {
+                    if (j == i) continue;
+
+                    float ox = px - crowd->posX[j];
+                    float oz = pz - crowd->posZ[j];
+                    float distanceSqr = ox*ox + oz*oz;
+
+                    if (distanceSqr < diameter*diameter)
+                    {
+                        // Overlapping: push apart, coincident agents are split by index
+                        float distance = sqrtf(distanceSqr);
+                        float push = (diameter - distance)/diameter;
+                        if (distance < 1e-5f) { ox = (i < j)? 1.0f : -1.0f; oz = 0.0f; distance = 1.0f; }
+
+                        separationX += ox/distance*push;
+                        separationZ += oz/distance*push;
+                        neighbors++;
+                        continue;
+                    }
+
+                    // Predicted closest approach within the time horizon
+                    float rvx = vx - crowd->velX[j];
+                    float rvz = vz - crowd->velZ[j];
+                    float speedSqr = rvx*rvx + rvz*rvz;
+                    if (speedSqr < 1e-6f) continue;
+
+                    float t = -(ox*rvx + oz*rvz)/speedSqr;
+                    if ((t <= 0.0f) || (t > s->avoidanceTime)) continue;
+
+                    float cx = ox + rvx*t;
+                    float cz = oz + rvz*t;
+                    float closestSqr = cx*cx + cz*cz;
+
+                    if (closestSqr < diameter*diameter)
+                    {
+                        float closest = sqrtf(closestSqr);
+                        float weight = 1.0f - t/s->avoidanceTime;
+
+                        if (closest < 1e-5f) { cx = -rvz; cz = rvx; closest = sqrtf(speedSqr); }     // Head-on: sidestep
+                        avoidX += cx/closest*weight;
+                        avoidZ += cz/closest*weight;
+                        neighbors++;
+                    }
+                }
+            }
+        }
+
+        steerX += (separationX*s->separation + avoidX*s->avoidance)*s->maxSpeed;
+        steerZ += (separationZ*s->separation + avoidZ*s->avoidance)*s->maxSpeed;
+
+        // Limit acceleration and speed
+        float steerSqr = steerX*steerX + steerZ*steerZ;
+        if (steerSqr > maxDelta*maxDelta)
+        {
+            float scale = maxDelta/sqrtf(steerSqr);
+            steerX *= scale;
+            steerZ *= scale;
+        }
+
+        vx += steerX;
+        vz += steerZ;
+
+        float speedSqr = vx*vx + vz*vz;
+        if (speedSqr > s->maxSpeed*s->maxSpeed)
+        {
+            float scale = s->maxSpeed/sqrtf(speedSqr);
+            vx *= scale;
+            vz *= scale;
+        }
+
+        crowd->steerX[i] = vx;
+        crowd->steerZ[i] = vz;
+    }
+}
+
+// Move agents with new velocities, sliding along walls, and relink agents that changed cell
+// NOTE: Axes are moved separately, a blocked axis is clamped at the wall and its velocity dropped
+static void MoveCrowd(Crowd *crowd, const NavGrid *nav, float dt)
+{
+    int width = crowd->grid->width;
+    float radius = crowd->settings.radius;
+    float sizeX = crowd->grid->cubeSize.x;
+    float sizeZ = crowd->grid->cubeSize.z;
+
+    for (int i = 0; i < crowd->count; i++)
+    {
+        float vx = crowd->steerX[i], vz = crowd->steerZ[i];
+        int cellX = crowd->cell[i]%width, cellZ = crowd->cell[i]/width;
+
+        // X axis: probe the cell at the agent edge in move direction
+        float x = crowd->posX[i] + vx*dt;
+        if (vx != 0.0f)
+        {
+            float side = (vx > 0.0f)? 1.0f : -1.0f;
+            int probeX, probeZ;
+            GetCrowdCell(crowd, x + side*radius, crowd->posZ[i], &probeX, &probeZ);
+
+            if ((probeX != cellX) && !(nav->moves[crowd->cell[i]] & ((vx > 0.0f)? 1 : 2)))
+            {
+                x = crowd->position.x + sizeX*(cellX + 0.5f*side) - side*(radius + 1e-4f);
+                vx = 0.0f;
+            }
+        }
+
+        int newX, newZ;
+        GetCrowdCell(crowd, x, crowd->posZ[i], &newX, &newZ);
+        int cell = cellZ*width + newX;
+
+        // Z axis from the cell reached along X
+        float z = crowd->posZ[i] + vz*dt;
+        if (vz != 0.0f)
+        {
+            float side = (vz > 0.0f)? 1.0f : -1.0f;
+            int probeX, probeZ;
+            GetCrowdCell(crowd, x, z + side*radius, &probeX, &probeZ);
+
+            if ((probeZ != cellZ) && !(nav->moves[cell] & ((vz > 0.0f)? 4 : 8)))
+            {
+                z = crowd->position.z + sizeZ*(cellZ + 0.5f*side) - side*(radius + 1e-4f);
+                vz = 0.0f;
+            }
+        }
+
+        GetCrowdCell(crowd, x, z, &newX, &newZ);
+        cell = newZ*width + newX;
+
+        crowd->posX[i] = x;
+        crowd->posZ[i] = z;
+        crowd->velX[i] = vx;
+        crowd->velZ[i] = vz;
+
+        if (cell != crowd->cell[i])
+        {
+            UnlinkCrowdAgent(crowd, i);
+            crowd->cell[i] = cell;
+            LinkCrowdAgent(crowd, i);
+        }
+
+        crowd->posY[i] = GetCrowdFloorHeight(crowd, cell);
+    }
+}
+
+// Update crowd: steer along flow field (optional, NULL stops agents) and move with wall sliding
+void UpdateCrowd(Crowd *crowd, const NavGrid *nav, const NavFlowField *field, float dt)
+{
+    if (dt <= 0.0f) return;
+
+    SteerCrowd(crowd, field, dt);
+    MoveCrowd(crowd, nav, dt);
+}
+
+// Draw crowd agents as cylinders
+void DrawCrowd(const Crowd *crowd, Color color)
+{
+    for (int i = 0; i < crowd->count; i++)
+    {
+        DrawCylinder(GetCrowdAgentPosition(crowd, i), crowd->settings.radius, crowd->settings.radius, crowd->settings.height, 8, color);
+    }
+}
+
+// Draw agents from a list of positions (i.e. a simulation snapshot), sized by crowd settings
+void DrawCrowdPositions(const Vector3 *positions, int count, CrowdSettings settings, Color color)
+{
+    for (int i = 0; i < count; i++) DrawCylinder(positions[i], settings.radius, settings.radius, settings.height, 8, color);
+}
+
+// Benchmark crowd updates: agents spawned on random walkable cells walk to a random goal, logs avg tick time
+// NOTE: Runs headless, takes cells from a fixed seed, returns the number of agents off the walkable cells or the spatial hash,
+// plus one if the average tick is over tickBudget (seconds)
+int BenchmarkCrowd(const CubicmapGrid *grid, NavGrid *nav, int agentCount, int ticks, float tickBudget)
+{
+    Crowd crowd = LoadCrowd(grid, (Vector3){ 0 }, agentCount, GetCrowdDefaults());
+    NavFlowField field = LoadNavFlowField(nav);
+
+    srand(1234);
+    while (crowd.count < agentCount)
+    {
+        int x = rand()%grid->width, z = rand()%grid->height;
+        if (!IsNavCellWalkable(nav, x, z)) continue;
+
+        AddCrowdAgent(&crowd, (Vector3){ (x + (rand()%100 - 50)/200.0f)*grid->cubeSize.x, 0.0f, (z + (rand()%100 - 50)/200.0f)*grid->cubeSize.z });
+    }
+
+    int goalX, goalZ;
+    do { goalX = rand()%grid->width; goalZ = rand()%grid->height; } while (!IsNavCellWalkable(nav, goalX, goalZ));
+    UpdateNavFlowField(nav, &field, goalX, goalZ, 1);
+
+    double start = GetTimerSeconds();
+    for (int t = 0; t < ticks; t++) UpdateCrowd(&crowd, nav, &field, 1.0f/60.0f);
+    double time = GetTimerSeconds() - start;
+
+    // Agents must stay on walkable cells matching their position and linked once in the bucket of their cell
+    int failures = 0;
+    int linked = 0;
+    for (int i = 0; i < crowd.count; i++)
+    {
+        int x, z;
+        GetCrowdCell(&crowd, crowd.posX[i], crowd.posZ[i], &x, &z);
+
+        if (isnan(crowd.posX[i]) || isnan(crowd.posZ[i]) || (crowd.cell[i] != z*grid->width + x) || !IsNavCellWalkable(nav, x, z)) failures++;
+    }
+    for (int b = 0; b < grid->width*grid->height; b++)
+    {
+        for (int i = crowd.buckets[b]; (i != CROWD_NONE) && (linked <= crowd.count); i = crowd.next[i])
+        {
+            if (crowd.cell[i] != b) failures++;
+            linked++;
+        }
+    }
+    if (linked != crowd.count) failures++;
+
+    double tickTime = time/ticks;
+    if (tickTime > tickBudget) failures++;
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "CROWD: %i agents, %i ticks: avg %.3f ms/tick (budget %.1f ms), %i failed checks",
+        agentCount, ticks, tickTime*1000.0, tickBudget*1000.0, failures);
+
+    UnloadNavFlowField(&field);
+    UnloadCrowd(&crowd);
+
+    return failures;
+}
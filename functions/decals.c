@@ -0,0 +1,266 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality, MatrixTranslate()
+#include "rlgl.h"           // Required for: rlDisableDepthMask(), rlEnableDepthMask()
+
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: fminf(), fmaxf()
+
+// Decals: bullet holes, scorch marks and splats on cubicmap walls, floors and ceilings
+// NOTE: Every decal is one quad slot in a fixed capacity ring inside a single dynamic mesh, spawning
+// overwrites the oldest slot, so spawn cost and draw cost never depend on how many decals were spawned.
+// Quads are axis aligned in the face plane and clipped to the hit cell face (rectangle intersection,
+// texcoords follow the clip), so a decal never hangs over a wall edge. Only slots written since the
+// last draw are uploaded with UpdateMeshBuffer(), all decals draw in one call.
+// WARNING: Decal quads are in mesh space (same space as GetGridRayCollision() hits)
+
+#define MAX_DECALS              16384       // 16-bit indices: 4 vertices per decal
+#define DECAL_ATLAS_TILES       4           // Atlas is a row of square tiles, one per DecalType
+#define DECAL_SURFACE_OFFSET    0.01f       // Lift off the face, avoids z-fighting
+
+typedef enum DecalType {
+    DECAL_BULLET_HOLE = 0,
+    DECAL_SCORCH,
+    DECAL_SPLAT
+} DecalType;
+
+typedef struct DecalBatch {
+    Mesh mesh;                  // capacity*4 vertices, dynamic buffers
+    Material material;          // Atlas on the diffuse map
+    int capacity;
+    int count;                  // Live decals, [0, count) after the first wrap it stays at capacity
+    int next;                   // Ring position of the next decal
+
+    int dirtyFirst;             // First slot written since the last upload
+    int dirtyCount;             // Slots written since the last upload (ring order from dirtyFirst)
+
+    const CubicmapGrid *grid;
+    Vector3 gridPosition;       // Grid draw offset
+} DecalBatch;
+
+// Load decal batch with fixed capacity, atlas holds DECAL_ATLAS_TILES tiles side by side
+DecalBatch LoadDecalBatch(const CubicmapGrid *grid, Vector3 position, int capacity, Texture2D atlas)
+{
+    DecalBatch batch = { 0 };
+
+    if (capacity > MAX_DECALS) capacity = MAX_DECALS;
+
+    batch.capacity = capacity;
+    batch.grid = grid;
+    batch.gridPosition = position;
+
+    // Unused slots are degenerate quads at the origin, they draw nothing
+    batch.mesh.vertexCount = capacity*4;
+    batch.mesh.triangleCount = capacity*2;
+    batch.mesh.vertices = (float *)RL_CALLOC(capacity*4*3, sizeof(float));
+    batch.mesh.texcoords = (float *)RL_CALLOC(capacity*4*2, sizeof(float));
+    batch.mesh.normals = (float *)RL_CALLOC(capacity*4*3, sizeof(float));
+    batch.mesh.colors = (unsigned char *)RL_CALLOC(capacity*4*4, sizeof(unsigned char));
+    batch.mesh.indices = (unsigned short *)RL_MALLOC(capacity*6*sizeof(unsigned short));
+
+    for (int i = 0; i < capacity; i++)
+    {
+        unsigned short *index = &batch.mesh.indices[i*6];
+        unsigned short v = (unsigned short)(i*4);
+        index[0] = v; index[1] = v + 1; index[2] = v + 2;
+        index[3] = v; index[4] = v + 2; index[5] = v + 3;
+    }
+
+    UploadMesh(&batch.mesh, true);
+
+    batch.material = LoadMaterialDefault();
+    SetMaterialTexture(&batch.material, MATERIAL_MAP_DIFFUSE, atlas);
+
+    return batch;
+}
+
+// Unload decal batch (atlas texture is not owned by the batch)
+void UnloadDecalBatch(DecalBatch *batch)
+{
+    UnloadMesh(batch->mesh);
+
+    // Default material shader and texture are shared, only the maps array is ours
+    RL_FREE(batch->material.maps);
+
+    memset(batch, 0, sizeof(DecalBatch));
+}
+
+// Get vertical range of the solid part of a wall hit, seen from the open neighbour cell
+static void GetDecalWallRange(const CubicmapGrid *grid, int cellX, int cellZ, int face, float y, float *minY, float *maxY)
+{
+    static const int neighbourX[4] = { 1, -1, 0, 0 };
+    static const int neighbourZ[4] = { 0, 0, -1, 1 };
+    float scaleY = grid->cubeSize.y/255.0f;
+    int floor, ceiling, openFloor, openCeiling;
+
+    GetCubicmapGridCell(grid, cellX, cellZ, &floor, &ceiling);
+    int side = (face < 2)? face : face - 2;
+    GetCubicmapGridCell(grid, cellX + neighbourX[side], cellZ + neighbourZ[side], &openFloor, &openCeiling);
+
+    // Lower part (up to the floor) or roof part (from the ceiling), clipped to the neighbour opening
+    if (y < floor*scaleY) { *minY = 0.0f; *maxY = floor*scaleY; }
+    else { *minY = ceiling*scaleY; *maxY = grid->cubeSize.y; }
+
+    *minY = fmaxf(*minY, openFloor*scaleY);
+    *maxY = fminf(*maxY, openCeiling*scaleY);
+}
+
+// Spawn decal at a grid ray hit, size is the quad side, orientation rotates the texture in 90 degree steps
+// NOTE: The oldest decal is recycled once the batch is full, returns false if the hit has no face
+bool SpawnDecal(DecalBatch *batch, GridRayHit hit, float size, int type, int orientation, Color color)
+{
+    if (!hit.hit || (hit.face == GRID_RAY_FACE_NONE)) return false;
+
+    const CubicmapGrid *grid = batch->grid;
+    Vector3 cellCenter = { hit.cellX*grid->cubeSize.x, 0.0f, hit.cellZ*grid->cubeSize.z };
+    Vector3 normal = hit.normal;
+
+    // Face plane basis (u, v) and face rectangle in it
+    Vector3 u, v;
+    float minU, maxU, minV, maxV, centerU, centerV;
+
+    if ((hit.face == 2) || (hit.face == 3))
+    {
+        // Floor or ceiling: u along X, v along Z
+        u = (Vector3){ 1.0f, 0.0f, 0.0f };
+        v = (Vector3){ 0.0f, 0.0f, 1.0f };
+        minU = cellCenter.x - 0.5f*grid->cubeSize.x; maxU = cellCenter.x + 0.5f*grid->cubeSize.x;
+        minV = cellCenter.z - 0.5f*grid->cubeSize.z; maxV = cellCenter.z + 0.5f*grid->cubeSize.z;
+        centerU = hit.point.x;
+        centerV = hit.point.z;
+    }
+    else
+    {
+        // Wall: u along the wall, v up
+        bool alongX = (hit.face >= 4);
+        u = alongX? (Vector3){ 1.0f, 0.0f, 0.0f } : (Vector3){ 0.0f, 0.0f, 1.0f };
+        v = (Vector3){ 0.0f, 1.0f, 0.0f };
+        float center = alongX? cellCenter.x : cellCenter.z;
+        float halfWidth = 0.5f*(alongX? grid->cubeSize.x : grid->cubeSize.z);
+        minU = center - halfWidth; maxU = center + halfWidth;
+        GetDecalWallRange(grid, hit.cellX, hit.cellZ, hit.face, hit.point.y, &minV, &maxV);
+        centerU = alongX? hit.point.x : hit.point.z;
+        centerV = hit.point.y;
+    }
+
+    // Clip the decal rectangle to the face, texcoords are clipped with it
+    float half = 0.5f*size;
+    float u0 = fmaxf(centerU - half, minU), u1 = fminf(centerU + half, maxU);
+    float v0 = fmaxf(centerV - half, minV), v1 = fminf(centerV + half, maxV);
+    if ((u0 >= u1) || (v0 >= v1)) return false;
+
+    float s0 = (u0 - (centerU - half))/size, s1 = (u1 - (centerU - half))/size;
+    float t0 = (v0 - (centerV - half))/size, t1 = (v1 - (centerV - half))/size;
+
+    int slot = batch->next;
+    float *vertices = &batch->mesh.vertices[slot*12];
+    float *texcoords = &batch->mesh.texcoords[slot*8];
+    float *normals = &batch->mesh.normals[slot*12];
+    unsigned char *colors = &batch->mesh.colors[slot*16];
+
+    // Quad corners in face order, wound counter-clockwise seen from the normal
+    Vector3 origin = Vector3Add(Vector3Subtract(hit.point, Vector3Add(Vector3Scale(u, Vector3DotProduct(hit.point, u)), Vector3Scale(v, Vector3DotProduct(hit.point, v)))), Vector3Scale(normal, DECAL_SURFACE_OFFSET));
+    float cornerU[4] = { u0, u1, u1, u0 };
+    float cornerV[4] = { v0, v0, v1, v1 };
+    float cornerS[4] = { s0, s1, s1, s0 };
+    float cornerT[4] = { t0, t0, t1, t1 };
+    bool flip = (Vector3DotProduct(Vector3CrossProduct(u, v), normal) < 0.0f);
+
+    for (int k = 0; k < 4; k++)
+    {
+        int c = flip? (3 - k) : k;
+        Vector3 p = Vector3Add(origin, Vector3Add(Vector3Scale(u, cornerU[c]), Vector3Scale(v, cornerV[c])));
+
+        // Texture orientation: rotate tile coordinates around the tile center
+        float s = cornerS[c], t = cornerT[c];
+        for (int r = 0; r < (orientation & 3); r++) { float tmp = s; s = t; t = 1.0f - tmp; }
+
+        vertices[k*3 + 0] = p.x;
+        vertices[k*3 + 1] = p.y;
+        vertices[k*3 + 2] = p.z;
+        texcoords[k*2 + 0] = ((float)type + s)/DECAL_ATLAS_TILES;
+        texcoords[k*2 + 1] = 1.0f - t;
+        normals[k*3 + 0] = normal.x;
+        normals[k*3 + 1] = normal.y;
+        normals[k*3 + 2] = normal.z;
+        colors[k*4 + 0] = color.r;
+        colors[k*4 + 1] = color.g;
+        colors[k*4 + 2] = color.b;
+        colors[k*4 + 3] = color.a;
+    }
+
+    // Written slots stay contiguous in ring order
+    if (batch->dirtyCount == 0) batch->dirtyFirst = slot;
+    if (batch->dirtyCount < batch->capacity) batch->dirtyCount++;
+
+    batch->next = (slot + 1)%batch->capacity;
+    if (batch->count < batch->capacity) batch->count++;
+
+    return true;
+}
+
+// Upload a slot range of every vertex attribute
+static void UploadDecalSlots(DecalBatch *batch, int first, int count)
+{
+    UpdateMeshBuffer(batch->mesh, 0, &batch->mesh.vertices[first*12], count*12*sizeof(float), first*12*sizeof(float));
+    UpdateMeshBuffer(batch->mesh, 1, &batch->mesh.texcoords[first*8], count*8*sizeof(float), first*8*sizeof(float));
+    UpdateMeshBuffer(batch->mesh, 2, &batch->mesh.normals[first*12], count*12*sizeof(float), first*12*sizeof(float));
+    UpdateMeshBuffer(batch->mesh, 3, &batch->mesh.colors[first*16], count*16, first*16);
+}
+
+// Upload decals spawned since the last call, at most two ranges when the ring wrapped
+void UpdateDecalBatch(DecalBatch *batch)
+{
+    if (batch->dirtyCount == 0) return;
+
+    int first = batch->dirtyFirst;
+    int count = batch->dirtyCount;
+
+    if (first + count <= batch->capacity) UploadDecalSlots(batch, first, count);
+    else
+    {
+        UploadDecalSlots(batch, first, batch->capacity - first);
+        UploadDecalSlots(batch, 0, first + count - batch->capacity);
+    }
+
+    batch->dirtyCount = 0;
+}
+
+// Draw all decals in one call, alpha blended without depth writes
+// NOTE: Call UpdateDecalBatch() before, or newly spawned decals are not uploaded yet
+void DrawDecalBatch(DecalBatch *batch)
+{
+    if (batch->count == 0) return;
+
+    // Slots past count were never written, draw only the written prefix
+    Mesh mesh = batch->mesh;
+    mesh.triangleCount = batch->count*2;
+
+    rlDisableDepthMask();
+    DrawMesh(mesh, batch->material, MatrixTranslate(batch->gridPosition.x, batch->gridPosition.y, batch->gridPosition.z));
+    rlEnableDepthMask();
+}
+
+// Generate decal atlas: bullet hole, scorch and splat tiles, tileSize pixels square
+Image GenImageDecalAtlas(int tileSize)
+{
+    Image atlas = GenImageColor(tileSize*DECAL_ATLAS_TILES, tileSize, BLANK);
+    Rectangle source = { 0.0f, 0.0f, (float)tileSize, (float)tileSize };
+
+    Image hole = GenImageGradientRadial(tileSize, tileSize, 0.3f, (Color){ 10, 10, 10, 255 }, BLANK);
+    Image scorch = GenImageGradientRadial(tileSize, tileSize, 0.0f, (Color){ 20, 15, 10, 220 }, BLANK);
+    Image splat = GenImageCellular(tileSize, tileSize, tileSize/4);
+    ImageColorTint(&splat, (Color){ 140, 0, 0, 255 });
+    Image splatMask = GenImageGradientRadial(tileSize, tileSize, 0.2f, WHITE, BLANK);
+    ImageAlphaMask(&splat, splatMask);
+
+    ImageDraw(&atlas, hole, source, (Rectangle){ (float)(DECAL_BULLET_HOLE*tileSize), 0.0f, (float)tileSize, (float)tileSize }, WHITE);
+    ImageDraw(&atlas, scorch, source, (Rectangle){ (float)(DECAL_SCORCH*tileSize), 0.0f, (float)tileSize, (float)tileSize }, WHITE);
+    ImageDraw(&atlas, splat, source, (Rectangle){ (float)(DECAL_SPLAT*tileSize), 0.0f, (float)tileSize, (float)tileSize }, WHITE);
+
+    UnloadImage(hole);
+    UnloadImage(scorch);
+    UnloadImage(splat);
+    UnloadImage(splatMask);
+
+    return atlas;
+}
@@ -0,0 +1,256 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: malloc(), free()
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: fmaxf()
+
+// Entity store: props and interactables kept in dense structure-of-arrays components
+// NOTE: Entities are referenced through generational handles, dense arrays are kept packed
+// on destroy (swap-remove) so every system is a linear loop over [0, count)
+
+#define MAX_ENTITY_MODELS       64
+
+#define ENTITY_INDEX_BITS       20
+#define ENTITY_INDEX_MASK       ((1u << ENTITY_INDEX_BITS) - 1)
+#define ENTITY_GENERATION_MASK  (0xffffffffu >> ENTITY_INDEX_BITS)
+
+#define ENTITY_NONE             ((EntityHandle){ 0 })
+
+// Entity handle, slot index in the low bits and slot generation in the high bits
+// NOTE: Generation starts at 1, so a zeroed handle is never valid
+typedef struct EntityHandle {
+    unsigned int id;
+} EntityHandle;
+
+typedef struct EntityStore {
+    int capacity;               // Max number of entities
+    int count;                  // Number of alive entities (dense arrays length)
+
+    // Dense components, indexed by [0, count)
+    Vector3 *position;          // World position
+    Vector3 *scale;             // Model scale
+    BoundingBox *bounds;        // World space bounds, set on creation and by UpdateEntityBounds()
+    int *model;                 // Model table index
+    unsigned char *interactable;// Player can interact with it (ray picking)
+    unsigned char *lod;         // Current LOD level, updated by UpdateEntityLods()
+    unsigned int *slot;         // Dense index -> handle slot
+
+    // Handle slots, indexed by handle index
+    unsigned int *dense;        // Handle slot -> dense index
+    unsigned int *generation;   // Handle slot generation
+    unsigned int *freeSlots;    // Free slots stack
+    int freeCount;
+
+    // Model table, entities reference models by index
+    Model models[MAX_ENTITY_MODELS];
+    BoundingBox modelBounds[MAX_ENTITY_MODELS];     // Model space bounds
+    const ModelLod *modelLods[MAX_ENTITY_MODELS];   // Optional LOD chain per model
+    int modelCount;
+} EntityStore;
+
+// Load entity store with fixed capacity
+EntityStore LoadEntityStore(int capacity)
+{
+    EntityStore store = { 0 };
+
+    if (capacity > (int)ENTITY_INDEX_MASK) capacity = ENTITY_INDEX_MASK;
+
+    store.capacity = capacity;
+    store.position = (Vector3 *)RL_MALLOC(capacity*sizeof(Vector3));
+    store.scale = (Vector3 *)RL_MALLOC(capacity*sizeof(Vector3));
+    store.bounds = (BoundingBox *)RL_MALLOC(capacity*sizeof(BoundingBox));
+    store.model = (int *)RL_MALLOC(capacity*sizeof(int));
+    store.interactable = (unsigned char *)RL_MALLOC(capacity*sizeof(unsigned char));
+    store.lod = (unsigned char *)RL_MALLOC(capacity*sizeof(unsigned char));
+    store.slot = (unsigned int *)RL_MALLOC(capacity*sizeof(unsigned int));
+
+    store.dense = (unsigned int *)RL_MALLOC(capacity*sizeof(unsigned int));
+    store.generation = (unsigned int *)RL_MALLOC(capacity*sizeof(unsigned int));
+    store.freeSlots = (unsigned int *)RL_MALLOC(capacity*sizeof(unsigned int));
+
+    // Slots are handed out lowest index first
+    for (int i = 0; i < capacity; i++)
+    {
+        store.generation[i] = 1;
+        store.freeSlots[i] = capacity - 1 - i;
+    }
+    store.freeCount = capacity;
+
+    return store;
+}
+
+// Unload entity store arrays
+// NOTE: Registered models are owned by the caller and not unloaded here
+void UnloadEntityStore(EntityStore *store)
+{
+    RL_FREE(store->position);
+    RL_FREE(store->scale);
+    RL_FREE(store->bounds);
+    RL_FREE(store->model);
+    RL_FREE(store->interactable);
+    RL_FREE(store->lod);
+    RL_FREE(store->slot);
+    RL_FREE(store->dense);
+    RL_FREE(store->generation);
+    RL_FREE(store->freeSlots);
+
+    memset(store, 0, sizeof(EntityStore));
+}
+
+// Register a model in the store model table, returns model index (-1 if table is full)
+int AddEntityModel(EntityStore *store, Model model)
+{
+    if (store->modelCount >= MAX_ENTITY_MODELS) return -1;
+
+    store->models[store->modelCount] = model;
+    store->modelBounds[store->modelCount] = GetModelBoundingBox(model);
+
+    return store->modelCount++;
+}
+
+// Attach LOD chain to a registered model, chain must outlive the store
+void SetEntityModelLod(EntityStore *store, int model, const ModelLod *lod)
+{
+    if ((model < 0) || (model >= store->modelCount)) return;
+
+    store->modelLods[model] = lod;
+}
+
+// Check if entity handle still references an alive entity
+bool IsEntityValid(const EntityStore *store, EntityHandle entity)
+{
+    unsigned int index = entity.id & ENTITY_INDEX_MASK;
+    unsigned int generation = entity.id >> ENTITY_INDEX_BITS;
+
+    return ((generation != 0) && (index < (unsigned int)store->capacity) && (store->generation[index] == generation));
+}
+
+// Get entity dense index, used to access components directly (-1 if handle is stale)
+// WARNING: Dense index is only stable until the next DestroyEntity() call
+int GetEntityIndex(const EntityStore *store, EntityHandle entity)
+{
+    if (!IsEntityValid(store, entity)) return -1;
+
+    return (int)store->dense[entity.id & ENTITY_INDEX_MASK];
+}
+
+// Create entity, returns ENTITY_NONE if store is full or model is not a store model index
+EntityHandle CreateEntity(EntityStore *store, int model, Vector3 position, Vector3 scale, bool interactable)
+{
+    if ((model < 0) || (model >= store->modelCount)) return ENTITY_NONE;
+    if (store->freeCount == 0) return ENTITY_NONE;
+
+    unsigned int index = store->freeSlots[--store->freeCount];
+    int i = store->count++;
+
+    store->position[i] = position;
+    store->scale[i] = scale;
+    store->model[i] = model;
+    store->interactable[i] = interactable;
+    store->lod[i] = 0;
+    store->slot[i] = index;
+    store->dense[index] = i;
+
+    // Compute bounds once, static props don't need a bounds update every frame
+    BoundingBox local = store->modelBounds[model];
+    store->bounds[i].min = Vector3Add(Vector3Multiply(local.min, scale), position);
+    store->bounds[i].max = Vector3Add(Vector3Multiply(local.max, scale), position);
+
+    return (EntityHandle){ index | (store->generation[index] << ENTITY_INDEX_BITS) };
+}
+
+// Destroy entity, last dense entity is moved into the freed place
+void DestroyEntity(EntityStore *store, EntityHandle entity)
+{
+    if (!IsEntityValid(store, entity)) return;
+
+    unsigned int index = entity.id & ENTITY_INDEX_MASK;
+    int i = store->dense[index];
+    int last = --store->count;
+
+    if (i != last)
+    {
+        store->position[i] = store->position[last];
+        store->scale[i] = store->scale[last];
+        store->bounds[i] = store->bounds[last];
+        store->model[i] = store->model[last];
+        store->interactable[i] = store->interactable[last];
+        store->lod[i] = store->lod[last];
+        store->slot[i] = store->slot[last];
+        store->dense[store->slot[i]] = i;
+    }
+
+    // Bump generation so stale handles fail validation, skip 0 on wrap-around
+    store->generation[index] = (store->generation[index] + 1) & ENTITY_GENERATION_MASK;
+    if (store->generation[index] == 0) store->generation[index] = 1;
+
+    store->freeSlots[store->freeCount++] = index;
+}
+
+// Recompute world bounds of all entities from model bounds, position and scale
+// NOTE: Bounds are set at creation, only call this after moving or scaling entities
+void UpdateEntityBounds(EntityStore *store)
+{
+    for (int i = 0; i < store->count; i++)
+    {
+        BoundingBox local = store->modelBounds[store->model[i]];
+
+        store->bounds[i].min = Vector3Add(Vector3Multiply(local.min, store->scale[i]), store->position[i]);
+        store->bounds[i].max = Vector3Add(Vector3Multiply(local.max, store->scale[i]), store->position[i]);
+    }
+}
+
+// Select LOD level of all entities with a LOD chain from their projected screen size
+void UpdateEntityLods(EntityStore *store, Camera camera)
+{
+    for (int i = 0; i < store->count; i++)
+    {
+        const ModelLod *lod = store->modelLods[store->model[i]];
+
+        if (lod == NULL) continue;
+
+        float screenSize = GetModelLodScreenSize(lod, store->position[i], fmaxf(store->scale[i].x, fmaxf(store->scale[i].y, store->scale[i].z)), camera);
+        store->lod[i] = (unsigned char)SelectModelLod(lod, screenSize, store->lod[i]);
+    }
+}
+
+// Submit all entities to a render queue, at their current LOD
+// NOTE: occlusion can be NULL, entities behind its occluders are skipped
+void SubmitEntities(const EntityStore *store, RenderQueue *queue, OcclusionCuller *occlusion)
+{
+    for (int i = 0; i < store->count; i++)
+    {
+        if (!CheckOcclusionBox(occlusion, store->bounds[i])) continue;
+
+        const ModelLod *lod = store->modelLods[store->model[i]];
+        Model model = (lod != NULL)? lod->levels[store->lod[i]] : store->models[store->model[i]];
+
+        SubmitRenderModel(queue, RENDER_PASS_OPAQUE, model, store->position[i], store->scale[i]);
+    }
+}
+
+// Get closest interactable entity hit by ray, returns ENTITY_NONE if nothing is hit
+EntityHandle GetEntityRayHit(const EntityStore *store, Ray ray, RayCollision *collision)
+{
+    EntityHandle result = ENTITY_NONE;
+    RayCollision closest = { 0 };
+    closest.distance = 3.402823466e+38f;
+
+    for (int i = 0; i < store->count; i++)
+    {
+        if (!store->interactable[i]) continue;
+
+        RayCollision hit = GetRayCollisionBox(ray, store->bounds[i]);
+
+        if (hit.hit && (hit.distance < closest.distance))
+        {
+            closest = hit;
+            result = (EntityHandle){ store->slot[i] | (store->generation[store->slot[i]] << ENTITY_INDEX_BITS) };
+        }
+    }
+
+    if (collision != NULL) *collision = closest;
+
+    return result;
+}
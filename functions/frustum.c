@@ -0,0 +1,83 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: MatrixLookAt(), MatrixPerspective(), MatrixMultiply()
+
+#include <math.h>           // Required for: sqrtf()
+
+// Camera frustum planes, used to cull terrain nodes, map regions and props on CPU
+// NOTE: Near/far planes match rlgl defaults used by BeginMode3D()
+
+#define FRUSTUM_NEAR        0.01
+#define FRUSTUM_FAR         1000.0
+
+typedef struct Frustum {
+    Vector4 planes[6];      // Left, right, bottom, top, near, far (xyz: normal pointing inside, w: distance)
+} Frustum;
+
+// Get camera view-projection matrix (same matrices BeginMode3D() uses for a perspective camera)
+Matrix GetCameraViewProjection(Camera camera, float aspect)
+{
+    Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+    Matrix projection = MatrixPerspective(camera.fovy*DEG2RAD, aspect, FRUSTUM_NEAR, FRUSTUM_FAR);
+
+    return MatrixMultiply(view, projection);
+}
+
+// Extract normalized frustum planes from a view-projection matrix
+Frustum GetFrustumFromMatrix(Matrix m)
+{
+    Frustum frustum = { 0 };
+
+    frustum.planes[0] = (Vector4){ m.m3 + m.m0, m.m7 + m.m4, m.m11 + m.m8, m.m15 + m.m12 };
+    frustum.planes[1] = (Vector4){ m.m3 - m.m0, m.m7 - m.m4, m.m11 - m.m8, m.m15 - m.m12 };
+    frustum.planes[2] = (Vector4){ m.m3 + m.m1, m.m7 + m.m5, m.m11 + m.m9, m.m15 + m.m13 };
+    frustum.planes[3] = (Vector4){ m.m3 - m.m1, m.m7 - m.m5, m.m11 - m.m9, m.m15 - m.m13 };
+    frustum.planes[4] = (Vector4){ m.m3 + m.m2, m.m7 + m.m6, m.m11 + m.m10, m.m15 + m.m14 };
+    frustum.planes[5] = (Vector4){ m.m3 - m.m2, m.m7 - m.m6, m.m11 - m.m10, m.m15 - m.m14 };
+
+    for (int i = 0; i < 6; i++)
+    {
+        Vector4 p = frustum.planes[i];
+        float length = sqrtf(p.x*p.x + p.y*p.y + p.z*p.z);
+
+        if (length > 0.0f) frustum.planes[i] = (Vector4){ p.x/length, p.y/length, p.z/length, p.w/length };
+    }
+
+    return frustum;
+}
+
+// Get camera frustum for a screen aspect ratio
+Frustum GetCameraFrustum(Camera camera, float aspect)
+{
+    return GetFrustumFromMatrix(GetCameraViewProjection(camera, aspect));
+}
+
+// Check if a bounding box is (at least partially) inside the frustum
+bool CheckFrustumBox(const Frustum *frustum, BoundingBox box)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        Vector4 p = frustum->planes[i];
+
+        // Test box corner furthest along plane normal
+        float x = (p.x >= 0.0f)? box.max.x : box.min.x;
+        float y = (p.y >= 0.0f)? box.max.y : box.min.y;
+        float z = (p.z >= 0.0f)? box.max.z : box.min.z;
+
+        if (p.x*x + p.y*y + p.z*z + p.w < 0.0f) return false;
+    }
+
+    return true;
+}
+
+// Check if a sphere is (at least partially) inside the frustum
+bool CheckFrustumSphere(const Frustum *frustum, Vector3 center, float radius)
+{
+    for (int i = 0; i < 6; i++)
+    {
+        Vector4 p = frustum->planes[i];
+
+        if (p.x*center.x + p.y*center.y + p.z*center.z + p.w < -radius) return false;
+    }
+
+    return true;
+}
@@ -0,0 +1,220 @@
+#include "raylib.h"         // Declares module functions
+
+#include <stdio.h>          // Required for: snprintf()
+#include <string.h>         // Required for: strchr(), strcmp(), strcpy(), strncpy(), memset()
+
+// HUD: retained text widgets composed into a render texture
+// NOTE: Widgets keep their laid out text, a bound value is formatted and measured again only when
+// it changes, and the render texture is redrawn only when a widget changed. In steady state the HUD
+// is one textured quad per frame, no formatting, measuring or glyph drawing.
+// Widgets are anchored to a screen fraction plus a pixel offset, a window resize lays them out again.
+
+#define MAX_HUD_WIDGETS         32
+#define MAX_HUD_TEXT            128
+#define MAX_HUD_VALUES          3
+
+typedef enum HudAlign {
+    HUD_ALIGN_LEFT = 0,
+    HUD_ALIGN_CENTER,
+    HUD_ALIGN_RIGHT
+} HudAlign;
+
+typedef struct HudWidget {
+    char text[MAX_HUD_TEXT];    // Laid out text
+    const char *format;         // Bound value format, NULL for static text
+    float values[MAX_HUD_VALUES];   // Last bound values
+    bool bound;                 // Values were set at least once
+
+    Vector2 anchor;             // Screen fraction [0..1]
+    Vector2 offset;             // Pixels from the anchor
+    int align;
+    int fontSize;
+    Color color;
+    bool visible;
+
+    int width;                  // Measured text width, cached with the text
+    Vector2 position;           // Laid out top left corner
+} HudWidget;
+
+typedef struct Hud {
+    RenderTexture2D target;
+    int width;
+    int height;
+
+    HudWidget widgets[MAX_HUD_WIDGETS];
+    int count;
+    bool dirty;                 // Render texture must be redrawn
+
+    int layouts;                // Widget layouts done (counters for profiling)
+    int redraws;                // Render texture redraws
+} Hud;
+
+// Load HUD with a screen sized render texture
+Hud LoadHud(int width, int height)
+{
+    Hud hud = { 0 };
+
+    hud.target = LoadRenderTexture(width, height);
+    hud.width = width;
+    hud.height = height;
+    hud.dirty = true;
+
+    return hud;
+}
+
+// Unload HUD render texture
+void UnloadHud(Hud *hud)
+{
+    UnloadRenderTexture(hud->target);
+
+    memset(hud, 0, sizeof(Hud));
+}
+
+// Measure widget text and place it relative to its anchor
+static void LayoutHudWidget(Hud *hud, HudWidget *widget)
+{
+    widget->width = MeasureText(widget->text, widget->fontSize);
+    widget->position.x = widget->anchor.x*hud->width + widget->offset.x;
+    widget->position.y = widget->anchor.y*hud->height + widget->offset.y;
+
+    if (widget->align == HUD_ALIGN_CENTER) widget->position.x -= widget->width/2;
+    else if (widget->align == HUD_ALIGN_RIGHT) widget->position.x -= widget->width;
+
+    hud->layouts++;
+    if (widget->visible) hud->dirty = true;
+}
+
+// Add text widget, returns widget index (-1 if the HUD is full)
+// NOTE: format is kept by pointer and used by SetHudValues(), text with no bound values is laid out once
+int AddHudText(Hud *hud, const char *format, Vector2 anchor, Vector2 offset, int align, int fontSize, Color color)
+{
+    if (hud->count == MAX_HUD_WIDGETS) return -1;
+
+    int index = hud->count++;
+    HudWidget *widget = &hud->widgets[index];
+
+    memset(widget, 0, sizeof(HudWidget));
+    widget->anchor = anchor;
+    widget->offset = offset;
+    widget->align = align;
+    widget->fontSize = fontSize;
+    widget->color = color;
+    widget->visible = true;
+
+    if (strchr(format, '%') != NULL) widget->format = format;
+    else strncpy(widget->text, format, MAX_HUD_TEXT - 1);
+
+    LayoutHudWidget(hud, widget);
+
+    return index;
+}
+
+// Format bound values, each conversion gets the next value as its own type (int for %i/%d/%x/%c, double otherwise)
+// NOTE: Conversions are formatted one at a time, formats can mix integer and float conversions
+static void FormatHudText(char *text, const char *format, const float *values)
+{
+    int length = 0;
+    int value = 0;
+
+    text[0] = '\0';
+    while ((*format != '\0') && (length < MAX_HUD_TEXT - 1))
+    {
+        if ((format[0] != '%') || (format[1] == '%'))
+        {
+            text[length++] = *format;
+            format += (format[0] == '%')? 2 : 1;
+            continue;
+        }
+
+        // Copy one conversion specification: flags, width and precision up to the conversion character
+        char spec[16] = { 0 };
+        int specLength = 0;
+        spec[specLength++] = *format++;
+        while ((*format != '\0') && (strchr("-+ #.0123456789", *format) != NULL) && (specLength < 14)) spec[specLength++] = *format++;
+        if (*format == '\0') break;
+        spec[specLength] = *format++;
+
+        float v = (value < MAX_HUD_VALUES)? values[value] : 0.0f;
+        value++;
+
+        int written = 0;
+        if (strchr("idxXuc", spec[specLength]) != NULL) written = snprintf(text + length, MAX_HUD_TEXT - length, spec, (int)v);
+        else written = snprintf(text + length, MAX_HUD_TEXT - length, spec, (double)v);
+
+        if (written > 0) length += written;
+        if (length > MAX_HUD_TEXT - 1) length = MAX_HUD_TEXT - 1;
+    }
+
+    text[length] = '\0';
+}
+
+// Set bound values of a widget, text is formatted and laid out again only if a value changed
+// NOTE: Values are passed as floats, each conversion takes the next value and integer conversions get it cast to int
+void SetHudValues(Hud *hud, int index, float a, float b, float c)
+{
+    HudWidget *widget = &hud->widgets[index];
+
+    if (widget->format == NULL) return;
+    if (widget->bound && (widget->values[0] == a) && (widget->values[1] == b) && (widget->values[2] == c)) return;
+
+    widget->values[0] = a;
+    widget->values[1] = b;
+    widget->values[2] = c;
+    widget->bound = true;
+
+    char text[MAX_HUD_TEXT];
+    FormatHudText(text, widget->format, widget->values);
+
+    // Values changed but the visible text did not (i.e. below format precision)
+    if (strcmp(text, widget->text) == 0) return;
+
+    strcpy(widget->text, text);
+    LayoutHudWidget(hud, widget);
+}
+
+// Show or hide a widget
+void SetHudVisible(Hud *hud, int index, bool visible)
+{
+    if (hud->widgets[index].visible == visible) return;
+
+    hud->widgets[index].visible = visible;
+    hud->dirty = true;
+}
+
+// Update HUD: resize to the screen if needed, redraw the render texture if a widget changed
+// NOTE: Call before BeginDrawing(), texture mode flushes the current batch
+void UpdateHud(Hud *hud, int width, int height)
+{
+    if ((width != hud->width) || (height != hud->height))
+    {
+        UnloadRenderTexture(hud->target);
+        hud->target = LoadRenderTexture(width, height);
+        hud->width = width;
+        hud->height = height;
+
+        for (int i = 0; i < hud->count; i++) LayoutHudWidget(hud, &hud->widgets[i]);
+        hud->dirty = true;
+    }
+
+    if (!hud->dirty) return;
+
+    BeginTextureMode(hud->target);
+        ClearBackground(BLANK);
+
+        for (int i = 0; i < hud->count; i++)
+        {
+            const HudWidget *widget = &hud->widgets[i];
+            if (widget->visible && (widget->text[0] != '\0')) DrawText(widget->text, (int)widget->position.x, (int)widget->position.y, widget->fontSize, widget->color);
+        }
+    EndTextureMode();
+
+    hud->dirty = false;
+    hud->redraws++;
+}
+
+// Draw HUD: one screen sized quad
+void DrawHud(const Hud *hud)
+{
+    // Render textures are stored bottom up, flip vertically
+    DrawTextureRec(hud->target.texture, (Rectangle){ 0.0f, 0.0f, (float)hud->width, -(float)hud->height }, (Vector2){ 0.0f, 0.0f }, WHITE);
+}
@@ -0,0 +1,289 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: malloc(), free()
+#include <string.h>         // Required for: memcpy()
+#include <math.h>           // Required for: floorf(), ceilf(), sqrtf(), sinf(), cosf(), fminf(), fmaxf()
+#include <pthread.h>        // Required for: pthread_create(), pthread_join()
+
+// Baked map lighting: per-vertex ambient occlusion and directional light, raymarched through cubicmap cells
+// NOTE: Result is written to mesh.colors as gray RGBA and packed to 8 bits by compact meshes, every vertex
+// is computed independently with fixed ray directions, so output does not depend on thread count
+
+#define BAKE_MAX_AO_RAYS        64
+#define BAKE_MAX_THREADS        16
+#define BAKE_CACHE_VERSION      1
+
+typedef struct CubicmapBakeSettings {
+    int aoRays;                 // Hemisphere rays per vertex
+    float aoDistance;           // Max occluder distance, in cubes
+    Vector3 lightDirection;     // Direction light travels (sun)
+    float lightIntensity;       // Direct light contribution
+    float lightDistance;        // Max shadow ray distance, in cubes
+    float ambient;              // Ambient light contribution, scaled by occlusion
+    int threads;                // Worker threads (1 bakes on calling thread)
+} CubicmapBakeSettings;
+
+typedef struct BakeJob {
+    const CubicmapGrid *grid;
+    const CubicmapBakeSettings *settings;
+    const Vector3 *directions;  // Cosine weighted hemisphere around +Y
+    Mesh *mesh;
+    int first;
+    int count;
+} BakeJob;
+
+// Get default bake settings
+CubicmapBakeSettings GetCubicmapBakeDefaults(void)
+{
+    CubicmapBakeSettings settings = { 0 };
+
+    settings.aoRays = 24;
+    settings.aoDistance = 1.5f;
+    settings.lightDirection = Vector3Normalize((Vector3){ 0.4f, -1.0f, 0.25f });
+    settings.lightIntensity = 0.45f;
+    settings.lightDistance = 32.0f;
+    settings.ambient = 0.7f;
+    settings.threads = 4;
+
+    return settings;
+}
+
+// Check if a mesh space point is inside cubicmap solid space (below 0 is solid, above cube height is open)
+static bool IsCubicmapPointSolid(const CubicmapGrid *grid, Vector3 point)
+{
+    if (point.y < 0.0f) return true;
+    if (point.y > grid->cubeSize.y) return false;
+
+    int floor, ceiling;
+    GetCubicmapGridCell(grid, (int)floorf(point.x/grid->cubeSize.x + 0.5f), (int)floorf(point.z/grid->cubeSize.z + 0.5f), &floor, &ceiling);
+
+    float height = point.y*255.0f/grid->cubeSize.y;
+
+    return ((height < (float)floor) || (height > (float)ceiling));
+}
+
+// March ray through cubicmap cells with fixed steps, returns true if blocked before maxDistance
+static bool IsCubicmapRayBlocked(const CubicmapGrid *grid, Vector3 origin, Vector3 direction, float maxDistance)
+{
+    float step = 0.2f*fminf(grid->cubeSize.x, grid->cubeSize.z);
+
+    for (float t = step*0.5f; t < maxDistance; t += step)
+    {
+        Vector3 p = { origin.x + direction.x*t, origin.y + direction.y*t, origin.z + direction.z*t };
+
+        if (p.y > grid->cubeSize.y) return false;   // Left the map through the top
+        if (IsCubicmapPointSolid(grid, p)) return true;
+    }
+
+    return false;
+}
+
+// Rotate a direction of the +Y hemisphere into the hemisphere of an axis aligned normal
+static Vector3 GetBakeHemisphereDirection(Vector3 dir, Vector3 normal)
+{
+    if (normal.y > 0.5f) return dir;
+    if (normal.y < -0.5f) return (Vector3){ dir.x, -dir.y, -dir.z };
+    if (normal.x > 0.5f) return (Vector3){ dir.y, dir.z, dir.x };
+    if (normal.x < -0.5f) return (Vector3){ -dir.y, dir.z, -dir.x };
+    if (normal.z > 0.5f) return (Vector3){ dir.x, dir.z, dir.y };
+    return (Vector3){ -dir.x, dir.z, -dir.y };
+}
+
+// Bake a range of vertices
+static void *BakeCubicmapVertices(void *data)
+{
+    BakeJob *job = (BakeJob *)data;
+    const CubicmapBakeSettings *settings = job->settings;
+    const CubicmapGrid *grid = job->grid;
+    Mesh *mesh = job->mesh;
+
+    float cube = fminf(grid->cubeSize.x, grid->cubeSize.z);
+    Vector3 toLight = Vector3Negate(settings->lightDirection);
+
+    for (int v = job->first; v < job->first + job->count; v++)
+    {
+        Vector3 normal = { mesh->normals[v*3], mesh->normals[v*3 + 1], mesh->normals[v*3 + 2] };
+        Vector3 position = { mesh->vertices[v*3], mesh->vertices[v*3 + 1], mesh->vertices[v*3 + 2] };
+
+        // Start slightly off the surface to skip the face itself
+        Vector3 origin = Vector3Add(position, Vector3Scale(normal, 0.001f*cube));
+
+        int open = 0;
+        for (int r = 0; r < settings->aoRays; r++)
+        {
+            Vector3 dir = GetBakeHemisphereDirection(job->directions[r], normal);
+            if (!IsCubicmapRayBlocked(grid, origin, dir, settings->aoDistance*cube)) open++;
+        }
+
+        float occlusion = (settings->aoRays > 0)? (float)open/settings->aoRays : 1.0f;
+        float diffuse = Vector3DotProduct(normal, toLight);
+
+        float light = settings->ambient*occlusion;
+        if ((diffuse > 0.0f) && !IsCubicmapRayBlocked(grid, origin, toLight, settings->lightDistance*cube)) light += settings->lightIntensity*diffuse;
+
+        unsigned char value = (unsigned char)(Clamp(light, 0.0f, 1.0f)*255.0f + 0.5f);
+
+        mesh->colors[v*4] = value;
+        mesh->colors[v*4 + 1] = value;
+        mesh->colors[v*4 + 2] = value;
+        mesh->colors[v*4 + 3] = 255;
+    }
+
+    return NULL;
+}
+
+// Bake ambient occlusion and directional light of cubicmap mesh vertices into mesh.colors
+// NOTE: Mesh must be generated from the same grid and still have CPU data, colors are allocated if missing
+void BakeCubicmapLighting(const CubicmapGrid *grid, Mesh *mesh, CubicmapBakeSettings settings)
+{
+    if ((mesh->vertices == NULL) || (mesh->normals == NULL) || (mesh->vertexCount == 0)) return;
+
+    if (settings.aoRays > BAKE_MAX_AO_RAYS) settings.aoRays = BAKE_MAX_AO_RAYS;
+    if (settings.threads < 1) settings.threads = 1;
+    if (settings.threads > BAKE_MAX_THREADS) settings.threads = BAKE_MAX_THREADS;
+    settings.lightDirection = Vector3Normalize(settings.lightDirection);
+
+    if (mesh->colors == NULL) mesh->colors = (unsigned char *)RL_MALLOC((size_t)mesh->vertexCount*4);
+
+    // Cosine weighted hemisphere directions: Fibonacci spiral on the unit disk projected up
+    Vector3 directions[BAKE_MAX_AO_RAYS] = { 0 };
+    for (int r = 0; r < settings.aoRays; r++)
+    {
+        float radius = sqrtf(((float)r + 0.5f)/settings.aoRays);
+        float angle = (float)r*2.39996323f;
+
+        directions[r] = (Vector3){ radius*cosf(angle), sqrtf(fmaxf(0.0f, 1.0f - radius*radius)), radius*sinf(angle) };
+    }
+
+    BakeJob jobs[BAKE_MAX_THREADS] = { 0 };
+    pthread_t threads[BAKE_MAX_THREADS] = { 0 };
+    int perThread = (mesh->vertexCount + settings.threads - 1)/settings.threads;
+    int jobCount = 0;
+
+    for (int first = 0; first < mesh->vertexCount; first += perThread)
+    {
+        jobs[jobCount] = (BakeJob){ grid, &settings, directions, mesh, first, (first + perThread <= mesh->vertexCount)? perThread : mesh->vertexCount - first };
+        jobCount++;
+    }
+
+    if (jobCount == 1) BakeCubicmapVertices(&jobs[0]);
+    else
+    {
+        for (int i = 0; i < jobCount; i++) pthread_create(&threads[i], NULL, BakeCubicmapVertices, &jobs[i]);
+        for (int i = 0; i < jobCount; i++) pthread_join(threads[i], NULL);
+    }
+}
+
+// Get bake cache key of the mesh of a grid region from cells and settings (FNV-1a), changes whenever baked result would change
+// NOTE: Only cells within ray reach of the region are hashed, edits further away keep the key
+unsigned int GetCubicmapBakeRegionKey(const CubicmapGrid *grid, CubicmapBakeSettings settings, int x, int z, int width, int height)
+{
+    unsigned int hash = 2166136261u;
+
+    #define BAKE_HASH_BYTES(ptr, size) for (size_t i = 0; i < (size); i++) { hash ^= ((const unsigned char *)(ptr))[i]; hash *= 16777619u; }
+
+    BAKE_HASH_BYTES(&grid->width, sizeof(int));
+    BAKE_HASH_BYTES(&grid->height, sizeof(int));
+    BAKE_HASH_BYTES(&grid->cubeSize, sizeof(Vector3));
+    BAKE_HASH_BYTES(&x, sizeof(int));
+    BAKE_HASH_BYTES(&z, sizeof(int));
+    BAKE_HASH_BYTES(&width, sizeof(int));
+    BAKE_HASH_BYTES(&height, sizeof(int));
+
+    // Rays are at most max distance cubes long, starting on region cell edges
+    int margin = (int)ceilf(fmaxf(settings.aoDistance, settings.lightDistance)) + 1;
+    int x0 = (x - margin > 0)? x - margin : 0;
+    int z0 = (z - margin > 0)? z - margin : 0;
+    int x1 = (x + width + margin < grid->width)? x + width + margin : grid->width;
+    int z1 = (z + height + margin < grid->height)? z + height + margin : grid->height;
+
+    for (int row = z0; row < z1; row++)
+    {
+        BAKE_HASH_BYTES(&grid->floor[row*grid->width + x0], (size_t)(x1 - x0));
+        BAKE_HASH_BYTES(&grid->ceiling[row*grid->width + x0], (size_t)(x1 - x0));
+    }
+
+    // Thread count is left out, it does not change results
+    BAKE_HASH_BYTES(&settings.aoRays, sizeof(int));
+    BAKE_HASH_BYTES(&settings.aoDistance, sizeof(float));
+    BAKE_HASH_BYTES(&settings.lightDirection, sizeof(Vector3));
+    BAKE_HASH_BYTES(&settings.lightIntensity, sizeof(float));
+    BAKE_HASH_BYTES(&settings.lightDistance, sizeof(float));
+    BAKE_HASH_BYTES(&settings.ambient, sizeof(float));
+
+    #undef BAKE_HASH_BYTES
+
+    return hash;
+}
+
+// Get bake cache key of the whole grid mesh
+unsigned int GetCubicmapBakeKey(const CubicmapGrid *grid, CubicmapBakeSettings settings)
+{
+    return GetCubicmapBakeRegionKey(grid, settings, 0, 0, grid->width, grid->height);
+}
+
+// Save baked vertex light to a cache file: header (version, key, vertex count) and one byte per vertex
+bool SaveCubicmapBake(const char *fileName, const Mesh *mesh, unsigned int key)
+{
+    if (mesh->colors == NULL) return false;
+
+    int dataSize = 3*sizeof(unsigned int) + mesh->vertexCount;
+    unsigned char *data = (unsigned char *)RL_MALLOC(dataSize);
+    unsigned int header[3] = { BAKE_CACHE_VERSION, key, (unsigned int)mesh->vertexCount };
+
+    memcpy(data, header, sizeof(header));
+    for (int v = 0; v < mesh->vertexCount; v++) data[sizeof(header) + v] = mesh->colors[v*4];
+
+    bool success = SaveFileData(fileName, data, dataSize);
+
+    RL_FREE(data);
+
+    return success;
+}
+
+// Load baked vertex light from a cache file into mesh.colors, fails if key or vertex count don't match
+bool LoadCubicmapBake(const char *fileName, Mesh *mesh, unsigned int key)
+{
+    if (!FileExists(fileName)) return false;
+
+    int dataSize = 0;
+    unsigned char *data = LoadFileData(fileName, &dataSize);
+    unsigned int header[3] = { 0 };
+    bool success = false;
+
+    if ((data != NULL) && (dataSize >= (int)sizeof(header))) memcpy(header, data, sizeof(header));
+
+    if ((header[0] == BAKE_CACHE_VERSION) && (header[1] == key) && (header[2] == (unsigned int)mesh->vertexCount) &&
+        (dataSize == (int)sizeof(header) + mesh->vertexCount))
+    {
+        if (mesh->colors == NULL) mesh->colors = (unsigned char *)RL_MALLOC((size_t)mesh->vertexCount*4);
+
+        for (int v = 0; v < mesh->vertexCount; v++)
+        {
+            unsigned char value = data[sizeof(header) + v];
+
+            mesh->colors[v*4] = value;
+            mesh->colors[v*4 + 1] = value;
+            mesh->colors[v*4 + 2] = value;
+            mesh->colors[v*4 + 3] = 255;
+        }
+
+        success = true;
+    }
+    else TRACELOG(LOG_INFO, "BAKE: [%s] Cache is out of date, map needs rebaking", fileName);
+
+    UnloadFileData(data);
+
+    return success;
+}
+
+// Load baked lighting from cache or bake and save it, key from GetCubicmapBakeKey() or GetCubicmapBakeRegionKey()
+void LoadOrBakeCubicmapLighting(const char *fileName, const CubicmapGrid *grid, Mesh *mesh, CubicmapBakeSettings settings, unsigned int key)
+{
+    if (LoadCubicmapBake(fileName, mesh, key)) return;
+
+    BakeCubicmapLighting(grid, mesh, settings);
+
+    if (SaveCubicmapBake(fileName, mesh, key)) TRACELOG(LOG_INFO, "BAKE: [%s] Baked lighting of %i vertices saved", fileName, mesh->vertexCount);
+}
@@ -0,0 +1,603 @@
+#include "raylib.h"         // Declares module functions
+#include "rlgl.h"           // Required for: rlLoadTexture(), rlUpdateTexture(), rlActiveTextureSlot()
+#include "raymath.h"        // Required for: MatrixLookAt(), Vector3Transform()
+
+#include <stdlib.h>         // Required for: rand(), srand()
+#include <string.h>         // Required for: memset(), memcpy()
+#include <math.h>           // Required for: tanf(), logf(), powf(), floorf(), fminf(), fmaxf(), sqrtf(), sinf(), cosf()
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // Required for: SSE2 sphere vs cluster test
+#endif
+
+// Clustered lighting: point lights are binned into a froxel grid (screen tiles x exponential depth
+// slices) on CPU every frame, the map shader reads only the lights listed for its fragment cluster
+// NOTE: Cluster bounds are view space boxes. A box extent on X only depends on the tile column and
+// the slice, on Y on the tile row and the slice, on depth on the slice: sphere distances are summed
+// per axis and 4 tile columns are tested per SSE2 step. Lights are only tested against the tiles
+// and slices covered by their bounds.
+// Results are compact: per cluster an offset and a count into one light index list. GPU data is in
+// float textures (GLSL 330 has no storage buffers), see shaders/compact_map.fs:
+//   lightData:    maxLights x 2, row 0 position + radius, row 1 color + intensity
+//   clusterData:  (tilesX*tilesY) x slices, index list offset + count
+//   lightIndices: LIGHT_INDEX_TEXTURE_WIDTH wide, one light index per texel
+
+#define MAX_LIGHTS_PER_CLUSTER      128         // Lights over this in one cluster are dropped (counted in stats)
+#define MAX_CLUSTER_LIGHT_INDICES   262144      // Index list size
+#define LIGHT_INDEX_TEXTURE_WIDTH   1024        // Must match compact_map.fs
+#define LIGHT_CLUSTER_NEAR          0.5f        // First slice boundary, closer fragments use slice 0
+#define LIGHT_CLUSTER_FAR           100.0f      // Fragments and lights beyond are not lit
+
+typedef struct PointLight {
+    Vector3 position;
+    float radius;               // Light has no effect past this distance
+    Vector3 color;              // Linear color [0..1]
+    float intensity;            // 0 disables the light
+} PointLight;
+
+typedef struct LightClusterStats {
+    int lights;                 // Enabled lights
+    int visibleLights;          // Lights touching at least one cluster
+    int indices;                // Index list entries
+    int maxClusterLights;       // Lights in the fullest cluster
+    int dropped;                // Cluster entries over capacity
+    float time;                 // Last binning time (seconds)
+} LightClusterStats;
+
+typedef struct LightClusters {
+    int tilesX;                 // Froxel grid size
+    int tilesY;
+    int slices;
+    int clusterCount;
+    int columnStride;           // tilesX rounded up to 4, SSE2 loads are never partial
+    float sliceScale;           // slices/log(far/near)
+
+    float fovy;                 // Projection cluster bounds were computed for
+    float aspect;
+    float *sliceDepth;          // Slice boundaries, slices + 1
+    float *columnMin;           // View space X extents per slice and tile column [slices][columnStride]
+    float *columnMax;
+    float *rowMin;              // View space Y extents per slice and tile row [slices][tilesY]
+    float *rowMax;
+
+    PointLight *lights;
+    int lightCount;
+    int capacity;
+
+    unsigned short *clusterLights;  // Per cluster light lists while binning [clusterCount][MAX_LIGHTS_PER_CLUSTER]
+    unsigned short *clusterCounts;
+    unsigned int *offsets;      // Compact result: per cluster index list offset and count
+    unsigned short *counts;
+    unsigned short *indices;
+
+    unsigned int lightTextureId;    // GPU data, created on first upload
+    unsigned int clusterTextureId;
+    unsigned int indexTextureId;
+    float *texels;              // Upload staging, big enough for the largest texture
+
+    LightClusterStats stats;
+} LightClusters;
+
+// Load light clusters for a froxel grid, lights can be added up to capacity
+// NOTE: Only CPU data is allocated here, GPU textures are created by the first UploadLightClusters()
+LightClusters LoadLightClusters(int tilesX, int tilesY, int slices, int capacity)
+{
+    LightClusters clusters = { 0 };
+
+    clusters.tilesX = tilesX;
+    clusters.tilesY = tilesY;
+    clusters.slices = slices;
+    clusters.clusterCount = tilesX*tilesY*slices;
+    clusters.columnStride = (tilesX + 3) & ~3;
+    clusters.sliceScale = slices/logf(LIGHT_CLUSTER_FAR/LIGHT_CLUSTER_NEAR);
+    clusters.capacity = capacity;
+
+    clusters.sliceDepth = (float *)RL_MALLOC((slices + 1)*sizeof(float));
+    clusters.columnMin = (float *)RL_MALLOC(slices*clusters.columnStride*sizeof(float));
+    clusters.columnMax = (float *)RL_MALLOC(slices*clusters.columnStride*sizeof(float));
+    clusters.rowMin = (float *)RL_MALLOC(slices*tilesY*sizeof(float));
+    clusters.rowMax = (float *)RL_MALLOC(slices*tilesY*sizeof(float));
+
+    clusters.lights = (PointLight *)RL_CALLOC(capacity, sizeof(PointLight));
+    clusters.clusterLights = (unsigned short *)RL_MALLOC(clusters.clusterCount*MAX_LIGHTS_PER_CLUSTER*sizeof(unsigned short));
+    clusters.clusterCounts = (unsigned short *)RL_CALLOC(clusters.clusterCount, sizeof(unsigned short));
+    clusters.offsets = (unsigned int *)RL_CALLOC(clusters.clusterCount, sizeof(unsigned int));
+    clusters.counts = (unsigned short *)RL_CALLOC(clusters.clusterCount, sizeof(unsigned short));
+    clusters.indices = (unsigned short *)RL_MALLOC(MAX_CLUSTER_LIGHT_INDICES*sizeof(unsigned short));
+
+    int texels = capacity*2*4;
+    if (clusters.clusterCount*3 > texels) texels = clusters.clusterCount*3;
+    if (MAX_CLUSTER_LIGHT_INDICES > texels) texels = MAX_CLUSTER_LIGHT_INDICES;
+    clusters.texels = (float *)RL_MALLOC(texels*sizeof(float));
+
+    // Slice 0 starts at the camera near plane, the next boundaries are exponential from LIGHT_CLUSTER_NEAR
+    clusters.sliceDepth[0] = FRUSTUM_NEAR;
+    for (int k = 1; k <= slices; k++) clusters.sliceDepth[k] = LIGHT_CLUSTER_NEAR*powf(LIGHT_CLUSTER_FAR/LIGHT_CLUSTER_NEAR, (float)k/slices);
+
+    return clusters;
+}
+
+// Unload light clusters CPU and GPU data
+void UnloadLightClusters(LightClusters *clusters)
+{
+    if (clusters->lightTextureId != 0) rlUnloadTexture(clusters->lightTextureId);
+    if (clusters->clusterTextureId != 0) rlUnloadTexture(clusters->clusterTextureId);
+    if (clusters->indexTextureId != 0) rlUnloadTexture(clusters->indexTextureId);
+
+    RL_FREE(clusters->sliceDepth);
+    RL_FREE(clusters->columnMin);
+    RL_FREE(clusters->columnMax);
+    RL_FREE(clusters->rowMin);
+    RL_FREE(clusters->rowMax);
+    RL_FREE(clusters->lights);
+    RL_FREE(clusters->clusterLights);
+    RL_FREE(clusters->clusterCounts);
+    RL_FREE(clusters->offsets);
+    RL_FREE(clusters->counts);
+    RL_FREE(clusters->indices);
+    RL_FREE(clusters->texels);
+
+    memset(clusters, 0, sizeof(LightClusters));
+}
+
+// Add point light, returns light index (-1 if full)
+int AddPointLight(LightClusters *clusters, Vector3 position, float radius, Color color, float intensity)
+{
+    if (clusters->lightCount == clusters->capacity) return -1;
+
+    int index = clusters->lightCount++;
+    clusters->lights[index] = (PointLight){ position, radius, (Vector3){ color.r/255.0f, color.g/255.0f, color.b/255.0f }, intensity };
+
+    return index;
+}
+
+// Compute cluster view space extents for a projection, only when it changed
+static void SetLightClustersProjection(LightClusters *clusters, float fovy, float aspect)
+{
+    if ((clusters->fovy == fovy) && (clusters->aspect == aspect)) return;
+
+    clusters->fovy = fovy;
+    clusters->aspect = aspect;
+
+    float ty = tanf(fovy*0.5f*DEG2RAD);
+    float tx = ty*aspect;
+
+    // View space extent of [ndc0, ndc1] over depths [d0, d1] is spanned by the corners
+    for (int k = 0; k < clusters->slices; k++)
+    {
+        float d0 = clusters->sliceDepth[k];
+        float d1 = clusters->sliceDepth[k + 1];
+
+        for (int i = 0; i < clusters->columnStride; i++)
+        {
+            float n0 = -1.0f + 2.0f*i/clusters->tilesX;
+            float n1 = -1.0f + 2.0f*(i + 1)/clusters->tilesX;
+
+            // Padding columns are never hit
+            if (i >= clusters->tilesX) n0 = n1 = 1e30f;
+
+            clusters->columnMin[k*clusters->columnStride + i] = tx*fminf(n0*d0, n0*d1);
+            clusters->columnMax[k*clusters->columnStride + i] = tx*fmaxf(n1*d0, n1*d1);
+        }
+
+        for (int j = 0; j < clusters->tilesY; j++)
+        {
+            float n0 = -1.0f + 2.0f*j/clusters->tilesY;
+            float n1 = -1.0f + 2.0f*(j + 1)/clusters->tilesY;
+
+            clusters->rowMin[k*clusters->tilesY + j] = ty*fminf(n0*d0, n0*d1);
+            clusters->rowMax[k*clusters->tilesY + j] = ty*fmaxf(n1*d0, n1*d1);
+        }
+    }
+}
+
+// Get slice containing a view depth, clamped to the grid
+static int GetLightClusterSlice(const LightClusters *clusters, float depth)
+{
+    int slice = (depth > LIGHT_CLUSTER_NEAR)? (int)floorf(logf(depth/LIGHT_CLUSTER_NEAR)*clusters->sliceScale) : 0;
+
+    return (slice < clusters->slices)? slice : clusters->slices - 1;
+}
+
+// Get tile range covered by view space interval [v0, v1] over depths [d0, d1], false if off screen
+static bool GetLightClusterTiles(float v0, float v1, float d0, float d1, float tangent, int tiles, int *first, int *last)
+{
+    float n0 = fminf(v0/d0, v0/d1)/tangent;
+    float n1 = fmaxf(v1/d0, v1/d1)/tangent;
+
+    if ((n0 > 1.0f) || (n1 < -1.0f)) return false;
+
+    *first = (int)floorf((n0*0.5f + 0.5f)*tiles);
+    *last = (int)floorf((n1*0.5f + 0.5f)*tiles);
+    if (*first < 0) *first = 0;
+    if (*last > tiles - 1) *last = tiles - 1;
+
+    return true;
+}
+
+// Distance from a value to an interval
+static inline float GetIntervalDistance(float value, float min, float max)
+{
+    return (value < min)? min - value : (value > max)? value - max : 0.0f;
+}
+
+// Bin lights into clusters for a camera view, CPU only
+// NOTE: Lists are compact afterwards: cluster c lights are indices[offsets[c]..offsets[c] + counts[c]]
+void BinLightClusters(LightClusters *clusters, Matrix view, float fovy, float aspect)
+{
+    double start = GetTimerSeconds();
+
+    SetLightClustersProjection(clusters, fovy, aspect);
+    memset(clusters->clusterCounts, 0, clusters->clusterCount*sizeof(unsigned short));
+    clusters->stats = (LightClusterStats){ 0 };
+
+    float ty = tanf(fovy*0.5f*DEG2RAD);
+    float tx = ty*aspect;
+    int stride = clusters->columnStride;
+
+    for (int l = 0; l < clusters->lightCount; l++)
+    {
+        const PointLight *light = &clusters->lights[l];
+        if ((light->intensity <= 0.0f) || (light->radius <= 0.0f)) continue;
+
+        clusters->stats.lights++;
+
+        Vector3 p = Vector3Transform(light->position, view);
+        float depth = -p.z;
+        float r = light->radius;
+        float r2 = r*r;
+
+        if ((depth + r < FRUSTUM_NEAR) || (depth - r > LIGHT_CLUSTER_FAR)) continue;
+
+        int k0 = GetLightClusterSlice(clusters, depth - r);
+        int k1 = GetLightClusterSlice(clusters, depth + r);
+        bool visible = false;
+
+        for (int k = k0; k <= k1; k++)
+        {
+            float d0 = clusters->sliceDepth[k];
+            float d1 = clusters->sliceDepth[k + 1];
+            float dz = GetIntervalDistance(depth, d0, d1);
+            float dz2 = dz*dz;
+            if (dz2 > r2) continue;
+
+            // Tiles covered by the sphere bounds inside the slice
+            float nearDepth = fmaxf(d0, depth - r);
+            float farDepth = fminf(d1, depth + r);
+            int i0, i1, j0, j1;
+            if (!GetLightClusterTiles(p.x - r, p.x + r, nearDepth, farDepth, tx, clusters->tilesX, &i0, &i1)) continue;
+            if (!GetLightClusterTiles(p.y - r, p.y + r, nearDepth, farDepth, ty, clusters->tilesY, &j0, &j1)) continue;
+
+            const float *columnMin = &clusters->columnMin[k*stride];
+            const float *columnMax = &clusters->columnMax[k*stride];
+
+            for (int j = j0; j <= j1; j++)
+            {
+                float dy = GetIntervalDistance(p.y, clusters->rowMin[k*clusters->tilesY + j], clusters->rowMax[k*clusters->tilesY + j]);
+                float dyz2 = dy*dy + dz2;
+                if (dyz2 > r2) continue;
+
+                int rowCluster = (k*clusters->tilesY + j)*clusters->tilesX;
+
+#if defined(__SSE2__)
+                const __m128 px = _mm_set1_ps(p.x);
+                const __m128 zero = _mm_setzero_ps();
+                const __m128 dyz = _mm_set1_ps(dyz2);
+                const __m128 radius2 = _mm_set1_ps(r2);
+
+                for (int i = i0 & ~3; i <= i1; i += 4)
+                {
+                    __m128 dx = _mm_max_ps(_mm_max_ps(_mm_sub_ps(_mm_loadu_ps(&columnMin[i]), px), _mm_sub_ps(px, _mm_loadu_ps(&columnMax[i]))), zero);
+                    int mask = _mm_movemask_ps(_mm_cmple_ps(_mm_add_ps(_mm_mul_ps(dx, dx), dyz), radius2));
+
+                    // Keep columns inside [i0, i1]
+                    if (i < i0) mask &= (0xf << (i0 - i)) & 0xf;
+                    if (i + 3 > i1) mask &= 0xf >> (i + 3 - i1);
+
+                    while (mask != 0)
+                    {
+                        int c = rowCluster + i + __builtin_ctz(mask);
+                        mask &= mask - 1;
+
+                        if (clusters->clusterCounts[c] < MAX_LIGHTS_PER_CLUSTER) clusters->clusterLights[c*MAX_LIGHTS_PER_CLUSTER + clusters->clusterCounts[c]++] = (unsigned short)l;
+                        else clusters->stats.dropped++;
+                        visible = true;
+                    }
+                }
+#else
+                for (int i = i0; i <= i1; i++)
+                {
+                    float dx = GetIntervalDistance(p.x, columnMin[i], columnMax[i]);
+                    if (dx*dx + dyz2 > r2) continue;
+
+                    int c = rowCluster + i;
+                    if (clusters->clusterCounts[c] < MAX_LIGHTS_PER_CLUSTER) clusters->clusterLights[c*MAX_LIGHTS_PER_CLUSTER + clusters->clusterCounts[c]++] = (unsigned short)l;
+                    else clusters->stats.dropped++;
+                    visible = true;
+                }
+#endif
+            }
+        }
+
+        if (visible) clusters->stats.visibleLights++;
+    }
+
+    // Compact per cluster lists into one index list
+    int indexCount = 0;
+    for (int c = 0; c < clusters->clusterCount; c++)
+    {
+        int count = clusters->clusterCounts[c];
+        if (indexCount + count > MAX_CLUSTER_LIGHT_INDICES)
+        {
+            clusters->stats.dropped += indexCount + count - MAX_CLUSTER_LIGHT_INDICES;
+            count = MAX_CLUSTER_LIGHT_INDICES - indexCount;
+        }
+
+        clusters->offsets[c] = indexCount;
+        clusters->counts[c] = (unsigned short)count;
+        memcpy(&clusters->indices[indexCount], &clusters->clusterLights[c*MAX_LIGHTS_PER_CLUSTER], count*sizeof(unsigned short));
+        indexCount += count;
+
+        if (count > clusters->stats.maxClusterLights) clusters->stats.maxClusterLights = count;
+    }
+
+    clusters->stats.indices = indexCount;
+    clusters->stats.time = (float)(GetTimerSeconds() - start);
+}
+
+// Upload lights and cluster lists to GPU textures, creates them on first call
+void UploadLightClusters(LightClusters *clusters)
+{
+    int clusterWidth = clusters->tilesX*clusters->tilesY;
+    int indexRows = MAX_CLUSTER_LIGHT_INDICES/LIGHT_INDEX_TEXTURE_WIDTH;
+
+    if (clusters->lightTextureId == 0)
+    {
+        clusters->lightTextureId = rlLoadTexture(NULL, clusters->capacity, 2, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, 1);
+        clusters->clusterTextureId = rlLoadTexture(NULL, clusterWidth, clusters->slices, PIXELFORMAT_UNCOMPRESSED_R32G32B32, 1);
+        clusters->indexTextureId = rlLoadTexture(NULL, LIGHT_INDEX_TEXTURE_WIDTH, indexRows, PIXELFORMAT_UNCOMPRESSED_R32, 1);
+    }
+
+    // Lights: position + radius row, then color + intensity row
+    float *texels = clusters->texels;
+    for (int l = 0; l < clusters->lightCount; l++)
+    {
+        const PointLight *light = &clusters->lights[l];
+        float *top = &texels[l*4];
+        float *bottom = &texels[(clusters->capacity + l)*4];
+
+        top[0] = light->position.x; top[1] = light->position.y; top[2] = light->position.z; top[3] = light->radius;
+        bottom[0] = light->color.x; bottom[1] = light->color.y; bottom[2] = light->color.z; bottom[3] = light->intensity;
+    }
+    if (clusters->lightCount > 0)
+    {
+        rlUpdateTexture(clusters->lightTextureId, 0, 0, clusters->lightCount, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, texels);
+        rlUpdateTexture(clusters->lightTextureId, 0, 1, clusters->lightCount, 1, PIXELFORMAT_UNCOMPRESSED_R32G32B32A32, &texels[clusters->capacity*4]);
+    }
+
+    for (int c = 0; c < clusters->clusterCount; c++)
+    {
+        texels[c*3] = (float)clusters->offsets[c];
+        texels[c*3 + 1] = (float)clusters->counts[c];
+        texels[c*3 + 2] = 0.0f;
+    }
+    rlUpdateTexture(clusters->clusterTextureId, 0, 0, clusterWidth, clusters->slices, PIXELFORMAT_UNCOMPRESSED_R32G32B32, texels);
+
+    // Index list, only the rows in use
+    int rows = (clusters->stats.indices + LIGHT_INDEX_TEXTURE_WIDTH - 1)/LIGHT_INDEX_TEXTURE_WIDTH;
+    for (int i = 0; i < rows*LIGHT_INDEX_TEXTURE_WIDTH; i++) texels[i] = (i < clusters->stats.indices)? (float)clusters->indices[i] : 0.0f;
+    if (rows > 0) rlUpdateTexture(clusters->indexTextureId, 0, 0, LIGHT_INDEX_TEXTURE_WIDTH, rows, PIXELFORMAT_UNCOMPRESSED_R32, texels);
+}
+
+// Update light clusters for a camera: bin lights and upload the result
+void UpdateLightClusters(LightClusters *clusters, Camera camera, float aspect)
+{
+    BinLightClusters(clusters, MatrixLookAt(camera.position, camera.target, camera.up), camera.fovy, aspect);
+    UploadLightClusters(clusters);
+}
+
+// Bind light clusters to the compact map shader, on texture slots 1 to 3
+// NOTE: Call before drawing map meshes, texture slot 0 is left active for diffuse textures
+void BindLightClusters(const LightClusters *clusters, CompactMapShader shader)
+{
+    float grid[3] = { (float)clusters->tilesX, (float)clusters->tilesY, (float)clusters->slices };
+    float depth[2] = { LIGHT_CLUSTER_NEAR, clusters->sliceScale };
+    int slots[3] = { 1, 2, 3 };
+
+    rlEnableShader(shader.shader.id);
+    rlSetUniform(shader.clusterGridLoc, grid, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(shader.clusterDepthLoc, depth, SHADER_UNIFORM_VEC2, 1);
+    rlSetUniform(shader.lightDataLoc, &slots[0], SHADER_UNIFORM_INT, 1);
+    rlSetUniform(shader.clusterDataLoc, &slots[1], SHADER_UNIFORM_INT, 1);
+    rlSetUniform(shader.lightIndicesLoc, &slots[2], SHADER_UNIFORM_INT, 1);
+    rlDisableShader();
+
+    rlActiveTextureSlot(1);
+    rlEnableTexture(clusters->lightTextureId);
+    rlActiveTextureSlot(2);
+    rlEnableTexture(clusters->clusterTextureId);
+    rlActiveTextureSlot(3);
+    rlEnableTexture(clusters->indexTextureId);
+    rlActiveTextureSlot(0);
+}
+
+// Unbind light cluster textures
+void UnbindLightClusters(void)
+{
+    for (int slot = 3; slot >= 1; slot--)
+    {
+        rlActiveTextureSlot(slot);
+        rlDisableTexture();
+    }
+
+    rlActiveTextureSlot(0);
+}
+
+// Check binned lists against brute force light tests, returns the number of failed checks
+// NOTE: Lists must be packed in cluster order with increasing valid light indices, and every listed
+// light must touch the cluster box (no false positives past the tested bounds). Every light must be
+// listed in the cluster of each fragment it reaches: sample points inside each light sphere are mapped
+// to clusters like compact_map.fs does, a light may only be missing from a full cluster and then it
+// must be counted as dropped
+static int CheckLightClusters(const LightClusters *clusters, Matrix view, float fovy, float aspect, int samplesPerLight)
+{
+    float ty = tanf(fovy*0.5f*DEG2RAD);
+    float tx = ty*aspect;
+    int failures = 0;
+    int indexCount = 0;
+
+    Vector3 *positions = (Vector3 *)RL_MALLOC(clusters->lightCount*sizeof(Vector3));
+    for (int l = 0; l < clusters->lightCount; l++) positions[l] = Vector3Transform(clusters->lights[l].position, view);
+
+    for (int k = 0; k < clusters->slices; k++)
+    {
+        float d0 = clusters->sliceDepth[k];
+        float d1 = clusters->sliceDepth[k + 1];
+
+        for (int j = 0; j < clusters->tilesY; j++)
+        {
+            for (int i = 0; i < clusters->tilesX; i++)
+            {
+                int c = (k*clusters->tilesY + j)*clusters->tilesX + i;
+                if (clusters->offsets[c] != (unsigned int)indexCount)
+                {
+                    failures++;
+                    indexCount = clusters->offsets[c];
+                }
+
+                float x0 = clusters->columnMin[k*clusters->columnStride + i];
+                float x1 = clusters->columnMax[k*clusters->columnStride + i];
+                float y0 = clusters->rowMin[k*clusters->tilesY + j];
+                float y1 = clusters->rowMax[k*clusters->tilesY + j];
+
+                for (int n = 0; n < clusters->counts[c]; n++)
+                {
+                    int l = clusters->indices[indexCount + n];
+                    if ((l >= clusters->lightCount) || ((n > 0) && (l <= clusters->indices[indexCount + n - 1]))) { failures++; break; }
+
+                    const PointLight *light = &clusters->lights[l];
+                    float dx = GetIntervalDistance(positions[l].x, x0, x1);
+                    float dy = GetIntervalDistance(positions[l].y, y0, y1);
+                    float dz = GetIntervalDistance(-positions[l].z, d0, d1);
+                    if ((light->intensity <= 0.0f) || (dx*dx + dy*dy + dz*dz > light->radius*light->radius*1.001f)) failures++;
+                }
+
+                indexCount += clusters->counts[c];
+            }
+        }
+    }
+
+    if (indexCount != clusters->stats.indices) failures++;
+
+    // Fragments lit by each light, the sample sequence is fixed per light
+    for (int l = 0; l < clusters->lightCount; l++)
+    {
+        const PointLight *light = &clusters->lights[l];
+        if ((light->intensity <= 0.0f) || (light->radius <= 0.0f)) continue;
+
+        unsigned int seed = 0x9e3779b9u*(l + 1);
+        for (int n = 0; n < samplesPerLight; n++)
+        {
+            float u[4];
+            for (int a = 0; a < 4; a++)
+            {
+                seed = seed*1664525u + 1013904223u;
+                u[a] = (seed >> 8)/16777216.0f;
+            }
+
+            // Point inside the sphere, away from its surface (float rounding)
+            Vector3 direction = Vector3Normalize((Vector3){ u[0] - 0.5f, u[1] - 0.5f, u[2] - 0.5f });
+            Vector3 point = Vector3Add(positions[l], Vector3Scale(direction, 0.999f*light->radius*cbrtf(u[3])));
+
+            float depth = -point.z;
+            if ((depth < FRUSTUM_NEAR) || (depth > LIGHT_CLUSTER_FAR)) continue;
+
+            float ndcx = point.x/(depth*tx);
+            float ndcy = point.y/(depth*ty);
+            if ((fabsf(ndcx) > 1.0f) || (fabsf(ndcy) > 1.0f)) continue;
+
+            int tileX = (int)fminf(floorf((ndcx*0.5f + 0.5f)*clusters->tilesX), clusters->tilesX - 1.0f);
+            int tileY = (int)fminf(floorf((ndcy*0.5f + 0.5f)*clusters->tilesY), clusters->tilesY - 1.0f);
+            int slice = (int)fmaxf(floorf(logf(depth/LIGHT_CLUSTER_NEAR)*clusters->sliceScale), 0.0f);
+            if (slice >= clusters->slices) continue;
+
+            int c = (slice*clusters->tilesY + tileY)*clusters->tilesX + tileX;
+            bool listed = false;
+            for (int m = 0; (m < clusters->counts[c]) && !listed; m++) listed = (clusters->indices[clusters->offsets[c] + m] == l);
+
+            if (!listed && ((clusters->counts[c] < MAX_LIGHTS_PER_CLUSTER) || (clusters->stats.dropped == 0))) failures++;
+        }
+    }
+
+    RL_FREE(positions);
+
+    return failures;
+}
+
+// Benchmark light binning with random lights around random cameras, returns the number of failed checks
+// NOTE: Runs headless (no upload), lights of 2 to 6 units radius are spread at 0..4 units height over
+// an area growing with the light count (about one light per 16 square units, a lamp every 4 cells).
+// The first checkFrames frames are checked against brute force light tests after timing
+int BenchmarkLightClusters(int lightCount, int frames, int checkFrames)
+{
+    LightClusters clusters = LoadLightClusters(16, 9, 24, lightCount);
+    float size = 4.0f*sqrtf((float)lightCount);
+
+    srand(1234);
+    for (int i = 0; i < lightCount; i++)
+    {
+        Vector3 position = { (rand()%1000)/1000.0f*size, (rand()%1000)/1000.0f*4.0f, (rand()%1000)/1000.0f*size };
+        Color color = { (unsigned char)(128 + rand()%128), (unsigned char)(128 + rand()%128), (unsigned char)(rand()%256), 255 };
+        AddPointLight(&clusters, position, 2.0f + (rand()%1000)/1000.0f*4.0f, color, 1.0f);
+    }
+
+    double time = 0.0;
+    long long visible = 0, indices = 0, dropped = 0;
+    int maxClusterLights = 0;
+    int failures = 0;
+
+    for (int f = 0; f < frames; f++)
+    {
+        float angle = (rand()%3600)*0.1f*DEG2RAD;
+        Camera camera = { 0 };
+        camera.position = (Vector3){ (rand()%1000)/1000.0f*size, 1.7f, (rand()%1000)/1000.0f*size };
+        camera.target = Vector3Add(camera.position, (Vector3){ cosf(angle), 0.0f, sinf(angle) });
+        camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+        camera.fovy = 70.0f;
+
+        Matrix view = MatrixLookAt(camera.position, camera.target, camera.up);
+        BinLightClusters(&clusters, view, camera.fovy, 16.0f/9.0f);
+
+        time += clusters.stats.time;
+        visible += clusters.stats.visibleLights;
+        indices += clusters.stats.indices;
+        dropped += clusters.stats.dropped;
+        if (clusters.stats.maxClusterLights > maxClusterLights) maxClusterLights = clusters.stats.maxClusterLights;
+
+        if (f < checkFrames) failures += CheckLightClusters(&clusters, view, camera.fovy, 16.0f/9.0f, 64);
+    }
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "LIGHTS: %i lights, %ix%ix%i clusters: %.3f ms binning, %.1f visible lights, %.1f indices, max %i lights per cluster, %lli dropped, %i failed checks in %i checked frames",
+        lightCount, clusters.tilesX, clusters.tilesY, clusters.slices, time*1000.0/frames, (float)visible/frames, (float)indices/frames, maxClusterLights, dropped,
+        failures, (checkFrames < frames)? checkFrames : frames);
+
+    // Overfull clusters: all lights packed in front of the camera, entries over capacity must be counted as dropped
+    if (lightCount > MAX_LIGHTS_PER_CLUSTER)
+    {
+        for (int i = 0; i < lightCount; i++) clusters.lights[i].position = (Vector3){ 10.0f + (rand()%1000)/1000.0f, 1.7f + (rand()%1000)/1000.0f, (rand()%1000)/1000.0f };
+
+        Matrix view = MatrixLookAt((Vector3){ 0.0f, 1.7f, 0.0f }, (Vector3){ 1.0f, 1.7f, 0.0f }, (Vector3){ 0.0f, 1.0f, 0.0f });
+        BinLightClusters(&clusters, view, 70.0f, 16.0f/9.0f);
+
+        int failed = CheckLightClusters(&clusters, view, 70.0f, 16.0f/9.0f, 64);
+        if ((clusters.stats.maxClusterLights != MAX_LIGHTS_PER_CLUSTER) || (clusters.stats.dropped == 0)) failed++;
+        failures += failed;
+
+        TRACELOG((failed == 0)? LOG_INFO : LOG_WARNING, "LIGHTS: %i packed lights: %i indices, max %i lights per cluster, %i dropped, %i failed checks",
+            lightCount, clusters.stats.indices, clusters.stats.maxClusterLights, clusters.stats.dropped, failed);
+    }
+
+    UnloadLightClusters(&clusters);
+
+    return failures;
+}
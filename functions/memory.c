@@ -0,0 +1,502 @@
+// Memory: tagged allocation accounting hooks and per-frame linear arena
+// WARNING: Must be included before raylib.h, RL_MALLOC/RL_CALLOC/RL_REALLOC/RL_FREE are redefined here
+// so every module compiled in this translation unit goes through the accounting hooks. raylib itself is
+// a separate library and keeps its own allocator unless it is rebuilt with the same defines, memory it
+// owns (textures, models, sounds) is reported with TrackMemory()
+// NOTE: Blocks have no header, size and tag are kept in a pointer table, so blocks allocated here can
+// still be freed by raylib (UnloadMesh() on generated meshes), they just stay counted as live
+
+#include <stdlib.h>         // Required for: malloc(), calloc(), realloc(), free()
+#include <stddef.h>         // Required for: size_t
+#include <string.h>         // Required for: memset()
+#include <assert.h>         // Required for: assert()
+#include <pthread.h>        // Required for: pthread_self(), pthread_equal()
+
+void *MemAllocCounted(size_t size);
+void *MemCallocCounted(size_t count, size_t size);
+void *MemReallocCounted(void *ptr, size_t size);
+void MemFreeCounted(void *ptr);
+
+#define RL_MALLOC(sz)           MemAllocCounted(sz)
+#define RL_CALLOC(n, sz)        MemCallocCounted(n, sz)
+#define RL_REALLOC(ptr, sz)     MemReallocCounted(ptr, sz)
+#define RL_FREE(ptr)            MemFreeCounted(ptr)
+
+#include "raylib.h"         // Declares module functions
+
+// Check if config flags have been externally provided on compilation line
+// NOTE: Must come before utils.h, TRACELOG() expands to nothing without SUPPORT_TRACELOG
+#if !defined(EXTERNAL_CONFIG_FLAGS)
+    #include "config.h"     // Defines module configuration flags
+#endif
+
+#include "utils.h"          // Required for: TRACELOG()
+
+#define FRAME_ARENA_ALIGNMENT   16
+#define FRAME_ARENA_MIN_SIZE    (1024*1024)
+
+#define MEMORY_TAG_STACK_SIZE   16
+
+// Memory tags, allocations are charged to the tag on top of the calling thread tag stack
+typedef enum MemoryTag {
+    MEMORY_TAG_GENERAL = 0,
+    MEMORY_TAG_MAP,             // Cubicmap grid, map meshes and generation staging
+    MEMORY_TAG_STREAMING,       // Streamed map regions
+    MEMORY_TAG_MODELS,          // Model and LOD mesh data
+    MEMORY_TAG_TEXTURES,        // Texture pixel data (GPU, tracked)
+    MEMORY_TAG_AUDIO,           // Decoded audio (tracked)
+    MEMORY_TAG_ENTITIES,
+    MEMORY_TAG_NAVIGATION,      // Navigation grid, flow fields and crowd
+    MEMORY_TAG_EFFECTS,         // Particles
+    MEMORY_TAG_FRAME,           // Frame arena
+    MEMORY_TAG_COUNT
+} MemoryTag;
+
+static const char *memoryTagNames[MEMORY_TAG_COUNT] = {
+    "general", "map", "streaming", "models", "textures", "audio", "entities", "navigation", "effects", "frame"
+};
+
+typedef struct MemoryTagStats {
+    long long bytes;            // Current bytes
+    long long peakBytes;
+    long long budget;           // Budget bytes, 0 if none
+    int blocks;                 // Current live blocks
+    long long allocations;      // Total allocations
+} MemoryTagStats;
+
+typedef struct MemoryCounters {
+    long long allocations;      // Heap allocations (malloc, calloc, realloc) since start
+    long long frees;            // Heap frees since start
+    int frameAllocations;       // Heap allocations on the main thread since last ResetFrameMemory()
+    int allocatingFrames;       // Checked frames that allocated
+} MemoryCounters;
+
+// Frame arena block, extra blocks are chained when the first one is full
+typedef struct FrameArenaBlock {
+    struct FrameArenaBlock *next;
+    size_t capacity;
+    size_t used;
+    unsigned char *data;
+} FrameArenaBlock;
+
+// Live block entry, open addressing table keyed by pointer
+typedef struct MemoryBlock {
+    void *ptr;
+    size_t size;
+    int tag;
+} MemoryBlock;
+
+static MemoryCounters memoryCounters = { 0 };
+static pthread_t memoryMainThread;
+static bool memoryMainThreadSet = false;
+static FrameArenaBlock *frameArena = NULL;
+
+static pthread_mutex_t memoryLock = PTHREAD_MUTEX_INITIALIZER;
+static MemoryTagStats memoryTags[MEMORY_TAG_COUNT] = { 0 };
+static MemoryBlock *memoryBlocks = NULL;
+static size_t memoryBlockCapacity = 0;          // Power of two
+static size_t memoryBlockCount = 0;
+
+static __thread int memoryTagStack[MEMORY_TAG_STACK_SIZE];
+static __thread int memoryTagDepth = 0;
+
+//----------------------------------------------------------------------------------
+// Tags
+//----------------------------------------------------------------------------------
+
+// Push memory tag for calling thread, following allocations are charged to it
+void PushMemoryTag(int tag)
+{
+    if (memoryTagDepth < MEMORY_TAG_STACK_SIZE) memoryTagStack[memoryTagDepth] = tag;
+    memoryTagDepth++;
+}
+
+// Pop memory tag of calling thread
+void PopMemoryTag(void)
+{
+    if (memoryTagDepth > 0) memoryTagDepth--;
+}
+
+// Get memory tag of calling thread
+static int GetCurrentMemoryTag(void)
+{
+    if (memoryTagDepth == 0) return MEMORY_TAG_GENERAL;
+
+    return memoryTagStack[(memoryTagDepth <= MEMORY_TAG_STACK_SIZE)? memoryTagDepth - 1 : MEMORY_TAG_STACK_SIZE - 1];
+}
+
+// Charge bytes to tag, warns when the tag crosses its budget
+// NOTE: Lock must be held
+static void ChargeMemoryTag(int tag, long long bytes, int blocks)
+{
+    MemoryTagStats *stats = &memoryTags[tag];
+    bool underBudget = (stats->budget == 0) || (stats->bytes <= stats->budget);
+
+    stats->bytes += bytes;
+    stats->blocks += blocks;
+    if (blocks > 0) stats->allocations += blocks;
+    if (stats->bytes > stats->peakBytes) stats->peakBytes = stats->bytes;
+
+    if (underBudget && (stats->budget > 0) && (stats->bytes > stats->budget))
+    {
+        TRACELOG(LOG_WARNING, "MEMORY: Tag '%s' over budget: %lld KB of %lld KB", memoryTagNames[tag], stats->bytes/1024, stats->budget/1024);
+    }
+}
+
+// Get table slot of a pointer (entry or first empty slot)
+// NOTE: Lock must be held
+static size_t GetMemoryBlockSlot(const void *ptr)
+{
+    size_t mask = memoryBlockCapacity - 1;
+    size_t slot = (((size_t)ptr >> 4)*0x9e3779b97f4a7c15ull) & mask;
+
+    while ((memoryBlocks[slot].ptr != NULL) && (memoryBlocks[slot].ptr != ptr)) slot = (slot + 1) & mask;
+
+    return slot;
+}
+
+// Add live block to table, table grows at half load
+// NOTE: Lock must be held
+static void AddMemoryBlock(void *ptr, size_t size, int tag)
+{
+    if ((memoryBlockCount + 1)*2 > memoryBlockCapacity)
+    {
+        MemoryBlock *old = memoryBlocks;
+        size_t oldCapacity = memoryBlockCapacity;
+
+        memoryBlockCapacity = (oldCapacity > 0)? oldCapacity*2 : 4096;
+        memoryBlocks = (MemoryBlock *)calloc(memoryBlockCapacity, sizeof(MemoryBlock));
+
+        for (size_t i = 0; i < oldCapacity; i++)
+        {
+            if (old[i].ptr != NULL) memoryBlocks[GetMemoryBlockSlot(old[i].ptr)] = old[i];
+        }
+
+        free(old);
+    }
+
+    size_t slot = GetMemoryBlockSlot(ptr);
+
+    // Address still listed: block was freed outside the hooks (by raylib), drop stale entry
+    if (memoryBlocks[slot].ptr == ptr) ChargeMemoryTag(memoryBlocks[slot].tag, -(long long)memoryBlocks[slot].size, -1);
+    else memoryBlockCount++;
+
+    memoryBlocks[slot] = (MemoryBlock){ ptr, size, tag };
+    ChargeMemoryTag(tag, (long long)size, 1);
+}
+
+// Remove live block from table, keeps probe chains intact (backward shift deletion)
+// NOTE: Lock must be held
+static void RemoveMemoryBlock(void *ptr)
+{
+    if (memoryBlockCapacity == 0) return;
+
+    size_t mask = memoryBlockCapacity - 1;
+    size_t slot = GetMemoryBlockSlot(ptr);
+    if (memoryBlocks[slot].ptr == NULL) return;     // Not allocated through the hooks
+
+    ChargeMemoryTag(memoryBlocks[slot].tag, -(long long)memoryBlocks[slot].size, -1);
+    memoryBlockCount--;
+
+    size_t hole = slot;
+    for (size_t next = (hole + 1) & mask; memoryBlocks[next].ptr != NULL; next = (next + 1) & mask)
+    {
+        size_t home = (((size_t)memoryBlocks[next].ptr >> 4)*0x9e3779b97f4a7c15ull) & mask;
+
+        // Entry can move into the hole if its home slot is not in (hole, next]
+        if (((next - home) & mask) >= ((next - hole) & mask))
+        {
+            memoryBlocks[hole] = memoryBlocks[next];
+            hole = next;
+        }
+    }
+
+    memoryBlocks[hole] = (MemoryBlock){ 0 };
+}
+
+//----------------------------------------------------------------------------------
+// Allocation hooks
+//----------------------------------------------------------------------------------
+
+// Count allocation, only main thread allocations count towards the frame check
+static void CountAllocation(void)
+{
+    __atomic_add_fetch(&memoryCounters.allocations, 1, __ATOMIC_RELAXED);
+
+    if (memoryMainThreadSet && pthread_equal(pthread_self(), memoryMainThread)) memoryCounters.frameAllocations++;
+}
+
+void *MemAllocCounted(size_t size)
+{
+    CountAllocation();
+
+    void *ptr = malloc(size);
+
+    if (ptr != NULL)
+    {
+        pthread_mutex_lock(&memoryLock);
+        AddMemoryBlock(ptr, size, GetCurrentMemoryTag());
+        pthread_mutex_unlock(&memoryLock);
+    }
+
+    return ptr;
+}
+
+void *MemCallocCounted(size_t count, size_t size)
+{
+    CountAllocation();
+
+    void *ptr = calloc(count, size);
+
+    if (ptr != NULL)
+    {
+        pthread_mutex_lock(&memoryLock);
+        AddMemoryBlock(ptr, count*size, GetCurrentMemoryTag());
+        pthread_mutex_unlock(&memoryLock);
+    }
+
+    return ptr;
+}
+
+// NOTE: Resized block keeps the tag it was allocated with, the old entry is removed before realloc()
+// frees the old block and put back if realloc() fails (old block still valid)
+void *MemReallocCounted(void *ptr, size_t size)
+{
+    CountAllocation();
+
+    pthread_mutex_lock(&memoryLock);
+
+    MemoryBlock old = { 0 };
+    old.tag = GetCurrentMemoryTag();
+    if ((ptr != NULL) && (memoryBlockCapacity > 0))
+    {
+        size_t slot = GetMemoryBlockSlot(ptr);
+        if (memoryBlocks[slot].ptr != NULL) old = memoryBlocks[slot];
+    }
+
+    if (old.ptr != NULL) RemoveMemoryBlock(ptr);
+
+    void *result = realloc(ptr, size);
+
+    if (result != NULL) AddMemoryBlock(result, size, old.tag);
+    else if ((size > 0) && (old.ptr != NULL))
+    {
+        AddMemoryBlock(old.ptr, old.size, old.tag);
+        memoryTags[old.tag].allocations--;
+    }
+
+    pthread_mutex_unlock(&memoryLock);
+
+    return result;
+}
+
+void MemFreeCounted(void *ptr)
+{
+    if (ptr == NULL) return;
+
+    __atomic_add_fetch(&memoryCounters.frees, 1, __ATOMIC_RELAXED);
+
+    pthread_mutex_lock(&memoryLock);
+    RemoveMemoryBlock(ptr);
+    pthread_mutex_unlock(&memoryLock);
+
+    free(ptr);
+}
+
+// Get allocation counters
+MemoryCounters GetMemoryCounters(void)
+{
+    return memoryCounters;
+}
+
+// Track memory not allocated through the hooks (GPU textures, raylib owned data), negative bytes release it
+void TrackMemory(int tag, long long bytes)
+{
+    pthread_mutex_lock(&memoryLock);
+    ChargeMemoryTag(tag, bytes, (bytes > 0)? 1 : -1);
+    pthread_mutex_unlock(&memoryLock);
+}
+
+// Set tag budget in bytes (0 disables it), crossing it logs a warning
+void SetMemoryBudget(int tag, long long bytes)
+{
+    pthread_mutex_lock(&memoryLock);
+    memoryTags[tag].budget = bytes;
+    pthread_mutex_unlock(&memoryLock);
+}
+
+// Get tag accounting
+MemoryTagStats GetMemoryTagStats(int tag)
+{
+    pthread_mutex_lock(&memoryLock);
+    MemoryTagStats stats = memoryTags[tag];
+    pthread_mutex_unlock(&memoryLock);
+
+    return stats;
+}
+
+// Log memory report: current, peak and budget bytes per tag
+void TraceMemoryReport(void)
+{
+    long long total = 0, peak = 0;
+
+    TRACELOG(LOG_INFO, "MEMORY: %-12s %10s %10s %10s %8s %10s", "tag", "current KB", "peak KB", "budget KB", "blocks", "allocs");
+
+    for (int tag = 0; tag < MEMORY_TAG_COUNT; tag++)
+    {
+        MemoryTagStats stats = GetMemoryTagStats(tag);
+
+        TRACELOG(LOG_INFO, "MEMORY: %-12s %10lld %10lld %10lld %8i %10lld%s", memoryTagNames[tag], stats.bytes/1024, stats.peakBytes/1024,
+            stats.budget/1024, stats.blocks, stats.allocations, ((stats.budget > 0) && (stats.peakBytes > stats.budget))? " OVER BUDGET" : "");
+
+        total += stats.bytes;
+        peak += stats.peakBytes;
+    }
+
+    TRACELOG(LOG_INFO, "MEMORY: %-12s %10lld %10lld (sum of tag peaks)", "total", total/1024, peak/1024);
+}
+
+// Get mesh CPU data size in bytes
+long long GetMeshMemorySize(Mesh mesh)
+{
+    long long bytes = 0;
+
+    if (mesh.vertices != NULL) bytes += (long long)mesh.vertexCount*3*sizeof(float);
+    if (mesh.normals != NULL) bytes += (long long)mesh.vertexCount*3*sizeof(float);
+    if (mesh.texcoords != NULL) bytes += (long long)mesh.vertexCount*2*sizeof(float);
+    if (mesh.texcoords2 != NULL) bytes += (long long)mesh.vertexCount*2*sizeof(float);
+    if (mesh.tangents != NULL) bytes += (long long)mesh.vertexCount*4*sizeof(float);
+    if (mesh.colors != NULL) bytes += (long long)mesh.vertexCount*4;
+    if (mesh.indices != NULL) bytes += (long long)mesh.triangleCount*3*sizeof(unsigned short);
+
+    return bytes;
+}
+
+// Get model mesh CPU data size in bytes
+long long GetModelMemorySize(Model model)
+{
+    long long bytes = 0;
+    for (int m = 0; m < model.meshCount; m++) bytes += GetMeshMemorySize(model.meshes[m]);
+
+    return bytes;
+}
+
+// Get texture data size in bytes (GPU), mipmaps add about a third
+long long GetTextureMemorySize(Texture2D texture)
+{
+    long long bytes = GetPixelDataSize(texture.width, texture.height, texture.format);
+
+    return (texture.mipmaps > 1)? bytes*4/3 : bytes;
+}
+
+// Get decoded sound size in bytes
+long long GetSoundMemorySize(Sound sound)
+{
+    return (long long)sound.frameCount*sound.stream.channels*sound.stream.sampleSize/8;
+}
+
+//----------------------------------------------------------------------------------
+// Frame arena
+//----------------------------------------------------------------------------------
+
+// Allocate frame arena block with given capacity
+static FrameArenaBlock *LoadFrameArenaBlock(size_t capacity)
+{
+    PushMemoryTag(MEMORY_TAG_FRAME);
+    FrameArenaBlock *block = (FrameArenaBlock *)MemAllocCounted(sizeof(FrameArenaBlock) + capacity + FRAME_ARENA_ALIGNMENT);
+    PopMemoryTag();
+
+    block->next = NULL;
+    block->capacity = capacity;
+    block->used = 0;
+    block->data = (unsigned char *)(((size_t)(block + 1) + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1));
+
+    return block;
+}
+
+// Init frame memory: frame arena with initial capacity, calling thread becomes the main thread for checks
+void InitFrameMemory(size_t capacity)
+{
+    if (capacity < FRAME_ARENA_MIN_SIZE) capacity = FRAME_ARENA_MIN_SIZE;
+
+    memoryMainThread = pthread_self();
+    memoryMainThreadSet = true;
+
+    frameArena = LoadFrameArenaBlock(capacity);
+}
+
+// Close frame memory, frame arena pointers become invalid
+void CloseFrameMemory(void)
+{
+    while (frameArena != NULL)
+    {
+        FrameArenaBlock *next = frameArena->next;
+        MemFreeCounted(frameArena);
+        frameArena = next;
+    }
+
+    memoryMainThreadSet = false;
+}
+
+// Allocate frame memory, valid until next ResetFrameMemory(), aligned to 16 bytes
+// NOTE: When the arena is full an extra block is chained (counted as heap allocation), on reset
+// the arena grows to the frame total so following frames fit again
+// WARNING: Main thread only
+void *FrameAlloc(size_t size)
+{
+    if (frameArena == NULL) InitFrameMemory(FRAME_ARENA_MIN_SIZE);
+
+    size = (size + FRAME_ARENA_ALIGNMENT - 1) & ~(size_t)(FRAME_ARENA_ALIGNMENT - 1);
+
+    if (frameArena->used + size > frameArena->capacity)
+    {
+        FrameArenaBlock *block = LoadFrameArenaBlock((size > frameArena->capacity)? size : frameArena->capacity);
+        block->next = frameArena;
+        frameArena = block;
+    }
+
+    void *result = frameArena->data + frameArena->used;
+    frameArena->used += size;
+
+    return result;
+}
+
+// Get bytes allocated from frame memory since last reset
+size_t GetFrameMemoryUsed(void)
+{
+    size_t used = 0;
+    for (FrameArenaBlock *block = frameArena; block != NULL; block = block->next) used += block->used;
+
+    return used;
+}
+
+// Reset frame memory, call once per frame after EndDrawing()
+// NOTE: With checkAllocations, heap allocations made by the main thread during the frame are reported
+// and assert in debug builds, use it once a level is running (loading frames are expected to allocate)
+void ResetFrameMemory(bool checkAllocations)
+{
+    if (frameArena == NULL) InitFrameMemory(FRAME_ARENA_MIN_SIZE);
+
+    // Overflow blocks: replace all blocks with one big enough for this frame
+    if (frameArena->next != NULL)
+    {
+        size_t total = 0;
+        for (FrameArenaBlock *block = frameArena; block != NULL; block = block->next) total += block->capacity;
+
+        CloseFrameMemory();
+        InitFrameMemory(total);
+
+        TRACELOG(LOG_INFO, "MEMORY: Frame arena grown to %i KB", (int)(total/1024));
+    }
+
+    frameArena->used = 0;
+
+    if (checkAllocations && (memoryCounters.frameAllocations > 0))
+    {
+        memoryCounters.allocatingFrames++;
+        TRACELOG(LOG_WARNING, "MEMORY: %i heap allocations in frame", memoryCounters.frameAllocations);
+        assert((memoryCounters.frameAllocations == 0) && "Heap allocation in steady state frame");
+    }
+
+    memoryCounters.frameAllocations = 0;
+}
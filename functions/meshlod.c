@@ -0,0 +1,644 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: malloc(), free(), qsort()
+#include <string.h>         // Required for: memcpy(), memcmp(), memset()
+#include <math.h>           // Required for: sqrtf(), tanf(), sinf(), cosf()
+
+// Mesh LOD chains: CPU quadric-error edge collapse simplifier plus screen size based selection
+// NOTE: Simplification only touches CPU mesh data, GenMeshSimplified() can run without a GL context
+
+#define MAX_LOD_LEVELS          4
+#define LOD_HYSTERESIS          0.15f       // Relative screen size band around thresholds to avoid popping
+
+typedef struct ModelLod {
+    Model levels[MAX_LOD_LEVELS];           // Level 0 is the source model, not owned by the chain
+    float screenSize[MAX_LOD_LEVELS];       // Min projected size (fraction of screen height) to use each level
+    int triangleCount[MAX_LOD_LEVELS];      // Triangles per level, all meshes
+    int levelCount;
+    float radius;                           // Model space bounding sphere radius
+} ModelLod;
+
+// Symmetric 4x4 error quadric, upper triangle
+typedef struct LodQuadric {
+    double a2, ab, ac, ad;
+    double b2, bc, bd;
+    double c2, cd;
+    double d2;
+} LodQuadric;
+
+typedef struct LodCollapse {
+    unsigned int from;
+    unsigned int to;
+    float cost;
+} LodCollapse;
+
+// Triangle ratio, max relative error and min screen size per level
+static const float lodRatio[MAX_LOD_LEVELS] = { 1.0f, 0.5f, 0.25f, 0.1f };
+static const float lodError[MAX_LOD_LEVELS] = { 0.0f, 0.01f, 0.03f, 0.08f };
+static const float lodScreenSize[MAX_LOD_LEVELS] = { 0.4f, 0.2f, 0.08f, 0.0f };
+
+static void LodQuadricAddPlane(LodQuadric *q, double a, double b, double c, double d, double weight)
+{
+    q->a2 += a*a*weight; q->ab += a*b*weight; q->ac += a*c*weight; q->ad += a*d*weight;
+    q->b2 += b*b*weight; q->bc += b*c*weight; q->bd += b*d*weight;
+    q->c2 += c*c*weight; q->cd += c*d*weight;
+    q->d2 += d*d*weight;
+}
+
+static void LodQuadricAdd(LodQuadric *q, const LodQuadric *r)
+{
+    q->a2 += r->a2; q->ab += r->ab; q->ac += r->ac; q->ad += r->ad;
+    q->b2 += r->b2; q->bc += r->bc; q->bd += r->bd;
+    q->c2 += r->c2; q->cd += r->cd;
+    q->d2 += r->d2;
+}
+
+static double LodQuadricError(const LodQuadric *q, Vector3 v)
+{
+    double x = v.x, y = v.y, z = v.z;
+    double error = q->a2*x*x + 2*q->ab*x*y + 2*q->ac*x*z + 2*q->ad*x
+                 + q->b2*y*y + 2*q->bc*y*z + 2*q->bd*y
+                 + q->c2*z*z + 2*q->cd*z
+                 + q->d2;
+
+    return (error < 0)? 0 : error;
+}
+
+static int LodCompareCollapse(const void *a, const void *b)
+{
+    float ca = ((const LodCollapse *)a)->cost;
+    float cb = ((const LodCollapse *)b)->cost;
+
+    return (ca < cb)? -1 : (ca > cb);
+}
+
+static int LodCompareEdge(const void *a, const void *b)
+{
+    const unsigned int *ea = (const unsigned int *)a;
+    const unsigned int *eb = (const unsigned int *)b;
+
+    if (ea[0] != eb[0]) return (ea[0] < eb[0])? -1 : 1;
+    if (ea[1] != eb[1]) return (ea[1] < eb[1])? -1 : 1;
+    return 0;
+}
+
+// Check if moving vertex 'from' onto 'to' flips or degenerates any triangle around 'from'
+static bool LodCollapseFlips(const unsigned int *indices, const int *adjOffset, const int *adjTris, const Vector3 *positions, unsigned int from, unsigned int to)
+{
+    for (int k = adjOffset[from]; k < adjOffset[from + 1]; k++)
+    {
+        const unsigned int *tri = &indices[adjTris[k]*3];
+
+        // Triangles sharing the collapsed edge disappear, they can't flip
+        if ((tri[0] == to) || (tri[1] == to) || (tri[2] == to)) continue;
+
+        Vector3 p0 = positions[tri[0]];
+        Vector3 p1 = positions[tri[1]];
+        Vector3 p2 = positions[tri[2]];
+        Vector3 before = Vector3CrossProduct(Vector3Subtract(p1, p0), Vector3Subtract(p2, p0));
+
+        if (tri[0] == from) p0 = positions[to];
+        if (tri[1] == from) p1 = positions[to];
+        if (tri[2] == from) p2 = positions[to];
+        Vector3 after = Vector3CrossProduct(Vector3Subtract(p1, p0), Vector3Subtract(p2, p0));
+
+        if (Vector3DotProduct(before, after) <= 0.25f*Vector3Length(before)*Vector3Length(after)) return true;
+    }
+
+    return false;
+}
+
+// Simplify indexed triangle list in place by half-edge collapses, returns new index count
+// NOTE: Positions must be normalized to unit scale, targetError is relative to that scale
+// NOTE: Vertices are never moved, surviving vertices keep their original attributes
+static int SimplifyIndices(unsigned int *indices, int indexCount, const Vector3 *positions, int vertexCount, int targetIndexCount, float targetError, float *resultError)
+{
+    LodQuadric *quadrics = (LodQuadric *)RL_CALLOC(vertexCount, sizeof(LodQuadric));
+    unsigned char *boundary = (unsigned char *)RL_CALLOC(vertexCount, sizeof(unsigned char));
+    unsigned char *locked = (unsigned char *)RL_MALLOC(vertexCount*sizeof(unsigned char));
+    unsigned int *remap = (unsigned int *)RL_MALLOC(vertexCount*sizeof(unsigned int));
+    int *adjOffset = (int *)RL_MALLOC((vertexCount + 1)*sizeof(int));
+    int *adjTris = (int *)RL_MALLOC(indexCount*sizeof(int));
+    unsigned int *edges = (unsigned int *)RL_MALLOC(indexCount*3*sizeof(unsigned int));
+    LodCollapse *collapses = (LodCollapse *)RL_MALLOC(indexCount*sizeof(LodCollapse));
+
+    double maxError = (double)targetError*targetError;
+    float worstError = 0.0f;
+
+    // Accumulate area weighted triangle planes
+    for (int i = 0; i < indexCount; i += 3)
+    {
+        Vector3 p0 = positions[indices[i]];
+        Vector3 p1 = positions[indices[i + 1]];
+        Vector3 p2 = positions[indices[i + 2]];
+        Vector3 normal = Vector3CrossProduct(Vector3Subtract(p1, p0), Vector3Subtract(p2, p0));
+        float area = Vector3Length(normal);
+
+        if (area <= 0.0f) continue;
+
+        normal = Vector3Scale(normal, 1.0f/area);
+        double d = -Vector3DotProduct(normal, p0);
+
+        for (int k = 0; k < 3; k++) LodQuadricAddPlane(&quadrics[indices[i + k]], normal.x, normal.y, normal.z, d, area*0.5f);
+    }
+
+    // Find boundary edges (used by a single triangle) and constrain them with perpendicular planes
+    for (int i = 0; i < indexCount; i += 3)
+    {
+        for (int k = 0; k < 3; k++)
+        {
+            unsigned int a = indices[i + k];
+            unsigned int b = indices[i + (k + 1)%3];
+            edges[(i + k)*3] = (a < b)? a : b;
+            edges[(i + k)*3 + 1] = (a < b)? b : a;
+            edges[(i + k)*3 + 2] = i/3;
+        }
+    }
+
+    qsort(edges, indexCount, 3*sizeof(unsigned int), LodCompareEdge);
+
+    for (int e = 0; e < indexCount; )
+    {
+        int run = 1;
+        while ((e + run < indexCount) && (LodCompareEdge(&edges[e*3], &edges[(e + run)*3]) == 0)) run++;
+
+        if (run == 1)
+        {
+            unsigned int a = edges[e*3];
+            unsigned int b = edges[e*3 + 1];
+            const unsigned int *tri = &indices[edges[e*3 + 2]*3];
+            Vector3 p0 = positions[tri[0]];
+            Vector3 faceNormal = Vector3Normalize(Vector3CrossProduct(Vector3Subtract(positions[tri[1]], p0), Vector3Subtract(positions[tri[2]], p0)));
+            Vector3 edge = Vector3Subtract(positions[b], positions[a]);
+            float length = Vector3Length(edge);
+            Vector3 normal = Vector3Normalize(Vector3CrossProduct(edge, faceNormal));
+            double d = -Vector3DotProduct(normal, positions[a]);
+
+            LodQuadricAddPlane(&quadrics[a], normal.x, normal.y, normal.z, d, length*10.0f);
+            LodQuadricAddPlane(&quadrics[b], normal.x, normal.y, normal.z, d, length*10.0f);
+            boundary[a] = 1;
+            boundary[b] = 1;
+        }
+
+        e += run;
+    }
+
+    while (indexCount > targetIndexCount)
+    {
+        // Build vertex -> triangles adjacency
+        memset(adjOffset, 0, (vertexCount + 1)*sizeof(int));
+        for (int i = 0; i < indexCount; i++) adjOffset[indices[i] + 1]++;
+        for (int v = 0; v < vertexCount; v++) adjOffset[v + 1] += adjOffset[v];
+        for (int i = 0; i < indexCount; i++) adjTris[adjOffset[indices[i]]++] = i/3;
+        for (int v = vertexCount; v > 0; v--) adjOffset[v] = adjOffset[v - 1];
+        adjOffset[0] = 0;
+
+        // Pick cheapest direction of every edge
+        int collapseCount = 0;
+
+        for (int i = 0; i < indexCount; i++)
+        {
+            unsigned int a = indices[i];
+            unsigned int b = indices[(i%3 == 2)? i - 2 : i + 1];
+
+            // Interior vertices can't slide onto the boundary in a way that opens it
+            bool canAB = !boundary[a] || boundary[b];
+            bool canBA = !boundary[b] || boundary[a];
+
+            LodQuadric q = quadrics[a];
+            LodQuadricAdd(&q, &quadrics[b]);
+
+            double costAB = canAB? LodQuadricError(&q, positions[b]) : 1e30;
+            double costBA = canBA? LodQuadricError(&q, positions[a]) : 1e30;
+
+            if (!canAB && !canBA) continue;
+
+            if (costAB <= costBA) collapses[collapseCount++] = (LodCollapse){ a, b, (float)costAB };
+            else collapses[collapseCount++] = (LodCollapse){ b, a, (float)costBA };
+        }
+
+        qsort(collapses, collapseCount, sizeof(LodCollapse), LodCompareCollapse);
+
+        memset(locked, 0, vertexCount*sizeof(unsigned char));
+        for (int v = 0; v < vertexCount; v++) remap[v] = v;
+
+        // Every collapse removes ~2 triangles, stop the pass once we are at target
+        int trianglesToRemove = (indexCount - targetIndexCount)/3;
+        int applied = 0;
+
+        for (int c = 0; (c < collapseCount) && (applied*2 < trianglesToRemove); c++)
+        {
+            LodCollapse collapse = collapses[c];
+
+            if (collapse.cost > maxError) break;
+            if (locked[collapse.from] || locked[collapse.to]) continue;
+            if (LodCollapseFlips(indices, adjOffset, adjTris, positions, collapse.from, collapse.to)) continue;
+
+            remap[collapse.from] = collapse.to;
+            LodQuadricAdd(&quadrics[collapse.to], &quadrics[collapse.from]);
+
+            // Lock the whole neighbourhood so flip tests of this pass stay valid
+            for (int k = adjOffset[collapse.from]; k < adjOffset[collapse.from + 1]; k++)
+            {
+                const unsigned int *tri = &indices[adjTris[k]*3];
+                locked[tri[0]] = locked[tri[1]] = locked[tri[2]] = 1;
+            }
+
+            if (collapse.cost > worstError) worstError = collapse.cost;
+            applied++;
+        }
+
+        if (applied == 0) break;
+
+        // Apply remap and drop degenerate triangles
+        int writeCount = 0;
+
+        for (int i = 0; i < indexCount; i += 3)
+        {
+            unsigned int a = remap[indices[i]];
+            unsigned int b = remap[indices[i + 1]];
+            unsigned int c = remap[indices[i + 2]];
+
+            if ((a == b) || (b == c) || (a == c)) continue;
+
+            indices[writeCount] = a;
+            indices[writeCount + 1] = b;
+            indices[writeCount + 2] = c;
+            writeCount += 3;
+        }
+
+        indexCount = writeCount;
+    }
+
+    RL_FREE(quadrics);
+    RL_FREE(boundary);
+    RL_FREE(locked);
+    RL_FREE(remap);
+    RL_FREE(adjOffset);
+    RL_FREE(adjTris);
+    RL_FREE(edges);
+    RL_FREE(collapses);
+
+    if (resultError != NULL) *resultError = sqrtf(worstError);
+
+    return indexCount;
+}
+
+// Generate simplified copy of a mesh (CPU data only, not uploaded)
+// NOTE: targetRatio is the fraction of triangles to keep, targetError is relative to mesh extent
+Mesh GenMeshSimplified(Mesh mesh, float targetRatio, float targetError, float *resultError)
+{
+    Mesh result = { 0 };
+
+    int indexCount = mesh.triangleCount*3;
+    unsigned int *indices = (unsigned int *)RL_MALLOC(indexCount*sizeof(unsigned int));
+    unsigned int *weld = (unsigned int *)RL_MALLOC(mesh.vertexCount*sizeof(unsigned int));
+
+    // Weld vertices with identical attributes, non indexed meshes would have no connectivity otherwise
+    int tableSize = 1;
+    while (tableSize < mesh.vertexCount*2) tableSize *= 2;
+    int *table = (int *)RL_MALLOC(tableSize*sizeof(int));
+    for (int i = 0; i < tableSize; i++) table[i] = -1;
+
+    for (int v = 0; v < mesh.vertexCount; v++)
+    {
+        unsigned int hash = 2166136261u;
+        const unsigned char *bytes = (const unsigned char *)&mesh.vertices[v*3];
+        for (int k = 0; k < 3*(int)sizeof(float); k++) hash = (hash ^ bytes[k])*16777619u;
+
+        int slot = hash & (tableSize - 1);
+        weld[v] = v;
+
+        while (table[slot] >= 0)
+        {
+            int o = table[slot];
+            bool equal = (memcmp(&mesh.vertices[o*3], &mesh.vertices[v*3], 3*sizeof(float)) == 0) &&
+                ((mesh.normals == NULL) || (memcmp(&mesh.normals[o*3], &mesh.normals[v*3], 3*sizeof(float)) == 0)) &&
+                ((mesh.texcoords == NULL) || (memcmp(&mesh.texcoords[o*2], &mesh.texcoords[v*2], 2*sizeof(float)) == 0)) &&
+                ((mesh.colors == NULL) || (memcmp(&mesh.colors[o*4], &mesh.colors[v*4], 4) == 0));
+
+            if (equal) { weld[v] = o; break; }
+            slot = (slot + 1) & (tableSize - 1);
+        }
+
+        if (weld[v] == (unsigned int)v) table[slot] = v;
+    }
+
+    RL_FREE(table);
+
+    for (int i = 0; i < indexCount; i++) indices[i] = weld[(mesh.indices != NULL)? mesh.indices[i] : i];
+
+    RL_FREE(weld);
+
+    // Normalize positions so error targets don't depend on model units
+    BoundingBox box = GetMeshBoundingBox(mesh);
+    Vector3 extent = Vector3Subtract(box.max, box.min);
+    float scale = fmaxf(extent.x, fmaxf(extent.y, extent.z));
+    scale = (scale > 0.0f)? 1.0f/scale : 1.0f;
+
+    Vector3 *positions = (Vector3 *)RL_MALLOC(mesh.vertexCount*sizeof(Vector3));
+    for (int v = 0; v < mesh.vertexCount; v++)
+    {
+        positions[v] = Vector3Scale(Vector3Subtract((Vector3){ mesh.vertices[v*3], mesh.vertices[v*3 + 1], mesh.vertices[v*3 + 2] }, box.min), scale);
+    }
+
+    int targetIndexCount = ((int)(mesh.triangleCount*targetRatio))*3;
+    indexCount = SimplifyIndices(indices, indexCount, positions, mesh.vertexCount, targetIndexCount, targetError, resultError);
+
+    RL_FREE(positions);
+
+    // Compact referenced vertices
+    int *vertexRemap = (int *)RL_MALLOC(mesh.vertexCount*sizeof(int));
+    for (int v = 0; v < mesh.vertexCount; v++) vertexRemap[v] = -1;
+
+    int vertexCount = 0;
+    for (int i = 0; i < indexCount; i++)
+    {
+        if (vertexRemap[indices[i]] < 0) vertexRemap[indices[i]] = vertexCount++;
+    }
+
+    // Meshes are indexed with unsigned short, fall back to a non indexed mesh when it doesn't fit
+    bool indexed = (vertexCount <= 65535);
+    if (!indexed) vertexCount = indexCount;
+
+    result.vertexCount = vertexCount;
+    result.triangleCount = indexCount/3;
+    result.vertices = (float *)RL_MALLOC(vertexCount*3*sizeof(float));
+    if (mesh.normals != NULL) result.normals = (float *)RL_MALLOC(vertexCount*3*sizeof(float));
+    if (mesh.texcoords != NULL) result.texcoords = (float *)RL_MALLOC(vertexCount*2*sizeof(float));
+    if (mesh.colors != NULL) result.colors = (unsigned char *)RL_MALLOC(vertexCount*4*sizeof(unsigned char));
+    if (indexed) result.indices = (unsigned short *)RL_MALLOC(indexCount*sizeof(unsigned short));
+
+    for (int i = 0; i < indexCount; i++)
+    {
+        int src = indices[i];
+        int dst = indexed? vertexRemap[src] : i;
+
+        if (indexed) result.indices[i] = (unsigned short)dst;
+
+        memcpy(&result.vertices[dst*3], &mesh.vertices[src*3], 3*sizeof(float));
+        if (mesh.normals != NULL) memcpy(&result.normals[dst*3], &mesh.normals[src*3], 3*sizeof(float));
+        if (mesh.texcoords != NULL) memcpy(&result.texcoords[dst*2], &mesh.texcoords[src*2], 2*sizeof(float));
+        if (mesh.colors != NULL) memcpy(&result.colors[dst*4], &mesh.colors[src*4], 4);
+    }
+
+    RL_FREE(vertexRemap);
+    RL_FREE(indices);
+
+    return result;
+}
+
+// Generate LOD chain for a model, levels are simplified from the source meshes and uploaded to GPU
+// NOTE: Materials are shared with the source model
+ModelLod GenModelLod(Model model, int levelCount)
+{
+    ModelLod lod = { 0 };
+
+    if (levelCount > MAX_LOD_LEVELS) levelCount = MAX_LOD_LEVELS;
+    if (levelCount < 1) levelCount = 1;
+
+    BoundingBox box = GetModelBoundingBox(model);
+    lod.radius = Vector3Length(Vector3Subtract(box.max, box.min))*0.5f;
+    lod.levelCount = levelCount;
+    lod.levels[0] = model;
+
+    for (int m = 0; m < model.meshCount; m++) lod.triangleCount[0] += model.meshes[m].triangleCount;
+
+    for (int l = 1; l < levelCount; l++)
+    {
+        Model level = model;
+        level.meshes = (Mesh *)RL_CALLOC(model.meshCount, sizeof(Mesh));
+
+        float error = 0.0f;
+
+        for (int m = 0; m < model.meshCount; m++)
+        {
+            float meshError = 0.0f;
+
+            level.meshes[m] = GenMeshSimplified(model.meshes[m], lodRatio[l], lodError[l], &meshError);
+            UploadMesh(&level.meshes[m], false);
+
+            lod.triangleCount[l] += level.meshes[m].triangleCount;
+            if (meshError > error) error = meshError;
+        }
+
+        lod.levels[l] = level;
+
+        TRACELOG(LOG_INFO, "LOD: Level %i: %i -> %i triangles (%.1f%%), error %.4f", l, lod.triangleCount[0], lod.triangleCount[l],
+            (lod.triangleCount[0] > 0)? 100.0f*lod.triangleCount[l]/lod.triangleCount[0] : 0.0f, error);
+    }
+
+    // Last level is used for anything smaller than previous threshold
+    for (int l = 0; l < levelCount; l++) lod.screenSize[l] = (l == levelCount - 1)? 0.0f : lodScreenSize[l];
+
+    return lod;
+}
+
+// Unload LOD chain generated levels (source model is not unloaded)
+void UnloadModelLod(ModelLod *lod)
+{
+    for (int l = 1; l < lod->levelCount; l++)
+    {
+        for (int m = 0; m < lod->levels[l].meshCount; m++) UnloadMesh(lod->levels[l].meshes[m]);
+        RL_FREE(lod->levels[l].meshes);
+    }
+
+    lod->levelCount = 0;
+}
+
+// Get projected bounding sphere size as a fraction of screen height
+float GetModelLodScreenSize(const ModelLod *lod, Vector3 position, float scale, Camera camera)
+{
+    float distance = Vector3Distance(position, camera.position);
+    float radius = lod->radius*scale;
+
+    if (distance <= radius) return 1.0f;
+
+    return radius/(distance*tanf(camera.fovy*0.5f*DEG2RAD));
+}
+
+// Select LOD level for a projected screen size, current level only changes once size leaves the hysteresis band
+int SelectModelLod(const ModelLod *lod, float screenSize, int currentLevel)
+{
+    int level = currentLevel;
+
+    if (level >= lod->levelCount) level = lod->levelCount - 1;
+    if (level < 0) level = 0;
+
+    while ((level < lod->levelCount - 1) && (screenSize < lod->screenSize[level]*(1.0f - LOD_HYSTERESIS))) level++;
+    while ((level > 0) && (screenSize > lod->screenSize[level - 1]*(1.0f + LOD_HYSTERESIS))) level--;
+
+    return level;
+}
+
+// Benchmark mesh: bumpy UV sphere with a texcoord seam, CPU data only
+static Mesh GenLodBenchmarkMesh(int rings, int slices)
+{
+    Mesh mesh = { 0 };
+
+    mesh.vertexCount = (rings + 1)*(slices + 1);
+    mesh.triangleCount = rings*slices*2;
+    mesh.vertices = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+    mesh.normals = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+    mesh.texcoords = (float *)RL_MALLOC(mesh.vertexCount*2*sizeof(float));
+    mesh.indices = (unsigned short *)RL_MALLOC(mesh.triangleCount*3*sizeof(unsigned short));
+
+    for (int r = 0; r <= rings; r++)
+    {
+        for (int s = 0; s <= slices; s++)
+        {
+            int v = r*(slices + 1) + s;
+            float theta = PI*r/rings, phi = 2.0f*PI*s/slices;
+            Vector3 direction = { sinf(theta)*cosf(phi), cosf(theta), sinf(theta)*sinf(phi) };
+            float radius = 1.0f + 0.1f*sinf(5.0f*theta)*sinf(4.0f*phi);
+
+            mesh.vertices[v*3] = direction.x*radius;
+            mesh.vertices[v*3 + 1] = direction.y*radius;
+            mesh.vertices[v*3 + 2] = direction.z*radius;
+            mesh.normals[v*3] = direction.x;
+            mesh.normals[v*3 + 1] = direction.y;
+            mesh.normals[v*3 + 2] = direction.z;
+            mesh.texcoords[v*2] = (float)s/slices;
+            mesh.texcoords[v*2 + 1] = (float)r/rings;
+        }
+    }
+
+    for (int r = 0, i = 0; r < rings; r++)
+    {
+        for (int s = 0; s < slices; s++)
+        {
+            unsigned short a = (unsigned short)(r*(slices + 1) + s);
+            unsigned short b = (unsigned short)(a + slices + 1);
+
+            mesh.indices[i++] = a; mesh.indices[i++] = b; mesh.indices[i++] = a + 1;
+            mesh.indices[i++] = a + 1; mesh.indices[i++] = b; mesh.indices[i++] = b + 1;
+        }
+    }
+
+    return mesh;
+}
+
+// Unload CPU mesh data of a mesh that was never uploaded
+static void UnloadLodBenchmarkMesh(Mesh *mesh)
+{
+    RL_FREE(mesh->vertices);
+    RL_FREE(mesh->normals);
+    RL_FREE(mesh->texcoords);
+    RL_FREE(mesh->colors);
+    RL_FREE(mesh->indices);
+
+    memset(mesh, 0, sizeof(Mesh));
+}
+
+// Benchmark LOD generation and selection, logs triangle reduction, error and time per level
+// NOTE: Runs headless on a generated mesh with the GenModelLod() level targets, returns the number of levels
+// that miss their triangle target, exceed their error, leave or shrink the source bounds, plus selection checks
+// where SelectModelLod() pops inside the hysteresis band or disagrees with the thresholds outside of it
+int BenchmarkMeshLod(int rings, int slices)
+{
+    int failures = 0;
+    Mesh source = GenLodBenchmarkMesh(rings, slices);
+    BoundingBox sourceBox = GetMeshBoundingBox(source);
+    Vector3 extent = Vector3Subtract(sourceBox.max, sourceBox.min);
+    float size = fmaxf(extent.x, fmaxf(extent.y, extent.z));
+    int previous = source.triangleCount;
+
+    for (int l = 1; l < MAX_LOD_LEVELS; l++)
+    {
+        float error = 0.0f;
+
+        double start = GetTimerSeconds();
+        Mesh level = GenMeshSimplified(source, lodRatio[l], lodError[l], &error);
+        double time = GetTimerSeconds() - start;
+
+        // Collapses keep source vertex positions, so level bounds stay inside the source bounds
+        // and may only shrink by the level error (relative to mesh extent)
+        BoundingBox box = GetMeshBoundingBox(level);
+        float shrink = fmaxf(fmaxf(box.min.x - sourceBox.min.x, box.min.y - sourceBox.min.y), box.min.z - sourceBox.min.z);
+        shrink = fmaxf(shrink, fmaxf(fmaxf(sourceBox.max.x - box.max.x, sourceBox.max.y - box.max.y), sourceBox.max.z - box.max.z));
+        float grow = fmaxf(fmaxf(sourceBox.min.x - box.min.x, sourceBox.min.y - box.min.y), sourceBox.min.z - box.min.z);
+        grow = fmaxf(grow, fmaxf(fmaxf(box.max.x - sourceBox.max.x, box.max.y - sourceBox.max.y), box.max.z - sourceBox.max.z));
+
+        int target = (int)(source.triangleCount*lodRatio[l]);
+        bool failed = (level.triangleCount >= previous) || (level.triangleCount > target) || (error > lodError[l]) ||
+            (grow > 0.0f) || (shrink > lodError[l]*size);
+
+        if (failed) failures++;
+
+        TRACELOG(failed? LOG_WARNING : LOG_INFO, "LOD: Level %i: %i -> %i triangles (%.1f%%, target %i), error %.4f (max %.2f), bounds shrink %.4f, %.2f ms",
+            l, source.triangleCount, level.triangleCount, 100.0f*level.triangleCount/source.triangleCount, target, error, lodError[l], shrink/size, time*1000.0);
+
+        previous = level.triangleCount;
+        UnloadLodBenchmarkMesh(&level);
+    }
+
+    UnloadLodBenchmarkMesh(&source);
+
+    // Selection: thresholds as set by GenModelLod()
+    ModelLod lod = { 0 };
+    lod.levelCount = MAX_LOD_LEVELS;
+    for (int l = 0; l < MAX_LOD_LEVELS; l++) lod.screenSize[l] = (l == MAX_LOD_LEVELS - 1)? 0.0f : lodScreenSize[l];
+
+    int selectionFailures = 0;
+    int checks = 0;
+
+    for (int l = 0; l < MAX_LOD_LEVELS - 1; l++)
+    {
+        float threshold = lod.screenSize[l];
+
+        // Sizes jittering inside the band keep the current level, from either side
+        for (int side = 0; side < 2; side++)
+        {
+            int level = l + side;
+
+            for (int k = 0; k < 64; k++)
+            {
+                float jitter = ((k%2)? 0.9f : -0.9f)*LOD_HYSTERESIS*((k%7) + 1)/7.0f;
+                level = SelectModelLod(&lod, threshold*(1.0f + jitter), level);
+            }
+
+            if (level != l + side) selectionFailures++;
+            checks++;
+        }
+
+        // Sizes leaving the band switch level
+        if (SelectModelLod(&lod, threshold*(1.0f - 1.1f*LOD_HYSTERESIS), l) != l + 1) selectionFailures++;
+        if (SelectModelLod(&lod, threshold*(1.0f + 1.1f*LOD_HYSTERESIS), l + 1) != l) selectionFailures++;
+        checks += 2;
+    }
+
+    // Sweeps down and up: level only moves one way, and outside every band it matches the thresholds from any current level
+    for (int direction = 0; direction < 2; direction++)
+    {
+        int level = (direction == 0)? 0 : MAX_LOD_LEVELS - 1;
+
+        for (int k = 0; k <= 400; k++)
+        {
+            float screenSize = powf(10.0f, (direction == 0)? -3.0f*k/400 : -3.0f + 3.0f*k/400);
+            int next = SelectModelLod(&lod, screenSize, level);
+
+            if ((direction == 0)? (next < level) : (next > level)) selectionFailures++;
+            level = next;
+
+            int expected = 0;
+            bool inBand = false;
+            for (int l = 0; l < MAX_LOD_LEVELS - 1; l++)
+            {
+                if (screenSize < lod.screenSize[l]) expected = l + 1;
+                if (fabsf(screenSize - lod.screenSize[l]) <= lod.screenSize[l]*LOD_HYSTERESIS) inBand = true;
+            }
+
+            if (!inBand)
+            {
+                for (int current = 0; current < MAX_LOD_LEVELS; current++) if (SelectModelLod(&lod, screenSize, current) != expected) selectionFailures++;
+            }
+
+            checks += 1 + (inBand? 0 : MAX_LOD_LEVELS);
+        }
+    }
+
+    TRACELOG((selectionFailures == 0)? LOG_INFO : LOG_WARNING, "LOD: Selection: %i checks, %i failed", checks, selectionFailures);
+
+    return failures + selectionFailures;
+}
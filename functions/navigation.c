@@ -0,0 +1,1399 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector2 functionality
+
+#include <stdlib.h>         // Required for: malloc(), calloc(), realloc(), free(), rand()
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: fabsf(), fminf(), floorf()
+#include <pthread.h>        // Required for: pthread_create(), pthread_join(), pthread_mutex_t, pthread_cond_t
+
+// Navigation over cubicmap cells: hierarchical A* for single agents and flow fields for crowds
+// NOTE: Cells are grouped in square clusters, cells where two clusters connect become portal nodes.
+// Intra-cluster paths between portals are found once at load and stored, so a query is an A* over
+// portals plus two small searches for start and goal clusters, and path cells are copied from storage.
+// Portals of a cluster connected inside it form a group, an A* over groups runs first and the portal
+// search only enters clusters around its route.
+// Moves are 8-connected without corner cutting, neighbour floors within step height are step-ups.
+
+#define NAV_DIAGONAL_COST       1.41421356f
+#define NAV_HEURISTIC_WEIGHT    1.2f        // Weighted A* over portals, paths stay within a few percent of optimal
+#define NAV_MAX_THREADS         16
+#define NAV_INFINITY            3.402823466e+38f
+
+#define NAV_EDGE_START          -2          // Abstract search edge from the start cell
+#define NAV_DIRECTION_NONE      255         // Flow field cell without direction (goal or unreachable)
+
+static const int navDx[8] = { 1, -1, 0, 0, 1, 1, -1, -1 };
+static const int navDz[8] = { 0, 0, 1, -1, 1, -1, 1, -1 };
+static const Vector2 navDirections[8] = {       // Unit vectors of navDx/navDz moves
+    { 1.0f, 0.0f }, { -1.0f, 0.0f }, { 0.0f, 1.0f }, { 0.0f, -1.0f },
+    { 0.70710678f, 0.70710678f }, { 0.70710678f, -0.70710678f }, { -0.70710678f, 0.70710678f }, { -0.70710678f, -0.70710678f }
+};
+
+typedef struct NavNode {
+    int cell;                   // Portal cell index (z*width + x)
+    int x;                      // Portal cell coordinates, heuristic without divisions
+    int z;
+    int cluster;
+    int group;                  // Portal group, see NavGroup
+    int firstEdge;              // Edges are stored per node, see NavGrid.edges
+    int edgeCount;
+} NavNode;
+
+// Portals of a cluster joined by stored paths, node of the group pass
+typedef struct NavGroup {
+    int cluster;
+    int x;                      // Cluster coordinates
+    int z;
+    int firstLink;              // Links to groups behind portal crossings, see NavGrid.groupLinks
+    int linkCount;
+} NavGroup;
+
+typedef struct NavEdge {
+    int to;                     // Destination node
+    float cost;
+    int pathFirst;              // Path cells (destination included, source excluded) in NavGrid.pathCells
+    int pathLength;
+} NavEdge;
+
+// Binary min-heap with lazy deletion, entries are (cost, value)
+typedef struct NavHeap {
+    float *keys;
+    int *values;
+    int count;
+    int capacity;
+} NavHeap;
+
+typedef struct NavGrid {
+    int width;
+    int height;
+    int clusterSize;
+    int clustersX;
+    int clustersZ;
+    unsigned char *moves;       // Passable directions per cell (bit per navDx/navDz entry)
+    int *cellComponent;         // Connected region per cell, queries between regions fail early (-1 if not walkable)
+
+    int *cellNode;              // Cell -> portal node (-1 if not a portal)
+    NavNode *nodes;
+    int nodeCount;
+    int *clusterFirstNode;      // Nodes are sorted by cluster, clusterFirstNode[clusterCount] == nodeCount
+    NavGroup *groups;
+    int groupCount;
+    int *groupLinks;
+    NavEdge *edges;
+    int edgeCount;
+    int *pathCells;
+    int pathCellCount;
+
+    // Query scratch data
+    // WARNING: Queries on the same NavGrid must not run concurrently
+    float *nodeCost;
+    int *nodeParent;
+    int *nodeParentEdge;
+    unsigned int *nodeStamp;
+    unsigned int stamp;
+    NavHeap heap;
+    float *startCost;           // Local search from start, cluster cells
+    int *startPred;
+    float *goalCost;            // Local search from goal, cluster cells
+    int *goalPred;
+    NavHeap localHeap;
+    float *groupCost;           // Group pass
+    int *groupParent;
+    unsigned int *groupStamp;
+    unsigned int *groupGoal;    // Groups reachable from the goal, marked with the query stamp
+    unsigned int *clusterCorridor;  // Clusters the portal search may enter, marked with the query stamp
+} NavGrid;
+
+typedef struct NavFlowField {
+    int width;
+    int height;
+    int goalX;
+    int goalZ;
+    float *cost;                // Path cost to goal per cell
+    unsigned char *direction;   // Move direction per cell (navDx/navDz index), NAV_DIRECTION_NONE if none
+    struct NavFlowWorkers *workers; // Worker threads and job scratch, started by the first update
+} NavFlowField;
+
+//----------------------------------------------------------------------------------
+// Heap
+//----------------------------------------------------------------------------------
+static NavHeap LoadNavHeap(int capacity)
+{
+    NavHeap heap = { 0 };
+
+    heap.capacity = capacity;
+    heap.keys = (float *)RL_MALLOC(capacity*sizeof(float));
+    heap.values = (int *)RL_MALLOC(capacity*sizeof(int));
+
+    return heap;
+}
+
+static void UnloadNavHeap(NavHeap *heap)
+{
+    RL_FREE(heap->keys);
+    RL_FREE(heap->values);
+}
+
+static void PushNavHeap(NavHeap *heap, float key, int value)
+{
+    if (heap->count == heap->capacity)
+    {
+        heap->capacity *= 2;
+        heap->keys = (float *)RL_REALLOC(heap->keys, heap->capacity*sizeof(float));
+        heap->values = (int *)RL_REALLOC(heap->values, heap->capacity*sizeof(int));
+    }
+
+    int i = heap->count++;
+    while (i > 0)
+    {
+        int parent = (i - 1)/2;
+        if (heap->keys[parent] <= key) break;
+
+        heap->keys[i] = heap->keys[parent];
+        heap->values[i] = heap->values[parent];
+        i = parent;
+    }
+
+    heap->keys[i] = key;
+    heap->values[i] = value;
+}
+
+static int PopNavHeap(NavHeap *heap, float *key)
+{
+    int result = heap->values[0];
+    *key = heap->keys[0];
+
+    float lastKey = heap->keys[--heap->count];
+    int lastValue = heap->values[heap->count];
+    int i = 0;
+
+    while (true)
+    {
+        int child = 2*i + 1;
+        if (child >= heap->count) break;
+        if ((child + 1 < heap->count) && (heap->keys[child + 1] < heap->keys[child])) child++;
+        if (lastKey <= heap->keys[child]) break;
+
+        heap->keys[i] = heap->keys[child];
+        heap->values[i] = heap->values[child];
+        i = child;
+    }
+
+    heap->keys[i] = lastKey;
+    heap->values[i] = lastValue;
+
+    return result;
+}
+
+//----------------------------------------------------------------------------------
+// Grid helpers
+//----------------------------------------------------------------------------------
+
+// Get cluster cell rectangle
+static void GetNavClusterRect(const NavGrid *nav, int cluster, int *x0, int *z0, int *w, int *h)
+{
+    *x0 = (cluster%nav->clustersX)*nav->clusterSize;
+    *z0 = (cluster/nav->clustersX)*nav->clusterSize;
+    *w = (*x0 + nav->clusterSize <= nav->width)? nav->clusterSize : nav->width - *x0;
+    *h = (*z0 + nav->clusterSize <= nav->height)? nav->clusterSize : nav->height - *z0;
+}
+
+// Get cluster of a cell
+static int GetNavCellCluster(const NavGrid *nav, int cell)
+{
+    return ((cell/nav->width)/nav->clusterSize)*nav->clustersX + (cell%nav->width)/nav->clusterSize;
+}
+
+// Dijkstra restricted to a cluster from one or more seed cells, results indexed by cluster local cell
+// NOTE: pred holds the next cell towards the seeds (global index), -1 for seeds and unreached cells
+static void SearchNavCluster(const NavGrid *nav, int cluster, const int *seeds, const float *seedCosts, int seedCount, float *cost, int *pred, NavHeap *heap)
+{
+    int x0, z0, w, h;
+    GetNavClusterRect(nav, cluster, &x0, &z0, &w, &h);
+
+    for (int i = 0; i < w*h; i++) { cost[i] = NAV_INFINITY; pred[i] = -1; }
+
+    heap->count = 0;
+    for (int s = 0; s < seedCount; s++)
+    {
+        int local = (seeds[s]/nav->width - z0)*w + (seeds[s]%nav->width - x0);
+
+        if (seedCosts[s] < cost[local])
+        {
+            cost[local] = seedCosts[s];
+            PushNavHeap(heap, seedCosts[s], local);
+        }
+    }
+
+    while (heap->count > 0)
+    {
+        float c;
+        int local = PopNavHeap(heap, &c);
+
+        if (c > cost[local]) continue;
+
+        int x = x0 + local%w;
+        int z = z0 + local/w;
+        unsigned char moves = nav->moves[z*nav->width + x];
+
+        for (int d = 0; d < 8; d++)
+        {
+            if (!(moves & (1 << d))) continue;
+
+            int nx = x + navDx[d];
+            int nz = z + navDz[d];
+            if ((nx < x0) || (nz < z0) || (nx >= x0 + w) || (nz >= z0 + h)) continue;
+
+            int next = (nz - z0)*w + (nx - x0);
+            float nc = c + ((d < 4)? 1.0f : NAV_DIAGONAL_COST);
+
+            if (nc < cost[next])
+            {
+                cost[next] = nc;
+                pred[next] = z*nav->width + x;
+                PushNavHeap(heap, nc, next);
+            }
+        }
+    }
+}
+
+// Octile distance between a portal and a cell, A* heuristic
+static float GetNavDistance(const NavNode *node, int x, int z)
+{
+    float dx = fabsf((float)(node->x - x));
+    float dz = fabsf((float)(node->z - z));
+
+    return (fmaxf(dx, dz) + (NAV_DIAGONAL_COST - 1.0f)*fminf(dx, dz))*NAV_HEURISTIC_WEIGHT;
+}
+
+// Manhattan distance between a group cluster and the goal cluster, group pass heuristic
+// NOTE: Ties between staircase routes are broken by distance to the start-goal line, so routes stay near it
+static float GetNavClusterDistance(const NavGroup *group, int goalX, int goalZ, int lineX, int lineZ)
+{
+    int dx = group->x - goalX;
+    int dz = group->z - goalZ;
+
+    return (float)(abs(dx) + abs(dz))*NAV_HEURISTIC_WEIGHT + 0.001f*(float)abs(dx*lineZ - dz*lineX);
+}
+
+//----------------------------------------------------------------------------------
+// Load/Unload
+//----------------------------------------------------------------------------------
+
+// Edge being built, sorted by source node before storing
+typedef struct NavBuildEdge {
+    int from;
+    NavEdge edge;
+} NavBuildEdge;
+
+// Add edge to build list
+static void AddNavBuildEdge(NavBuildEdge **edges, int *count, int *capacity, int from, NavEdge edge)
+{
+    if (*count == *capacity)
+    {
+        *capacity = (*capacity > 0)? *capacity*2 : 1024;
+        *edges = (NavBuildEdge *)RL_REALLOC(*edges, *capacity*sizeof(NavBuildEdge));
+    }
+
+    (*edges)[(*count)++] = (NavBuildEdge){ from, edge };
+}
+
+// Add path cells to path storage, returns first cell index
+static int AddNavPathCells(NavGrid *nav, int *capacity, const int *cells, int count)
+{
+    if (nav->pathCellCount + count > *capacity)
+    {
+        while (nav->pathCellCount + count > *capacity) *capacity = (*capacity > 0)? *capacity*2 : 4096;
+        nav->pathCells = (int *)RL_REALLOC(nav->pathCells, *capacity*sizeof(int));
+    }
+
+    int first = nav->pathCellCount;
+    for (int i = 0; i < count; i++) nav->pathCells[first + i] = cells[i];
+    nav->pathCellCount += count;
+
+    return first;
+}
+
+// Load navigation grid from cubicmap cells
+// NOTE: Heights are in world units, a cell is walkable with agentHeight headroom and neighbour
+// floors within maxStepHeight are reachable (step-ups), clusterSize is clamped to [4, 64]
+NavGrid LoadNavGrid(const CubicmapGrid *grid, int clusterSize, float agentHeight, float maxStepHeight)
+{
+    NavGrid nav = { 0 };
+
+    if (clusterSize < 4) clusterSize = 4;
+    if (clusterSize > 64) clusterSize = 64;
+
+    nav.width = grid->width;
+    nav.height = grid->height;
+    nav.clusterSize = clusterSize;
+    nav.clustersX = (grid->width + clusterSize - 1)/clusterSize;
+    nav.clustersZ = (grid->height + clusterSize - 1)/clusterSize;
+
+    int cellCount = nav.width*nav.height;
+    int clusterCount = nav.clustersX*nav.clustersZ;
+    float headroom = agentHeight*255.0f/grid->cubeSize.y;
+    float step = maxStepHeight*255.0f/grid->cubeSize.y;
+
+    // Passable moves: orthogonal moves first, diagonal moves need both orthogonal moves around them
+    nav.moves = (unsigned char *)RL_CALLOC(cellCount, 1);
+
+    for (int z = 0; z < nav.height; z++)
+    {
+        for (int x = 0; x < nav.width; x++)
+        {
+            int f = grid->floor[z*nav.width + x];
+            int c = grid->ceiling[z*nav.width + x];
+
+            if ((float)(c - f) < headroom) continue;
+
+            for (int d = 0; d < 4; d++)
+            {
+                int nx = x + navDx[d], nz = z + navDz[d];
+                if ((nx < 0) || (nz < 0) || (nx >= nav.width) || (nz >= nav.height)) continue;
+
+                int nf = grid->floor[nz*nav.width + nx];
+                int nc = grid->ceiling[nz*nav.width + nx];
+
+                // Neighbour needs headroom, the opening between both cells too
+                if (((float)(nc - nf) >= headroom) && (fabsf((float)(nf - f)) <= step) && ((float)(((c < nc)? c : nc) - ((f > nf)? f : nf)) >= headroom)) nav.moves[z*nav.width + x] |= (1 << d);
+            }
+        }
+    }
+
+    for (int z = 0; z < nav.height; z++)
+    {
+        for (int x = 0; x < nav.width; x++)
+        {
+            unsigned char moves = nav.moves[z*nav.width + x];
+
+            for (int d = 4; d < 8; d++)
+            {
+                int ox = (navDx[d] > 0)? 0 : 1;     // Orthogonal move along X
+                int oz = (navDz[d] > 0)? 2 : 3;     // Orthogonal move along Z
+
+                if (!(moves & (1 << ox)) || !(moves & (1 << oz))) continue;
+
+                unsigned char movesX = nav.moves[z*nav.width + x + navDx[d]];
+                unsigned char movesZ = nav.moves[(z + navDz[d])*nav.width + x];
+
+                if ((movesX & (1 << oz)) && (movesZ & (1 << ox))) nav.moves[z*nav.width + x] |= (1 << d);
+            }
+        }
+    }
+
+    // Connected regions, flood fill over passable moves
+    nav.cellComponent = (int *)RL_MALLOC(cellCount*sizeof(int));
+    for (int i = 0; i < cellCount; i++) nav.cellComponent[i] = -1;
+
+    int *stack = (int *)RL_MALLOC(cellCount*sizeof(int));
+    int componentCount = 0;
+
+    for (int i = 0; i < cellCount; i++)
+    {
+        if ((nav.moves[i] == 0) || (nav.cellComponent[i] != -1)) continue;
+
+        int top = 0;
+        stack[top++] = i;
+        nav.cellComponent[i] = componentCount;
+
+        while (top > 0)
+        {
+            int cell = stack[--top];
+
+            for (int d = 0; d < 4; d++)
+            {
+                int next = cell + navDz[d]*nav.width + navDx[d];
+
+                if ((nav.moves[cell] & (1 << d)) && (nav.cellComponent[next] == -1))
+                {
+                    nav.cellComponent[next] = componentCount;
+                    stack[top++] = next;
+                }
+            }
+        }
+
+        componentCount++;
+    }
+
+    RL_FREE(stack);
+
+    // Portals: middle cell of each run of passable crossings between two clusters
+    nav.cellNode = (int *)RL_MALLOC(cellCount*sizeof(int));
+    for (int i = 0; i < cellCount; i++) nav.cellNode[i] = -1;
+
+    int pairCount = 0, pairCapacity = 1024;
+    int *pairs = (int *)RL_MALLOC(pairCapacity*2*sizeof(int));
+
+    for (int axis = 0; axis < 2; axis++)
+    {
+        // axis 0: borders between cluster columns (crossing +X), axis 1: between cluster rows (crossing +Z)
+        int borders = (axis == 0)? nav.clustersX - 1 : nav.clustersZ - 1;
+        int length = (axis == 0)? nav.height : nav.width;
+
+        for (int b = 0; b < borders; b++)
+        {
+            int edge = (b + 1)*clusterSize - 1;     // Last cell before the border
+            int runStart = -1;
+
+            for (int i = 0; i <= length; i++)
+            {
+                // Runs are also split at cluster boundaries along the border
+                bool open = false;
+                if ((i < length) && !((runStart >= 0) && (i%clusterSize == 0)))
+                {
+                    int cell = (axis == 0)? i*nav.width + edge : edge*nav.width + i;
+                    open = (nav.moves[cell] & (1 << ((axis == 0)? 0 : 2))) != 0;
+                }
+
+                if (open && (runStart < 0)) runStart = i;
+                else if (!open && (runStart >= 0))
+                {
+                    int mid = (runStart + i - 1)/2;
+                    int a = (axis == 0)? mid*nav.width + edge : edge*nav.width + mid;
+                    int c = (axis == 0)? a + 1 : a + nav.width;
+
+                    if (pairCount == pairCapacity)
+                    {
+                        pairCapacity *= 2;
+                        pairs = (int *)RL_REALLOC(pairs, pairCapacity*2*sizeof(int));
+                    }
+                    pairs[pairCount*2] = a;
+                    pairs[pairCount*2 + 1] = c;
+                    pairCount++;
+
+                    nav.cellNode[a] = nav.cellNode[c] = 0;
+                    runStart = -1;
+
+                    // Cell at a cluster boundary starts a new run
+                    if ((i < length) && (i%clusterSize == 0)) i--;
+                }
+            }
+        }
+    }
+
+    // Number nodes cluster by cluster, so nodes of a cluster are contiguous
+    nav.clusterFirstNode = (int *)RL_MALLOC((clusterCount + 1)*sizeof(int));
+    for (int cluster = 0; cluster < clusterCount; cluster++)
+    {
+        int x0, z0, w, h;
+        GetNavClusterRect(&nav, cluster, &x0, &z0, &w, &h);
+
+        nav.clusterFirstNode[cluster] = nav.nodeCount;
+        for (int z = z0; z < z0 + h; z++)
+        {
+            for (int x = x0; x < x0 + w; x++)
+            {
+                if (nav.cellNode[z*nav.width + x] == 0) nav.cellNode[z*nav.width + x] = nav.nodeCount++ + 1;
+            }
+        }
+    }
+    nav.clusterFirstNode[clusterCount] = nav.nodeCount;
+
+    nav.nodes = (NavNode *)RL_CALLOC(nav.nodeCount + 2, sizeof(NavNode));
+    for (int i = 0; i < cellCount; i++)
+    {
+        if (nav.cellNode[i] > 0)
+        {
+            nav.cellNode[i]--;
+            nav.nodes[nav.cellNode[i]].cell = i;
+            nav.nodes[nav.cellNode[i]].x = i%nav.width;
+            nav.nodes[nav.cellNode[i]].z = i/nav.width;
+            nav.nodes[nav.cellNode[i]].cluster = GetNavCellCluster(&nav, i);
+        }
+    }
+
+    // Edges: crossings between paired portals and stored shortest paths between portals of a cluster
+    NavBuildEdge *buildEdges = NULL;
+    int buildCount = 0, buildCapacity = 0, pathCapacity = 0;
+
+    for (int p = 0; p < pairCount; p++)
+    {
+        int a = nav.cellNode[pairs[p*2]], c = nav.cellNode[pairs[p*2 + 1]];
+
+        AddNavBuildEdge(&buildEdges, &buildCount, &buildCapacity, a, (NavEdge){ c, 1.0f, AddNavPathCells(&nav, &pathCapacity, &pairs[p*2 + 1], 1), 1 });
+        AddNavBuildEdge(&buildEdges, &buildCount, &buildCapacity, c, (NavEdge){ a, 1.0f, AddNavPathCells(&nav, &pathCapacity, &pairs[p*2], 1), 1 });
+    }
+
+    RL_FREE(pairs);
+
+    int clusterCells = clusterSize*clusterSize;
+    float *cost = (float *)RL_MALLOC(clusterCells*sizeof(float));
+    int *pred = (int *)RL_MALLOC(clusterCells*sizeof(int));
+    int *path = (int *)RL_MALLOC(clusterCells*sizeof(int));
+    NavHeap heap = LoadNavHeap(clusterCells*8);
+
+    for (int cluster = 0; cluster < clusterCount; cluster++)
+    {
+        int x0, z0, w, h;
+        GetNavClusterRect(&nav, cluster, &x0, &z0, &w, &h);
+
+        for (int a = nav.clusterFirstNode[cluster]; a < nav.clusterFirstNode[cluster + 1]; a++)
+        {
+            // Search from destination portal 'a', pred then walks from any cell towards 'a'
+            float zero = 0.0f;
+            SearchNavCluster(&nav, cluster, &nav.nodes[a].cell, &zero, 1, cost, pred, &heap);
+
+            for (int b = nav.clusterFirstNode[cluster]; b < nav.clusterFirstNode[cluster + 1]; b++)
+            {
+                int cell = nav.nodes[b].cell;
+                int local = (cell/nav.width - z0)*w + (cell%nav.width - x0);
+
+                if ((b == a) || (cost[local] == NAV_INFINITY)) continue;
+
+                // Edge b -> a, path cells after b up to a
+                int length = 0;
+                for (int next = pred[local]; next != -1; next = pred[(next/nav.width - z0)*w + (next%nav.width - x0)]) path[length++] = next;
+
+                AddNavBuildEdge(&buildEdges, &buildCount, &buildCapacity, b, (NavEdge){ a, cost[local], AddNavPathCells(&nav, &pathCapacity, path, length), length });
+            }
+        }
+    }
+
+    RL_FREE(cost);
+    RL_FREE(pred);
+    RL_FREE(path);
+    UnloadNavHeap(&heap);
+
+    // Store edges grouped by source node
+    nav.edgeCount = buildCount;
+    nav.edges = (NavEdge *)RL_MALLOC((buildCount + 1)*sizeof(NavEdge));
+
+    for (int i = 0; i < buildCount; i++) nav.nodes[buildEdges[i].from].edgeCount++;
+    for (int i = 0, first = 0; i < nav.nodeCount; i++) { nav.nodes[i].firstEdge = first; first += nav.nodes[i].edgeCount; nav.nodes[i].edgeCount = 0; }
+    for (int i = 0; i < buildCount; i++)
+    {
+        NavNode *node = &nav.nodes[buildEdges[i].from];
+        nav.edges[node->firstEdge + node->edgeCount++] = buildEdges[i].edge;
+    }
+
+    RL_FREE(buildEdges);
+
+    // Portal groups: union of portals joined by stored paths inside their cluster (edges are symmetric)
+    int *root = (int *)RL_MALLOC((nav.nodeCount + 1)*sizeof(int));
+    for (int i = 0; i < nav.nodeCount; i++) root[i] = i;
+
+    for (int i = 0; i < nav.nodeCount; i++)
+    {
+        for (int e = nav.nodes[i].firstEdge; e < nav.nodes[i].firstEdge + nav.nodes[i].edgeCount; e++)
+        {
+            int to = nav.edges[e].to;
+            if (nav.nodes[to].cluster != nav.nodes[i].cluster) continue;
+
+            int ra = i, rb = to;
+            while (root[ra] != ra) { root[ra] = root[root[ra]]; ra = root[ra]; }
+            while (root[rb] != rb) { root[rb] = root[root[rb]]; rb = root[rb]; }
+            if (ra != rb) root[(ra > rb)? ra : rb] = (ra < rb)? ra : rb;
+        }
+    }
+
+    // Roots are the lowest node of their group, so group ids follow node order
+    nav.groups = (NavGroup *)RL_CALLOC(nav.nodeCount + 1, sizeof(NavGroup));
+    for (int i = 0; i < nav.nodeCount; i++)
+    {
+        int r = i;
+        while (root[r] != r) r = root[r];
+
+        if (r == i)
+        {
+            int cluster = nav.nodes[i].cluster;
+
+            nav.nodes[i].group = nav.groupCount;
+            nav.groups[nav.groupCount++] = (NavGroup){ cluster, cluster%nav.clustersX, cluster/nav.clustersX, 0, 0 };
+        }
+        else nav.nodes[i].group = nav.nodes[r].group;
+    }
+
+    RL_FREE(root);
+
+    // Group links from portal crossings, stored grouped by source group
+    int linkTotal = 0;
+    for (int i = 0; i < nav.nodeCount; i++)
+    {
+        for (int e = nav.nodes[i].firstEdge; e < nav.nodes[i].firstEdge + nav.nodes[i].edgeCount; e++)
+        {
+            if (nav.nodes[nav.edges[e].to].cluster != nav.nodes[i].cluster) { nav.groups[nav.nodes[i].group].linkCount++; linkTotal++; }
+        }
+    }
+    for (int g = 0, first = 0; g < nav.groupCount; g++) { nav.groups[g].firstLink = first; first += nav.groups[g].linkCount; nav.groups[g].linkCount = 0; }
+
+    nav.groupLinks = (int *)RL_MALLOC((linkTotal + 1)*sizeof(int));
+    for (int i = 0; i < nav.nodeCount; i++)
+    {
+        NavGroup *group = &nav.groups[nav.nodes[i].group];
+
+        for (int e = nav.nodes[i].firstEdge; e < nav.nodes[i].firstEdge + nav.nodes[i].edgeCount; e++)
+        {
+            int to = nav.edges[e].to;
+            if (nav.nodes[to].cluster != nav.nodes[i].cluster) nav.groupLinks[group->firstLink + group->linkCount++] = nav.nodes[to].group;
+        }
+    }
+
+
+    // Query scratch data, two extra nodes for start and goal
+    nav.nodeCost = (float *)RL_MALLOC((nav.nodeCount + 2)*sizeof(float));
+    nav.nodeParent = (int *)RL_MALLOC((nav.nodeCount + 2)*sizeof(int));
+    nav.nodeParentEdge = (int *)RL_MALLOC((nav.nodeCount + 2)*sizeof(int));
+    nav.nodeStamp = (unsigned int *)RL_CALLOC(nav.nodeCount + 2, sizeof(unsigned int));
+    nav.heap = LoadNavHeap(nav.nodeCount + 64);
+    nav.startCost = (float *)RL_MALLOC(clusterCells*sizeof(float));
+    nav.startPred = (int *)RL_MALLOC(clusterCells*sizeof(int));
+    nav.goalCost = (float *)RL_MALLOC(clusterCells*sizeof(float));
+    nav.goalPred = (int *)RL_MALLOC(clusterCells*sizeof(int));
+    nav.localHeap = LoadNavHeap(clusterCells*8);
+    nav.groupCost = (float *)RL_MALLOC((nav.groupCount + 1)*sizeof(float));
+    nav.groupParent = (int *)RL_MALLOC((nav.groupCount + 1)*sizeof(int));
+    nav.groupStamp = (unsigned int *)RL_CALLOC(nav.groupCount + 1, sizeof(unsigned int));
+    nav.groupGoal = (unsigned int *)RL_CALLOC(nav.groupCount + 1, sizeof(unsigned int));
+    nav.clusterCorridor = (unsigned int *)RL_CALLOC(clusterCount, sizeof(unsigned int));
+
+    TRACELOG(LOG_INFO, "NAV: Navigation grid loaded [%i x %i], %i regions, %i clusters, %i portals, %i groups, %i edges, %i path cells",
+        nav.width, nav.height, componentCount, clusterCount, nav.nodeCount, nav.groupCount, nav.edgeCount, nav.pathCellCount);
+
+    return nav;
+}
+
+// Unload navigation grid
+void UnloadNavGrid(NavGrid *nav)
+{
+    RL_FREE(nav->moves);
+    RL_FREE(nav->cellComponent);
+    RL_FREE(nav->cellNode);
+    RL_FREE(nav->nodes);
+    RL_FREE(nav->clusterFirstNode);
+    RL_FREE(nav->groups);
+    RL_FREE(nav->groupLinks);
+    RL_FREE(nav->edges);
+    RL_FREE(nav->pathCells);
+    RL_FREE(nav->nodeCost);
+    RL_FREE(nav->nodeParent);
+    RL_FREE(nav->nodeParentEdge);
+    RL_FREE(nav->nodeStamp);
+    UnloadNavHeap(&nav->heap);
+    RL_FREE(nav->startCost);
+    RL_FREE(nav->startPred);
+    RL_FREE(nav->goalCost);
+    RL_FREE(nav->goalPred);
+    UnloadNavHeap(&nav->localHeap);
+    RL_FREE(nav->groupCost);
+    RL_FREE(nav->groupParent);
+    RL_FREE(nav->groupStamp);
+    RL_FREE(nav->groupGoal);
+    RL_FREE(nav->clusterCorridor);
+
+    memset(nav, 0, sizeof(NavGrid));
+}
+
+// Check if an agent can stand on a cell and move out of it
+bool IsNavCellWalkable(const NavGrid *nav, int x, int z)
+{
+    if ((x < 0) || (z < 0) || (x >= nav->width) || (z >= nav->height)) return false;
+
+    return (nav->moves[z*nav->width + x] != 0);
+}
+
+//----------------------------------------------------------------------------------
+// Path queries
+//----------------------------------------------------------------------------------
+
+// Append cell to output path, returns new length
+static int AddNavPathCell(int *path, int length, int maxLength, int cell)
+{
+    if (length < maxLength) path[length] = cell;
+
+    return length + 1;
+}
+
+// Group pass: A* over portal groups from groups reached by the start search to groups reached by the goal
+// search, marks clusters on the route and around it as the portal search corridor
+// NOTE: Uses the current query stamp, a route always has a portal path inside its corridor
+static bool MarkNavCorridor(NavGrid *nav, int startCluster, int goalCluster)
+{
+    int sx0, sz0, sw, sh, gx0, gz0, gw, gh;
+    GetNavClusterRect(nav, startCluster, &sx0, &sz0, &sw, &sh);
+    GetNavClusterRect(nav, goalCluster, &gx0, &gz0, &gw, &gh);
+
+    int goalX = goalCluster%nav->clustersX, goalZ = goalCluster/nav->clustersX;
+    int lineX = startCluster%nav->clustersX - goalX, lineZ = startCluster/nav->clustersX - goalZ;
+
+    for (int n = nav->clusterFirstNode[goalCluster]; n < nav->clusterFirstNode[goalCluster + 1]; n++)
+    {
+        const NavNode *node = &nav->nodes[n];
+        if (nav->goalCost[(node->z - gz0)*gw + (node->x - gx0)] < NAV_INFINITY) nav->groupGoal[node->group] = nav->stamp;
+    }
+
+    NavHeap *heap = &nav->heap;
+    heap->count = 0;
+
+    for (int n = nav->clusterFirstNode[startCluster]; n < nav->clusterFirstNode[startCluster + 1]; n++)
+    {
+        const NavNode *node = &nav->nodes[n];
+        int group = node->group;
+
+        if ((nav->startCost[(node->z - sz0)*sw + (node->x - sx0)] == NAV_INFINITY) || (nav->groupStamp[group] == nav->stamp)) continue;
+
+        nav->groupStamp[group] = nav->stamp;
+        nav->groupCost[group] = 0.0f;
+        nav->groupParent[group] = -1;
+        PushNavHeap(heap, GetNavClusterDistance(&nav->groups[group], goalX, goalZ, lineX, lineZ), group);
+    }
+
+    int found = -1;
+
+    while (heap->count > 0)
+    {
+        float key;
+        int group = PopNavHeap(heap, &key);
+
+        if (nav->groupGoal[group] == nav->stamp) { found = group; break; }
+
+        float c = nav->groupCost[group];
+        if (key > c + GetNavClusterDistance(&nav->groups[group], goalX, goalZ, lineX, lineZ) + 1e-4f) continue;     // Stale entry
+
+        const NavGroup *from = &nav->groups[group];
+        for (int l = from->firstLink; l < from->firstLink + from->linkCount; l++)
+        {
+            int next = nav->groupLinks[l];
+            float nc = c + 1.0f;
+
+            if ((nav->groupStamp[next] != nav->stamp) || (nc < nav->groupCost[next]))
+            {
+                nav->groupStamp[next] = nav->stamp;
+                nav->groupCost[next] = nc;
+                nav->groupParent[next] = group;
+                PushNavHeap(heap, nc + GetNavClusterDistance(&nav->groups[next], goalX, goalZ, lineX, lineZ), next);
+            }
+        }
+    }
+
+    if (found < 0) return false;
+
+    // Corridor: route clusters and their 4 neighbours, so portal paths can cut corners of the route
+    for (int group = found; group != -1; group = nav->groupParent[group])
+    {
+        const NavGroup *route = &nav->groups[group];
+
+        for (int d = -1; d < 4; d++)
+        {
+            int x = route->x + ((d < 0)? 0 : navDx[d]), z = route->z + ((d < 0)? 0 : navDz[d]);
+            if ((x >= 0) && (z >= 0) && (x < nav->clustersX) && (z < nav->clustersZ)) nav->clusterCorridor[z*nav->clustersX + x] = nav->stamp;
+        }
+    }
+
+    return true;
+}
+
+// A* over portals from the start search to the goal search, node nodeCount is the goal
+// NOTE: Uses the current query stamp, with corridor set only clusters marked by the cluster pass are entered
+static bool SearchNavPortals(NavGrid *nav, int start, int goal, bool corridor)
+{
+    int startCluster = GetNavCellCluster(nav, start);
+    int goalCluster = GetNavCellCluster(nav, goal);
+    int sx0, sz0, sw, sh, gx0, gz0, gw, gh;
+    GetNavClusterRect(nav, startCluster, &sx0, &sz0, &sw, &sh);
+    GetNavClusterRect(nav, goalCluster, &gx0, &gz0, &gw, &gh);
+
+    int goalNode = nav->nodeCount;
+    int goalX = goal%nav->width, goalZ = goal/nav->width;
+    NavHeap *heap = &nav->heap;
+    heap->count = 0;
+
+    nav->nodeStamp[goalNode] = nav->stamp;
+    nav->nodeCost[goalNode] = NAV_INFINITY;
+
+    for (int n = nav->clusterFirstNode[startCluster]; n < nav->clusterFirstNode[startCluster + 1]; n++)
+    {
+        const NavNode *node = &nav->nodes[n];
+        float c = nav->startCost[(node->z - sz0)*sw + (node->x - sx0)];
+
+        if (c == NAV_INFINITY) continue;
+
+        nav->nodeStamp[n] = nav->stamp;
+        nav->nodeCost[n] = c;
+        nav->nodeParent[n] = -1;
+        nav->nodeParentEdge[n] = NAV_EDGE_START;
+        PushNavHeap(heap, c + GetNavDistance(node, goalX, goalZ), n);
+    }
+
+    bool found = false;
+
+    while (heap->count > 0)
+    {
+        float key;
+        int n = PopNavHeap(heap, &key);
+
+        if (n == goalNode) { found = true; break; }
+
+        const NavNode *node = &nav->nodes[n];
+        float c = nav->nodeCost[n];
+        if (key > c + GetNavDistance(node, goalX, goalZ) + 1e-4f) continue;     // Stale entry
+
+        // Portal in goal cluster: connect to the goal through the goal search
+        if (node->cluster == goalCluster)
+        {
+            float toGoal = nav->goalCost[(node->z - gz0)*gw + (node->x - gx0)];
+
+            if ((toGoal < NAV_INFINITY) && (c + toGoal < nav->nodeCost[goalNode]))
+            {
+                nav->nodeCost[goalNode] = c + toGoal;
+                nav->nodeParent[goalNode] = n;
+                PushNavHeap(heap, c + toGoal, goalNode);
+            }
+        }
+
+        for (int e = node->firstEdge; e < node->firstEdge + node->edgeCount; e++)
+        {
+            const NavEdge *edge = &nav->edges[e];
+            const NavNode *to = &nav->nodes[edge->to];
+            if (corridor && (nav->clusterCorridor[to->cluster] != nav->stamp)) continue;
+
+            float nc = c + edge->cost;
+
+            if ((nav->nodeStamp[edge->to] != nav->stamp) || (nc < nav->nodeCost[edge->to]))
+            {
+                nav->nodeStamp[edge->to] = nav->stamp;
+                nav->nodeCost[edge->to] = nc;
+                nav->nodeParent[edge->to] = n;
+                nav->nodeParentEdge[edge->to] = e;
+                PushNavHeap(heap, nc + GetNavDistance(to, goalX, goalZ), edge->to);
+            }
+        }
+    }
+
+    return found;
+}
+
+// Find path between two cells, writes cell indices (z*width + x) from start to goal included
+// Returns path length (may be bigger than maxLength, path is then truncated), 0 if there is no path
+int FindNavPath(NavGrid *nav, int startX, int startZ, int goalX, int goalZ, int *path, int maxLength)
+{
+    if (!IsNavCellWalkable(nav, startX, startZ) || !IsNavCellWalkable(nav, goalX, goalZ)) return 0;
+
+    int start = startZ*nav->width + startX;
+    int goal = goalZ*nav->width + goalX;
+
+    if (nav->cellComponent[start] != nav->cellComponent[goal]) return 0;
+
+    int startCluster = GetNavCellCluster(nav, start);
+    int goalCluster = GetNavCellCluster(nav, goal);
+    float zero = 0.0f;
+
+    int gx0, gz0, gw, gh;
+    GetNavClusterRect(nav, goalCluster, &gx0, &gz0, &gw, &gh);
+
+    // Goal search: cost from every goal cluster cell to the goal, pred walks towards the goal
+    SearchNavCluster(nav, goalCluster, &goal, &zero, 1, nav->goalCost, nav->goalPred, &nav->localHeap);
+
+    int length = 0;
+
+    // Same cluster and locally reachable: local path is used directly
+    if ((startCluster == goalCluster) && (nav->goalCost[(startZ - gz0)*gw + (startX - gx0)] < NAV_INFINITY))
+    {
+        for (int cell = start; cell != -1; cell = nav->goalPred[(cell/nav->width - gz0)*gw + (cell%nav->width - gx0)]) length = AddNavPathCell(path, length, maxLength, cell);
+
+        return length;
+    }
+
+    int sx0, sz0, sw, sh;
+    GetNavClusterRect(nav, startCluster, &sx0, &sz0, &sw, &sh);
+
+    // Start search: pred walks towards the start
+    SearchNavCluster(nav, startCluster, &start, &zero, 1, nav->startCost, nav->startPred, &nav->localHeap);
+
+    // Group pass first, then portal search in its corridor (whole portal graph as fallback)
+    nav->stamp++;
+    bool found = MarkNavCorridor(nav, startCluster, goalCluster) && SearchNavPortals(nav, start, goal, true);
+
+    if (!found)
+    {
+        nav->stamp++;
+        found = SearchNavPortals(nav, start, goal, false);
+    }
+
+    if (!found) return 0;
+
+    NavHeap *heap = &nav->heap;
+    int goalNode = nav->nodeCount;
+
+    // Collect portal chain from goal back to start (reusing heap storage, search is done)
+    int chainCount = 0;
+    for (int n = nav->nodeParent[goalNode]; n != -1; n = nav->nodeParent[n])
+    {
+        if (chainCount == heap->capacity) break;
+        heap->values[chainCount++] = n;
+    }
+
+    // Start to first portal: start pred walks towards the start, so it is written reversed
+    int first = heap->values[chainCount - 1];
+    int segment = 0;
+    for (int cell = nav->nodes[first].cell; cell != -1; cell = nav->startPred[(cell/nav->width - sz0)*sw + (cell%nav->width - sx0)]) segment++;
+
+    for (int i = segment - 1, cell = nav->nodes[first].cell; i >= 0; i--)
+    {
+        if (i < maxLength) path[i] = cell;
+        cell = nav->startPred[(cell/nav->width - sz0)*sw + (cell%nav->width - sx0)];
+    }
+    length = segment;
+
+    // Portal to portal: stored edge paths
+    for (int i = chainCount - 2; i >= 0; i--)
+    {
+        const NavEdge *edge = &nav->edges[nav->nodeParentEdge[heap->values[i]]];
+
+        for (int k = 0; k < edge->pathLength; k++) length = AddNavPathCell(path, length, maxLength, nav->pathCells[edge->pathFirst + k]);
+    }
+
+    // Last portal to goal: goal pred walks towards the goal
+    int last = nav->nodes[heap->values[0]].cell;
+    for (int cell = nav->goalPred[(last/nav->width - gz0)*gw + (last%nav->width - gx0)]; cell != -1; cell = nav->goalPred[(cell/nav->width - gz0)*gw + (cell%nav->width - gx0)]) length = AddNavPathCell(path, length, maxLength, cell);
+
+    return length;
+}
+
+//----------------------------------------------------------------------------------
+// Flow fields
+//----------------------------------------------------------------------------------
+
+typedef struct NavFlowJob {
+    const NavGrid *nav;
+    NavFlowField *field;
+    int goal;
+    int index;                  // Job index, work is striped by job count
+    int jobCount;
+    struct NavFlowWorkers *workers;
+
+    // Cluster search scratch, kept between updates
+    float *cost;
+    int *pred;
+    int *seeds;
+    float *seedCosts;
+    NavHeap heap;
+} NavFlowJob;
+
+// Flow field worker threads, started once and woken for each batch of jobs
+// NOTE: The updating thread runs job 0, worker thread i runs job i
+typedef struct NavFlowWorkers {
+    NavFlowJob jobs[NAV_MAX_THREADS];
+    int jobCount;
+    int clusterCells;           // Scratch size per job
+
+    pthread_t threads[NAV_MAX_THREADS];
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    pthread_cond_t done;
+    void *(*function)(void *);  // Job function of the current batch
+    unsigned int batch;         // Incremented for each batch, workers wait for a new one
+    int pending;                // Worker jobs not finished in the current batch
+    bool quit;
+} NavFlowWorkers;
+
+// Flow field integration of clusters index, index + jobCount, ...: local search seeded with portal costs
+static void *IntegrateNavFlowClusters(void *data)
+{
+    NavFlowJob *job = (NavFlowJob *)data;
+    const NavGrid *nav = job->nav;
+    float *cost = job->cost;
+    int *seeds = job->seeds;
+    float *seedCosts = job->seedCosts;
+
+    for (int cluster = job->index; cluster < nav->clustersX*nav->clustersZ; cluster += job->jobCount)
+    {
+        int x0, z0, w, h;
+        GetNavClusterRect(nav, cluster, &x0, &z0, &w, &h);
+
+        int seedCount = 0;
+        for (int n = nav->clusterFirstNode[cluster]; n < nav->clusterFirstNode[cluster + 1]; n++)
+        {
+            if ((nav->nodeStamp[n] == nav->stamp) && (nav->nodeCost[n] < NAV_INFINITY))
+            {
+                seeds[seedCount] = nav->nodes[n].cell;
+                seedCosts[seedCount++] = nav->nodeCost[n];
+            }
+        }
+
+        if (GetNavCellCluster(nav, job->goal) == cluster)
+        {
+            seeds[seedCount] = job->goal;
+            seedCosts[seedCount++] = 0.0f;
+        }
+
+        if (seedCount > 0) SearchNavCluster(nav, cluster, seeds, seedCosts, seedCount, cost, job->pred, &job->heap);
+        else for (int i = 0; i < w*h; i++) cost[i] = NAV_INFINITY;
+
+        for (int z = 0; z < h; z++)
+        {
+            for (int x = 0; x < w; x++) job->field->cost[(z0 + z)*nav->width + x0 + x] = cost[z*w + x];
+        }
+    }
+
+    return NULL;
+}
+
+// Flow field directions of rows index, index + jobCount, ...: move to the cheapest reachable neighbour
+static void *GetNavFlowDirections(void *data)
+{
+    NavFlowJob *job = (NavFlowJob *)data;
+    const NavGrid *nav = job->nav;
+    const float *cost = job->field->cost;
+
+    for (int z = job->index; z < nav->height; z += job->jobCount)
+    {
+        for (int x = 0; x < nav->width; x++)
+        {
+            int cell = z*nav->width + x;
+            unsigned char moves = nav->moves[cell];
+            unsigned char direction = NAV_DIRECTION_NONE;
+            float best = cost[cell];
+
+            for (int d = 0; d < 8; d++)
+            {
+                if (!(moves & (1 << d))) continue;
+
+                float c = cost[cell + navDz[d]*nav->width + navDx[d]];
+                if (c < best) { best = c; direction = (unsigned char)d; }
+            }
+
+            job->field->direction[cell] = direction;
+        }
+    }
+
+    return NULL;
+}
+
+// Flow field worker thread: run job of each new batch until quit
+static void *NavFlowWorker(void *data)
+{
+    NavFlowJob *job = (NavFlowJob *)data;
+    NavFlowWorkers *workers = job->workers;
+    unsigned int batch = 0;
+
+    pthread_mutex_lock(&workers->mutex);
+
+    while (true)
+    {
+        while (!workers->quit && (workers->batch == batch)) pthread_cond_wait(&workers->wake, &workers->mutex);
+        if (workers->quit) break;
+
+        batch = workers->batch;
+        void *(*function)(void *) = workers->function;
+
+        pthread_mutex_unlock(&workers->mutex);
+        function(job);
+        pthread_mutex_lock(&workers->mutex);
+
+        if (--workers->pending == 0) pthread_cond_signal(&workers->done);
+    }
+
+    pthread_mutex_unlock(&workers->mutex);
+
+    return NULL;
+}
+
+// Load flow field job scratch and start worker threads for jobs 1..jobCount - 1
+static NavFlowWorkers *LoadNavFlowWorkers(int jobCount, int clusterCells)
+{
+    NavFlowWorkers *workers = (NavFlowWorkers *)RL_CALLOC(1, sizeof(NavFlowWorkers));
+
+    workers->jobCount = jobCount;
+    workers->clusterCells = clusterCells;
+
+    for (int i = 0; i < jobCount; i++)
+    {
+        NavFlowJob *job = &workers->jobs[i];
+
+        job->index = i;
+        job->jobCount = jobCount;
+        job->workers = workers;
+        job->cost = (float *)RL_MALLOC(clusterCells*sizeof(float));
+        job->pred = (int *)RL_MALLOC(clusterCells*sizeof(int));
+        job->seeds = (int *)RL_MALLOC((clusterCells + 1)*sizeof(int));
+        job->seedCosts = (float *)RL_MALLOC((clusterCells + 1)*sizeof(float));
+        job->heap = LoadNavHeap(clusterCells*8);
+    }
+
+    pthread_mutex_init(&workers->mutex, NULL);
+    pthread_cond_init(&workers->wake, NULL);
+    pthread_cond_init(&workers->done, NULL);
+
+    for (int i = 1; i < jobCount; i++) pthread_create(&workers->threads[i], NULL, NavFlowWorker, &workers->jobs[i]);
+
+    return workers;
+}
+
+// Stop worker threads and unload job scratch
+static void UnloadNavFlowWorkers(NavFlowWorkers *workers)
+{
+    pthread_mutex_lock(&workers->mutex);
+    workers->quit = true;
+    pthread_cond_broadcast(&workers->wake);
+    pthread_mutex_unlock(&workers->mutex);
+
+    for (int i = 1; i < workers->jobCount; i++) pthread_join(workers->threads[i], NULL);
+
+    for (int i = 0; i < workers->jobCount; i++)
+    {
+        RL_FREE(workers->jobs[i].cost);
+        RL_FREE(workers->jobs[i].pred);
+        RL_FREE(workers->jobs[i].seeds);
+        RL_FREE(workers->jobs[i].seedCosts);
+        UnloadNavHeap(&workers->jobs[i].heap);
+    }
+
+    pthread_cond_destroy(&workers->done);
+    pthread_cond_destroy(&workers->wake);
+    pthread_mutex_destroy(&workers->mutex);
+
+    RL_FREE(workers);
+}
+
+// Run a batch of flow field jobs, job 0 on the calling thread, returns when all jobs are done
+static void RunNavFlowJobs(NavFlowWorkers *workers, void *(*function)(void *))
+{
+    if (workers->jobCount > 1)
+    {
+        pthread_mutex_lock(&workers->mutex);
+        workers->function = function;
+        workers->pending = workers->jobCount - 1;
+        workers->batch++;
+        pthread_cond_broadcast(&workers->wake);
+        pthread_mutex_unlock(&workers->mutex);
+    }
+
+    function(&workers->jobs[0]);
+
+    if (workers->jobCount > 1)
+    {
+        pthread_mutex_lock(&workers->mutex);
+        while (workers->pending > 0) pthread_cond_wait(&workers->done, &workers->mutex);
+        pthread_mutex_unlock(&workers->mutex);
+    }
+}
+
+// Load flow field buffers for a navigation grid
+NavFlowField LoadNavFlowField(const NavGrid *nav)
+{
+    NavFlowField field = { 0 };
+
+    field.width = nav->width;
+    field.height = nav->height;
+    field.goalX = field.goalZ = -1;
+    field.cost = (float *)RL_MALLOC((size_t)nav->width*nav->height*sizeof(float));
+    field.direction = (unsigned char *)RL_MALLOC((size_t)nav->width*nav->height);
+
+    return field;
+}
+
+// Unload flow field buffers and stop its worker threads
+void UnloadNavFlowField(NavFlowField *field)
+{
+    if (field->workers != NULL) UnloadNavFlowWorkers(field->workers);
+
+    RL_FREE(field->cost);
+    RL_FREE(field->direction);
+
+    memset(field, 0, sizeof(NavFlowField));
+}
+
+// Update flow field towards a goal cell, clusters and rows are spread across worker threads
+// NOTE: Portal costs come from a Dijkstra over the portal graph, then each cluster is filled independently.
+// Worker threads are started by the first update and kept until the thread count changes or the field is unloaded
+void UpdateNavFlowField(NavGrid *nav, NavFlowField *field, int goalX, int goalZ, int threads)
+{
+    if (threads < 1) threads = 1;
+    if (threads > NAV_MAX_THREADS) threads = NAV_MAX_THREADS;
+
+    field->goalX = goalX;
+    field->goalZ = goalZ;
+
+    if (!IsNavCellWalkable(nav, goalX, goalZ))
+    {
+        for (int i = 0; i < nav->width*nav->height; i++) { field->cost[i] = NAV_INFINITY; field->direction[i] = NAV_DIRECTION_NONE; }
+        return;
+    }
+
+    int goal = goalZ*nav->width + goalX;
+    int goalCluster = GetNavCellCluster(nav, goal);
+    float zero = 0.0f;
+
+    int gx0, gz0, gw, gh;
+    GetNavClusterRect(nav, goalCluster, &gx0, &gz0, &gw, &gh);
+    SearchNavCluster(nav, goalCluster, &goal, &zero, 1, nav->goalCost, nav->goalPred, &nav->localHeap);
+
+    // Dijkstra over portals from the goal (edges are symmetric)
+    NavHeap *heap = &nav->heap;
+    heap->count = 0;
+    nav->stamp++;
+
+    for (int n = nav->clusterFirstNode[goalCluster]; n < nav->clusterFirstNode[goalCluster + 1]; n++)
+    {
+        int cell = nav->nodes[n].cell;
+        float c = nav->goalCost[(cell/nav->width - gz0)*gw + (cell%nav->width - gx0)];
+
+        if (c == NAV_INFINITY) continue;
+
+        nav->nodeStamp[n] = nav->stamp;
+        nav->nodeCost[n] = c;
+        PushNavHeap(heap, c, n);
+    }
+
+    while (heap->count > 0)
+    {
+        float c;
+        int n = PopNavHeap(heap, &c);
+
+        if (c > nav->nodeCost[n]) continue;
+
+        const NavNode *node = &nav->nodes[n];
+        for (int e = node->firstEdge; e < node->firstEdge + node->edgeCount; e++)
+        {
+            const NavEdge *edge = &nav->edges[e];
+            float nc = c + edge->cost;
+
+            if ((nav->nodeStamp[edge->to] != nav->stamp) || (nc < nav->nodeCost[edge->to]))
+            {
+                nav->nodeStamp[edge->to] = nav->stamp;
+                nav->nodeCost[edge->to] = nc;
+                PushNavHeap(heap, nc, edge->to);
+            }
+        }
+    }
+
+    int clusterCells = nav->clusterSize*nav->clusterSize;
+    if ((field->workers == NULL) || (field->workers->jobCount != threads) || (field->workers->clusterCells != clusterCells))
+    {
+        if (field->workers != NULL) UnloadNavFlowWorkers(field->workers);
+        field->workers = LoadNavFlowWorkers(threads, clusterCells);
+    }
+
+    for (int i = 0; i < threads; i++)
+    {
+        field->workers->jobs[i].nav = nav;
+        field->workers->jobs[i].field = field;
+        field->workers->jobs[i].goal = goal;
+    }
+
+    // Directions need costs of neighbour clusters, so integration must be complete first
+    RunNavFlowJobs(field->workers, IntegrateNavFlowClusters);
+    RunNavFlowJobs(field->workers, GetNavFlowDirections);
+}
+
+// Get flow field move direction of a cell (unit vector on XZ), zero at goal or if goal can't be reached
+Vector2 GetNavFlowDirection(const NavFlowField *field, int x, int z)
+{
+    if ((x < 0) || (z < 0) || (x >= field->width) || (z >= field->height)) return (Vector2){ 0 };
+
+    unsigned char d = field->direction[z*field->width + x];
+    if (d == NAV_DIRECTION_NONE) return (Vector2){ 0 };
+
+    return navDirections[d];
+}
+
+// Check a path goes from start to goal through passable moves only
+static bool IsNavPathValid(const NavGrid *nav, const int *path, int length, int start, int goal)
+{
+    if ((length == 0) || (path[0] != start) || (path[length - 1] != goal)) return false;
+
+    for (int i = 1; i < length; i++)
+    {
+        int dx = path[i]%nav->width - path[i - 1]%nav->width;
+        int dz = path[i]/nav->width - path[i - 1]/nav->width;
+        int d = 0;
+
+        while ((d < 8) && ((navDx[d] != dx) || (navDz[d] != dz))) d++;
+        if ((d == 8) || !(nav->moves[path[i - 1]] & (1 << d))) return false;
+    }
+
+    return true;
+}
+
+// Benchmark path queries between random walkable cells and flow field updates, logs average times
+// NOTE: Runs headless, takes cells from a fixed seed, returns the number of invalid paths, flow field cells
+// that do not lead to the goal and average times over budget (seconds per query and per flow field update)
+int BenchmarkNavigation(NavGrid *nav, int queries, int flowUpdates, int threads, float queryBudget, float flowBudget)
+{
+    int cellCount = nav->width*nav->height;
+    int *path = (int *)RL_MALLOC(cellCount*sizeof(int));
+    int failures = 0;
+    int found = 0;
+    long long totalLength = 0;
+    double queryTime = 0.0;
+
+    srand(4321);
+    for (int q = 0; q < queries; q++)
+    {
+        int sx, sz, gx, gz;
+        do { sx = rand()%nav->width; sz = rand()%nav->height; } while (!IsNavCellWalkable(nav, sx, sz));
+        do { gx = rand()%nav->width; gz = rand()%nav->height; } while (!IsNavCellWalkable(nav, gx, gz));
+
+        double start = GetTimerSeconds();
+        int length = FindNavPath(nav, sx, sz, gx, gz, path, cellCount);
+        queryTime += GetTimerSeconds() - start;
+
+        if (length > 0) { found++; totalLength += length; }
+
+        // Path must exist exactly when both cells are in the same region
+        int startCell = sz*nav->width + sx, goalCell = gz*nav->width + gx;
+        bool reachable = (nav->cellComponent[startCell] == nav->cellComponent[goalCell]);
+        if ((length > 0)? !IsNavPathValid(nav, path, length, startCell, goalCell) : reachable) failures++;
+    }
+
+    // Flow fields: first update starts the worker threads, later updates reuse them
+    NavFlowField field = LoadNavFlowField(nav);
+    unsigned char *state = (unsigned char *)RL_MALLOC(cellCount);
+    int flowFailures = 0;
+    double flowTime = 0.0, flowMax = 0.0;
+
+    for (int u = 0; u < flowUpdates; u++)
+    {
+        int gx, gz;
+        do { gx = rand()%nav->width; gz = rand()%nav->height; } while (!IsNavCellWalkable(nav, gx, gz));
+
+        double start = GetTimerSeconds();
+        UpdateNavFlowField(nav, &field, gx, gz, threads);
+        double time = GetTimerSeconds() - start;
+
+        flowTime += time;
+        if (time > flowMax) flowMax = time;
+
+        // Following directions from any cell of the goal region must reach the goal
+        // NOTE: Cell states are 0 unknown, 1 reaches the goal, 2 misses it, 3 on the current walk (a loop if met again)
+        int goal = gz*nav->width + gx;
+        memset(state, 0, cellCount);
+        state[goal] = 1;
+
+        for (int cell = 0; cell < cellCount; cell++)
+        {
+            if ((nav->moves[cell] == 0) || (nav->cellComponent[cell] != nav->cellComponent[goal]) || (state[cell] != 0)) continue;
+
+            int count = 0, c = cell;
+            while (state[c] == 0)
+            {
+                unsigned char d = field.direction[c];
+
+                state[c] = 3;
+                path[count++] = c;
+                if (d == NAV_DIRECTION_NONE) break;
+                c += navDz[d]*nav->width + navDx[d];
+            }
+
+            unsigned char result = (state[c] == 1)? 1 : 2;
+            for (int i = 0; i < count; i++) state[path[i]] = result;
+            if (result == 2) flowFailures += count;
+        }
+    }
+
+    UnloadNavFlowField(&field);
+    RL_FREE(state);
+    RL_FREE(path);
+
+    double queryMean = queryTime/queries;
+    double flowMean = flowTime/flowUpdates;
+    int timeFailures = (queryMean > queryBudget) + (flowMean > flowBudget);
+
+    TRACELOG((failures == 0) && (queryMean <= queryBudget)? LOG_INFO : LOG_WARNING, "NAV: [%i x %i] %i path queries, %i found, avg length %.1f cells, avg %.2f us/query (budget %.0f us), %i invalid",
+        nav->width, nav->height, queries, found, (found > 0)? (double)totalLength/found : 0.0, queryMean*1e6, queryBudget*1e6, failures);
+    TRACELOG((flowFailures == 0) && (flowMean <= flowBudget)? LOG_INFO : LOG_WARNING, "NAV: [%i x %i] %i flow field updates with %i threads: avg %.2f ms, max %.2f ms (budget %.0f ms), %i cells miss the goal",
+        nav->width, nav->height, flowUpdates, threads, flowMean*1000.0, flowMax*1000.0, flowBudget*1000.0, flowFailures);
+
+    return failures + flowFailures + timeFailures;
+}
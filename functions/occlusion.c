@@ -0,0 +1,693 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: qsort(), rand(), srand()
+#include <string.h>         // Required for: memset(), memcpy()
+#include <math.h>           // Required for: floorf(), ceilf(), fabsf(), fminf(), fmaxf(), sinf(), cosf()
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // Required for: SSE2 half-space rasterization
+#endif
+
+// Occlusion culling: the biggest nearby walls are rasterized on CPU into a small depth buffer, map
+// regions and props whose screen bounds are behind it are not submitted
+// NOTE: Occluders are the faces of full height (solid) cubicmap cells towards open cells, merged
+// along rows and columns into long quads once at load. Every frame the closest and largest front
+// facing ones are rasterized with half-space edge functions, 8x4 pixel tiles, 4 pixels per SSE2 step.
+// Depth is stored as inverse view depth (0 = nothing rasterized), perspective correct and linear in
+// screen space. A min (farthest) depth pyramid lets a box test read at most a few texels.
+// Pixels are covered by their center, so an object can be culled when it is visible only through
+// a gap thinner than one depth buffer pixel.
+
+#define OCCLUSION_TILE_WIDTH        8
+#define OCCLUSION_TILE_HEIGHT       4
+#define OCCLUSION_TILE_SIZE         (OCCLUSION_TILE_WIDTH*OCCLUSION_TILE_HEIGHT)
+#define MAX_OCCLUSION_LEVELS        12
+#define MAX_OCCLUSION_OCCLUDERS     64          // Occluders rasterized per frame
+#define OCCLUSION_TEST_TEXELS       4           // Max texels per axis a box test reads
+
+typedef struct Occluder {
+    Vector3 corners[4];         // World space quad
+    Vector3 normal;             // Facing out of the solid cells
+    BoundingBox bounds;
+} Occluder;
+
+typedef struct OccluderCandidate {
+    float score;                // Projected size estimate: area/distance^2
+    int index;
+} OccluderCandidate;
+
+typedef struct OcclusionStats {
+    int occluders;              // Occluders rasterized last update
+    int triangles;              // Triangles rasterized last update (after near plane clipping)
+    int tested;                 // Boxes tested since last update
+    int culled;                 // Boxes found occluded since last update
+    float time;                 // Last update time: selection, rasterization and pyramid (seconds)
+} OcclusionStats;
+
+typedef struct OcclusionCuller {
+    Occluder *occluders;        // Merged wall faces of the whole map
+    OccluderCandidate *candidates;
+    int occluderCount;
+
+    int width;                  // Depth buffer size, multiple of the tile size
+    int height;
+    int tilesX;
+    int tilesY;
+    float *depth;               // Tiled inverse depth, tiles are row major, pixels row major inside a tile
+    float *levels[MAX_OCCLUSION_LEVELS];    // Depth pyramid, level 0 is linear full resolution
+    int levelWidth[MAX_OCCLUSION_LEVELS];
+    int levelHeight[MAX_OCCLUSION_LEVELS];
+    int levelCount;
+
+    Matrix viewProjection;      // Camera of last update
+    bool enabled;               // Disabled culler rasterizes nothing and reports all boxes visible
+
+    // Tuning, can be changed any time
+    float maxDistance;          // Occluders farther than this are ignored
+    int maxOccluders;           // Occluders rasterized per update [1..MAX_OCCLUSION_OCCLUDERS]
+
+    OcclusionStats stats;
+} OcclusionCuller;
+
+// Check if a cell is solid over its full height
+static bool IsOccluderCell(const CubicmapGrid *grid, int x, int z)
+{
+    int floor, ceiling;
+    GetCubicmapGridCell(grid, x, z, &floor, &ceiling);
+
+    return (floor >= ceiling);
+}
+
+// Add full height wall quad between cell rows/columns, in mesh space shifted by position
+static void AddOccluder(OcclusionCuller *culler, Vector3 position, Vector3 a, Vector3 b, float height, Vector3 normal)
+{
+    Occluder *occluder = &culler->occluders[culler->occluderCount++];
+
+    a = Vector3Add(a, position);
+    b = Vector3Add(b, position);
+    occluder->corners[0] = a;
+    occluder->corners[1] = b;
+    occluder->corners[2] = (Vector3){ b.x, b.y + height, b.z };
+    occluder->corners[3] = (Vector3){ a.x, a.y + height, a.z };
+    occluder->normal = normal;
+    occluder->bounds.min = Vector3Min(occluder->corners[0], occluder->corners[2]);
+    occluder->bounds.max = Vector3Max(occluder->corners[0], occluder->corners[2]);
+}
+
+// Load occlusion culler: merge grid walls into occluders, allocate a width x height depth buffer
+// NOTE: Grid is only read here, position is the world position of the grid mesh space origin
+OcclusionCuller LoadOcclusionCuller(const CubicmapGrid *grid, Vector3 position, int width, int height)
+{
+    OcclusionCuller culler = { 0 };
+
+    culler.width = ((width + OCCLUSION_TILE_WIDTH - 1)/OCCLUSION_TILE_WIDTH)*OCCLUSION_TILE_WIDTH;
+    culler.height = ((height + OCCLUSION_TILE_HEIGHT - 1)/OCCLUSION_TILE_HEIGHT)*OCCLUSION_TILE_HEIGHT;
+    culler.tilesX = culler.width/OCCLUSION_TILE_WIDTH;
+    culler.tilesY = culler.height/OCCLUSION_TILE_HEIGHT;
+    culler.depth = (float *)RL_CALLOC(culler.width*culler.height, sizeof(float));
+
+    int levelWidth = culler.width;
+    int levelHeight = culler.height;
+    while (culler.levelCount < MAX_OCCLUSION_LEVELS)
+    {
+        culler.levels[culler.levelCount] = (float *)RL_CALLOC(levelWidth*levelHeight, sizeof(float));
+        culler.levelWidth[culler.levelCount] = levelWidth;
+        culler.levelHeight[culler.levelCount] = levelHeight;
+        culler.levelCount++;
+
+        if ((levelWidth == 1) && (levelHeight == 1)) break;
+        levelWidth = (levelWidth + 1)/2;
+        levelHeight = (levelHeight + 1)/2;
+    }
+
+    // Upper bound: every cell has up to 4 walls, merging only reduces it
+    culler.occluders = (Occluder *)RL_MALLOC((size_t)grid->width*grid->height*4*sizeof(Occluder) + sizeof(Occluder));
+
+    Vector3 cs = grid->cubeSize;
+
+    // Walls facing -Z/+Z: runs of solid cells along X with an open cell on that side
+    for (int side = -1; side <= 1; side += 2)
+    {
+        for (int z = 0; z < grid->height; z++)
+        {
+            int x = 0;
+            while (x < grid->width)
+            {
+                if (!IsOccluderCell(grid, x, z) || IsOccluderCell(grid, x, z + side)) { x++; continue; }
+
+                int first = x;
+                while ((x < grid->width) && IsOccluderCell(grid, x, z) && !IsOccluderCell(grid, x, z + side)) x++;
+
+                float wallZ = cs.z*(z + 0.5f*side);
+                AddOccluder(&culler, position, (Vector3){ cs.x*(first - 0.5f), 0.0f, wallZ }, (Vector3){ cs.x*(x - 0.5f), 0.0f, wallZ }, cs.y, (Vector3){ 0.0f, 0.0f, (float)side });
+            }
+        }
+    }
+
+    // Walls facing -X/+X: runs of solid cells along Z with an open cell on that side
+    for (int side = -1; side <= 1; side += 2)
+    {
+        for (int x = 0; x < grid->width; x++)
+        {
+            int z = 0;
+            while (z < grid->height)
+            {
+                if (!IsOccluderCell(grid, x, z) || IsOccluderCell(grid, x + side, z)) { z++; continue; }
+
+                int first = z;
+                while ((z < grid->height) && IsOccluderCell(grid, x, z) && !IsOccluderCell(grid, x + side, z)) z++;
+
+                float wallX = cs.x*(x + 0.5f*side);
+                AddOccluder(&culler, position, (Vector3){ wallX, 0.0f, cs.z*(first - 0.5f) }, (Vector3){ wallX, 0.0f, cs.z*(z - 0.5f) }, cs.y, (Vector3){ (float)side, 0.0f, 0.0f });
+            }
+        }
+    }
+
+    culler.occluders = (Occluder *)RL_REALLOC(culler.occluders, culler.occluderCount*sizeof(Occluder) + sizeof(Occluder));
+    culler.candidates = (OccluderCandidate *)RL_MALLOC(culler.occluderCount*sizeof(OccluderCandidate) + sizeof(OccluderCandidate));
+
+    culler.enabled = true;
+    culler.maxDistance = 30.0f;
+    culler.maxOccluders = 32;
+
+    TRACELOG(LOG_INFO, "OCCLUSION: %i occluders merged from %ix%i cells, %ix%i depth buffer", culler.occluderCount, grid->width, grid->height, culler.width, culler.height);
+
+    return culler;
+}
+
+// Unload occlusion culler
+void UnloadOcclusionCuller(OcclusionCuller *culler)
+{
+    RL_FREE(culler->occluders);
+    RL_FREE(culler->candidates);
+    RL_FREE(culler->depth);
+    for (int i = 0; i < culler->levelCount; i++) RL_FREE(culler->levels[i]);
+
+    memset(culler, 0, sizeof(OcclusionCuller));
+}
+
+// Sort candidates by decreasing score
+static int CompareOccluderCandidates(const void *a, const void *b)
+{
+    float sa = ((const OccluderCandidate *)a)->score;
+    float sb = ((const OccluderCandidate *)b)->score;
+
+    return (sa < sb) - (sa > sb);
+}
+
+// Rasterize a screen space triangle (x, y in depth buffer pixels, z inverse depth), keeps the nearest depth
+static void RasterizeOccluderTriangle(OcclusionCuller *culler, Vector3 v0, Vector3 v1, Vector3 v2)
+{
+    float area = (v1.x - v0.x)*(v2.y - v0.y) - (v2.x - v0.x)*(v1.y - v0.y);
+    if (fabsf(area) < 1e-6f) return;
+    if (area < 0.0f) { Vector3 t = v1; v1 = v2; v2 = t; area = -area; }
+
+    // Pixel bounds, clamped to the buffer
+    int minX = (int)fmaxf(floorf(fminf(v0.x, fminf(v1.x, v2.x))), 0.0f);
+    int minY = (int)fmaxf(floorf(fminf(v0.y, fminf(v1.y, v2.y))), 0.0f);
+    int maxX = (int)fminf(ceilf(fmaxf(v0.x, fmaxf(v1.x, v2.x))), (float)(culler->width - 1));
+    int maxY = (int)fminf(ceilf(fmaxf(v0.y, fmaxf(v1.y, v2.y))), (float)(culler->height - 1));
+    if ((minX > maxX) || (minY > maxY)) return;
+
+    // Edge functions e = A*x + B*y + C, positive inside; edge i is opposite to vertex i
+    float ea[3] = { v1.y - v2.y, v2.y - v0.y, v0.y - v1.y };
+    float eb[3] = { v2.x - v1.x, v0.x - v2.x, v1.x - v0.x };
+    float ec[3] = { -(ea[0]*v1.x + eb[0]*v1.y), -(ea[1]*v2.x + eb[1]*v2.y), -(ea[2]*v0.x + eb[2]*v0.y) };
+
+    // Inverse depth plane from barycentrics (edge functions over area)
+    float za = (ea[0]*v0.z + ea[1]*v1.z + ea[2]*v2.z)/area;
+    float zb = (eb[0]*v0.z + eb[1]*v1.z + eb[2]*v2.z)/area;
+    float zc = (ec[0]*v0.z + ec[1]*v1.z + ec[2]*v2.z)/area;
+
+    for (int ty = minY/OCCLUSION_TILE_HEIGHT; ty <= maxY/OCCLUSION_TILE_HEIGHT; ty++)
+    {
+        for (int tx = minX/OCCLUSION_TILE_WIDTH; tx <= maxX/OCCLUSION_TILE_WIDTH; tx++)
+        {
+            float x0 = tx*OCCLUSION_TILE_WIDTH + 0.5f;
+            float y0 = ty*OCCLUSION_TILE_HEIGHT + 0.5f;
+            float x1 = x0 + OCCLUSION_TILE_WIDTH - 1;
+            float y1 = y0 + OCCLUSION_TILE_HEIGHT - 1;
+
+            // Tile is outside if all its pixel centers are outside one edge
+            bool outside = false;
+            for (int e = 0; e < 3; e++)
+            {
+                float best = ea[e]*((ea[e] > 0.0f)? x1 : x0) + eb[e]*((eb[e] > 0.0f)? y1 : y0) + ec[e];
+                if (best < 0.0f) { outside = true; break; }
+            }
+            if (outside) continue;
+
+            float *tile = &culler->depth[(ty*culler->tilesX + tx)*OCCLUSION_TILE_SIZE];
+
+#if defined(__SSE2__)
+            const __m128 zero = _mm_setzero_ps();
+            const __m128 offsets = _mm_setr_ps(0.0f, 1.0f, 2.0f, 3.0f);
+
+            for (int row = 0; row < OCCLUSION_TILE_HEIGHT; row++)
+            {
+                float y = y0 + row;
+
+                for (int column = 0; column < OCCLUSION_TILE_WIDTH; column += 4)
+                {
+                    __m128 x = _mm_add_ps(_mm_set1_ps(x0 + column), offsets);
+                    __m128 e0 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ea[0]), x), _mm_set1_ps(eb[0]*y + ec[0]));
+                    __m128 e1 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ea[1]), x), _mm_set1_ps(eb[1]*y + ec[1]));
+                    __m128 e2 = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(ea[2]), x), _mm_set1_ps(eb[2]*y + ec[2]));
+                    __m128 inside = _mm_and_ps(_mm_and_ps(_mm_cmpge_ps(e0, zero), _mm_cmpge_ps(e1, zero)), _mm_cmpge_ps(e2, zero));
+
+                    __m128 z = _mm_add_ps(_mm_mul_ps(_mm_set1_ps(za), x), _mm_set1_ps(zb*y + zc));
+                    __m128 current = _mm_loadu_ps(&tile[row*OCCLUSION_TILE_WIDTH + column]);
+                    __m128 nearest = _mm_max_ps(current, z);
+
+                    _mm_storeu_ps(&tile[row*OCCLUSION_TILE_WIDTH + column], _mm_or_ps(_mm_and_ps(inside, nearest), _mm_andnot_ps(inside, current)));
+                }
+            }
+#else
+            for (int row = 0; row < OCCLUSION_TILE_HEIGHT; row++)
+            {
+                float y = y0 + row;
+
+                for (int column = 0; column < OCCLUSION_TILE_WIDTH; column++)
+                {
+                    float x = x0 + column;
+
+                    if ((ea[0]*x + eb[0]*y + ec[0] < 0.0f) || (ea[1]*x + eb[1]*y + ec[1] < 0.0f) || (ea[2]*x + eb[2]*y + ec[2] < 0.0f)) continue;
+
+                    float z = za*x + zb*y + zc;
+                    float *pixel = &tile[row*OCCLUSION_TILE_WIDTH + column];
+                    if (z > *pixel) *pixel = z;
+                }
+            }
+#endif
+        }
+    }
+
+    culler->stats.triangles++;
+}
+
+// Rasterize occluder quad: clip against the near plane, project and rasterize as a triangle fan
+static void RasterizeOccluder(OcclusionCuller *culler, const Occluder *occluder)
+{
+    Matrix m = culler->viewProjection;
+    Vector4 clip[4];
+    Vector4 polygon[8];
+    int count = 0;
+
+    for (int i = 0; i < 4; i++)
+    {
+        Vector3 p = occluder->corners[i];
+        clip[i] = (Vector4){ m.m0*p.x + m.m4*p.y + m.m8*p.z + m.m12, m.m1*p.x + m.m5*p.y + m.m9*p.z + m.m13, 0.0f, m.m3*p.x + m.m7*p.y + m.m11*p.z + m.m15 };
+    }
+
+    // Sutherland-Hodgman against w = near
+    for (int i = 0; i < 4; i++)
+    {
+        Vector4 a = clip[i];
+        Vector4 b = clip[(i + 1)%4];
+        bool insideA = (a.w >= FRUSTUM_NEAR);
+        bool insideB = (b.w >= FRUSTUM_NEAR);
+
+        if (insideA) polygon[count++] = a;
+        if (insideA != insideB)
+        {
+            float t = (FRUSTUM_NEAR - a.w)/(b.w - a.w);
+            polygon[count++] = (Vector4){ a.x + (b.x - a.x)*t, a.y + (b.y - a.y)*t, 0.0f, FRUSTUM_NEAR };
+        }
+    }
+
+    if (count < 3) return;
+
+    Vector3 screen[8];
+    for (int i = 0; i < count; i++)
+    {
+        float inverseW = 1.0f/polygon[i].w;
+        screen[i].x = (0.5f + 0.5f*polygon[i].x*inverseW)*culler->width;
+        screen[i].y = (0.5f - 0.5f*polygon[i].y*inverseW)*culler->height;
+        screen[i].z = inverseW;
+    }
+
+    for (int i = 1; i < count - 1; i++) RasterizeOccluderTriangle(culler, screen[0], screen[i], screen[i + 1]);
+
+    culler->stats.occluders++;
+}
+
+// Update occlusion culler for a camera: select and rasterize occluders, build the depth pyramid
+// NOTE: Resets tested/culled counters, boxes are tested against this camera until the next update
+void UpdateOcclusionCuller(OcclusionCuller *culler, Camera camera, float aspect)
+{
+    double start = GetTimerSeconds();
+
+    culler->viewProjection = GetCameraViewProjection(camera, aspect);
+    culler->stats = (OcclusionStats){ 0 };
+    memset(culler->depth, 0, culler->width*culler->height*sizeof(float));
+
+    if (culler->enabled)
+    {
+        // Candidates: front facing, in range and in frustum, scored by area over squared distance of the closest point
+        Frustum frustum = GetFrustumFromMatrix(culler->viewProjection);
+        int candidateCount = 0;
+
+        for (int i = 0; i < culler->occluderCount; i++)
+        {
+            const Occluder *occluder = &culler->occluders[i];
+
+            if (Vector3DotProduct(occluder->normal, Vector3Subtract(camera.position, occluder->corners[0])) <= 0.0f) continue;
+
+            Vector3 closest = Vector3Clamp(camera.position, occluder->bounds.min, occluder->bounds.max);
+            float distance2 = Vector3DistanceSqr(camera.position, closest);
+            if (distance2 > culler->maxDistance*culler->maxDistance) continue;
+            if (!CheckFrustumBox(&frustum, occluder->bounds)) continue;
+
+            Vector3 size = Vector3Subtract(occluder->bounds.max, occluder->bounds.min);
+            float area = fmaxf(size.x, size.z)*size.y;
+
+            culler->candidates[candidateCount++] = (OccluderCandidate){ area/fmaxf(distance2, 1.0f), i };
+        }
+
+        qsort(culler->candidates, candidateCount, sizeof(OccluderCandidate), CompareOccluderCandidates);
+
+        int maxOccluders = (culler->maxOccluders < MAX_OCCLUSION_OCCLUDERS)? culler->maxOccluders : MAX_OCCLUSION_OCCLUDERS;
+        if (candidateCount > maxOccluders) candidateCount = maxOccluders;
+
+        for (int i = 0; i < candidateCount; i++) RasterizeOccluder(culler, &culler->occluders[culler->candidates[i].index]);
+    }
+
+    // Pyramid level 0: untile the depth buffer
+    float *level = culler->levels[0];
+    for (int ty = 0; ty < culler->tilesY; ty++)
+    {
+        for (int tx = 0; tx < culler->tilesX; tx++)
+        {
+            const float *tile = &culler->depth[(ty*culler->tilesX + tx)*OCCLUSION_TILE_SIZE];
+
+            for (int row = 0; row < OCCLUSION_TILE_HEIGHT; row++)
+            {
+                memcpy(&level[(ty*OCCLUSION_TILE_HEIGHT + row)*culler->width + tx*OCCLUSION_TILE_WIDTH], &tile[row*OCCLUSION_TILE_WIDTH], OCCLUSION_TILE_WIDTH*sizeof(float));
+            }
+        }
+    }
+
+    // Next levels keep the farthest depth of the (up to) 2x2 texels they cover
+    for (int l = 1; l < culler->levelCount; l++)
+    {
+        const float *source = culler->levels[l - 1];
+        float *target = culler->levels[l];
+        int sourceWidth = culler->levelWidth[l - 1];
+        int sourceHeight = culler->levelHeight[l - 1];
+
+        for (int y = 0; y < culler->levelHeight[l]; y++)
+        {
+            int y0 = 2*y;
+            int y1 = (2*y + 1 < sourceHeight)? 2*y + 1 : y0;
+
+            for (int x = 0; x < culler->levelWidth[l]; x++)
+            {
+                int x0 = 2*x;
+                int x1 = (2*x + 1 < sourceWidth)? 2*x + 1 : x0;
+
+                float farthest = fminf(fminf(source[y0*sourceWidth + x0], source[y0*sourceWidth + x1]), fminf(source[y1*sourceWidth + x0], source[y1*sourceWidth + x1]));
+                target[y*culler->levelWidth[l] + x] = farthest;
+            }
+        }
+    }
+
+    culler->stats.time = (float)(GetTimerSeconds() - start);
+}
+
+// Check if a box may be visible (not completely behind rasterized occluders)
+// NOTE: culler can be NULL (always visible), boxes crossing the near plane are always visible
+bool CheckOcclusionBox(OcclusionCuller *culler, BoundingBox box)
+{
+    if (culler == NULL) return true;
+
+    culler->stats.tested++;
+
+    Matrix m = culler->viewProjection;
+    float minX = 3.402823466e+38f, minY = 3.402823466e+38f;
+    float maxX = -3.402823466e+38f, maxY = -3.402823466e+38f;
+    float nearest = 0.0f;
+
+    for (int i = 0; i < 8; i++)
+    {
+        Vector3 p = { (i & 1)? box.max.x : box.min.x, (i & 2)? box.max.y : box.min.y, (i & 4)? box.max.z : box.min.z };
+        float w = m.m3*p.x + m.m7*p.y + m.m11*p.z + m.m15;
+
+        if (w < FRUSTUM_NEAR) return true;
+
+        float inverseW = 1.0f/w;
+        float x = (0.5f + 0.5f*(m.m0*p.x + m.m4*p.y + m.m8*p.z + m.m12)*inverseW)*culler->width;
+        float y = (0.5f - 0.5f*(m.m1*p.x + m.m5*p.y + m.m9*p.z + m.m13)*inverseW)*culler->height;
+
+        minX = fminf(minX, x);
+        maxX = fmaxf(maxX, x);
+        minY = fminf(minY, y);
+        maxY = fmaxf(maxY, y);
+        nearest = fmaxf(nearest, inverseW);
+    }
+
+    int x0 = (int)fmaxf(floorf(minX), 0.0f);
+    int y0 = (int)fmaxf(floorf(minY), 0.0f);
+    int x1 = (int)fminf(floorf(maxX), (float)(culler->width - 1));
+    int y1 = (int)fminf(floorf(maxY), (float)(culler->height - 1));
+
+    // Off screen boxes are left to frustum culling
+    if ((x0 > x1) || (y0 > y1)) return true;
+
+    // Coarsest level where the box covers at most a few texels per axis
+    int l = 0;
+    while ((l < culler->levelCount - 1) && (((x1 >> l) - (x0 >> l) >= OCCLUSION_TEST_TEXELS) || ((y1 >> l) - (y0 >> l) >= OCCLUSION_TEST_TEXELS))) l++;
+
+    const float *level = culler->levels[l];
+    for (int y = (y0 >> l); y <= (y1 >> l); y++)
+    {
+        for (int x = (x0 >> l); x <= (x1 >> l); x++)
+        {
+            if (level[y*culler->levelWidth[l] + x] <= nearest) return true;
+        }
+    }
+
+    culler->stats.culled++;
+
+    return false;
+}
+
+// Get occlusion counters
+OcclusionStats GetOcclusionStats(const OcclusionCuller *culler)
+{
+    return culler->stats;
+}
+
+// Get distance along a ray to the first occluder it crosses (grid walls), maxDistance if none is closer
+// NOTE: Reference for the benchmark, walks the grid cells along the ray: an occluder is crossed when the
+// ray goes from an open cell into a full height solid cell below the wall top. Occluders past the culler
+// maxDistance are included, they only make the reference see less
+static float GetOccluderRayDistance(const CubicmapGrid *grid, Vector3 position, Ray ray, float maxDistance)
+{
+    Vector3 cs = grid->cubeSize;
+    float ox = (ray.position.x - position.x)/cs.x + 0.5f;
+    float oz = (ray.position.z - position.z)/cs.z + 0.5f;
+    float dx = ray.direction.x/cs.x;
+    float dz = ray.direction.z/cs.z;
+
+    int x = (int)floorf(ox);
+    int z = (int)floorf(oz);
+    int stepX = (dx > 0.0f)? 1 : -1;
+    int stepZ = (dz > 0.0f)? 1 : -1;
+    float nextX = (dx != 0.0f)? ((x + (stepX > 0) - ox)/dx) : 3.402823466e+38f;
+    float nextZ = (dz != 0.0f)? ((z + (stepZ > 0) - oz)/dz) : 3.402823466e+38f;
+    float deltaX = (dx != 0.0f)? fabsf(1.0f/dx) : 3.402823466e+38f;
+    float deltaZ = (dz != 0.0f)? fabsf(1.0f/dz) : 3.402823466e+38f;
+
+    bool solid = IsOccluderCell(grid, x, z);
+    float t = 0.0f;
+
+    while (t < maxDistance)
+    {
+        if (nextX < nextZ)
+        {
+            t = nextX;
+            nextX += deltaX;
+            x += stepX;
+        }
+        else
+        {
+            t = nextZ;
+            nextZ += deltaZ;
+            z += stepZ;
+        }
+
+        // Cells outside the grid are open, nothing more to cross once the ray leaves it
+        if (((x < 0) && (stepX < 0)) || ((z < 0) && (stepZ < 0)) || ((x >= grid->width) && (stepX > 0)) || ((z >= grid->height) && (stepZ > 0))) break;
+
+        bool wasSolid = solid;
+        solid = IsOccluderCell(grid, x, z);
+
+        float y = ray.position.y - position.y + ray.direction.y*t;
+        if (solid && !wasSolid && (t < maxDistance) && (y >= 0.0f) && (y <= cs.y)) return t;
+    }
+
+    return maxDistance;
+}
+
+// Get ray through a depth buffer pixel center
+static Ray GetOcclusionPixelRay(const OcclusionCuller *culler, Camera camera, float aspect, int x, int y)
+{
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+    Vector3 right = Vector3Normalize(Vector3CrossProduct(forward, camera.up));
+    Vector3 up = Vector3CrossProduct(right, forward);
+    float ty = tanf(camera.fovy*0.5f*DEG2RAD);
+    float tx = ty*aspect;
+
+    float ndcX = 2.0f*(x + 0.5f)/culler->width - 1.0f;
+    float ndcY = 1.0f - 2.0f*(y + 0.5f)/culler->height;
+
+    return (Ray){ camera.position, Vector3Add(forward, Vector3Add(Vector3Scale(right, ndcX*tx), Vector3Scale(up, ndcY*ty))) };
+}
+
+// Check if a box is visible through any depth buffer pixel center, against reference occluder distances per pixel
+// NOTE: Reference for the benchmark, distances are ray cast against the grid walls for every pixel. Walls
+// touching the box entry point (within 0.1%) count as occluding
+static bool IsOcclusionBoxVisible(const OcclusionCuller *culler, Camera camera, float aspect, BoundingBox box, const float *distances)
+{
+    Matrix m = culler->viewProjection;
+    float minX = 3.402823466e+38f, minY = 3.402823466e+38f;
+    float maxX = -3.402823466e+38f, maxY = -3.402823466e+38f;
+
+    for (int i = 0; i < 8; i++)
+    {
+        Vector3 p = { (i & 1)? box.max.x : box.min.x, (i & 2)? box.max.y : box.min.y, (i & 4)? box.max.z : box.min.z };
+        float w = m.m3*p.x + m.m7*p.y + m.m11*p.z + m.m15;
+        if (w < FRUSTUM_NEAR) return true;
+
+        float x = (0.5f + 0.5f*(m.m0*p.x + m.m4*p.y + m.m8*p.z + m.m12)/w)*culler->width;
+        float y = (0.5f - 0.5f*(m.m1*p.x + m.m5*p.y + m.m9*p.z + m.m13)/w)*culler->height;
+        minX = fminf(minX, x);
+        maxX = fmaxf(maxX, x);
+        minY = fminf(minY, y);
+        maxY = fmaxf(maxY, y);
+    }
+
+    int x0 = (int)fmaxf(floorf(minX) - 1.0f, 0.0f);
+    int y0 = (int)fmaxf(floorf(minY) - 1.0f, 0.0f);
+    int x1 = (int)fminf(floorf(maxX) + 1.0f, (float)(culler->width - 1));
+    int y1 = (int)fminf(floorf(maxY) + 1.0f, (float)(culler->height - 1));
+
+    for (int py = y0; py <= y1; py++)
+    {
+        for (int px = x0; px <= x1; px++)
+        {
+            Ray ray = GetOcclusionPixelRay(culler, camera, aspect, px, py);
+
+            // Ray entry distance into the box (slabs)
+            float enter = 0.0f, leave = 3.402823466e+38f;
+            float origin[3] = { ray.position.x, ray.position.y, ray.position.z };
+            float direction[3] = { ray.direction.x, ray.direction.y, ray.direction.z };
+            float boxMin[3] = { box.min.x, box.min.y, box.min.z };
+            float boxMax[3] = { box.max.x, box.max.y, box.max.z };
+
+            for (int a = 0; (a < 3) && (enter <= leave); a++)
+            {
+                if (direction[a] == 0.0f)
+                {
+                    if ((origin[a] < boxMin[a]) || (origin[a] > boxMax[a])) leave = -1.0f;
+                    continue;
+                }
+
+                float t0 = (boxMin[a] - origin[a])/direction[a];
+                float t1 = (boxMax[a] - origin[a])/direction[a];
+                enter = fmaxf(enter, fminf(t0, t1));
+                leave = fminf(leave, fmaxf(t0, t1));
+            }
+
+            if ((enter <= leave) && (distances[py*culler->width + px] > enter*1.001f + 0.001f)) return true;
+        }
+    }
+
+    return false;
+}
+
+// Benchmark occlusion culling of grid regions from random cameras in open cells, returns the number of failed checks
+// NOTE: Regions are regionSize cells wide boxes of the grid, as submitted by world streaming. Mean update
+// time must stay within budget (seconds), and in the first checkFrames frames no culled region may be
+// visible to a ray cast reference (culling must be conservative)
+int BenchmarkOcclusionCuller(const CubicmapGrid *grid, int regionSize, int frames, int checkFrames, float budget)
+{
+    OcclusionCuller culler = LoadOcclusionCuller(grid, (Vector3){ 0.0f, 0.0f, 0.0f }, 256, 128);
+    Vector3 cs = grid->cubeSize;
+    int regionsX = (grid->width + regionSize - 1)/regionSize;
+    int regionsZ = (grid->height + regionSize - 1)/regionSize;
+
+    double updateTime = 0.0, testTime = 0.0;
+    float maxUpdateTime = 0.0f;
+    long long tested = 0, culled = 0, visible = 0, occluders = 0;
+    int checked = 0, wrong = 0;
+    float *distances = (float *)RL_MALLOC(culler.width*culler.height*sizeof(float));
+
+    srand(1234);
+    for (int f = 0; f < frames; f++)
+    {
+        // Camera at eye height in a random open cell, looking in a random direction
+        int x = rand()%grid->width, z = rand()%grid->height;
+        for (int tries = 0; (tries < 1000) && IsOccluderCell(grid, x, z); tries++) { x = rand()%grid->width; z = rand()%grid->height; }
+
+        float angle = (rand()%3600)*0.1f*DEG2RAD;
+        Camera camera = { 0 };
+        camera.position = (Vector3){ x*cs.x, 0.6f*cs.y, z*cs.z };
+        camera.target = Vector3Add(camera.position, (Vector3){ cosf(angle), 0.0f, sinf(angle) });
+        camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+        camera.fovy = 70.0f;
+
+        UpdateOcclusionCuller(&culler, camera, 16.0f/9.0f);
+        updateTime += culler.stats.time;
+        if (culler.stats.time > maxUpdateTime) maxUpdateTime = culler.stats.time;
+
+        Frustum frustum = GetFrustumFromMatrix(culler.viewProjection);
+        double start = GetTimerSeconds();
+
+        for (int rz = 0; rz < regionsZ; rz++)
+        {
+            for (int rx = 0; rx < regionsX; rx++)
+            {
+                BoundingBox bounds = { { cs.x*(rx*regionSize - 0.5f), 0.0f, cs.z*(rz*regionSize - 0.5f) }, { cs.x*((rx + 1)*regionSize - 0.5f), cs.y, cs.z*((rz + 1)*regionSize - 0.5f) } };
+                if (CheckFrustumBox(&frustum, bounds) && CheckOcclusionBox(&culler, bounds)) visible++;
+            }
+        }
+
+        testTime += GetTimerSeconds() - start;
+        tested += culler.stats.tested;
+        culled += culler.stats.culled;
+        occluders += culler.stats.occluders;
+
+        // Culled regions checked against the ray cast reference after timing
+        if (f >= checkFrames) continue;
+
+        for (int y = 0; y < culler.height; y++)
+        {
+            for (int x = 0; x < culler.width; x++) distances[y*culler.width + x] = GetOccluderRayDistance(grid, (Vector3){ 0.0f, 0.0f, 0.0f }, GetOcclusionPixelRay(&culler, camera, 16.0f/9.0f, x, y), 3.402823466e+38f);
+        }
+
+        for (int rz = 0; rz < regionsZ; rz++)
+        {
+            for (int rx = 0; rx < regionsX; rx++)
+            {
+                BoundingBox bounds = { { cs.x*(rx*regionSize - 0.5f), 0.0f, cs.z*(rz*regionSize - 0.5f) }, { cs.x*((rx + 1)*regionSize - 0.5f), cs.y, cs.z*((rz + 1)*regionSize - 0.5f) } };
+                if (!CheckFrustumBox(&frustum, bounds) || CheckOcclusionBox(&culler, bounds)) continue;
+
+                checked++;
+                if (IsOcclusionBoxVisible(&culler, camera, 16.0f/9.0f, bounds, distances)) wrong++;
+            }
+        }
+    }
+
+    int failures = wrong + ((updateTime/frames > budget)? 1 : 0);
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "OCCLUSION: %i frames, %i regions: %.3f ms update (max %.3f ms, budget %.3f ms, %.1f occluders), %.3f ms tests, %.1f%% of frustum visible regions culled, %.1f regions drawn per frame",
+        frames, regionsX*regionsZ, updateTime*1000.0/frames, maxUpdateTime*1000.0f, budget*1000.0f, (float)occluders/frames, testTime*1000.0/frames, (tested > 0)? 100.0f*culled/tested : 0.0f, (float)visible/frames);
+    TRACELOG((wrong == 0)? LOG_INFO : LOG_WARNING, "OCCLUSION: %i culled regions checked against ray casts, %i visible", checked, wrong);
+
+    RL_FREE(distances);
+    UnloadOcclusionCuller(&culler);
+
+    return failures;
+}
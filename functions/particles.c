@@ -0,0 +1,382 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 and Matrix functionality
+#include "rlgl.h"           // Required for: rlBegin(), rlSetTexture(), rlCheckRenderBatchLimit()
+
+#include <stdlib.h>         // Required for: malloc(), free(), abs()
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: floorf(), fmaxf(), fabsf()
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // Required for: SSE2 particle integration
+#endif
+
+// Particles: one preallocated structure-of-arrays pool per particle type (sparks, smoke, ...)
+// NOTE: Update integrates velocity, position and lifetime 4 particles at a time, then dead particles
+// are removed with swap-remove so live particles stay packed in [0, count). Pools don't grow,
+// emitting into a full pool drops the new particles. Each pool is drawn as one batch of billboards.
+
+#define PARTICLE_DRAW_CHUNK     1024        // Particles per rlgl batch check
+
+typedef struct ParticleType {
+    Texture2D texture;          // Billboard texture, pools with the same texture could share a batch
+    Color colorStart;           // Color at spawn, blended to colorEnd over lifetime
+    Color colorEnd;
+    float sizeStart;            // Billboard size at spawn, blended to sizeEnd over lifetime
+    float sizeEnd;
+    Vector3 gravity;            // Acceleration (world units per second^2)
+    float drag;                 // Velocity damping per second
+    float bounce;               // Floor collision: vertical velocity kept on bounce
+    float friction;             // Floor collision: horizontal velocity kept on bounce
+} ParticleType;
+
+typedef struct ParticlePool {
+    ParticleType type;
+    int capacity;
+    int count;
+
+    // Optional floor collision against a cubicmap grid drawn at gridPosition
+    const CubicmapGrid *grid;
+    Vector3 gridPosition;
+
+    // Particle data, indexed by [0, count)
+    float *posX;
+    float *posY;
+    float *posZ;
+    float *velX;
+    float *velY;
+    float *velZ;
+    float *life;                // Remaining lifetime (seconds), dead at <= 0
+    float *lifeScale;           // 1/lifetime, remaining life fraction is life*lifeScale
+
+    unsigned int seed;          // Emission random state (xorshift)
+} ParticlePool;
+
+// Load particle pool with fixed capacity
+ParticlePool LoadParticlePool(int capacity, ParticleType type)
+{
+    ParticlePool pool = { 0 };
+
+    pool.type = type;
+    pool.capacity = capacity;
+    pool.seed = 0x9e3779b9u;
+
+    // Arrays are padded to 4 particles, integration works on full SIMD lanes
+    int padded = (capacity + 3) & ~3;
+    pool.posX = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.posY = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.posZ = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.velX = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.velY = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.velZ = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.life = (float *)RL_CALLOC(padded, sizeof(float));
+    pool.lifeScale = (float *)RL_CALLOC(padded, sizeof(float));
+
+    return pool;
+}
+
+// Unload particle pool data (texture is not owned by the pool)
+void UnloadParticlePool(ParticlePool *pool)
+{
+    RL_FREE(pool->posX);
+    RL_FREE(pool->posY);
+    RL_FREE(pool->posZ);
+    RL_FREE(pool->velX);
+    RL_FREE(pool->velY);
+    RL_FREE(pool->velZ);
+    RL_FREE(pool->life);
+    RL_FREE(pool->lifeScale);
+
+    memset(pool, 0, sizeof(ParticlePool));
+}
+
+// Enable floor collision against cubicmap cells (grid drawn at position), NULL disables it
+void SetParticlePoolGrid(ParticlePool *pool, const CubicmapGrid *grid, Vector3 position)
+{
+    pool->grid = grid;
+    pool->gridPosition = position;
+}
+
+// Get random float in [-1, 1] from pool random state
+static float GetParticleRandom(ParticlePool *pool)
+{
+    pool->seed ^= pool->seed << 13;
+    pool->seed ^= pool->seed >> 17;
+    pool->seed ^= pool->seed << 5;
+
+    return (float)(pool->seed & 0xffffff)/(float)0x7fffff - 1.0f;
+}
+
+// Emit particles at position, velocity is direction*speed plus a random offset of spread*speed
+// NOTE: Lifetime varies +-25% per particle, returns number of particles emitted
+int EmitParticles(ParticlePool *pool, Vector3 position, Vector3 direction, float speed, float spread, float lifetime, int count)
+{
+    if (count > pool->capacity - pool->count) count = pool->capacity - pool->count;
+
+    for (int n = 0; n < count; n++)
+    {
+        int i = pool->count++;
+
+        // Random offset inside unit sphere
+        Vector3 offset;
+        do { offset = (Vector3){ GetParticleRandom(pool), GetParticleRandom(pool), GetParticleRandom(pool) }; } while (Vector3LengthSqr(offset) > 1.0f);
+
+        float life = lifetime*(1.0f + 0.25f*GetParticleRandom(pool));
+
+        pool->posX[i] = position.x;
+        pool->posY[i] = position.y;
+        pool->posZ[i] = position.z;
+        pool->velX[i] = (direction.x + offset.x*spread)*speed;
+        pool->velY[i] = (direction.y + offset.y*spread)*speed;
+        pool->velZ[i] = (direction.z + offset.z*spread)*speed;
+        pool->life[i] = life;
+        pool->lifeScale[i] = 1.0f/life;
+    }
+
+    return count;
+}
+
+// Integrate particles: v = (v + g*dt)*damping, p += v*dt, life -= dt
+static void IntegrateParticlesScalar(ParticlePool *pool, float dt)
+{
+    const Vector3 g = pool->type.gravity;
+    float damping = fmaxf(0.0f, 1.0f - pool->type.drag*dt);
+
+    for (int i = 0; i < pool->count; i++)
+    {
+        pool->velX[i] = (pool->velX[i] + g.x*dt)*damping;
+        pool->velY[i] = (pool->velY[i] + g.y*dt)*damping;
+        pool->velZ[i] = (pool->velZ[i] + g.z*dt)*damping;
+        pool->posX[i] += pool->velX[i]*dt;
+        pool->posY[i] += pool->velY[i]*dt;
+        pool->posZ[i] += pool->velZ[i]*dt;
+        pool->life[i] -= dt;
+    }
+}
+
+#if defined(__SSE2__)
+// Integrate particles 4 at a time, same arithmetic as IntegrateParticlesScalar()
+// NOTE: Padding lanes past count are integrated too, they are dead and never read
+static void IntegrateParticlesSSE2(ParticlePool *pool, float dt)
+{
+    float damping = fmaxf(0.0f, 1.0f - pool->type.drag*dt);
+    const __m128 vdt = _mm_set1_ps(dt);
+    const __m128 vdamping = _mm_set1_ps(damping);
+    const __m128 gx = _mm_set1_ps(pool->type.gravity.x*dt);
+    const __m128 gy = _mm_set1_ps(pool->type.gravity.y*dt);
+    const __m128 gz = _mm_set1_ps(pool->type.gravity.z*dt);
+
+    for (int i = 0; i < pool->count; i += 4)
+    {
+        __m128 vx = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&pool->velX[i]), gx), vdamping);
+        __m128 vy = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&pool->velY[i]), gy), vdamping);
+        __m128 vz = _mm_mul_ps(_mm_add_ps(_mm_loadu_ps(&pool->velZ[i]), gz), vdamping);
+
+        _mm_storeu_ps(&pool->velX[i], vx);
+        _mm_storeu_ps(&pool->velY[i], vy);
+        _mm_storeu_ps(&pool->velZ[i], vz);
+        _mm_storeu_ps(&pool->posX[i], _mm_add_ps(_mm_loadu_ps(&pool->posX[i]), _mm_mul_ps(vx, vdt)));
+        _mm_storeu_ps(&pool->posY[i], _mm_add_ps(_mm_loadu_ps(&pool->posY[i]), _mm_mul_ps(vy, vdt)));
+        _mm_storeu_ps(&pool->posZ[i], _mm_add_ps(_mm_loadu_ps(&pool->posZ[i]), _mm_mul_ps(vz, vdt)));
+        _mm_storeu_ps(&pool->life[i], _mm_sub_ps(_mm_loadu_ps(&pool->life[i]), vdt));
+    }
+}
+#endif
+
+// Collide particles with cubicmap floor heights, particles inside solid cells die
+static void CollideParticles(ParticlePool *pool)
+{
+    const CubicmapGrid *grid = pool->grid;
+    float scaleX = 1.0f/grid->cubeSize.x;
+    float scaleZ = 1.0f/grid->cubeSize.z;
+    float scaleY = grid->cubeSize.y/255.0f;
+
+    for (int i = 0; i < pool->count; i++)
+    {
+        int x = (int)floorf((pool->posX[i] - pool->gridPosition.x)*scaleX + 0.5f);
+        int z = (int)floorf((pool->posZ[i] - pool->gridPosition.z)*scaleZ + 0.5f);
+        if ((x < 0) || (z < 0) || (x >= grid->width) || (z >= grid->height)) continue;
+
+        int floor = grid->floor[z*grid->width + x];
+        if (floor >= grid->ceiling[z*grid->width + x]) { pool->life[i] = 0.0f; continue; }
+
+        float floorY = pool->gridPosition.y + floor*scaleY;
+        if (pool->posY[i] < floorY)
+        {
+            pool->posY[i] = floorY;
+            if (pool->velY[i] < 0.0f) pool->velY[i] = -pool->velY[i]*pool->type.bounce;
+            pool->velX[i] *= pool->type.friction;
+            pool->velZ[i] *= pool->type.friction;
+        }
+    }
+}
+
+// Remove dead particles, last live particle takes the dead particle index
+static void CompactParticles(ParticlePool *pool)
+{
+    int i = 0;
+
+    while (i < pool->count)
+    {
+        if (pool->life[i] > 0.0f) { i++; continue; }
+
+        int last = --pool->count;
+        pool->posX[i] = pool->posX[last];
+        pool->posY[i] = pool->posY[last];
+        pool->posZ[i] = pool->posZ[last];
+        pool->velX[i] = pool->velX[last];
+        pool->velY[i] = pool->velY[last];
+        pool->velZ[i] = pool->velZ[last];
+        pool->life[i] = pool->life[last];
+        pool->lifeScale[i] = pool->lifeScale[last];
+    }
+}
+
+// Update particles: integrate, collide with floor (if grid set) and remove dead particles
+void UpdateParticles(ParticlePool *pool, float dt)
+{
+    if (dt <= 0.0f) return;
+
+#if defined(__SSE2__)
+    IntegrateParticlesSSE2(pool, dt);
+#else
+    IntegrateParticlesScalar(pool, dt);
+#endif
+
+    if (pool->grid != NULL) CollideParticles(pool);
+
+    CompactParticles(pool);
+}
+
+// Draw particles as camera facing quads, one texture bind for the whole pool
+// NOTE: Depth writes are disabled while drawing, so overlapping particles don't cut each other
+void DrawParticles(const ParticlePool *pool, Camera camera)
+{
+    if (pool->count == 0) return;
+
+    Matrix view = GetCameraMatrix(camera);
+    Vector3 right = { view.m0, view.m4, view.m8 };
+    Vector3 up = { view.m1, view.m5, view.m9 };
+    const ParticleType *type = &pool->type;
+
+    rlDisableDepthMask();
+    rlSetTexture(type->texture.id);
+
+    for (int first = 0; first < pool->count; first += PARTICLE_DRAW_CHUNK)
+    {
+        int last = (first + PARTICLE_DRAW_CHUNK < pool->count)? first + PARTICLE_DRAW_CHUNK : pool->count;
+
+        rlCheckRenderBatchLimit(4*(last - first));
+        rlBegin(RL_QUADS);
+
+        for (int i = first; i < last; i++)
+        {
+            float t = 1.0f - pool->life[i]*pool->lifeScale[i];     // 0 at spawn, 1 at death
+            float half = 0.5f*(type->sizeStart + (type->sizeEnd - type->sizeStart)*t);
+            Vector3 p = { pool->posX[i], pool->posY[i], pool->posZ[i] };
+            Vector3 r = Vector3Scale(right, half);
+            Vector3 u = Vector3Scale(up, half);
+
+            rlColor4ub((unsigned char)(type->colorStart.r + (type->colorEnd.r - type->colorStart.r)*t),
+                       (unsigned char)(type->colorStart.g + (type->colorEnd.g - type->colorStart.g)*t),
+                       (unsigned char)(type->colorStart.b + (type->colorEnd.b - type->colorStart.b)*t),
+                       (unsigned char)(type->colorStart.a + (type->colorEnd.a - type->colorStart.a)*t));
+
+            rlTexCoord2f(0.0f, 0.0f); rlVertex3f(p.x - r.x + u.x, p.y - r.y + u.y, p.z - r.z + u.z);
+            rlTexCoord2f(0.0f, 1.0f); rlVertex3f(p.x - r.x - u.x, p.y - r.y - u.y, p.z - r.z - u.z);
+            rlTexCoord2f(1.0f, 1.0f); rlVertex3f(p.x + r.x - u.x, p.y + r.y - u.y, p.z + r.z - u.z);
+            rlTexCoord2f(1.0f, 0.0f); rlVertex3f(p.x + r.x + u.x, p.y + r.y + u.y, p.z + r.z + u.z);
+        }
+
+        rlEnd();
+    }
+
+    rlSetTexture(0);
+    rlEnableDepthMask();
+}
+
+// Benchmark particle update: scalar and SIMD integration, collision and compaction, logs avg times
+// NOTE: Runs headless, particles live longer than the benchmark so count stays constant until the
+// last tick, where half of them are killed to time compaction. Returns the number of particles where
+// SIMD and scalar integration disagree, that end up below the floor or are lost or kept dead by compaction
+int BenchmarkParticles(int count, int ticks)
+{
+    ParticleType type = { 0 };
+    type.gravity = (Vector3){ 0.0f, -9.8f, 0.0f };
+    type.drag = 0.5f;
+    type.bounce = 0.4f;
+    type.friction = 0.8f;
+
+    ParticlePool pool = LoadParticlePool(count, type);
+    float dt = 1.0f/60.0f;
+
+    EmitParticles(&pool, (Vector3){ 0.0f, 1.0f, 0.0f }, (Vector3){ 0.0f, 1.0f, 0.0f }, 5.0f, 1.0f, ticks*dt*4.0f, count);
+
+    double start = GetTimerSeconds();
+    for (int t = 0; t < ticks; t++) IntegrateParticlesScalar(&pool, dt);
+    double scalarTime = GetTimerSeconds() - start;
+
+    int failures = 0;
+
+#if defined(__SSE2__)
+    // Same emission on a second pool, integrated with SIMD and compared against the scalar pool
+    ParticlePool simdPool = LoadParticlePool(count, type);
+    EmitParticles(&simdPool, (Vector3){ 0.0f, 1.0f, 0.0f }, (Vector3){ 0.0f, 1.0f, 0.0f }, 5.0f, 1.0f, ticks*dt*4.0f, count);
+
+    start = GetTimerSeconds();
+    for (int t = 0; t < ticks; t++) IntegrateParticlesSSE2(&simdPool, dt);
+    double simdTime = GetTimerSeconds() - start;
+
+    for (int i = 0; i < pool.count; i++)
+    {
+        const float a[4] = { pool.posX[i], pool.posY[i], pool.posZ[i], pool.life[i] };
+        const float b[4] = { simdPool.posX[i], simdPool.posY[i], simdPool.posZ[i], simdPool.life[i] };
+
+        for (int k = 0; k < 4; k++)
+        {
+            if (!(fabsf(a[k] - b[k]) <= 1e-4f*(1.0f + fabsf(a[k])))) { failures++; break; }
+        }
+    }
+
+    UnloadParticlePool(&simdPool);
+#else
+    double simdTime = scalarTime;
+#endif
+
+    // Floor collision against a flat open grid
+    CubicmapGrid grid = { 64, 64, (unsigned char *)RL_CALLOC(64*64, 1), (unsigned char *)RL_MALLOC(64*64), { 1.0f, 1.0f, 1.0f } };
+    memset(grid.ceiling, 255, 64*64);
+    SetParticlePoolGrid(&pool, &grid, (Vector3){ -32.0f, 0.0f, -32.0f });
+
+    start = GetTimerSeconds();
+    for (int t = 0; t < ticks; t++) CollideParticles(&pool);
+    double collideTime = GetTimerSeconds() - start;
+
+    // Particles over the grid must be at or above the floor
+    for (int i = 0; i < pool.count; i++)
+    {
+        float x = floorf(pool.posX[i] - pool.gridPosition.x + 0.5f), z = floorf(pool.posZ[i] - pool.gridPosition.z + 0.5f);
+        if ((x >= 0.0f) && (z >= 0.0f) && (x < grid.width) && (z < grid.height) && !(pool.posY[i] >= pool.gridPosition.y)) failures++;
+    }
+
+    for (int i = 0; i < pool.count; i += 2) pool.life[i] = 0.0f;
+
+    int alive = 0;
+    for (int i = 0; i < pool.count; i++) if (pool.life[i] > 0.0f) alive++;
+
+    start = GetTimerSeconds();
+    CompactParticles(&pool);
+    double compactTime = GetTimerSeconds() - start;
+
+    // Compaction keeps exactly the live particles
+    failures += abs(pool.count - alive);
+    for (int i = 0; i < pool.count; i++) if (!(pool.life[i] > 0.0f)) failures++;
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "PARTICLES: %i particles, integrate: scalar %.3f ms, SIMD %.3f ms, floor collision %.3f ms, compact (50%% dead) %.3f ms, %i invalid",
+        count, scalarTime*1000.0/ticks, simdTime*1000.0/ticks, collideTime*1000.0/ticks, compactTime*1000.0, failures);
+
+    RL_FREE(grid.floor);
+    RL_FREE(grid.ceiling);
+    UnloadParticlePool(&pool);
+
+    return failures;
+}
@@ -0,0 +1,1016 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 and Quaternion functionality
+#include "rlgl.h"           // Required for: rlPushMatrix(), rlRotatef()
+
+#include <stdlib.h>         // Required for: rand(), srand()
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: fabsf(), floorf(), ceilf(), sqrtf(), fminf(), fmaxf()
+
+// Physics: lightweight rigid bodies (boxes and spheres) colliding with each other and a cubicmap grid
+// NOTE: Fixed step pipeline: integrate velocities, sort-and-sweep broadphase on X, contacts, sequential
+// impulse solver, integrate positions, island sleeping. Box pairs use a separating axis test with
+// clipped face contacts, boxes against the grid use their corners.
+// Bodies linked by contacts form an island, an island sleeps when all of its bodies stayed still
+// for PHYSICS_SLEEP_TIME, sleeping bodies are not integrated or collided with the grid.
+
+#define PHYSICS_STEP                (1.0f/60.0f)
+#define PHYSICS_MAX_SUBSTEPS        4           // Max fixed steps per UpdatePhysicsWorld() call
+#define PHYSICS_ITERATIONS          8           // Solver iterations per step
+#define PHYSICS_MAX_CONTACTS        16          // Contact capacity per body
+#define PHYSICS_BOUNDS_MARGIN       0.02f       // Bounds inflation, keeps resting pairs in the broadphase
+#define PHYSICS_SLOP                0.01f       // Allowed penetration, avoids jitter on resting contacts
+#define PHYSICS_BAUMGARTE           0.2f        // Penetration fraction recovered per step
+#define PHYSICS_SLEEP_TIME          0.5f        // Seconds an island must stay still before sleeping
+#define PHYSICS_SLEEP_LINEAR        0.05f       // Max linear speed considered still (world units per second)
+#define PHYSICS_SLEEP_ANGULAR       0.1f        // Max angular speed considered still (radians per second)
+#define PHYSICS_LINEAR_DAMPING      0.05f       // Velocity damping per second
+#define PHYSICS_ANGULAR_DAMPING     0.5f        // Angular damping per second, also stops spheres rolling forever
+#define PHYSICS_GRID_EXTENT         1000.0f     // Vertical extent of grid floor/ceiling/wall boxes
+
+typedef enum PhysicsShape {
+    PHYSICS_BOX = 0,
+    PHYSICS_SPHERE
+} PhysicsShape;
+
+typedef struct PhysicsBody {
+    int shape;
+    Vector3 halfSize;               // Box half extents, x is the radius for spheres
+    float invMass;                  // 0 for static bodies
+    Vector3 invInertia;             // Inverse inertia, body space diagonal
+    float restitution;
+    float friction;
+
+    Vector3 position;
+    Quaternion rotation;
+    Vector3 velocity;
+    Vector3 angularVelocity;
+
+    BoundingBox bounds;
+    float stillTime;                // Time spent below sleep speeds
+    bool sleeping;
+} PhysicsBody;
+
+typedef struct PhysicsContact {
+    int a;
+    int b;                          // Second body, -1 for the grid
+    Vector3 point;
+    Vector3 normal;                 // From b to a
+    float depth;
+
+    Vector3 tangent[2];
+    float normalMass;
+    float tangentMass[2];
+    float bias;                     // Target separating velocity
+    float normalImpulse;            // Accumulated impulses
+    float tangentImpulse[2];
+} PhysicsContact;
+
+typedef struct PhysicsStats {
+    int bodies;
+    int awake;
+    int pairs;                      // Broadphase pairs tested
+    int contacts;
+} PhysicsStats;
+
+typedef struct PhysicsWorld {
+    PhysicsBody *bodies;
+    int count;
+    int capacity;
+
+    int *order;                     // Body indices sorted by bounds.min.x, kept by insertion sort
+    PhysicsContact *contacts;
+    int contactCount;
+    int contactCapacity;
+    int *island;                    // Union-find parent per body
+    float *islandStill;             // Min still time per island root
+
+    const CubicmapGrid *grid;       // Optional, static world geometry
+    Vector3 gridPosition;
+
+    Vector3 gravity;
+    float accumulator;
+    PhysicsStats stats;
+} PhysicsWorld;
+
+// Static body used as the grid side of contacts
+static const PhysicsBody physicsGridBody = { 0 };
+
+// Load physics world with room for capacity bodies
+PhysicsWorld LoadPhysicsWorld(int capacity)
+{
+    PhysicsWorld world = { 0 };
+
+    world.bodies = (PhysicsBody *)RL_CALLOC(capacity, sizeof(PhysicsBody));
+    world.order = (int *)RL_MALLOC(capacity*sizeof(int));
+    world.island = (int *)RL_MALLOC(capacity*sizeof(int));
+    world.islandStill = (float *)RL_MALLOC(capacity*sizeof(float));
+    world.contactCapacity = capacity*PHYSICS_MAX_CONTACTS;
+    world.contacts = (PhysicsContact *)RL_MALLOC(world.contactCapacity*sizeof(PhysicsContact));
+    world.capacity = capacity;
+    world.gravity = (Vector3){ 0.0f, -9.8f, 0.0f };
+
+    return world;
+}
+
+// Unload physics world
+void UnloadPhysicsWorld(PhysicsWorld *world)
+{
+    RL_FREE(world->bodies);
+    RL_FREE(world->order);
+    RL_FREE(world->island);
+    RL_FREE(world->islandStill);
+    RL_FREE(world->contacts);
+
+    memset(world, 0, sizeof(PhysicsWorld));
+}
+
+// Set cubicmap grid bodies collide with, position is the grid draw offset
+void SetPhysicsWorldGrid(PhysicsWorld *world, const CubicmapGrid *grid, Vector3 position)
+{
+    world->grid = grid;
+    world->gridPosition = position;
+}
+
+// Update body bounds from position and rotation
+static void UpdatePhysicsBounds(PhysicsBody *body)
+{
+    Vector3 extent = body->halfSize;
+
+    if (body->shape == PHYSICS_SPHERE) extent = (Vector3){ body->halfSize.x, body->halfSize.x, body->halfSize.x };
+    else
+    {
+        // Box extents along world axes: |R|*halfSize
+        Vector3 axisX = Vector3RotateByQuaternion((Vector3){ body->halfSize.x, 0.0f, 0.0f }, body->rotation);
+        Vector3 axisY = Vector3RotateByQuaternion((Vector3){ 0.0f, body->halfSize.y, 0.0f }, body->rotation);
+        Vector3 axisZ = Vector3RotateByQuaternion((Vector3){ 0.0f, 0.0f, body->halfSize.z }, body->rotation);
+        extent.x = fabsf(axisX.x) + fabsf(axisY.x) + fabsf(axisZ.x);
+        extent.y = fabsf(axisX.y) + fabsf(axisY.y) + fabsf(axisZ.y);
+        extent.z = fabsf(axisX.z) + fabsf(axisY.z) + fabsf(axisZ.z);
+    }
+
+    extent = Vector3AddValue(extent, PHYSICS_BOUNDS_MARGIN);
+    body->bounds.min = Vector3Subtract(body->position, extent);
+    body->bounds.max = Vector3Add(body->position, extent);
+}
+
+// Add body, mass 0 makes it static, returns body index (-1 if the world is full)
+static int AddPhysicsBody(PhysicsWorld *world, int shape, Vector3 position, Vector3 halfSize, float mass, Vector3 inertia)
+{
+    if (world->count == world->capacity) return -1;
+
+    int index = world->count++;
+    PhysicsBody *body = &world->bodies[index];
+
+    memset(body, 0, sizeof(PhysicsBody));
+    body->shape = shape;
+    body->halfSize = halfSize;
+    body->position = position;
+    body->rotation = QuaternionIdentity();
+    body->restitution = 0.2f;
+    body->friction = 0.6f;
+
+    if (mass > 0.0f)
+    {
+        body->invMass = 1.0f/mass;
+        body->invInertia = (Vector3){ 1.0f/inertia.x, 1.0f/inertia.y, 1.0f/inertia.z };
+    }
+
+    UpdatePhysicsBounds(body);
+    world->order[index] = index;
+
+    return index;
+}
+
+// Add box body
+int AddPhysicsBox(PhysicsWorld *world, Vector3 position, Vector3 halfSize, float mass)
+{
+    Vector3 size2 = Vector3Multiply(halfSize, halfSize);
+    Vector3 inertia = { mass/3.0f*(size2.y + size2.z), mass/3.0f*(size2.x + size2.z), mass/3.0f*(size2.x + size2.y) };
+
+    return AddPhysicsBody(world, PHYSICS_BOX, position, halfSize, mass, inertia);
+}
+
+// Add sphere body
+int AddPhysicsSphere(PhysicsWorld *world, Vector3 position, float radius, float mass)
+{
+    float inertia = 0.4f*mass*radius*radius;
+
+    return AddPhysicsBody(world, PHYSICS_SPHERE, position, (Vector3){ radius, radius, radius }, mass, (Vector3){ inertia, inertia, inertia });
+}
+
+// Wake body up, i.e. after moving it from code
+void WakePhysicsBody(PhysicsWorld *world, int index)
+{
+    world->bodies[index].sleeping = false;
+    world->bodies[index].stillTime = 0.0f;
+}
+
+// Apply world inverse inertia: R*invI*R^T*v
+static Vector3 ApplyInvInertia(const PhysicsBody *body, Vector3 v)
+{
+    if (body->invMass == 0.0f) return (Vector3){ 0 };
+
+    Vector3 local = Vector3RotateByQuaternion(v, QuaternionInvert(body->rotation));
+
+    return Vector3RotateByQuaternion(Vector3Multiply(local, body->invInertia), body->rotation);
+}
+
+// Apply impulse at a world point, wakes the body
+void ApplyPhysicsImpulse(PhysicsWorld *world, int index, Vector3 impulse, Vector3 point)
+{
+    PhysicsBody *body = &world->bodies[index];
+    if (body->invMass == 0.0f) return;
+
+    body->velocity = Vector3Add(body->velocity, Vector3Scale(impulse, body->invMass));
+    body->angularVelocity = Vector3Add(body->angularVelocity, ApplyInvInertia(body, Vector3CrossProduct(Vector3Subtract(point, body->position), impulse)));
+    WakePhysicsBody(world, index);
+}
+
+// Add contact, dropped when the contact buffer is full
+static void AddPhysicsContact(PhysicsWorld *world, int a, int b, Vector3 point, Vector3 normal, float depth)
+{
+    if (world->contactCount == world->contactCapacity) return;
+
+    PhysicsContact *contact = &world->contacts[world->contactCount++];
+    contact->a = a;
+    contact->b = b;
+    contact->point = point;
+    contact->normal = normal;
+    contact->depth = depth;
+}
+
+// Get box corner in world space, corner index bits select the sign per axis
+static Vector3 GetBoxCorner(const PhysicsBody *box, int corner)
+{
+    Vector3 local = { (corner & 1)? box->halfSize.x : -box->halfSize.x, (corner & 2)? box->halfSize.y : -box->halfSize.y, (corner & 4)? box->halfSize.z : -box->halfSize.z };
+
+    return Vector3Add(box->position, Vector3RotateByQuaternion(local, box->rotation));
+}
+
+// Get box axis in world space
+static Vector3 GetBoxAxis(const PhysicsBody *box, int axis)
+{
+    Vector3 unit = { (axis == 0)? 1.0f : 0.0f, (axis == 1)? 1.0f : 0.0f, (axis == 2)? 1.0f : 0.0f };
+
+    return Vector3RotateByQuaternion(unit, box->rotation);
+}
+
+// Get box half extent along an axis index
+static float GetBoxExtent(const PhysicsBody *box, int axis)
+{
+    return (axis == 0)? box->halfSize.x : ((axis == 1)? box->halfSize.y : box->halfSize.z);
+}
+
+// Box face contacts: incident box face clipped against the reference face sides
+// NOTE: normal is the reference face normal, pointing towards the incident box
+static void CollideBoxFace(PhysicsWorld *world, int reference, int incident, int referenceAxis, Vector3 normal, const Vector3 axesR[3], const Vector3 axesI[3])
+{
+    const PhysicsBody *boxR = &world->bodies[reference];
+    const PhysicsBody *boxI = &world->bodies[incident];
+
+    Vector3 faceCenter = Vector3Add(boxR->position, Vector3Scale(normal, GetBoxExtent(boxR, referenceAxis)));
+    int sideAxis[2] = { (referenceAxis + 1)%3, (referenceAxis + 2)%3 };
+
+    // Incident face: the one most opposed to the normal
+    int incidentAxis = 0;
+    float best = 0.0f;
+    for (int k = 0; k < 3; k++)
+    {
+        float d = fabsf(Vector3DotProduct(axesI[k], normal));
+        if (d > best) { best = d; incidentAxis = k; }
+    }
+
+    float sign = (Vector3DotProduct(axesI[incidentAxis], normal) > 0.0f)? -1.0f : 1.0f;
+    Vector3 incidentCenter = Vector3Add(boxI->position, Vector3Scale(axesI[incidentAxis], sign*GetBoxExtent(boxI, incidentAxis)));
+    Vector3 u = Vector3Scale(axesI[(incidentAxis + 1)%3], GetBoxExtent(boxI, (incidentAxis + 1)%3));
+    Vector3 v = Vector3Scale(axesI[(incidentAxis + 2)%3], GetBoxExtent(boxI, (incidentAxis + 2)%3));
+
+    Vector3 polygon[8] = {
+        Vector3Add(incidentCenter, Vector3Add(u, v)), Vector3Add(incidentCenter, Vector3Subtract(u, v)),
+        Vector3Subtract(incidentCenter, Vector3Add(u, v)), Vector3Subtract(incidentCenter, Vector3Subtract(u, v))
+    };
+    int count = 4;
+
+    // Clip against the 4 side planes of the reference face (Sutherland-Hodgman)
+    for (int plane = 0; plane < 4; plane++)
+    {
+        Vector3 axis = axesR[sideAxis[plane/2]];
+        float sideSign = (plane%2 == 0)? 1.0f : -1.0f;
+        float extent = GetBoxExtent(boxR, sideAxis[plane/2]);
+        Vector3 clipped[8];
+        int clippedCount = 0;
+
+        for (int i = 0; i < count; i++)
+        {
+            Vector3 p0 = polygon[i];
+            Vector3 p1 = polygon[(i + 1)%count];
+            // Small tolerance keeps points lying on the side plane (equal sized boxes) from splitting edges
+            float d0 = sideSign*Vector3DotProduct(Vector3Subtract(p0, faceCenter), axis) - extent - 0.001f;
+            float d1 = sideSign*Vector3DotProduct(Vector3Subtract(p1, faceCenter), axis) - extent - 0.001f;
+
+            if (d0 <= 0.0f) clipped[clippedCount++] = p0;
+            if ((d0 <= 0.0f) != (d1 <= 0.0f)) clipped[clippedCount++] = Vector3Lerp(p0, p1, d0/(d0 - d1));
+        }
+
+        count = clippedCount;
+        for (int i = 0; i < count; i++) polygon[i] = clipped[i];
+        if (count == 0) return;
+    }
+
+    for (int i = 0; i < count; i++)
+    {
+        float separation = Vector3DotProduct(Vector3Subtract(polygon[i], faceCenter), normal);
+        if (separation < 0.0f) AddPhysicsContact(world, incident, reference, polygon[i], normal, -separation);
+    }
+}
+
+// Box against box: separating axis test over face normals and edge cross products
+static void CollideBoxes(PhysicsWorld *world, int a, int b)
+{
+    const PhysicsBody *boxA = &world->bodies[a];
+    const PhysicsBody *boxB = &world->bodies[b];
+    Vector3 axesA[3] = { GetBoxAxis(boxA, 0), GetBoxAxis(boxA, 1), GetBoxAxis(boxA, 2) };
+    Vector3 axesB[3] = { GetBoxAxis(boxB, 0), GetBoxAxis(boxB, 1), GetBoxAxis(boxB, 2) };
+    Vector3 delta = Vector3Subtract(boxB->position, boxA->position);
+
+    float bestFace[2] = { PHYSICS_GRID_EXTENT, PHYSICS_GRID_EXTENT };
+    int bestFaceAxis[2] = { 0 };
+    float bestEdge = PHYSICS_GRID_EXTENT;
+    int bestEdgeAxis[2] = { 0 };
+    Vector3 bestEdgeNormal = { 0 };
+
+    for (int test = 0; test < 15; test++)
+    {
+        Vector3 axis;
+        if (test < 3) axis = axesA[test];
+        else if (test < 6) axis = axesB[test - 3];
+        else
+        {
+            axis = Vector3CrossProduct(axesA[(test - 6)/3], axesB[(test - 6)%3]);
+            float length = Vector3Length(axis);
+            if (length < 1e-4f) continue;       // Parallel edges, covered by face axes
+            axis = Vector3Scale(axis, 1.0f/length);
+        }
+
+        float radiusA = 0.0f, radiusB = 0.0f;
+        for (int k = 0; k < 3; k++)
+        {
+            radiusA += GetBoxExtent(boxA, k)*fabsf(Vector3DotProduct(axesA[k], axis));
+            radiusB += GetBoxExtent(boxB, k)*fabsf(Vector3DotProduct(axesB[k], axis));
+        }
+
+        float penetration = radiusA + radiusB - fabsf(Vector3DotProduct(delta, axis));
+        if (penetration < 0.0f) return;         // Separating axis found
+
+        if ((test < 6) && (penetration < bestFace[test/3])) { bestFace[test/3] = penetration; bestFaceAxis[test/3] = test%3; }
+        else if ((test >= 6) && (penetration < bestEdge))
+        {
+            bestEdge = penetration;
+            bestEdgeAxis[0] = (test - 6)/3;
+            bestEdgeAxis[1] = (test - 6)%3;
+            bestEdgeNormal = (Vector3DotProduct(delta, axis) < 0.0f)? Vector3Negate(axis) : axis;
+        }
+    }
+
+    // Face contacts are preferred, they give stable resting manifolds
+    float bestFaceDepth = fminf(bestFace[0], bestFace[1]);
+
+    if (bestEdge < 0.95f*bestFaceDepth - 0.01f)
+    {
+        // Edge-edge: closest points of the two supporting edges
+        Vector3 normal = bestEdgeNormal;
+        Vector3 pointA = boxA->position, pointB = boxB->position;
+
+        for (int k = 0; k < 3; k++)
+        {
+            if (k != bestEdgeAxis[0]) pointA = Vector3Add(pointA, Vector3Scale(axesA[k], ((Vector3DotProduct(axesA[k], normal) > 0.0f)? 1.0f : -1.0f)*GetBoxExtent(boxA, k)));
+            if (k != bestEdgeAxis[1]) pointB = Vector3Add(pointB, Vector3Scale(axesB[k], ((Vector3DotProduct(axesB[k], normal) < 0.0f)? 1.0f : -1.0f)*GetBoxExtent(boxB, k)));
+        }
+
+        Vector3 edgeA = axesA[bestEdgeAxis[0]];
+        Vector3 edgeB = axesB[bestEdgeAxis[1]];
+        Vector3 r = Vector3Subtract(pointA, pointB);
+        float ab = Vector3DotProduct(edgeA, edgeB);
+        float denominator = 1.0f - ab*ab;
+        float s = 0.0f, t = 0.0f;
+
+        if (denominator > 1e-6f)
+        {
+            float ra = Vector3DotProduct(edgeA, r), rb = Vector3DotProduct(edgeB, r);
+            s = Clamp((ab*rb - ra)/denominator, -GetBoxExtent(boxA, bestEdgeAxis[0]), GetBoxExtent(boxA, bestEdgeAxis[0]));
+            t = Clamp((rb + ab*s), -GetBoxExtent(boxB, bestEdgeAxis[1]), GetBoxExtent(boxB, bestEdgeAxis[1]));
+        }
+
+        Vector3 closestA = Vector3Add(pointA, Vector3Scale(edgeA, s));
+        Vector3 closestB = Vector3Add(pointB, Vector3Scale(edgeB, t));
+        AddPhysicsContact(world, b, a, Vector3Lerp(closestA, closestB, 0.5f), normal, bestEdge);
+    }
+    else if (bestFace[0] <= 1.05f*bestFace[1] + 0.001f)
+    {
+        Vector3 normal = axesA[bestFaceAxis[0]];
+        if (Vector3DotProduct(delta, normal) < 0.0f) normal = Vector3Negate(normal);
+
+        // Reference face on A: flip the box axis so the face extent sign matches the normal
+        Vector3 axesR[3] = { axesA[0], axesA[1], axesA[2] };
+        axesR[bestFaceAxis[0]] = normal;
+        CollideBoxFace(world, a, b, bestFaceAxis[0], normal, axesR, axesB);
+    }
+    else
+    {
+        Vector3 normal = axesB[bestFaceAxis[1]];
+        if (Vector3DotProduct(delta, normal) > 0.0f) normal = Vector3Negate(normal);
+
+        Vector3 axesR[3] = { axesB[0], axesB[1], axesB[2] };
+        axesR[bestFaceAxis[1]] = normal;
+        CollideBoxFace(world, b, a, bestFaceAxis[1], normal, axesR, axesA);
+    }
+}
+
+// Sphere a against box b: closest point on the box
+static void CollideSphereBox(PhysicsWorld *world, int a, int b)
+{
+    const PhysicsBody *sphere = &world->bodies[a];
+    const PhysicsBody *box = &world->bodies[b];
+    float radius = sphere->halfSize.x;
+
+    Vector3 local = Vector3RotateByQuaternion(Vector3Subtract(sphere->position, box->position), QuaternionInvert(box->rotation));
+    Vector3 closest = { Clamp(local.x, -box->halfSize.x, box->halfSize.x), Clamp(local.y, -box->halfSize.y, box->halfSize.y), Clamp(local.z, -box->halfSize.z, box->halfSize.z) };
+    Vector3 delta = Vector3Subtract(local, closest);
+    float distance = Vector3Length(delta);
+
+    if (distance >= radius) return;
+
+    Vector3 normal = { 0.0f, 1.0f, 0.0f };
+    float depth = radius - distance;
+
+    if (distance > 0.0f) normal = Vector3Scale(delta, 1.0f/distance);
+    else
+    {
+        // Center inside the box, push out through the closest face
+        Vector3 faceDepth = { box->halfSize.x - fabsf(local.x), box->halfSize.y - fabsf(local.y), box->halfSize.z - fabsf(local.z) };
+        normal = (Vector3){ (local.x < 0.0f)? -1.0f : 1.0f, 0.0f, 0.0f };
+        depth = faceDepth.x + radius;
+        if (faceDepth.y < faceDepth.x) { normal = (Vector3){ 0.0f, (local.y < 0.0f)? -1.0f : 1.0f, 0.0f }; depth = faceDepth.y + radius; }
+        if ((faceDepth.z < faceDepth.x) && (faceDepth.z < faceDepth.y)) { normal = (Vector3){ 0.0f, 0.0f, (local.z < 0.0f)? -1.0f : 1.0f }; depth = faceDepth.z + radius; }
+    }
+
+    normal = Vector3RotateByQuaternion(normal, box->rotation);
+    AddPhysicsContact(world, a, b, Vector3Subtract(sphere->position, Vector3Scale(normal, radius)), normal, depth);
+}
+
+// Narrowphase between two bodies
+static void CollidePhysicsBodies(PhysicsWorld *world, int a, int b)
+{
+    const PhysicsBody *bodyA = &world->bodies[a];
+    const PhysicsBody *bodyB = &world->bodies[b];
+
+    if ((bodyA->shape == PHYSICS_SPHERE) && (bodyB->shape == PHYSICS_SPHERE))
+    {
+        Vector3 delta = Vector3Subtract(bodyA->position, bodyB->position);
+        float distance = Vector3Length(delta);
+        float radii = bodyA->halfSize.x + bodyB->halfSize.x;
+
+        if (distance >= radii) return;
+
+        Vector3 normal = (distance > 0.0f)? Vector3Scale(delta, 1.0f/distance) : (Vector3){ 0.0f, 1.0f, 0.0f };
+        AddPhysicsContact(world, a, b, Vector3Subtract(bodyA->position, Vector3Scale(normal, bodyA->halfSize.x)), normal, radii - distance);
+    }
+    else if (bodyA->shape == PHYSICS_SPHERE) CollideSphereBox(world, a, b);
+    else if (bodyB->shape == PHYSICS_SPHERE) CollideSphereBox(world, b, a);
+    else CollideBoxes(world, a, b);
+}
+
+// Check grid point is open (outside the grid is open)
+static bool IsPhysicsGridOpen(const PhysicsWorld *world, int x, int z, float y)
+{
+    const CubicmapGrid *grid = world->grid;
+    if ((x < 0) || (z < 0) || (x >= grid->width) || (z >= grid->height)) return true;
+
+    float scaleY = grid->cubeSize.y/255.0f;
+    int floor = grid->floor[z*grid->width + x];
+    int ceiling = grid->ceiling[z*grid->width + x];
+
+    return (floor < ceiling) && (y >= world->gridPosition.y + floor*scaleY) && (y <= world->gridPosition.y + ceiling*scaleY);
+}
+
+// Point against grid: push out through the closest floor, ceiling or cell side leading to open space
+static bool GetPhysicsGridPointContact(const PhysicsWorld *world, Vector3 point, Vector3 *normal, float *depth)
+{
+    const CubicmapGrid *grid = world->grid;
+    float localX = (point.x - world->gridPosition.x)/grid->cubeSize.x + 0.5f;
+    float localZ = (point.z - world->gridPosition.z)/grid->cubeSize.z + 0.5f;
+    int x = (int)floorf(localX);
+    int z = (int)floorf(localZ);
+
+    if (IsPhysicsGridOpen(world, x, z, point.y)) return false;
+
+    float scaleY = grid->cubeSize.y/255.0f;
+    int floor = grid->floor[z*grid->width + x];
+    int ceiling = grid->ceiling[z*grid->width + x];
+    float floorY = world->gridPosition.y + floor*scaleY;
+    float ceilingY = world->gridPosition.y + ceiling*scaleY;
+    bool solid = (floor >= ceiling);
+
+    float best = PHYSICS_GRID_EXTENT;
+    if (!solid && (point.y < floorY)) { best = floorY - point.y; *normal = (Vector3){ 0.0f, 1.0f, 0.0f }; }
+    if (!solid && (point.y > ceilingY) && (point.y - ceilingY < best)) { best = point.y - ceilingY; *normal = (Vector3){ 0.0f, -1.0f, 0.0f }; }
+
+    // Cell sides, only towards neighbours open at this height
+    float sideDepth[4] = { (localX - x)*grid->cubeSize.x, (x + 1 - localX)*grid->cubeSize.x, (localZ - z)*grid->cubeSize.z, (z + 1 - localZ)*grid->cubeSize.z };
+    int sideX[4] = { x - 1, x + 1, x, x };
+    int sideZ[4] = { z, z, z - 1, z + 1 };
+    Vector3 sideNormal[4] = { { -1.0f, 0.0f, 0.0f }, { 1.0f, 0.0f, 0.0f }, { 0.0f, 0.0f, -1.0f }, { 0.0f, 0.0f, 1.0f } };
+
+    for (int s = 0; s < 4; s++)
+    {
+        if ((sideDepth[s] < best) && IsPhysicsGridOpen(world, sideX[s], sideZ[s], point.y))
+        {
+            best = sideDepth[s];
+            *normal = sideNormal[s];
+        }
+    }
+
+    *depth = best;
+
+    return (best < PHYSICS_GRID_EXTENT);
+}
+
+// Sphere against the grid cells it overlaps, cells are floor/ceiling boxes or a full column when solid
+static void CollideSphereGrid(PhysicsWorld *world, int index)
+{
+    const CubicmapGrid *grid = world->grid;
+    const PhysicsBody *sphere = &world->bodies[index];
+    float radius = sphere->halfSize.x;
+    float scaleY = grid->cubeSize.y/255.0f;
+
+    int minX = (int)floorf((sphere->bounds.min.x - world->gridPosition.x)/grid->cubeSize.x + 0.5f);
+    int maxX = (int)floorf((sphere->bounds.max.x - world->gridPosition.x)/grid->cubeSize.x + 0.5f);
+    int minZ = (int)floorf((sphere->bounds.min.z - world->gridPosition.z)/grid->cubeSize.z + 0.5f);
+    int maxZ = (int)floorf((sphere->bounds.max.z - world->gridPosition.z)/grid->cubeSize.z + 0.5f);
+    if (minX < 0) minX = 0;
+    if (minZ < 0) minZ = 0;
+    if (maxX >= grid->width) maxX = grid->width - 1;
+    if (maxZ >= grid->height) maxZ = grid->height - 1;
+
+    for (int z = minZ; z <= maxZ; z++)
+    {
+        for (int x = minX; x <= maxX; x++)
+        {
+            int floor = grid->floor[z*grid->width + x];
+            int ceiling = grid->ceiling[z*grid->width + x];
+            Vector3 cellMin = { world->gridPosition.x + (x - 0.5f)*grid->cubeSize.x, 0.0f, world->gridPosition.z + (z - 0.5f)*grid->cubeSize.z };
+            Vector3 cellMax = { cellMin.x + grid->cubeSize.x, 0.0f, cellMin.z + grid->cubeSize.z };
+
+            // Solid boxes of the cell: below floor and above ceiling, or the whole column
+            float boxMinY[2] = { world->gridPosition.y - PHYSICS_GRID_EXTENT, world->gridPosition.y + ceiling*scaleY };
+            float boxMaxY[2] = { world->gridPosition.y + floor*scaleY, world->gridPosition.y + PHYSICS_GRID_EXTENT };
+            if (floor >= ceiling) { boxMaxY[0] = boxMaxY[1]; boxMinY[1] = boxMaxY[1]; }
+
+            for (int k = 0; k < 2; k++)
+            {
+                if (boxMinY[k] >= boxMaxY[k]) continue;
+
+                Vector3 closest = { Clamp(sphere->position.x, cellMin.x, cellMax.x), Clamp(sphere->position.y, boxMinY[k], boxMaxY[k]), Clamp(sphere->position.z, cellMin.z, cellMax.z) };
+                Vector3 delta = Vector3Subtract(sphere->position, closest);
+                float distance = Vector3Length(delta);
+
+                if (distance >= radius) continue;
+
+                // Center inside a box only happens on deep hits, push up
+                Vector3 normal = (distance > 0.0f)? Vector3Scale(delta, 1.0f/distance) : (Vector3){ 0.0f, 1.0f, 0.0f };
+                float depth = (distance > 0.0f)? radius - distance : boxMaxY[k] - sphere->position.y + radius;
+                AddPhysicsContact(world, index, -1, closest, normal, depth);
+            }
+        }
+    }
+}
+
+// Body against the grid
+static void CollidePhysicsGrid(PhysicsWorld *world, int index)
+{
+    const PhysicsBody *body = &world->bodies[index];
+
+    if (body->shape == PHYSICS_SPHERE) CollideSphereGrid(world, index);
+    else
+    {
+        for (int c = 0; c < 8; c++)
+        {
+            Vector3 corner = GetBoxCorner(body, c);
+            Vector3 normal = { 0 };
+            float depth = 0.0f;
+
+            if (GetPhysicsGridPointContact(world, corner, &normal, &depth)) AddPhysicsContact(world, index, -1, corner, normal, depth);
+        }
+    }
+}
+
+// Broadphase: insertion sort by bounds.min.x (nearly sorted from last step), then sweep along X
+static void CollidePhysicsBroadphase(PhysicsWorld *world)
+{
+    PhysicsBody *bodies = world->bodies;
+    int *order = world->order;
+
+    for (int i = 1; i < world->count; i++)
+    {
+        int index = order[i];
+        float minX = bodies[index].bounds.min.x;
+        int j = i - 1;
+
+        while ((j >= 0) && (bodies[order[j]].bounds.min.x > minX))
+        {
+            order[j + 1] = order[j];
+            j--;
+        }
+
+        order[j + 1] = index;
+    }
+
+    for (int i = 0; i < world->count; i++)
+    {
+        int a = order[i];
+        const PhysicsBody *bodyA = &bodies[a];
+        bool restingA = bodyA->sleeping || (bodyA->invMass == 0.0f);
+
+        for (int j = i + 1; (j < world->count) && (bodies[order[j]].bounds.min.x <= bodyA->bounds.max.x); j++)
+        {
+            int b = order[j];
+            const PhysicsBody *bodyB = &bodies[b];
+
+            if (restingA && (bodyB->sleeping || (bodyB->invMass == 0.0f))) continue;
+            if ((bodyA->bounds.max.y < bodyB->bounds.min.y) || (bodyA->bounds.min.y > bodyB->bounds.max.y) ||
+                (bodyA->bounds.max.z < bodyB->bounds.min.z) || (bodyA->bounds.min.z > bodyB->bounds.max.z)) continue;
+
+            world->stats.pairs++;
+            CollidePhysicsBodies(world, a, b);
+        }
+    }
+}
+
+// Get relative velocity of contact bodies at the contact point
+static Vector3 GetContactVelocity(const PhysicsBody *bodyA, const PhysicsBody *bodyB, Vector3 rA, Vector3 rB)
+{
+    Vector3 velocityA = Vector3Add(bodyA->velocity, Vector3CrossProduct(bodyA->angularVelocity, rA));
+    Vector3 velocityB = Vector3Add(bodyB->velocity, Vector3CrossProduct(bodyB->angularVelocity, rB));
+
+    return Vector3Subtract(velocityA, velocityB);
+}
+
+// Get effective mass along a direction
+static float GetContactMass(const PhysicsBody *bodyA, const PhysicsBody *bodyB, Vector3 rA, Vector3 rB, Vector3 direction)
+{
+    Vector3 angularA = Vector3CrossProduct(ApplyInvInertia(bodyA, Vector3CrossProduct(rA, direction)), rA);
+    Vector3 angularB = Vector3CrossProduct(ApplyInvInertia(bodyB, Vector3CrossProduct(rB, direction)), rB);
+    float k = bodyA->invMass + bodyB->invMass + Vector3DotProduct(Vector3Add(angularA, angularB), direction);
+
+    return (k > 0.0f)? 1.0f/k : 0.0f;
+}
+
+// Apply impulse to both contact bodies
+static void ApplyContactImpulse(PhysicsBody *bodyA, PhysicsBody *bodyB, Vector3 rA, Vector3 rB, Vector3 impulse)
+{
+    bodyA->velocity = Vector3Add(bodyA->velocity, Vector3Scale(impulse, bodyA->invMass));
+    bodyA->angularVelocity = Vector3Add(bodyA->angularVelocity, ApplyInvInertia(bodyA, Vector3CrossProduct(rA, impulse)));
+
+    if (bodyB->invMass > 0.0f)
+    {
+        bodyB->velocity = Vector3Subtract(bodyB->velocity, Vector3Scale(impulse, bodyB->invMass));
+        bodyB->angularVelocity = Vector3Subtract(bodyB->angularVelocity, ApplyInvInertia(bodyB, Vector3CrossProduct(rB, impulse)));
+    }
+}
+
+// Sequential impulse solver: normal impulses with restitution and penetration bias, Coulomb friction
+static void SolvePhysicsContacts(PhysicsWorld *world, float dt)
+{
+    for (int i = 0; i < world->contactCount; i++)
+    {
+        PhysicsContact *contact = &world->contacts[i];
+        PhysicsBody *bodyA = &world->bodies[contact->a];
+        const PhysicsBody *bodyB = (contact->b >= 0)? &world->bodies[contact->b] : &physicsGridBody;
+        Vector3 rA = Vector3Subtract(contact->point, bodyA->position);
+        Vector3 rB = Vector3Subtract(contact->point, bodyB->position);
+        Vector3 n = contact->normal;
+
+        // Contacts with sleeping bodies wake them, islands decide if they sleep again
+        if (contact->b >= 0) world->bodies[contact->b].sleeping = false;
+        bodyA->sleeping = false;
+
+        contact->tangent[0] = (fabsf(n.x) > 0.57f)? Vector3Normalize((Vector3){ n.y, -n.x, 0.0f }) : Vector3Normalize((Vector3){ 0.0f, n.z, -n.y });
+        contact->tangent[1] = Vector3CrossProduct(n, contact->tangent[0]);
+        contact->normalMass = GetContactMass(bodyA, bodyB, rA, rB, n);
+        contact->tangentMass[0] = GetContactMass(bodyA, bodyB, rA, rB, contact->tangent[0]);
+        contact->tangentMass[1] = GetContactMass(bodyA, bodyB, rA, rB, contact->tangent[1]);
+        contact->normalImpulse = 0.0f;
+        contact->tangentImpulse[0] = 0.0f;
+        contact->tangentImpulse[1] = 0.0f;
+
+        float approach = Vector3DotProduct(GetContactVelocity(bodyA, bodyB, rA, rB), n);
+        float restitution = fmaxf(bodyA->restitution, bodyB->restitution);
+        contact->bias = PHYSICS_BAUMGARTE/dt*fmaxf(contact->depth - PHYSICS_SLOP, 0.0f);
+        if (approach < -1.0f) contact->bias = fmaxf(contact->bias, -restitution*approach);
+    }
+
+    for (int iteration = 0; iteration < PHYSICS_ITERATIONS; iteration++)
+    {
+        for (int i = 0; i < world->contactCount; i++)
+        {
+            PhysicsContact *contact = &world->contacts[i];
+            PhysicsBody *bodyA = &world->bodies[contact->a];
+            PhysicsBody *bodyB = (contact->b >= 0)? &world->bodies[contact->b] : (PhysicsBody *)&physicsGridBody;
+            Vector3 rA = Vector3Subtract(contact->point, bodyA->position);
+            Vector3 rB = Vector3Subtract(contact->point, bodyB->position);
+            float friction = sqrtf(bodyA->friction*((contact->b >= 0)? bodyB->friction : bodyA->friction));
+
+            // Friction first, limited by the normal impulse of the previous iteration
+            for (int t = 0; t < 2; t++)
+            {
+                Vector3 velocity = GetContactVelocity(bodyA, bodyB, rA, rB);
+                float lambda = -Vector3DotProduct(velocity, contact->tangent[t])*contact->tangentMass[t];
+                float limit = friction*contact->normalImpulse;
+                float accumulated = Clamp(contact->tangentImpulse[t] + lambda, -limit, limit);
+
+                lambda = accumulated - contact->tangentImpulse[t];
+                contact->tangentImpulse[t] = accumulated;
+                ApplyContactImpulse(bodyA, bodyB, rA, rB, Vector3Scale(contact->tangent[t], lambda));
+            }
+
+            Vector3 velocity = GetContactVelocity(bodyA, bodyB, rA, rB);
+            float lambda = (contact->bias - Vector3DotProduct(velocity, contact->normal))*contact->normalMass;
+            float accumulated = fmaxf(contact->normalImpulse + lambda, 0.0f);
+
+            lambda = accumulated - contact->normalImpulse;
+            contact->normalImpulse = accumulated;
+            ApplyContactImpulse(bodyA, bodyB, rA, rB, Vector3Scale(contact->normal, lambda));
+        }
+    }
+}
+
+// Find island root with path halving
+static int FindPhysicsIsland(int *island, int index)
+{
+    while (island[index] != index)
+    {
+        island[index] = island[island[index]];
+        index = island[index];
+    }
+
+    return index;
+}
+
+// Islands: bodies linked by contacts sleep together once all of them stayed still long enough
+static void UpdatePhysicsSleeping(PhysicsWorld *world, float dt)
+{
+    for (int i = 0; i < world->count; i++)
+    {
+        PhysicsBody *body = &world->bodies[i];
+        world->island[i] = i;
+        world->islandStill[i] = PHYSICS_SLEEP_TIME;
+
+        if (body->invMass == 0.0f) continue;
+        if (body->sleeping) continue;
+
+        bool still = (Vector3LengthSqr(body->velocity) < PHYSICS_SLEEP_LINEAR*PHYSICS_SLEEP_LINEAR) &&
+                     (Vector3LengthSqr(body->angularVelocity) < PHYSICS_SLEEP_ANGULAR*PHYSICS_SLEEP_ANGULAR);
+        body->stillTime = still? body->stillTime + dt : 0.0f;
+    }
+
+    for (int i = 0; i < world->contactCount; i++)
+    {
+        const PhysicsContact *contact = &world->contacts[i];
+        if ((contact->b < 0) || (world->bodies[contact->b].invMass == 0.0f)) continue;
+
+        int rootA = FindPhysicsIsland(world->island, contact->a);
+        int rootB = FindPhysicsIsland(world->island, contact->b);
+        if (rootA != rootB) world->island[rootA] = rootB;
+    }
+
+    for (int i = 0; i < world->count; i++)
+    {
+        if (world->bodies[i].invMass == 0.0f) continue;
+
+        int root = FindPhysicsIsland(world->island, i);
+        world->islandStill[root] = fminf(world->islandStill[root], world->bodies[i].stillTime);
+    }
+
+    world->stats.awake = 0;
+
+    for (int i = 0; i < world->count; i++)
+    {
+        PhysicsBody *body = &world->bodies[i];
+        if (body->invMass == 0.0f) continue;
+
+        if (world->islandStill[FindPhysicsIsland(world->island, i)] >= PHYSICS_SLEEP_TIME)
+        {
+            body->sleeping = true;
+            body->velocity = (Vector3){ 0 };
+            body->angularVelocity = (Vector3){ 0 };
+        }
+        else
+        {
+            body->sleeping = false;
+            world->stats.awake++;
+        }
+    }
+}
+
+// Run one fixed physics step
+void StepPhysicsWorld(PhysicsWorld *world)
+{
+    float dt = PHYSICS_STEP;
+
+    world->contactCount = 0;
+    world->stats.pairs = 0;
+
+    for (int i = 0; i < world->count; i++)
+    {
+        PhysicsBody *body = &world->bodies[i];
+        if ((body->invMass == 0.0f) || body->sleeping) continue;
+
+        body->velocity = Vector3Add(body->velocity, Vector3Scale(world->gravity, dt));
+        body->velocity = Vector3Scale(body->velocity, 1.0f/(1.0f + PHYSICS_LINEAR_DAMPING*dt));
+        body->angularVelocity = Vector3Scale(body->angularVelocity, 1.0f/(1.0f + PHYSICS_ANGULAR_DAMPING*dt));
+        UpdatePhysicsBounds(body);
+    }
+
+    CollidePhysicsBroadphase(world);
+
+    if (world->grid != NULL)
+    {
+        for (int i = 0; i < world->count; i++)
+        {
+            if ((world->bodies[i].invMass > 0.0f) && !world->bodies[i].sleeping) CollidePhysicsGrid(world, i);
+        }
+    }
+
+    SolvePhysicsContacts(world, dt);
+
+    for (int i = 0; i < world->count; i++)
+    {
+        PhysicsBody *body = &world->bodies[i];
+        if ((body->invMass == 0.0f) || body->sleeping) continue;
+
+        body->position = Vector3Add(body->position, Vector3Scale(body->velocity, dt));
+
+        Vector3 w = body->angularVelocity;
+        Quaternion spin = QuaternionMultiply((Quaternion){ w.x, w.y, w.z, 0.0f }, body->rotation);
+        body->rotation.x += 0.5f*dt*spin.x;
+        body->rotation.y += 0.5f*dt*spin.y;
+        body->rotation.z += 0.5f*dt*spin.z;
+        body->rotation.w += 0.5f*dt*spin.w;
+        body->rotation = QuaternionNormalize(body->rotation);
+    }
+
+    UpdatePhysicsSleeping(world, dt);
+
+    world->stats.bodies = world->count;
+    world->stats.contacts = world->contactCount;
+}
+
+// Update physics world: runs the fixed steps covered by dt, up to PHYSICS_MAX_SUBSTEPS
+void UpdatePhysicsWorld(PhysicsWorld *world, float dt)
+{
+    world->accumulator += dt;
+
+    int steps = 0;
+    while ((world->accumulator >= PHYSICS_STEP) && (steps < PHYSICS_MAX_SUBSTEPS))
+    {
+        StepPhysicsWorld(world);
+        world->accumulator -= PHYSICS_STEP;
+        steps++;
+    }
+
+    // Drop time we could not catch up with
+    if (world->accumulator >= PHYSICS_STEP) world->accumulator = 0.0f;
+}
+
+// Get closest body hit by ray, returns -1 if nothing is hit
+int GetPhysicsRayHit(const PhysicsWorld *world, Ray ray, float maxDistance, RayCollision *collision)
+{
+    int result = -1;
+    RayCollision closest = { 0 };
+    closest.distance = maxDistance;
+
+    for (int i = 0; i < world->count; i++)
+    {
+        const PhysicsBody *body = &world->bodies[i];
+        RayCollision hit = { 0 };
+
+        if (body->shape == PHYSICS_SPHERE) hit = GetRayCollisionSphere(ray, body->position, body->halfSize.x);
+        else
+        {
+            // Box hit in body space
+            Quaternion inverse = QuaternionInvert(body->rotation);
+            Ray local = { Vector3RotateByQuaternion(Vector3Subtract(ray.position, body->position), inverse), Vector3RotateByQuaternion(ray.direction, inverse) };
+            hit = GetRayCollisionBox(local, (BoundingBox){ Vector3Negate(body->halfSize), body->halfSize });
+            hit.point = Vector3Add(body->position, Vector3RotateByQuaternion(hit.point, body->rotation));
+            hit.normal = Vector3RotateByQuaternion(hit.normal, body->rotation);
+        }
+
+        if (hit.hit && (hit.distance < closest.distance))
+        {
+            closest = hit;
+            result = i;
+        }
+    }
+
+    if (collision != NULL) *collision = closest;
+
+    return result;
+}
+
+// Get physics counters of the last step
+PhysicsStats GetPhysicsStats(const PhysicsWorld *world)
+{
+    return world->stats;
+}
+
+// Draw a body shape at a given position and rotation (i.e. from a simulation snapshot)
+void DrawPhysicsShape(int shape, Vector3 halfSize, Vector3 position, Quaternion rotation, Color color)
+{
+    Vector3 axis = { 0 };
+    float angle = 0.0f;
+    QuaternionToAxisAngle(rotation, &axis, &angle);
+
+    rlPushMatrix();
+        rlTranslatef(position.x, position.y, position.z);
+        rlRotatef(angle*RAD2DEG, axis.x, axis.y, axis.z);
+
+        if (shape == PHYSICS_SPHERE) DrawSphere((Vector3){ 0 }, halfSize.x, color);
+        else
+        {
+            DrawCube((Vector3){ 0 }, halfSize.x*2.0f, halfSize.y*2.0f, halfSize.z*2.0f, color);
+            DrawCubeWires((Vector3){ 0 }, halfSize.x*2.0f, halfSize.y*2.0f, halfSize.z*2.0f, BLACK);
+        }
+    rlPopMatrix();
+}
+
+// Benchmark physics: bodies dropped on a flat walled grid, logs avg step time while falling and once settled
+// NOTE: Runs headless, bodies spawn from a fixed seed, every 4th body is a sphere. Returns the number of bodies
+// that sink into the floor, leave the walled area or are not finite, plus one if the bodies never all sleep
+int BenchmarkPhysics(int bodyCount, int steps)
+{
+    int size = 64;
+    CubicmapGrid grid = { size, size, (unsigned char *)RL_CALLOC(size*size, 1), (unsigned char *)RL_MALLOC(size*size), { 1.0f, 16.0f, 1.0f } };
+    memset(grid.ceiling, 255, size*size);
+
+    // Solid border cells keep rolling bodies on the grid
+    for (int i = 0; i < size; i++)
+    {
+        int border[4] = { i, (size - 1)*size + i, i*size, i*size + size - 1 };
+        for (int k = 0; k < 4; k++) { grid.floor[border[k]] = 255; grid.ceiling[border[k]] = 0; }
+    }
+
+    PhysicsWorld world = LoadPhysicsWorld(bodyCount);
+    SetPhysicsWorldGrid(&world, &grid, (Vector3){ -size/2.0f, 0.0f, -size/2.0f });
+
+    // One loose layer dropped from random heights and orientations, neighbours collide and settle in small islands
+    srand(2024);
+    int side = (int)ceilf(sqrtf((float)bodyCount));
+    for (int i = 0; i < bodyCount; i++)
+    {
+        Vector3 position = { (i%side - side/2)*1.2f + (rand()%100)/500.0f, 0.6f + (rand()%100)/40.0f, (i/side - side/2)*1.2f + (rand()%100)/500.0f };
+        int index = (i%4 == 3)? AddPhysicsSphere(&world, position, 0.4f, 1.0f) : AddPhysicsBox(&world, position, (Vector3){ 0.4f, 0.4f, 0.4f }, 1.0f);
+
+        Vector3 axis = Vector3Normalize((Vector3){ (float)(rand()%100 - 50), (float)(rand()%100 - 50), (float)(rand()%100 - 50) + 0.5f });
+        world.bodies[index].rotation = QuaternionFromAxisAngle(axis, (rand()%628)/100.0f);
+        world.bodies[index].velocity = (Vector3){ (rand()%100 - 50)/50.0f, 0.0f, (rand()%100 - 50)/50.0f };
+    }
+
+    double start = GetTimerSeconds();
+    int awakeSum = 0;
+    for (int s = 0; s < steps; s++)
+    {
+        StepPhysicsWorld(&world);
+        awakeSum += world.stats.awake;
+    }
+    double activeTime = GetTimerSeconds() - start;
+
+    // Let everything settle, then time steps with sleeping islands
+    for (int s = 0; (s < 2000) && (world.stats.awake > 0); s++) StepPhysicsWorld(&world);
+    int settledAwake = world.stats.awake;
+
+    start = GetTimerSeconds();
+    for (int s = 0; s < steps; s++) StepPhysicsWorld(&world);
+    double settledTime = GetTimerSeconds() - start;
+
+    // Lowest point from the world bounds, rotated boxes reach below position.y - halfSize.y
+    int failures = (settledAwake > 0)? 1 : 0;
+    float lowest = 1000.0f;
+    float inside = size/2.0f - 1.5f;
+    for (int i = 0; i < world.count; i++)
+    {
+        const PhysicsBody *body = &world.bodies[i];
+        float bottom = body->bounds.min.y + PHYSICS_BOUNDS_MARGIN;
+
+        lowest = fminf(lowest, bottom);
+        if (!(bottom > -4.0f*PHYSICS_SLOP) || !(fabsf(body->position.x) < inside) || !(fabsf(body->position.z) < inside)) failures++;
+    }
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "PHYSICS: %i bodies, %i steps: falling avg %.3f ms/step (%i awake avg), settled avg %.3f ms/step (%i awake), lowest point %.3f, %i invalid",
+        bodyCount, steps, activeTime*1000.0/steps, awakeSum/steps, settledTime*1000.0/steps, settledAwake, lowest, failures);
+
+    UnloadPhysicsWorld(&world);
+    RL_FREE(grid.floor);
+    RL_FREE(grid.ceiling);
+
+    return failures;
+}
@@ -0,0 +1,565 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: malloc(), free(), rand()
+#include <math.h>           // Required for: floorf(), fabsf(), fminf(), fmaxf()
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // Required for: SSE2 ray packets
+#endif
+
+// Cubicmap raycasts: rays walk grid cells with a DDA, inside each cell the ray is tested against the
+// cell floor, ceiling and roof heights, walls are hit when the ray enters a cell at a solid height
+// NOTE: Rays are in mesh space (same space as GenMeshCubicmapGridData() vertices), distance is
+// measured in ray direction lengths, use normalized directions to get world units
+
+#define GRID_RAY_FACE_NONE      -1  // Ray started inside solid space
+
+#define GRID_RAY_INFINITY       3.402823466e+38f
+
+typedef struct GridRayHit {
+    bool hit;
+    int cellX;                  // Hit cell
+    int cellZ;
+    int face;                   // Hit face: 0 +X, 1 -X, 2 +Y, 3 -Y, 4 -Z, 5 +Z (same as compact mesh faces)
+    float distance;
+    Vector3 point;
+    Vector3 normal;
+} GridRayHit;
+
+// Ray traversal state, filled by SetupGridRay()
+typedef struct GridRayState {
+    int cellX, cellZ;
+    int stepX, stepZ;
+    int face;                   // Face crossed to enter current cell
+    float t0;                   // Current cell entry distance
+    float tExit;                // Grid exit (or max) distance
+    float tMaxX, tMaxZ;         // Distance to next cell boundary on each axis
+    float tDeltaX, tDeltaZ;     // Distance between cell boundaries on each axis
+} GridRayState;
+
+// Get normal of a hit face
+static Vector3 GetGridFaceNormal(int face)
+{
+    static const Vector3 normals[6] = { { 1, 0, 0 }, { -1, 0, 0 }, { 0, 1, 0 }, { 0, -1, 0 }, { 0, 0, -1 }, { 0, 0, 1 } };
+
+    return (face >= 0)? normals[face] : (Vector3){ 0 };
+}
+
+// Clip ray to the grid XZ bounds and find first cell, returns false if ray misses the grid
+static bool SetupGridRay(const CubicmapGrid *grid, Ray ray, float maxDistance, GridRayState *state)
+{
+    float w = grid->cubeSize.x;
+    float d = grid->cubeSize.z;
+    float minX = -0.5f*w, maxX = ((float)grid->width - 0.5f)*w;
+    float minZ = -0.5f*d, maxZ = ((float)grid->height - 0.5f)*d;
+
+    float tEnter = 0.0f;
+    float tExit = maxDistance;
+    int face = GRID_RAY_FACE_NONE;
+
+    if (ray.direction.x != 0.0f)
+    {
+        float ta = (minX - ray.position.x)/ray.direction.x;
+        float tb = (maxX - ray.position.x)/ray.direction.x;
+        if (ta > tb) { float t = ta; ta = tb; tb = t; }
+        if (ta > tEnter) { tEnter = ta; face = (ray.direction.x > 0.0f)? 1 : 0; }
+        if (tb < tExit) tExit = tb;
+    }
+    else if ((ray.position.x < minX) || (ray.position.x > maxX)) return false;
+
+    if (ray.direction.z != 0.0f)
+    {
+        float ta = (minZ - ray.position.z)/ray.direction.z;
+        float tb = (maxZ - ray.position.z)/ray.direction.z;
+        if (ta > tb) { float t = ta; ta = tb; tb = t; }
+        if (ta > tEnter) { tEnter = ta; face = (ray.direction.z > 0.0f)? 4 : 5; }
+        if (tb < tExit) tExit = tb;
+    }
+    else if ((ray.position.z < minZ) || (ray.position.z > maxZ)) return false;
+
+    if (tEnter > tExit) return false;
+
+    float px = ray.position.x + ray.direction.x*tEnter;
+    float pz = ray.position.z + ray.direction.z*tEnter;
+
+    state->cellX = (int)Clamp(floorf(px/w + 0.5f), 0.0f, (float)(grid->width - 1));
+    state->cellZ = (int)Clamp(floorf(pz/d + 0.5f), 0.0f, (float)(grid->height - 1));
+    state->stepX = (ray.direction.x > 0.0f)? 1 : -1;
+    state->stepZ = (ray.direction.z > 0.0f)? 1 : -1;
+    state->face = face;
+    state->t0 = tEnter;
+    state->tExit = tExit;
+
+    if (ray.direction.x != 0.0f)
+    {
+        state->tDeltaX = w/fabsf(ray.direction.x);
+        state->tMaxX = (((float)state->cellX + 0.5f*state->stepX)*w - ray.position.x)/ray.direction.x;
+    }
+    else state->tDeltaX = state->tMaxX = GRID_RAY_INFINITY;
+
+    if (ray.direction.z != 0.0f)
+    {
+        state->tDeltaZ = d/fabsf(ray.direction.z);
+        state->tMaxZ = (((float)state->cellZ + 0.5f*state->stepZ)*d - ray.position.z)/ray.direction.z;
+    }
+    else state->tDeltaZ = state->tMaxZ = GRID_RAY_INFINITY;
+
+    return true;
+}
+
+// Fill hit info
+static void SetGridRayHit(GridRayHit *hit, Ray ray, int cellX, int cellZ, int face, float distance)
+{
+    hit->hit = true;
+    hit->cellX = cellX;
+    hit->cellZ = cellZ;
+    hit->face = face;
+    hit->distance = distance;
+    hit->point = (Vector3){ ray.position.x + ray.direction.x*distance, ray.position.y + ray.direction.y*distance, ray.position.z + ray.direction.z*distance };
+    hit->normal = GetGridFaceNormal(face);
+}
+
+// Get ray collision with cubicmap cells (mesh space), up to maxDistance
+GridRayHit GetGridRayCollision(const CubicmapGrid *grid, Ray ray, float maxDistance)
+{
+    GridRayHit result = { 0 };
+    GridRayState s = { 0 };
+
+    result.face = GRID_RAY_FACE_NONE;
+
+    if (!SetupGridRay(grid, ray, maxDistance, &s)) return result;
+
+    float h2 = grid->cubeSize.y;
+    float oy = ray.position.y;
+    float dy = ray.direction.y;
+
+    while (true)
+    {
+        float t1 = fminf(fminf(s.tMaxX, s.tMaxZ), s.tExit);
+
+        int floor, ceiling;
+        GetCubicmapGridCell(grid, s.cellX, s.cellZ, &floor, &ceiling);
+
+        float fy = h2*(float)floor/255.0f;
+        float cy = h2*(float)ceiling/255.0f;
+        bool roof = (ceiling < 255) || (floor >= ceiling);
+        float y0 = oy + dy*s.t0;
+
+        // Entering the cell inside a solid part: wall (or start point inside solid space)
+        if ((y0 < fy) || (roof && (y0 > cy) && (y0 < h2)))
+        {
+            SetGridRayHit(&result, ray, s.cellX, s.cellZ, s.face, s.t0);
+            break;
+        }
+
+        // Horizontal surfaces inside the cell: roof top, floor top or ceiling bottom (open cells always have a ceiling)
+        float tHit = GRID_RAY_INFINITY;
+        int face = GRID_RAY_FACE_NONE;
+
+        if (dy < 0.0f)
+        {
+            if (roof && (y0 >= h2)) { tHit = (h2 - oy)/dy; face = 2; }
+            else { tHit = (fy - oy)/dy; face = 2; }
+        }
+        else if ((dy > 0.0f) && (y0 <= cy)) { tHit = (cy - oy)/dy; face = 3; }
+
+        if (tHit <= t1)
+        {
+            SetGridRayHit(&result, ray, s.cellX, s.cellZ, face, fmaxf(tHit, s.t0));
+            break;
+        }
+
+        if (t1 >= s.tExit) break;
+
+        // Step to next cell, entered through the face pointing back to the ray origin
+        if (s.tMaxX < s.tMaxZ)
+        {
+            s.cellX += s.stepX;
+            s.t0 = s.tMaxX;
+            s.tMaxX += s.tDeltaX;
+            s.face = (s.stepX > 0)? 1 : 0;
+        }
+        else
+        {
+            s.cellZ += s.stepZ;
+            s.t0 = s.tMaxZ;
+            s.tMaxZ += s.tDeltaZ;
+            s.face = (s.stepZ > 0)? 4 : 5;
+        }
+    }
+
+    return result;
+}
+
+// Check if there is a clear line of sight between two mesh space points
+bool CheckGridLineOfSight(const CubicmapGrid *grid, Vector3 from, Vector3 to)
+{
+    Vector3 delta = Vector3Subtract(to, from);
+    float length = Vector3Length(delta);
+
+    if (length <= 0.0f) return true;
+
+    Ray ray = { from, Vector3Scale(delta, 1.0f/length) };
+
+    return !GetGridRayCollision(grid, ray, length).hit;
+}
+
+#if defined(__SSE2__)
+// Select per lane: mask ? a : b
+static inline __m128 SelectGridLanes(__m128 mask, __m128 a, __m128 b) { return _mm_or_ps(_mm_and_ps(mask, a), _mm_andnot_ps(mask, b)); }
+static inline __m128i SelectGridLanesInt(__m128 mask, __m128i a, __m128i b) { __m128i m = _mm_castps_si128(mask); return _mm_or_si128(_mm_and_si128(m, a), _mm_andnot_si128(m, b)); }
+
+// Clip one axis of 4 rays to the grid bounds, same steps as SetupGridRay()
+static void SetupGridRayAxis4(__m128 p, __m128 d, float minBound, float maxBound, int facePositive, int faceNegative, __m128 *tEnter, __m128 *tExit, __m128i *face, __m128 *miss)
+{
+    const __m128 minB = _mm_set1_ps(minBound);
+    const __m128 maxB = _mm_set1_ps(maxBound);
+    __m128 moving = _mm_cmpneq_ps(d, _mm_setzero_ps());
+
+    __m128 ta = _mm_div_ps(_mm_sub_ps(minB, p), d);
+    __m128 tb = _mm_div_ps(_mm_sub_ps(maxB, p), d);
+    __m128 swap = _mm_cmpgt_ps(ta, tb);
+    __m128 tNear = SelectGridLanes(swap, tb, ta);
+    __m128 tFar = SelectGridLanes(swap, ta, tb);
+
+    __m128 enter = _mm_and_ps(moving, _mm_cmpgt_ps(tNear, *tEnter));
+    __m128i enterFace = SelectGridLanesInt(_mm_cmpgt_ps(d, _mm_setzero_ps()), _mm_set1_epi32(facePositive), _mm_set1_epi32(faceNegative));
+    *tEnter = SelectGridLanes(enter, tNear, *tEnter);
+    *face = SelectGridLanesInt(enter, enterFace, *face);
+    *tExit = SelectGridLanes(_mm_and_ps(moving, _mm_cmplt_ps(tFar, *tExit)), tFar, *tExit);
+
+    // Rays parallel to the axis miss if they start outside the bounds
+    *miss = _mm_or_ps(*miss, _mm_andnot_ps(moving, _mm_or_ps(_mm_cmplt_ps(p, minB), _mm_cmpgt_ps(p, maxB))));
+}
+
+// Get first cell and step distances of 4 rays on one axis, same steps as SetupGridRay()
+static void SetupGridRayCells4(__m128 p, __m128 d, __m128 tEnter, float size, int cells, __m128i *cell, __m128i *step, __m128 *tMax, __m128 *tDelta)
+{
+    const __m128 vsize = _mm_set1_ps(size);
+    const __m128 infinity = _mm_set1_ps(GRID_RAY_INFINITY);
+    __m128 moving = _mm_cmpneq_ps(d, _mm_setzero_ps());
+
+    // floorf() without SSE4.1: truncate, then step down where truncation rounded up
+    __m128 v = _mm_add_ps(_mm_div_ps(_mm_add_ps(p, _mm_mul_ps(d, tEnter)), vsize), _mm_set1_ps(0.5f));
+    __m128 truncated = _mm_cvtepi32_ps(_mm_cvttps_epi32(v));
+    __m128 floored = _mm_sub_ps(truncated, _mm_and_ps(_mm_cmpgt_ps(truncated, v), _mm_set1_ps(1.0f)));
+    __m128 clamped = _mm_min_ps(_mm_max_ps(floored, _mm_setzero_ps()), _mm_set1_ps((float)(cells - 1)));
+
+    *cell = _mm_cvttps_epi32(clamped);
+    *step = SelectGridLanesInt(_mm_cmpgt_ps(d, _mm_setzero_ps()), _mm_set1_epi32(1), _mm_set1_epi32(-1));
+
+    __m128 half = _mm_mul_ps(_mm_set1_ps(0.5f), _mm_cvtepi32_ps(*step));
+    __m128 absD = _mm_andnot_ps(_mm_set1_ps(-0.0f), d);
+    *tDelta = SelectGridLanes(moving, _mm_div_ps(vsize, absD), infinity);
+    *tMax = SelectGridLanes(moving, _mm_div_ps(_mm_sub_ps(_mm_mul_ps(_mm_add_ps(_mm_cvtepi32_ps(*cell), half), vsize), p), d), infinity);
+}
+
+// Setup traversal of 4 rays at once, same results as SetupGridRay() on each ray, returns mask of rays that hit the grid
+static int SetupGridRay4(const CubicmapGrid *grid, const Ray *rays, float maxDistance, GridRayState *states)
+{
+    float w = grid->cubeSize.x;
+    float d = grid->cubeSize.z;
+
+    __m128 px = _mm_setr_ps(rays[0].position.x, rays[1].position.x, rays[2].position.x, rays[3].position.x);
+    __m128 pz = _mm_setr_ps(rays[0].position.z, rays[1].position.z, rays[2].position.z, rays[3].position.z);
+    __m128 dx = _mm_setr_ps(rays[0].direction.x, rays[1].direction.x, rays[2].direction.x, rays[3].direction.x);
+    __m128 dz = _mm_setr_ps(rays[0].direction.z, rays[1].direction.z, rays[2].direction.z, rays[3].direction.z);
+
+    __m128 tEnter = _mm_setzero_ps();
+    __m128 tExit = _mm_set1_ps(maxDistance);
+    __m128i face = _mm_set1_epi32(GRID_RAY_FACE_NONE);
+    __m128 miss = _mm_setzero_ps();
+
+    SetupGridRayAxis4(px, dx, -0.5f*w, ((float)grid->width - 0.5f)*w, 1, 0, &tEnter, &tExit, &face, &miss);
+    SetupGridRayAxis4(pz, dz, -0.5f*d, ((float)grid->height - 0.5f)*d, 4, 5, &tEnter, &tExit, &face, &miss);
+    miss = _mm_or_ps(miss, _mm_cmpgt_ps(tEnter, tExit));
+
+    __m128i cellX, cellZ, stepX, stepZ;
+    __m128 tMaxX, tMaxZ, tDeltaX, tDeltaZ;
+    SetupGridRayCells4(px, dx, tEnter, w, grid->width, &cellX, &stepX, &tMaxX, &tDeltaX);
+    SetupGridRayCells4(pz, dz, tEnter, d, grid->height, &cellZ, &stepZ, &tMaxZ, &tDeltaZ);
+
+    float lanes[6][4];
+    int laneInts[5][4];
+    _mm_storeu_ps(lanes[0], tEnter);
+    _mm_storeu_ps(lanes[1], tExit);
+    _mm_storeu_ps(lanes[2], tMaxX);
+    _mm_storeu_ps(lanes[3], tMaxZ);
+    _mm_storeu_ps(lanes[4], tDeltaX);
+    _mm_storeu_ps(lanes[5], tDeltaZ);
+    _mm_storeu_si128((__m128i *)laneInts[0], cellX);
+    _mm_storeu_si128((__m128i *)laneInts[1], cellZ);
+    _mm_storeu_si128((__m128i *)laneInts[2], stepX);
+    _mm_storeu_si128((__m128i *)laneInts[3], stepZ);
+    _mm_storeu_si128((__m128i *)laneInts[4], face);
+
+    for (int i = 0; i < 4; i++)
+    {
+        states[i] = (GridRayState){ .cellX = laneInts[0][i], .cellZ = laneInts[1][i], .stepX = laneInts[2][i], .stepZ = laneInts[3][i], .face = laneInts[4][i],
+            .t0 = lanes[0][i], .tExit = lanes[1][i], .tMaxX = lanes[2][i], .tMaxZ = lanes[3][i], .tDeltaX = lanes[4][i], .tDeltaZ = lanes[5][i] };
+    }
+
+    return ~_mm_movemask_ps(miss) & 0xf;
+}
+
+// Ray packet lanes, spilled to memory only when a finished lane is refilled
+typedef struct GridRayLanes {
+    float oy[4], dy[4];
+    float t0[4], tExit[4];
+    float tMaxX[4], tMaxZ[4];
+    float tDeltaX[4], tDeltaZ[4];
+    int cellX[4], cellZ[4];
+    int stepX[4], stepZ[4];
+    int face[4];
+    int ray[4];                 // Ray traced by each lane
+} GridRayLanes;
+
+// Trace rays 4 lanes at a time, same arithmetic as GetGridRayCollision() so results are identical
+// NOTE: A lane whose ray finishes takes the next ray right away, so short rays don't leave lanes idle
+// while the longest ray of a fixed group of 4 is still stepping
+static void GetGridRayCollisionLanes(const CubicmapGrid *grid, const Ray *rays, int count, float maxDistance, GridRayHit *hits)
+{
+    GridRayLanes lanes = { 0 };
+    GridRayState setup[4] = { 0 };     // Traversal setup of rays setupFirst to setupFirst + setupCount - 1
+    int setupFirst = 0;
+    int setupCount = 0;
+    int setupMask = 0;
+    int next = 0;
+    int live = 0;
+
+    const __m128 h2 = _mm_set1_ps(grid->cubeSize.y);
+    const __m128 maxHeight = _mm_set1_ps(255.0f);
+    const __m128 zero = _mm_setzero_ps();
+    const __m128 infinity = _mm_set1_ps(GRID_RAY_INFINITY);
+
+    while (true)
+    {
+        // Refill empty lanes with the next rays entering the grid
+        for (int i = 0; i < 4; i++)
+        {
+            while (!(live & (1 << i)) && (next < count))
+            {
+                int r = next++;
+
+                hits[r] = (GridRayHit){ 0 };
+                hits[r].face = GRID_RAY_FACE_NONE;
+
+                // Setup is done for 4 rays at once, the last rays of the batch one by one
+                if (r >= setupFirst + setupCount)
+                {
+                    setupFirst = r;
+                    setupCount = (r + 4 <= count)? 4 : 1;
+                    if (setupCount == 4) setupMask = SetupGridRay4(grid, &rays[r], maxDistance, setup);
+                    else setupMask = SetupGridRay(grid, rays[r], maxDistance, &setup[0])? 1 : 0;
+                }
+
+                if (!(setupMask & (1 << (r - setupFirst)))) continue;
+
+                GridRayState s = setup[r - setupFirst];
+
+                lanes.oy[i] = rays[r].position.y;
+                lanes.dy[i] = rays[r].direction.y;
+                lanes.t0[i] = s.t0;
+                lanes.tExit[i] = s.tExit;
+                lanes.tMaxX[i] = s.tMaxX;
+                lanes.tMaxZ[i] = s.tMaxZ;
+                lanes.tDeltaX[i] = s.tDeltaX;
+                lanes.tDeltaZ[i] = s.tDeltaZ;
+                lanes.cellX[i] = s.cellX;
+                lanes.cellZ[i] = s.cellZ;
+                lanes.stepX[i] = s.stepX;
+                lanes.stepZ[i] = s.stepZ;
+                lanes.face[i] = s.face;
+                lanes.ray[i] = r;
+                live |= (1 << i);
+            }
+        }
+
+        if (live == 0) break;
+
+        __m128 oy = _mm_loadu_ps(lanes.oy);
+        __m128 dy = _mm_loadu_ps(lanes.dy);
+        __m128 t0 = _mm_loadu_ps(lanes.t0);
+        __m128 tExit = _mm_loadu_ps(lanes.tExit);
+        __m128 tMaxX = _mm_loadu_ps(lanes.tMaxX);
+        __m128 tMaxZ = _mm_loadu_ps(lanes.tMaxZ);
+        __m128 tDeltaX = _mm_loadu_ps(lanes.tDeltaX);
+        __m128 tDeltaZ = _mm_loadu_ps(lanes.tDeltaZ);
+        __m128i cellX = _mm_loadu_si128((const __m128i *)lanes.cellX);
+        __m128i cellZ = _mm_loadu_si128((const __m128i *)lanes.cellZ);
+        __m128i stepX = _mm_loadu_si128((const __m128i *)lanes.stepX);
+        __m128i stepZ = _mm_loadu_si128((const __m128i *)lanes.stepZ);
+        __m128i face = _mm_loadu_si128((const __m128i *)lanes.face);
+
+        // Face entered on each step direction: +X step enters -X face (1), -X step enters +X face (0), +Z step: 4, -Z step: 5
+        __m128i faceX = _mm_sub_epi32(_mm_setzero_si128(), _mm_cmpgt_epi32(stepX, _mm_setzero_si128()));
+        __m128i faceZ = _mm_add_epi32(_mm_set1_epi32(5), _mm_cmpgt_epi32(stepZ, _mm_setzero_si128()));
+
+        // Step until a lane finishes and there is a ray left to take its place
+        bool refill = false;
+        while ((live != 0) && !refill)
+        {
+            __m128 t1 = _mm_min_ps(_mm_min_ps(tMaxX, tMaxZ), tExit);
+
+            // Gather cell heights (no gather in SSE2)
+            int cx[4], cz[4], floorHeights[4], ceilingHeights[4];
+            _mm_storeu_si128((__m128i *)cx, cellX);
+            _mm_storeu_si128((__m128i *)cz, cellZ);
+            for (int i = 0; i < 4; i++)
+            {
+                if (live & (1 << i)) GetCubicmapGridCell(grid, cx[i], cz[i], &floorHeights[i], &ceilingHeights[i]);
+                else { floorHeights[i] = 0; ceilingHeights[i] = 255; }
+            }
+
+            __m128i floorInt = _mm_loadu_si128((const __m128i *)floorHeights);
+            __m128i ceilingInt = _mm_loadu_si128((const __m128i *)ceilingHeights);
+            __m128 fy = _mm_div_ps(_mm_mul_ps(h2, _mm_cvtepi32_ps(floorInt)), maxHeight);
+            __m128 cy = _mm_div_ps(_mm_mul_ps(h2, _mm_cvtepi32_ps(ceilingInt)), maxHeight);
+            __m128 roof = _mm_castsi128_ps(_mm_or_si128(_mm_cmplt_epi32(ceilingInt, _mm_set1_epi32(255)), _mm_xor_si128(_mm_cmplt_epi32(floorInt, ceilingInt), _mm_set1_epi32(-1))));
+            __m128 y0 = _mm_add_ps(oy, _mm_mul_ps(dy, t0));
+
+            __m128 wall = _mm_or_ps(_mm_cmplt_ps(y0, fy), _mm_and_ps(roof, _mm_and_ps(_mm_cmpgt_ps(y0, cy), _mm_cmplt_ps(y0, h2))));
+
+            __m128 down = _mm_cmplt_ps(dy, zero);
+            __m128 up = _mm_andnot_ps(down, _mm_and_ps(_mm_cmpgt_ps(dy, zero), _mm_cmple_ps(y0, cy)));
+            __m128 onRoof = _mm_and_ps(roof, _mm_cmpge_ps(y0, h2));
+            __m128 downTarget = SelectGridLanes(onRoof, h2, fy);
+            __m128 tDown = _mm_div_ps(_mm_sub_ps(downTarget, oy), dy);
+            __m128 tUp = _mm_div_ps(_mm_sub_ps(cy, oy), dy);
+            __m128 tHit = SelectGridLanes(down, tDown, SelectGridLanes(up, tUp, infinity));
+            __m128 surface = _mm_and_ps(_mm_or_ps(down, up), _mm_cmple_ps(tHit, t1));
+            __m128 leave = _mm_cmpge_ps(t1, tExit);
+
+            int wallMask = _mm_movemask_ps(wall) & live;
+            int surfaceMask = _mm_movemask_ps(surface) & live & ~wallMask;
+            int leaveMask = _mm_movemask_ps(leave) & live & ~wallMask & ~surfaceMask;
+            int upMask = _mm_movemask_ps(up);
+
+            if (wallMask | surfaceMask)
+            {
+                float t0Lanes[4], tHitLanes[4];
+                int faceLanes[4];
+                _mm_storeu_ps(t0Lanes, t0);
+                _mm_storeu_ps(tHitLanes, tHit);
+                _mm_storeu_si128((__m128i *)faceLanes, face);
+
+                for (int i = 0; i < 4; i++)
+                {
+                    int r = lanes.ray[i];
+
+                    if (wallMask & (1 << i)) SetGridRayHit(&hits[r], rays[r], cx[i], cz[i], faceLanes[i], t0Lanes[i]);
+                    else if (surfaceMask & (1 << i)) SetGridRayHit(&hits[r], rays[r], cx[i], cz[i], (upMask & (1 << i))? 3 : 2, fmaxf(tHitLanes[i], t0Lanes[i]));
+                }
+            }
+
+            int finished = wallMask | surfaceMask | leaveMask;
+            live &= ~finished;
+            refill = (finished != 0) && (next < count);
+
+            // Step all lanes, finished lanes are ignored
+            __m128 alongX = _mm_cmplt_ps(tMaxX, tMaxZ);
+            __m128i alongXInt = _mm_castps_si128(alongX);
+
+            cellX = _mm_add_epi32(cellX, _mm_and_si128(alongXInt, stepX));
+            cellZ = _mm_add_epi32(cellZ, _mm_andnot_si128(alongXInt, stepZ));
+            t0 = SelectGridLanes(alongX, tMaxX, tMaxZ);
+            tMaxX = SelectGridLanes(alongX, _mm_add_ps(tMaxX, tDeltaX), tMaxX);
+            tMaxZ = SelectGridLanes(alongX, tMaxZ, _mm_add_ps(tMaxZ, tDeltaZ));
+            face = SelectGridLanesInt(alongX, faceX, faceZ);
+        }
+
+        // Spill stepped lanes, refilled lanes are overwritten
+        _mm_storeu_ps(lanes.t0, t0);
+        _mm_storeu_ps(lanes.tMaxX, tMaxX);
+        _mm_storeu_ps(lanes.tMaxZ, tMaxZ);
+        _mm_storeu_si128((__m128i *)lanes.cellX, cellX);
+        _mm_storeu_si128((__m128i *)lanes.cellZ, cellZ);
+        _mm_storeu_si128((__m128i *)lanes.face, face);
+    }
+}
+#endif
+
+// Trace a batch of rays (shotgun spreads, AI sight checks), rays are traced 4 at a time with SSE2
+void GetGridRayCollisionPacket(const CubicmapGrid *grid, const Ray *rays, int count, float maxDistance, GridRayHit *hits)
+{
+#if defined(__SSE2__)
+    GetGridRayCollisionLanes(grid, rays, count, maxDistance, hits);
+#else
+    for (int i = 0; i < count; i++) hits[i] = GetGridRayCollision(grid, rays[i], maxDistance);
+#endif
+}
+
+// Benchmark single and packet raycasts with random rays inside the grid, logs rays per second
+// NOTE: Runs headless, packet results are checked against single ray results and the first checkCount
+// single ray results against brute force collision with every grid mesh triangle, returns mismatches of both
+int BenchmarkGridRaycast(const CubicmapGrid *grid, int rayCount, int checkCount, float maxDistance)
+{
+    Ray *rays = (Ray *)RL_MALLOC(rayCount*sizeof(Ray));
+    GridRayHit *single = (GridRayHit *)RL_MALLOC(rayCount*sizeof(GridRayHit));
+    GridRayHit *packet = (GridRayHit *)RL_MALLOC(rayCount*sizeof(GridRayHit));
+
+    // Fixed seed, rays start at eye height in open cells
+    srand(1234);
+    for (int i = 0; i < rayCount; i++)
+    {
+        Vector3 origin = { 0 };
+        int floor = 255, ceiling = 255;
+
+        for (int tries = 0; (tries < 64) && (floor >= ceiling); tries++)
+        {
+            origin.x = grid->cubeSize.x*((float)(rand()%grid->width));
+            origin.z = grid->cubeSize.z*((float)(rand()%grid->height));
+            GetCubicmapGridCell(grid, (int)(origin.x/grid->cubeSize.x), (int)(origin.z/grid->cubeSize.z), &floor, &ceiling);
+        }
+
+        origin.y = grid->cubeSize.y*((float)floor + 0.5f*(float)(ceiling - floor))/255.0f;
+
+        Vector3 direction = { (float)(rand()%2001 - 1000), (float)(rand()%801 - 400), (float)(rand()%2001 - 1000) };
+        rays[i] = (Ray){ origin, Vector3Normalize(direction) };
+    }
+
+    double start = GetTimerSeconds();
+    for (int i = 0; i < rayCount; i++) single[i] = GetGridRayCollision(grid, rays[i], maxDistance);
+    double singleTime = GetTimerSeconds() - start;
+
+    start = GetTimerSeconds();
+    GetGridRayCollisionPacket(grid, rays, rayCount, maxDistance, packet);
+    double packetTime = GetTimerSeconds() - start;
+
+    int mismatches = 0, hitCount = 0;
+    for (int i = 0; i < rayCount; i++)
+    {
+        if (single[i].hit) hitCount++;
+        if ((single[i].hit != packet[i].hit) || (single[i].face != packet[i].face) || (single[i].distance != packet[i].distance) ||
+            (single[i].cellX != packet[i].cellX) || (single[i].cellZ != packet[i].cellZ)) mismatches++;
+    }
+
+    // Brute force reference: closest hit against all triangles of the mesh the grid draws
+    Mesh mesh = GenMeshCubicmapGridData(grid);
+    int meshMismatches = 0;
+    if (checkCount > rayCount) checkCount = rayCount;
+
+    for (int i = 0; i < checkCount; i++)
+    {
+        RayCollision collision = GetRayCollisionMesh(rays[i], mesh, MatrixIdentity());
+        bool hit = collision.hit && (collision.distance <= maxDistance);
+
+        if (hit != single[i].hit) meshMismatches++;
+        else if (hit && ((fabsf(collision.distance - single[i].distance) > 1e-3f*(1.0f + collision.distance)) ||
+            (Vector3DotProduct(collision.normal, single[i].normal) < 0.999f))) meshMismatches++;
+    }
+
+    RL_FREE(mesh.vertices);
+    RL_FREE(mesh.normals);
+    RL_FREE(mesh.texcoords);
+
+    TRACELOG(((mismatches + meshMismatches) == 0)? LOG_INFO : LOG_WARNING, "RAYCAST: %i rays, %i hits: single %.2f Mrays/s, packet %.2f Mrays/s, %i mismatches, %i of %i differ from the mesh",
+        rayCount, hitCount, rayCount/singleTime*1e-6, rayCount/packetTime*1e-6, mismatches, meshMismatches, checkCount);
+
+    RL_FREE(rays);
+    RL_FREE(single);
+    RL_FREE(packet);
+
+    return mismatches + meshMismatches;
+}
@@ -0,0 +1,470 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Matrix and Vector3 functionality
+#include "rlgl.h"           // Required for: rlEnableShader(), rlEnableTexture(), rlEnableVertexArray()
+
+#include <stdlib.h>         // Required for: malloc(), free(), rand()
+#include <string.h>         // Required for: memset(), memcpy()
+
+// Render queue: draws are submitted with a 64 bit sort key, radix sorted once per frame and
+// executed binding shaders and textures only when they change
+// NOTE: Key layout, most significant bits first:
+//   opaque:      pass (4) | shader (12) | texture (16) | depth (32), state first, then front-to-back
+//   transparent: pass (4) | inverted depth (32) | shader (12) | texture (16), back-to-front first
+// Depth is the squared distance to the view position, as float bits (ordered for positive floats).
+// Ids wider than their key field only cost batching, state changes are tracked on the real ids.
+// WARNING: Submitted models and meshes must stay loaded until the queue is drawn
+
+#define RENDER_KEY_PASS_SHIFT       60
+#define RENDER_KEY_SHADER_BITS      12
+#define RENDER_KEY_TEXTURE_BITS     16
+
+typedef enum RenderPass {
+    RENDER_PASS_OPAQUE = 0,
+    RENDER_PASS_TRANSPARENT         // Drawn after opaque items, depth writes disabled
+} RenderPass;
+
+typedef enum RenderItemType {
+    RENDER_ITEM_MESH = 0,           // Mesh + Material, default raylib shader locations
+    RENDER_ITEM_COMPACT_MESH        // CompactMesh + CompactMapShader
+} RenderItemType;
+
+typedef struct RenderItem {
+    int type;
+    int pass;
+    Matrix transform;
+
+    Mesh mesh;                      // RENDER_ITEM_MESH
+    Material material;
+
+    CompactMesh compactMesh;        // RENDER_ITEM_COMPACT_MESH
+    CompactMapShader compactShader;
+    Texture2D texture;
+} RenderItem;
+
+typedef struct RenderQueueStats {
+    int items;
+    int shaderChanges;              // Shader binds in sorted order
+    int textureChanges;             // Texture binds in sorted order
+    int submitOrderChanges;         // Shader + texture binds the same items need in submission order
+} RenderQueueStats;
+
+typedef struct RenderQueue {
+    RenderItem *items;
+    unsigned long long *keys;
+    unsigned int *order;            // Item indices, sorted by key
+    unsigned long long *keysTemp;   // Radix sort ping-pong buffers
+    unsigned int *orderTemp;
+    int count;
+    int capacity;
+
+    Vector3 viewPosition;           // Depth reference, set by BeginRenderQueue()
+    RenderQueueStats stats;
+} RenderQueue;
+
+// Load render queue, buffers are allocated once, submitting never allocates
+RenderQueue LoadRenderQueue(int capacity)
+{
+    RenderQueue queue = { 0 };
+
+    queue.items = (RenderItem *)RL_CALLOC(capacity, sizeof(RenderItem));
+    queue.keys = (unsigned long long *)RL_MALLOC(capacity*sizeof(unsigned long long));
+    queue.order = (unsigned int *)RL_MALLOC(capacity*sizeof(unsigned int));
+    queue.keysTemp = (unsigned long long *)RL_MALLOC(capacity*sizeof(unsigned long long));
+    queue.orderTemp = (unsigned int *)RL_MALLOC(capacity*sizeof(unsigned int));
+    queue.capacity = capacity;
+
+    return queue;
+}
+
+// Unload render queue
+void UnloadRenderQueue(RenderQueue *queue)
+{
+    RL_FREE(queue->items);
+    RL_FREE(queue->keys);
+    RL_FREE(queue->order);
+    RL_FREE(queue->keysTemp);
+    RL_FREE(queue->orderTemp);
+
+    memset(queue, 0, sizeof(RenderQueue));
+}
+
+// Build render sort key
+unsigned long long GetRenderKey(int pass, unsigned int shaderId, unsigned int textureId, float depth)
+{
+    union { float f; unsigned int u; } depthBits = { (depth > 0.0f)? depth : 0.0f };
+
+    unsigned long long key = (unsigned long long)(pass & 0xf) << RENDER_KEY_PASS_SHIFT;
+    unsigned long long state = ((unsigned long long)(shaderId & ((1u << RENDER_KEY_SHADER_BITS) - 1)) << RENDER_KEY_TEXTURE_BITS) |
+                               (textureId & ((1u << RENDER_KEY_TEXTURE_BITS) - 1));
+
+    if (pass == RENDER_PASS_TRANSPARENT) key |= ((unsigned long long)(~depthBits.u) << 28) | state;
+    else key |= (state << 32) | depthBits.u;
+
+    return key;
+}
+
+// Begin a new frame of submissions, clears the queue
+void BeginRenderQueue(RenderQueue *queue, Camera camera)
+{
+    queue->count = 0;
+    queue->viewPosition = camera.position;
+}
+
+// Add item to the queue, returns NULL if the queue is full
+static RenderItem *AddRenderItem(RenderQueue *queue, int type, int pass, Matrix transform, unsigned int shaderId, unsigned int textureId, Vector3 center)
+{
+    if (queue->count == queue->capacity) return NULL;
+
+    RenderItem *item = &queue->items[queue->count];
+    item->type = type;
+    item->pass = pass;
+    item->transform = transform;
+
+    queue->keys[queue->count] = GetRenderKey(pass, shaderId, textureId, Vector3DistanceSqr(center, queue->viewPosition));
+    queue->order[queue->count] = queue->count;
+    queue->count++;
+
+    return item;
+}
+
+// Submit mesh draw, center is the world position used for depth sorting
+// NOTE: Returns false if the queue is full and the draw was dropped
+bool SubmitRenderMesh(RenderQueue *queue, int pass, Mesh mesh, Material material, Matrix transform, Vector3 center)
+{
+    RenderItem *item = AddRenderItem(queue, RENDER_ITEM_MESH, pass, transform, material.shader.id, material.maps[MATERIAL_MAP_DIFFUSE].texture.id, center);
+    if (item == NULL) return false;
+
+    item->mesh = mesh;
+    item->material = material;
+
+    return true;
+}
+
+// Submit all meshes of a model, placed like DrawModelEx() without rotation
+bool SubmitRenderModel(RenderQueue *queue, int pass, Model model, Vector3 position, Vector3 scale)
+{
+    Matrix transform = MatrixMultiply(MatrixMultiply(model.transform, MatrixScale(scale.x, scale.y, scale.z)), MatrixTranslate(position.x, position.y, position.z));
+    bool result = true;
+
+    for (int i = 0; i < model.meshCount; i++) result &= SubmitRenderMesh(queue, pass, model.meshes[i], model.materials[model.meshMaterial[i]], transform, position);
+
+    return result;
+}
+
+// Submit compact mesh draw, center is the world position used for depth sorting
+bool SubmitRenderCompactMesh(RenderQueue *queue, int pass, CompactMesh mesh, CompactMapShader shader, Texture2D texture, Matrix transform, Vector3 center)
+{
+    RenderItem *item = AddRenderItem(queue, RENDER_ITEM_COMPACT_MESH, pass, transform, shader.shader.id, texture.id, center);
+    if (item == NULL) return false;
+
+    item->compactMesh = mesh;
+    item->compactShader = shader;
+    item->texture = texture;
+
+    return true;
+}
+
+// Radix sort keys with their item indices, 8 bits per pass, passes where all keys share the digit are skipped
+// NOTE: Stable, so equal keys keep submission order
+static void SortRenderKeys(unsigned long long *keys, unsigned int *values, unsigned long long *keysTemp, unsigned int *valuesTemp, int count)
+{
+    unsigned int histogram[8][256] = { 0 };
+
+    for (int i = 0; i < count; i++)
+    {
+        unsigned long long key = keys[i];
+        for (int d = 0; d < 8; d++) histogram[d][(key >> (d*8)) & 0xff]++;
+    }
+
+    unsigned long long *srcKeys = keys, *dstKeys = keysTemp;
+    unsigned int *srcValues = values, *dstValues = valuesTemp;
+
+    for (int d = 0; d < 8; d++)
+    {
+        int shift = d*8;
+        if (histogram[d][(srcKeys[0] >> shift) & 0xff] == (unsigned int)count) continue;
+
+        unsigned int offset = 0;
+        for (int b = 0; b < 256; b++)
+        {
+            unsigned int bucketCount = histogram[d][b];
+            histogram[d][b] = offset;
+            offset += bucketCount;
+        }
+
+        for (int i = 0; i < count; i++)
+        {
+            unsigned int slot = histogram[d][(srcKeys[i] >> shift) & 0xff]++;
+            dstKeys[slot] = srcKeys[i];
+            dstValues[slot] = srcValues[i];
+        }
+
+        unsigned long long *swapKeys = srcKeys; srcKeys = dstKeys; dstKeys = swapKeys;
+        unsigned int *swapValues = srcValues; srcValues = dstValues; dstValues = swapValues;
+    }
+
+    if (srcKeys != keys)
+    {
+        memcpy(keys, srcKeys, count*sizeof(unsigned long long));
+        memcpy(values, srcValues, count*sizeof(unsigned int));
+    }
+}
+
+// Get shader and texture ids an item binds
+static void GetRenderItemState(const RenderItem *item, unsigned int *shaderId, unsigned int *textureId)
+{
+    if (item->type == RENDER_ITEM_COMPACT_MESH)
+    {
+        *shaderId = item->compactShader.shader.id;
+        *textureId = item->texture.id;
+    }
+    else
+    {
+        *shaderId = item->material.shader.id;
+        *textureId = item->material.maps[MATERIAL_MAP_DIFFUSE].texture.id;
+    }
+}
+
+// Count shader and texture changes of the items in the given order
+static int CountRenderStateChanges(const RenderQueue *queue, const unsigned int *order, int *shaderChanges, int *textureChanges)
+{
+    unsigned int currentShader = 0xffffffff, currentTexture = 0xffffffff;
+    int shaders = 0, textures = 0;
+
+    for (int i = 0; i < queue->count; i++)
+    {
+        unsigned int shaderId, textureId;
+        GetRenderItemState(&queue->items[(order != NULL)? order[i] : (unsigned int)i], &shaderId, &textureId);
+
+        if (shaderId != currentShader) { shaders++; currentShader = shaderId; }
+        if (textureId != currentTexture) { textures++; currentTexture = textureId; }
+    }
+
+    if (shaderChanges != NULL) *shaderChanges = shaders;
+    if (textureChanges != NULL) *textureChanges = textures;
+
+    return shaders + textures;
+}
+
+// Sort queue by key and update state change counters
+void SortRenderQueue(RenderQueue *queue)
+{
+    queue->stats.items = queue->count;
+    queue->stats.submitOrderChanges = CountRenderStateChanges(queue, NULL, NULL, NULL);
+
+    if (queue->count > 1) SortRenderKeys(queue->keys, queue->order, queue->keysTemp, queue->orderTemp, queue->count);
+
+    CountRenderStateChanges(queue, queue->order, &queue->stats.shaderChanges, &queue->stats.textureChanges);
+}
+
+// Sort and draw queued items, must be called inside BeginMode3D()
+void DrawRenderQueue(RenderQueue *queue)
+{
+    SortRenderQueue(queue);
+
+    // Flush pending batched draws, we bind our own vertex arrays
+    rlDrawRenderBatchActive();
+
+    Matrix matView = rlGetMatrixModelview();
+    Matrix matProjection = rlGetMatrixProjection();
+    Matrix matViewProjection = MatrixMultiply(matView, matProjection);
+    unsigned int currentShader = 0xffffffff, currentTexture = 0xffffffff;
+    int currentPass = RENDER_PASS_OPAQUE;
+    int textureSlot = 0;
+
+    for (int i = 0; i < queue->count; i++)
+    {
+        const RenderItem *item = &queue->items[queue->order[i]];
+        Matrix matModelViewProjection = MatrixMultiply(item->transform, matViewProjection);
+        unsigned int shaderId, textureId;
+        GetRenderItemState(item, &shaderId, &textureId);
+
+        if ((item->pass == RENDER_PASS_TRANSPARENT) && (currentPass != RENDER_PASS_TRANSPARENT)) rlDisableDepthMask();
+        currentPass = item->pass;
+
+        if (item->type == RENDER_ITEM_COMPACT_MESH)
+        {
+            const CompactMapShader *shader = &item->compactShader;
+            float colDiffuse[4] = { 1.0f, 1.0f, 1.0f, 1.0f };
+
+            if (shaderId != currentShader)
+            {
+                rlEnableShader(shaderId);
+                rlSetUniform(shader->shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+                rlSetUniform(shader->textureLoc, &textureSlot, SHADER_UNIFORM_INT, 1);
+                currentShader = shaderId;
+            }
+
+            rlSetUniformMatrix(shader->shader.locs[SHADER_LOC_MATRIX_MVP], matModelViewProjection);
+            rlSetUniformMatrix(shader->modelLoc, item->transform);
+            rlSetUniform(shader->originLoc, &item->compactMesh.origin, SHADER_UNIFORM_VEC3, 1);
+            rlSetUniform(shader->unitLoc, &item->compactMesh.unit, SHADER_UNIFORM_VEC3, 1);
+        }
+        else
+        {
+            const Material *material = &item->material;
+            Color color = material->maps[MATERIAL_MAP_DIFFUSE].color;
+            float colDiffuse[4] = { color.r/255.0f, color.g/255.0f, color.b/255.0f, color.a/255.0f };
+
+            // Meshes without a vertex array need the full raylib path
+            if (item->mesh.vaoId == 0)
+            {
+                DrawMesh(item->mesh, *material, item->transform);
+                currentShader = 0xffffffff;
+                currentTexture = 0xffffffff;
+                continue;
+            }
+
+            if (shaderId != currentShader)
+            {
+                rlEnableShader(shaderId);
+                if (material->shader.locs[SHADER_LOC_MATRIX_VIEW] != -1) rlSetUniformMatrix(material->shader.locs[SHADER_LOC_MATRIX_VIEW], matView);
+                if (material->shader.locs[SHADER_LOC_MATRIX_PROJECTION] != -1) rlSetUniformMatrix(material->shader.locs[SHADER_LOC_MATRIX_PROJECTION], matProjection);
+                if (material->shader.locs[SHADER_LOC_MAP_DIFFUSE] != -1) rlSetUniform(material->shader.locs[SHADER_LOC_MAP_DIFFUSE], &textureSlot, SHADER_UNIFORM_INT, 1);
+                currentShader = shaderId;
+            }
+
+            rlSetUniformMatrix(material->shader.locs[SHADER_LOC_MATRIX_MVP], matModelViewProjection);
+            if (material->shader.locs[SHADER_LOC_MATRIX_MODEL] != -1) rlSetUniformMatrix(material->shader.locs[SHADER_LOC_MATRIX_MODEL], item->transform);
+            if (material->shader.locs[SHADER_LOC_MATRIX_NORMAL] != -1) rlSetUniformMatrix(material->shader.locs[SHADER_LOC_MATRIX_NORMAL], MatrixTranspose(MatrixInvert(item->transform)));
+            if (material->shader.locs[SHADER_LOC_COLOR_DIFFUSE] != -1) rlSetUniform(material->shader.locs[SHADER_LOC_COLOR_DIFFUSE], colDiffuse, SHADER_UNIFORM_VEC4, 1);
+        }
+
+        if (textureId != currentTexture)
+        {
+            rlActiveTextureSlot(0);
+            rlEnableTexture(textureId);
+            currentTexture = textureId;
+        }
+
+        if (item->type == RENDER_ITEM_COMPACT_MESH)
+        {
+            rlEnableVertexArray(item->compactMesh.vaoId);
+            rlDrawVertexArray(0, item->compactMesh.vertexCount);
+        }
+        else
+        {
+            rlEnableVertexArray(item->mesh.vaoId);
+            if (item->mesh.indices != NULL) rlDrawVertexArrayElements(0, item->mesh.triangleCount*3, 0);
+            else rlDrawVertexArray(0, item->mesh.vertexCount);
+        }
+    }
+
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+    if (currentPass == RENDER_PASS_TRANSPARENT) rlEnableDepthMask();
+}
+
+// Get render queue counters of the last sort
+RenderQueueStats GetRenderQueueStats(const RenderQueue *queue)
+{
+    return queue->stats;
+}
+
+// Sort (key, index) pairs by key, then index: the order a stable sort gives
+static int CompareRenderKeyOrder(const void *a, const void *b)
+{
+    const unsigned long long *pa = (const unsigned long long *)a;
+    const unsigned long long *pb = (const unsigned long long *)b;
+
+    if (pa[0] != pb[0]) return (pa[0] < pb[0])? -1 : 1;
+
+    return (pa[1] > pb[1]) - (pa[1] < pb[1]);
+}
+
+// Benchmark render queue: key building and radix sort of random items, returns the number of failed checks
+// NOTE: Runs headless, items use fake ids (8 shaders, 64 textures) and are never drawn. The last sort is
+// checked: it must be a permutation of the submitted items, equal to a stable qsort of the keys, with
+// opaque items before transparent ones, opaque items of the same state front-to-back and transparent
+// items back-to-front
+int BenchmarkRenderQueue(int itemCount, int ticks)
+{
+    RenderQueue queue = LoadRenderQueue(itemCount);
+    Camera camera = { 0 };
+
+    Material *materials = (Material *)RL_CALLOC(64, sizeof(Material));
+    MaterialMap *maps = (MaterialMap *)RL_CALLOC(64*(MATERIAL_MAP_DIFFUSE + 1), sizeof(MaterialMap));
+    for (int m = 0; m < 64; m++)
+    {
+        materials[m].shader.id = 1 + m%8;
+        materials[m].maps = &maps[m*(MATERIAL_MAP_DIFFUSE + 1)];
+        materials[m].maps[MATERIAL_MAP_DIFFUSE].texture.id = 100 + m;
+    }
+
+    Vector3 *centers = (Vector3 *)RL_MALLOC(itemCount*sizeof(Vector3));
+    int *itemMaterials = (int *)RL_MALLOC(itemCount*sizeof(int));
+    srand(1234);
+    for (int i = 0; i < itemCount; i++)
+    {
+        centers[i] = (Vector3){ (float)(rand()%2000)/10.0f - 100.0f, 0.0f, (float)(rand()%2000)/10.0f - 100.0f };
+        itemMaterials[i] = rand()%64;
+    }
+
+    Mesh mesh = { 0 };
+    double submitTime = 0.0, sortTime = 0.0;
+
+    for (int t = 0; t < ticks; t++)
+    {
+        double start = GetTimerSeconds();
+        BeginRenderQueue(&queue, camera);
+        for (int i = 0; i < itemCount; i++) SubmitRenderMesh(&queue, (i%16 == 0)? RENDER_PASS_TRANSPARENT : RENDER_PASS_OPAQUE, mesh, materials[itemMaterials[i]], MatrixIdentity(), centers[i]);
+        double middle = GetTimerSeconds();
+        SortRenderQueue(&queue);
+        double end = GetTimerSeconds();
+
+        submitTime += middle - start;
+        sortTime += end - middle;
+    }
+
+    RenderQueueStats stats = GetRenderQueueStats(&queue);
+
+    // Reference: keys of the submitted items sorted by qsort
+    unsigned long long *reference = (unsigned long long *)RL_MALLOC(queue.count*2*sizeof(unsigned long long));
+    unsigned char *seen = (unsigned char *)RL_CALLOC(queue.count, 1);
+    for (int i = 0; i < queue.count; i++)
+    {
+        reference[i*2] = GetRenderKey(queue.items[i].pass, queue.items[i].material.shader.id, queue.items[i].material.maps[MATERIAL_MAP_DIFFUSE].texture.id, Vector3DistanceSqr(centers[i], camera.position));
+        reference[i*2 + 1] = i;
+    }
+    qsort(reference, queue.count, 2*sizeof(unsigned long long), CompareRenderKeyOrder);
+
+    int failures = 0;
+    for (int i = 0; i < queue.count; i++)
+    {
+        unsigned int index = queue.order[i];
+        bool failed = (index >= (unsigned int)queue.count) || seen[index] || (queue.keys[i] != reference[i*2]) || (index != reference[i*2 + 1]);
+
+        if (!failed && (i > 0))
+        {
+            const RenderItem *previous = &queue.items[queue.order[i - 1]];
+            const RenderItem *item = &queue.items[index];
+            float previousDepth = Vector3DistanceSqr(centers[queue.order[i - 1]], camera.position);
+            float depth = Vector3DistanceSqr(centers[index], camera.position);
+            bool sameState = (previous->material.shader.id == item->material.shader.id) &&
+                             (previous->material.maps[MATERIAL_MAP_DIFFUSE].texture.id == item->material.maps[MATERIAL_MAP_DIFFUSE].texture.id);
+
+            if (previous->pass > item->pass) failed = true;
+            else if ((item->pass == RENDER_PASS_OPAQUE) && (previous->pass == RENDER_PASS_OPAQUE) && sameState && (depth < previousDepth)) failed = true;
+            else if ((item->pass == RENDER_PASS_TRANSPARENT) && (previous->pass == RENDER_PASS_TRANSPARENT) && (depth > previousDepth)) failed = true;
+        }
+
+        if (index < (unsigned int)queue.count) seen[index] = 1;
+        if (failed) failures++;
+    }
+
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "RENDERQUEUE: %i items, submit + keys %.3f ms, radix sort %.3f ms, binds: %i immediate, %i submission order, %i sorted (%i shader, %i texture), %i misplaced items",
+        itemCount, submitTime*1000.0/ticks, sortTime*1000.0/ticks, stats.items*2, stats.submitOrderChanges,
+        stats.shaderChanges + stats.textureChanges, stats.shaderChanges, stats.textureChanges, failures);
+
+    RL_FREE(reference);
+    RL_FREE(seen);
+
+    RL_FREE(centers);
+    RL_FREE(itemMaterials);
+    RL_FREE(materials);
+    RL_FREE(maps);
+    UnloadRenderQueue(&queue);
+
+    return failures;
+}
@@ -0,0 +1,1034 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: rand(), srand()
+#include <string.h>         // Required for: memset(), memcpy()
+#include <math.h>           // Required for: roundf(), atan2f(), asinf(), sinf(), cosf(), fmodf()
+
+#if defined(_WIN32)
+    #include <stdint.h>         // Required for: uintptr_t
+
+    // Winsock (ws2_32) declared here to avoid winsock2.h, it pulls windows.h that conflicts with raylib symbols
+    // and with the timer declarations, types and constants match winsock2.h
+    typedef uintptr_t NetSocket;
+
+    struct sockaddr { unsigned short sa_family; char sa_data[14]; };
+    struct in_addr { unsigned long s_addr; };
+    struct sockaddr_in { short sin_family; unsigned short sin_port; struct in_addr sin_addr; char sin_zero[8]; };
+    typedef int socklen_t;
+
+    #define AF_INET                 2
+    #define SOCK_DGRAM              2
+    #define INADDR_ANY              0ul
+    #define INADDR_NONE             0xfffffffful
+    #define INVALID_SOCKET          (~(NetSocket)0)
+    #define FIONBIO                 ((long)0x8004667eul)
+    #define WSAECONNRESET           10054
+
+    __declspec(dllimport) int __stdcall WSAStartup(unsigned short wVersionRequested, void *lpWSAData);
+    __declspec(dllimport) int __stdcall WSACleanup(void);
+    __declspec(dllimport) int __stdcall WSAGetLastError(void);
+    __declspec(dllimport) NetSocket __stdcall socket(int af, int type, int protocol);
+    __declspec(dllimport) int __stdcall bind(NetSocket s, const struct sockaddr *name, int namelen);
+    __declspec(dllimport) int __stdcall sendto(NetSocket s, const char *buf, int len, int flags, const struct sockaddr *to, int tolen);
+    __declspec(dllimport) int __stdcall recvfrom(NetSocket s, char *buf, int len, int flags, struct sockaddr *from, int *fromlen);
+    __declspec(dllimport) int __stdcall ioctlsocket(NetSocket s, long cmd, unsigned long *argp);
+    __declspec(dllimport) int __stdcall closesocket(NetSocket s);
+    __declspec(dllimport) unsigned short __stdcall htons(unsigned short hostshort);
+    __declspec(dllimport) unsigned long __stdcall htonl(unsigned long hostlong);
+    __declspec(dllimport) unsigned long __stdcall inet_addr(const char *cp);
+
+    #define CloseNetSocket(socket)  closesocket(socket)
+#else
+    #include <unistd.h>         // Required for: close()
+    #include <fcntl.h>          // Required for: fcntl()
+    #include <sys/socket.h>     // Required for: socket(), bind(), sendto(), recvfrom()
+    #include <netinet/in.h>     // Required for: struct sockaddr_in, htons()
+    #include <arpa/inet.h>      // Required for: inet_addr()
+
+    typedef int NetSocket;
+    #define INVALID_SOCKET          (-1)
+    #define CloseNetSocket(socket)  close(socket)
+#endif
+
+// Replication: server authoritative player state sent to clients as delta compressed snapshots
+// NOTE: Every server tick player poses are quantized (position 1/128 unit, yaw 16 bits, pitch 12 bits)
+// into a snapshot kept in a history ring. Each client gets the snapshot bit-packed as a delta against
+// the last snapshot it acknowledged: unchanged players cost 1 bit, small moves a few bits per axis.
+// Without a usable baseline (first packets, ack too old) the delta is against an empty snapshot.
+// Clients decode against their own copy of the baseline, acknowledge the newest tick in every input
+// packet and render players interpolated a fixed delay behind the estimated server time.
+// Packets go through a transport: an in-process loopback (latency, jitter and loss simulated, for
+// tests and local play) or UDP. Peer 0 is always the server, clients are assigned peers 1 and up.
+// WARNING: On Windows the UDP transport uses winsock, link with ws2_32 (-lws2_32 on MinGW)
+
+#define MAX_NET_PLAYERS             32
+#define MAX_NET_PEERS               (MAX_NET_PLAYERS + 1)
+#define MAX_NET_PACKET              1200        // Bytes, below common MTU
+#define NET_SNAPSHOT_HISTORY        64          // Ticks kept as delta baselines, power of two
+#define NET_CLIENT_TIMEOUT          5.0f        // Seconds without packets before a client slot is freed
+
+#define NET_POSITION_BITS           18          // 1/128 unit over [-1024, 1024)
+#define NET_POSITION_RANGE          1024.0f
+#define NET_POSITION_SCALE          128.0f
+#define NET_YAW_BITS                16
+#define NET_PITCH_BITS              12
+
+typedef enum NetPacketType {
+    NET_PACKET_SNAPSHOT = 1,        // Server to client
+    NET_PACKET_INPUT                // Client to server: ack + input
+} NetPacketType;
+
+// Transport callbacks, peer is the destination/source peer id
+typedef bool (*NetSendCallback)(void *context, int peer, const unsigned char *data, int size);
+typedef int (*NetReceiveCallback)(void *context, int *peer, unsigned char *data, int capacity);    // Returns size, 0 if none
+
+typedef struct NetTransport {
+    NetSendCallback send;
+    NetReceiveCallback receive;
+    void *context;
+} NetTransport;
+
+// Quantized player state
+typedef struct NetPlayerState {
+    unsigned char active;
+    unsigned char actions;          // SimAction flags held
+    unsigned short yaw;
+    unsigned short pitch;
+    int position[3];
+} NetPlayerState;
+
+typedef struct NetSnapshot {
+    unsigned int tick;              // 0 = empty
+    NetPlayerState players[MAX_NET_PLAYERS];
+} NetSnapshot;
+
+// Dequantized player pose
+typedef struct NetPlayerPose {
+    bool active;
+    Vector3 position;
+    float yaw;                      // Radians, around +Y from +Z
+    float pitch;                    // Radians, up positive
+    unsigned int actions;
+} NetPlayerPose;
+
+typedef struct NetStats {
+    long long bytesSent;
+    long long bytesReceived;
+    int packetsSent;
+    int packetsReceived;
+    int snapshots;                  // Snapshots encoded (server) or decoded (client)
+    int deltaSnapshots;             // ... of them against an acknowledged baseline
+    long long players;              // Active players encoded or decoded
+    double time;                    // Encode (server) or decode (client) time, seconds
+    int errors;                     // Packets dropped: malformed or missing baseline
+} NetStats;
+
+typedef struct NetClientSlot {
+    bool connected;
+    int peer;
+    unsigned int ackTick;           // Newest snapshot the client has, delta baseline
+    float idleTime;                 // Seconds since last packet
+    SimInput input;                 // Latest input (pressed flags accumulate until read)
+} NetClientSlot;
+
+typedef struct NetServer {
+    NetTransport transport;
+    float tickTime;
+    unsigned int tick;
+    NetPlayerState players[MAX_NET_PLAYERS];    // Current state, set by the game
+    NetSnapshot history[NET_SNAPSHOT_HISTORY];
+    NetClientSlot clients[MAX_NET_PLAYERS];     // Indexed by player slot
+    NetStats stats;
+} NetServer;
+
+typedef struct NetClient {
+    NetTransport transport;
+    float tickTime;
+    int slot;                       // Own player slot, -1 until the first snapshot
+    NetSnapshot history[NET_SNAPSHOT_HISTORY];
+    unsigned int latestTick;
+
+    double time;                    // Local clock
+    double serverOffset;            // Estimated server time minus local clock
+    float interpolationDelay;       // Seconds behind the estimated server time
+    bool synced;
+    NetStats stats;
+} NetClient;
+
+//----------------------------------------------------------------------------------
+// Bit packing
+//----------------------------------------------------------------------------------
+typedef struct NetBitStream {
+    unsigned char *data;
+    int capacity;                   // Bytes
+    int position;                   // Bytes written or read
+    unsigned long long scratch;
+    int scratchBits;
+    bool overflow;
+} NetBitStream;
+
+// Write up to 32 bits
+static void WriteNetBits(NetBitStream *stream, unsigned int value, int bits)
+{
+    stream->scratch |= (unsigned long long)(value & (unsigned int)((1ull << bits) - 1)) << stream->scratchBits;
+    stream->scratchBits += bits;
+
+    while (stream->scratchBits >= 8)
+    {
+        if (stream->position < stream->capacity) stream->data[stream->position++] = (unsigned char)stream->scratch;
+        else stream->overflow = true;
+
+        stream->scratch >>= 8;
+        stream->scratchBits -= 8;
+    }
+}
+
+// Flush partial byte, returns bytes written
+static int FlushNetBits(NetBitStream *stream)
+{
+    if (stream->scratchBits > 0) WriteNetBits(stream, 0, 8 - stream->scratchBits);
+
+    return stream->position;
+}
+
+// Read up to 32 bits, reads past the end return zeros and set overflow
+static unsigned int ReadNetBits(NetBitStream *stream, int bits)
+{
+    while (stream->scratchBits < bits)
+    {
+        unsigned long long byte = 0;
+        if (stream->position < stream->capacity) byte = stream->data[stream->position++];
+        else stream->overflow = true;
+
+        stream->scratch |= byte << stream->scratchBits;
+        stream->scratchBits += 8;
+    }
+
+    unsigned int value = (unsigned int)(stream->scratch & ((1ull << bits) - 1));
+    stream->scratch >>= bits;
+    stream->scratchBits -= bits;
+
+    return value;
+}
+
+// Write quantized value as a delta from base: '0' same, '10' + 7 bit, '110' + 12 bit signed delta, '111' + full value
+static void WriteNetDelta(NetBitStream *stream, int value, int base, int bits)
+{
+    int delta = value - base;
+
+    if (delta == 0) WriteNetBits(stream, 0, 1);
+    else if ((delta >= -64) && (delta < 64)) { WriteNetBits(stream, 1, 2); WriteNetBits(stream, (unsigned int)delta, 7); }
+    else if ((delta >= -2048) && (delta < 2048)) { WriteNetBits(stream, 3, 3); WriteNetBits(stream, (unsigned int)delta, 12); }
+    else { WriteNetBits(stream, 7, 3); WriteNetBits(stream, (unsigned int)value, bits); }
+}
+
+// Sign extend a field of bits
+static int GetNetSigned(unsigned int value, int bits)
+{
+    return (int)(value << (32 - bits)) >> (32 - bits);
+}
+
+// Read value written by WriteNetDelta()
+static int ReadNetDelta(NetBitStream *stream, int base, int bits)
+{
+    if (ReadNetBits(stream, 1) == 0) return base;
+    if (ReadNetBits(stream, 1) == 0) return base + GetNetSigned(ReadNetBits(stream, 7), 7);
+    if (ReadNetBits(stream, 1) == 0) return base + GetNetSigned(ReadNetBits(stream, 12), 12);
+
+    return (int)ReadNetBits(stream, bits);
+}
+
+//----------------------------------------------------------------------------------
+// Quantization
+//----------------------------------------------------------------------------------
+
+// Quantize float to an unsigned bit field over [min, min + range)
+static int QuantizeNetValue(float value, float min, float range, int bits)
+{
+    int max = (1 << bits) - 1;
+    int q = (int)roundf((value - min)/range*(float)(1 << bits));
+
+    return (q < 0)? 0 : (q > max)? max : q;
+}
+
+// Get quantized player state from a first person camera
+NetPlayerState GetNetPlayerState(Camera camera, unsigned int actions)
+{
+    NetPlayerState state = { 0 };
+    Vector3 forward = Vector3Normalize(Vector3Subtract(camera.target, camera.position));
+
+    state.active = 1;
+    state.actions = (unsigned char)actions;
+    state.yaw = (unsigned short)(QuantizeNetValue(atan2f(forward.x, forward.z), -PI, 2.0f*PI, NET_YAW_BITS) & ((1 << NET_YAW_BITS) - 1));
+    state.pitch = (unsigned short)QuantizeNetValue(asinf(Clamp(forward.y, -1.0f, 1.0f)), -0.5f*PI, PI, NET_PITCH_BITS);
+    state.position[0] = QuantizeNetValue(camera.position.x, -NET_POSITION_RANGE, 2.0f*NET_POSITION_RANGE, NET_POSITION_BITS);
+    state.position[1] = QuantizeNetValue(camera.position.y, -NET_POSITION_RANGE, 2.0f*NET_POSITION_RANGE, NET_POSITION_BITS);
+    state.position[2] = QuantizeNetValue(camera.position.z, -NET_POSITION_RANGE, 2.0f*NET_POSITION_RANGE, NET_POSITION_BITS);
+
+    return state;
+}
+
+// Dequantize player state
+NetPlayerPose GetNetPlayerPose(NetPlayerState state)
+{
+    NetPlayerPose pose = { 0 };
+
+    pose.active = (state.active != 0);
+    pose.actions = state.actions;
+    pose.position.x = state.position[0]/NET_POSITION_SCALE - NET_POSITION_RANGE;
+    pose.position.y = state.position[1]/NET_POSITION_SCALE - NET_POSITION_RANGE;
+    pose.position.z = state.position[2]/NET_POSITION_SCALE - NET_POSITION_RANGE;
+    pose.yaw = state.yaw*(2.0f*PI/(1 << NET_YAW_BITS)) - PI;
+    pose.pitch = state.pitch*(PI/(1 << NET_PITCH_BITS)) - 0.5f*PI;
+
+    return pose;
+}
+
+// Get view direction of a pose
+Vector3 GetNetPoseDirection(NetPlayerPose pose)
+{
+    return (Vector3){ sinf(pose.yaw)*cosf(pose.pitch), sinf(pose.pitch), cosf(pose.yaw)*cosf(pose.pitch) };
+}
+
+//----------------------------------------------------------------------------------
+// Snapshot delta encoding
+//----------------------------------------------------------------------------------
+
+// Check quantized states are equal, compared by field (struct padding is undefined)
+static bool IsNetPlayerStateEqual(const NetPlayerState *a, const NetPlayerState *b)
+{
+    return (a->active == b->active) && (a->actions == b->actions) && (a->yaw == b->yaw) && (a->pitch == b->pitch) &&
+        (a->position[0] == b->position[0]) && (a->position[1] == b->position[1]) && (a->position[2] == b->position[2]);
+}
+
+// Encode snapshot as delta against baseline (empty snapshot if NULL), returns packet size
+static int EncodeNetSnapshot(const NetSnapshot *snapshot, const NetSnapshot *baseline, int slot, unsigned char *data, int capacity)
+{
+    static const NetPlayerState empty = { 0 };
+    NetBitStream stream = { .data = data, .capacity = capacity };
+
+    WriteNetBits(&stream, NET_PACKET_SNAPSHOT, 4);
+    WriteNetBits(&stream, snapshot->tick, 32);
+    WriteNetBits(&stream, (baseline != NULL)? snapshot->tick - baseline->tick : 0, 8);   // Baseline age in ticks, 0 = none
+    WriteNetBits(&stream, (unsigned int)slot, 6);
+
+    for (int i = 0; i < MAX_NET_PLAYERS; i++)
+    {
+        const NetPlayerState *player = &snapshot->players[i];
+        const NetPlayerState *base = ((baseline != NULL) && baseline->players[i].active)? &baseline->players[i] : &empty;
+
+        if (IsNetPlayerStateEqual(player, base)) { WriteNetBits(&stream, 0, 1); continue; }
+
+        WriteNetBits(&stream, 1, 1);
+        WriteNetBits(&stream, player->active, 1);
+        if (!player->active) continue;
+
+        for (int k = 0; k < 3; k++) WriteNetDelta(&stream, player->position[k], base->position[k], NET_POSITION_BITS);
+
+        WriteNetBits(&stream, player->yaw != base->yaw, 1);
+        if (player->yaw != base->yaw) WriteNetBits(&stream, player->yaw, NET_YAW_BITS);
+        WriteNetBits(&stream, player->pitch != base->pitch, 1);
+        if (player->pitch != base->pitch) WriteNetBits(&stream, player->pitch, NET_PITCH_BITS);
+        WriteNetBits(&stream, player->actions != base->actions, 1);
+        if (player->actions != base->actions) WriteNetBits(&stream, player->actions, 8);
+    }
+
+    int size = FlushNetBits(&stream);
+
+    return stream.overflow? 0 : size;
+}
+
+// Decode snapshot packet body (after the header) against baseline (empty snapshot if NULL)
+static bool DecodeNetSnapshotPlayers(NetBitStream *stream, const NetSnapshot *baseline, NetSnapshot *snapshot)
+{
+    static const NetPlayerState empty = { 0 };
+
+    for (int i = 0; i < MAX_NET_PLAYERS; i++)
+    {
+        const NetPlayerState *base = ((baseline != NULL) && baseline->players[i].active)? &baseline->players[i] : &empty;
+        NetPlayerState *player = &snapshot->players[i];
+
+        *player = *base;
+        if (ReadNetBits(stream, 1) == 0) continue;
+
+        memset(player, 0, sizeof(NetPlayerState));
+        player->active = (unsigned char)ReadNetBits(stream, 1);
+        if (!player->active) continue;
+
+        for (int k = 0; k < 3; k++) player->position[k] = ReadNetDelta(stream, base->position[k], NET_POSITION_BITS);
+
+        player->yaw = ReadNetBits(stream, 1)? (unsigned short)ReadNetBits(stream, NET_YAW_BITS) : base->yaw;
+        player->pitch = ReadNetBits(stream, 1)? (unsigned short)ReadNetBits(stream, NET_PITCH_BITS) : base->pitch;
+        player->actions = ReadNetBits(stream, 1)? (unsigned char)ReadNetBits(stream, 8) : base->actions;
+    }
+
+    return !stream->overflow;
+}
+
+//----------------------------------------------------------------------------------
+// Server
+//----------------------------------------------------------------------------------
+
+// Load replication server ticking every tickTime seconds
+NetServer *LoadNetServer(NetTransport transport, float tickTime)
+{
+    NetServer *server = (NetServer *)RL_CALLOC(1, sizeof(NetServer));
+
+    server->transport = transport;
+    server->tickTime = tickTime;
+
+    return server;
+}
+
+// Unload replication server
+void UnloadNetServer(NetServer *server)
+{
+    RL_FREE(server);
+}
+
+// Set player slot state, an inactive state removes the player
+// NOTE: Slots not owned by a connected client (i.e. the host player) must be set active before clients connect
+void SetNetServerPlayer(NetServer *server, int slot, NetPlayerState state)
+{
+    // Inactive slots are all zeros, as clients decode them, a reused slot is then encoded from the same base
+    if (!state.active) memset(&state, 0, sizeof(NetPlayerState));
+
+    server->players[slot] = state;
+}
+
+// Get and clear latest input of a client slot, false if no client owns it
+bool GetNetServerInput(NetServer *server, int slot, SimInput *input)
+{
+    if (!server->clients[slot].connected) return false;
+
+    *input = server->clients[slot].input;
+    server->clients[slot].input.pressed = 0;
+    server->clients[slot].input.mouseDelta = (Vector2){ 0 };
+
+    return true;
+}
+
+// Receive client packets: connect new peers, store acks and input
+static void ReceiveNetServerPackets(NetServer *server)
+{
+    unsigned char data[MAX_NET_PACKET];
+    int peer = 0;
+    int size = 0;
+
+    while ((size = server->transport.receive(server->transport.context, &peer, data, MAX_NET_PACKET)) > 0)
+    {
+        server->stats.bytesReceived += size;
+        server->stats.packetsReceived++;
+
+        NetBitStream stream = { .data = data, .capacity = size };
+        if (ReadNetBits(&stream, 4) != NET_PACKET_INPUT) { server->stats.errors++; continue; }
+
+        unsigned int ack = ReadNetBits(&stream, 32);
+        SimInput input = { 0 };
+        input.down = ReadNetBits(&stream, 8);
+        input.pressed = ReadNetBits(&stream, 8);
+        input.mouseDelta.x = GetNetSigned(ReadNetBits(&stream, 16), 16)/8.0f;
+        input.mouseDelta.y = GetNetSigned(ReadNetBits(&stream, 16), 16)/8.0f;
+        if (stream.overflow) { server->stats.errors++; continue; }
+
+        // Find the peer slot, or give it the first free one
+        int slot = -1;
+        for (int i = 0; i < MAX_NET_PLAYERS; i++) if (server->clients[i].connected && (server->clients[i].peer == peer)) { slot = i; break; }
+        if (slot == -1)
+        {
+            for (int i = 0; i < MAX_NET_PLAYERS; i++)
+            {
+                if (!server->clients[i].connected && !server->players[i].active)
+                {
+                    slot = i;
+                    server->clients[i] = (NetClientSlot){ .connected = true, .peer = peer };
+                    TRACELOG(LOG_INFO, "NET: Peer %i connected as player %i", peer, slot);
+                    break;
+                }
+            }
+            if (slot == -1) continue;
+        }
+
+        NetClientSlot *client = &server->clients[slot];
+        if (ack > client->ackTick) client->ackTick = ack;
+        client->idleTime = 0.0f;
+        client->input.down = input.down;
+        client->input.pressed |= input.pressed;
+        client->input.mouseDelta = Vector2Add(client->input.mouseDelta, input.mouseDelta);
+    }
+}
+
+// Run one server tick: receive client packets, store a snapshot and send it to every client
+void UpdateNetServer(NetServer *server)
+{
+    ReceiveNetServerPackets(server);
+
+    // Drop clients gone silent, their player leaves the game
+    for (int i = 0; i < MAX_NET_PLAYERS; i++)
+    {
+        NetClientSlot *client = &server->clients[i];
+        if (!client->connected) continue;
+
+        client->idleTime += server->tickTime;
+        if (client->idleTime > NET_CLIENT_TIMEOUT)
+        {
+            TRACELOG(LOG_INFO, "NET: Player %i timed out", i);
+            client->connected = false;
+            memset(&server->players[i], 0, sizeof(NetPlayerState));
+        }
+    }
+
+    server->tick++;
+    NetSnapshot *snapshot = &server->history[server->tick & (NET_SNAPSHOT_HISTORY - 1)];
+    snapshot->tick = server->tick;
+    memcpy(snapshot->players, server->players, sizeof(server->players));
+
+    int active = 0;
+    for (int i = 0; i < MAX_NET_PLAYERS; i++) active += snapshot->players[i].active;
+
+    unsigned char data[MAX_NET_PACKET];
+    double start = GetTimerSeconds();
+
+    for (int i = 0; i < MAX_NET_PLAYERS; i++)
+    {
+        NetClientSlot *client = &server->clients[i];
+        if (!client->connected) continue;
+
+        // Baseline: last acknowledged snapshot, if still in history
+        const NetSnapshot *baseline = NULL;
+        if ((client->ackTick != 0) && (server->tick - client->ackTick < NET_SNAPSHOT_HISTORY))
+        {
+            baseline = &server->history[client->ackTick & (NET_SNAPSHOT_HISTORY - 1)];
+        }
+
+        int size = EncodeNetSnapshot(snapshot, baseline, i, data, MAX_NET_PACKET);
+        if (size == 0) { server->stats.errors++; continue; }
+
+        if (server->transport.send(server->transport.context, client->peer, data, size))
+        {
+            server->stats.bytesSent += size;
+            server->stats.packetsSent++;
+        }
+
+        server->stats.snapshots++;
+        if (baseline != NULL) server->stats.deltaSnapshots++;
+        server->stats.players += active;
+    }
+
+    server->stats.time += GetTimerSeconds() - start;
+}
+
+//----------------------------------------------------------------------------------
+// Client
+//----------------------------------------------------------------------------------
+
+// Load replication client for a server ticking every tickTime seconds
+NetClient *LoadNetClient(NetTransport transport, float tickTime)
+{
+    NetClient *client = (NetClient *)RL_CALLOC(1, sizeof(NetClient));
+
+    client->transport = transport;
+    client->tickTime = tickTime;
+    client->slot = -1;
+    client->interpolationDelay = 2.5f*tickTime;
+
+    return client;
+}
+
+// Unload replication client
+void UnloadNetClient(NetClient *client)
+{
+    RL_FREE(client);
+}
+
+// Decode one snapshot packet into client history
+static void ReceiveNetClientSnapshot(NetClient *client, unsigned char *data, int size)
+{
+    double start = GetTimerSeconds();
+    NetBitStream stream = { .data = data, .capacity = size };
+
+    if (ReadNetBits(&stream, 4) != NET_PACKET_SNAPSHOT) { client->stats.errors++; return; }
+
+    unsigned int tick = ReadNetBits(&stream, 32);
+    unsigned int age = ReadNetBits(&stream, 8);
+    int slot = (int)ReadNetBits(&stream, 6);
+
+    // Late or duplicate packets are useless, newer snapshots already replaced them
+    if ((tick <= client->latestTick) || stream.overflow) return;
+
+    const NetSnapshot *baseline = NULL;
+    if (age != 0)
+    {
+        baseline = &client->history[(tick - age) & (NET_SNAPSHOT_HISTORY - 1)];
+        if (baseline->tick != tick - age) { client->stats.errors++; return; }
+    }
+
+    NetSnapshot *snapshot = &client->history[tick & (NET_SNAPSHOT_HISTORY - 1)];
+    NetSnapshot decoded = { 0 };
+    decoded.tick = tick;
+    if (!DecodeNetSnapshotPlayers(&stream, baseline, &decoded)) { client->stats.errors++; return; }
+    *snapshot = decoded;
+
+    client->latestTick = tick;
+    client->slot = slot;
+
+    // Server time estimate follows arrivals, smoothed over jitter
+    double offset = tick*(double)client->tickTime - client->time;
+    if (!client->synced) { client->serverOffset = offset; client->synced = true; }
+    else client->serverOffset += 0.05*(offset - client->serverOffset);
+
+    client->stats.snapshots++;
+    if (baseline != NULL) client->stats.deltaSnapshots++;
+    for (int i = 0; i < MAX_NET_PLAYERS; i++) client->stats.players += decoded.players[i].active;
+    client->stats.time += GetTimerSeconds() - start;
+}
+
+// Update client: advance clock, decode received snapshots, send ack and input to the server
+void UpdateNetClient(NetClient *client, float deltaTime, SimInput input)
+{
+    unsigned char data[MAX_NET_PACKET];
+    int peer = 0;
+    int size = 0;
+
+    client->time += deltaTime;
+
+    while ((size = client->transport.receive(client->transport.context, &peer, data, MAX_NET_PACKET)) > 0)
+    {
+        client->stats.bytesReceived += size;
+        client->stats.packetsReceived++;
+        if (peer == 0) ReceiveNetClientSnapshot(client, data, size);
+    }
+
+    NetBitStream stream = { .data = data, .capacity = MAX_NET_PACKET };
+    WriteNetBits(&stream, NET_PACKET_INPUT, 4);
+    WriteNetBits(&stream, client->latestTick, 32);
+    WriteNetBits(&stream, input.down, 8);
+    WriteNetBits(&stream, input.pressed, 8);
+    WriteNetBits(&stream, (unsigned int)(int)roundf(Clamp(input.mouseDelta.x*8.0f, -32768.0f, 32767.0f)), 16);
+    WriteNetBits(&stream, (unsigned int)(int)roundf(Clamp(input.mouseDelta.y*8.0f, -32768.0f, 32767.0f)), 16);
+    size = FlushNetBits(&stream);
+
+    if (client->transport.send(client->transport.context, 0, data, size))
+    {
+        client->stats.bytesSent += size;
+        client->stats.packetsSent++;
+    }
+}
+
+// Get player pose interpolated at the client render time (interpolation delay behind the server)
+// NOTE: Holds the newest snapshot if the next one is late, a player missing in either snapshot is not blended
+NetPlayerPose GetNetClientPlayer(const NetClient *client, int slot)
+{
+    NetPlayerPose pose = { 0 };
+    if (client->latestTick == 0) return pose;
+
+    double renderTick = (client->time + client->serverOffset - client->interpolationDelay)/client->tickTime;
+    const NetSnapshot *latest = &client->history[client->latestTick & (NET_SNAPSHOT_HISTORY - 1)];
+
+    if (renderTick >= (double)client->latestTick) return GetNetPlayerPose(latest->players[slot]);
+
+    // Newest received snapshot at or before render time, and the next received one
+    const NetSnapshot *from = NULL;
+    const NetSnapshot *to = latest;
+    for (unsigned int tick = client->latestTick - 1; (tick > 0) && (client->latestTick - tick < NET_SNAPSHOT_HISTORY); tick--)
+    {
+        const NetSnapshot *snapshot = &client->history[tick & (NET_SNAPSHOT_HISTORY - 1)];
+        if (snapshot->tick != tick) continue;
+
+        if ((double)tick <= renderTick) { from = snapshot; break; }
+        to = snapshot;
+    }
+
+    if (from == NULL) return GetNetPlayerPose(to->players[slot]);
+
+    NetPlayerPose a = GetNetPlayerPose(from->players[slot]);
+    NetPlayerPose b = GetNetPlayerPose(to->players[slot]);
+    if (!a.active || !b.active) return b;
+
+    float t = (float)((renderTick - from->tick)/(double)(to->tick - from->tick));
+    float yawDelta = fmodf(b.yaw - a.yaw + 3.0f*PI, 2.0f*PI) - PI;     // Shortest way around
+
+    pose = b;
+    pose.position = Vector3Lerp(a.position, b.position, t);
+    pose.yaw = a.yaw + yawDelta*t;
+    pose.pitch = a.pitch + (b.pitch - a.pitch)*t;
+
+    return pose;
+}
+
+//----------------------------------------------------------------------------------
+// Loopback transport
+//----------------------------------------------------------------------------------
+typedef struct NetLoopbackPacket {
+    int from;
+    int to;
+    double deliverTime;
+    int size;
+    unsigned char data[MAX_NET_PACKET];
+} NetLoopbackPacket;
+
+// Loopback endpoint context: the loopback and the endpoint peer id
+typedef struct NetLoopbackEndpoint {
+    struct NetLoopback *loopback;
+    int peer;
+} NetLoopbackEndpoint;
+
+typedef struct NetLoopback {
+    NetLoopbackPacket *packets;     // In flight
+    int count;
+    int capacity;
+    double time;
+
+    float latency;                  // One way, seconds
+    float jitter;                   // Added latency, uniform [0, jitter]
+    float loss;                     // Drop probability [0..1]
+    unsigned int seed;              // Private random state, reproducible runs
+
+    NetLoopbackEndpoint endpoints[MAX_NET_PEERS];   // Transport contexts
+    int dropped;
+} NetLoopback;
+
+// Get loopback random value [0..1)
+static float GetNetLoopbackRandom(NetLoopback *loopback)
+{
+    loopback->seed = loopback->seed*1664525u + 1013904223u;
+
+    return (loopback->seed >> 8)/16777216.0f;
+}
+
+// Send loopback packet, queued until its delivery time
+static bool SendNetLoopback(void *context, int peer, const unsigned char *data, int size)
+{
+    NetLoopbackEndpoint *endpoint = (NetLoopbackEndpoint *)context;
+    NetLoopback *loopback = endpoint->loopback;
+
+    if ((size > MAX_NET_PACKET) || (loopback->count == loopback->capacity)) { loopback->dropped++; return false; }
+    if (GetNetLoopbackRandom(loopback) < loopback->loss) { loopback->dropped++; return true; }     // Lost on the way
+
+    NetLoopbackPacket *packet = &loopback->packets[loopback->count++];
+    packet->from = endpoint->peer;
+    packet->to = peer;
+    packet->deliverTime = loopback->time + loopback->latency + loopback->jitter*GetNetLoopbackRandom(loopback);
+    packet->size = size;
+    memcpy(packet->data, data, size);
+
+    return true;
+}
+
+// Receive first delivered loopback packet for the endpoint (jitter can reorder packets)
+static int ReceiveNetLoopback(void *context, int *peer, unsigned char *data, int capacity)
+{
+    NetLoopbackEndpoint *endpoint = (NetLoopbackEndpoint *)context;
+    NetLoopback *loopback = endpoint->loopback;
+
+    for (int i = 0; i < loopback->count; i++)
+    {
+        NetLoopbackPacket *packet = &loopback->packets[i];
+        if ((packet->to != endpoint->peer) || (packet->deliverTime > loopback->time)) continue;
+
+        int size = (packet->size < capacity)? packet->size : capacity;
+        memcpy(data, packet->data, size);
+        *peer = packet->from;
+
+        *packet = loopback->packets[--loopback->count];
+
+        return size;
+    }
+
+    return 0;
+}
+
+// Load loopback with capacity packets in flight
+NetLoopback *LoadNetLoopback(int capacity, float latency, float jitter, float loss)
+{
+    NetLoopback *loopback = (NetLoopback *)RL_CALLOC(1, sizeof(NetLoopback));
+
+    loopback->packets = (NetLoopbackPacket *)RL_MALLOC(capacity*sizeof(NetLoopbackPacket));
+    loopback->capacity = capacity;
+    loopback->latency = latency;
+    loopback->jitter = jitter;
+    loopback->loss = loss;
+    loopback->seed = 12345;
+
+    for (int i = 0; i < MAX_NET_PEERS; i++) loopback->endpoints[i] = (NetLoopbackEndpoint){ .loopback = loopback, .peer = i };
+
+    return loopback;
+}
+
+// Unload loopback
+void UnloadNetLoopback(NetLoopback *loopback)
+{
+    if (loopback == NULL) return;
+
+    RL_FREE(loopback->packets);
+    RL_FREE(loopback);
+}
+
+// Get transport of a loopback endpoint (0: server, 1 and up: clients)
+NetTransport GetNetLoopbackTransport(NetLoopback *loopback, int peer)
+{
+    return (NetTransport){ SendNetLoopback, ReceiveNetLoopback, &loopback->endpoints[peer] };
+}
+
+// Advance loopback clock, packets are delivered when their time is reached
+void UpdateNetLoopback(NetLoopback *loopback, float deltaTime)
+{
+    loopback->time += deltaTime;
+}
+
+//----------------------------------------------------------------------------------
+// UDP transport
+//----------------------------------------------------------------------------------
+typedef struct NetUdp {
+    NetSocket socket;
+    struct sockaddr_in peers[MAX_NET_PEERS];    // Peer 0 is the server (client side), server side peers are assigned on receive
+    int peerCount;
+} NetUdp;
+
+#if defined(_WIN32)
+static int netUdpSockets = 0;       // Open sockets, winsock is started with the first and cleaned up with the last
+#endif
+
+// Send datagram to a peer
+static bool SendNetUdp(void *context, int peer, const unsigned char *data, int size)
+{
+    NetUdp *udp = (NetUdp *)context;
+    if ((peer < 0) || (peer >= udp->peerCount)) return false;
+
+    return (sendto(udp->socket, (const char *)data, size, 0, (struct sockaddr *)&udp->peers[peer], sizeof(struct sockaddr_in)) == size);
+}
+
+// Receive datagram without blocking, unknown senders get the next peer id
+static int ReceiveNetUdp(void *context, int *peer, unsigned char *data, int capacity)
+{
+    NetUdp *udp = (NetUdp *)context;
+
+    while (true)
+    {
+        struct sockaddr_in address = { 0 };
+        socklen_t length = sizeof(address);
+
+        int size = (int)recvfrom(udp->socket, (char *)data, capacity, 0, (struct sockaddr *)&address, &length);
+        if (size <= 0)
+        {
+#if defined(_WIN32)
+            // Port unreachable reported for an earlier send, not an error of this socket
+            if ((size < 0) && (WSAGetLastError() == WSAECONNRESET)) continue;
+#endif
+            return 0;
+        }
+
+        int id = -1;
+        for (int i = 0; i < udp->peerCount; i++)
+        {
+            if ((udp->peers[i].sin_addr.s_addr == address.sin_addr.s_addr) && (udp->peers[i].sin_port == address.sin_port)) { id = i; break; }
+        }
+        if ((id == -1) && (udp->peerCount < MAX_NET_PEERS))
+        {
+            id = udp->peerCount++;
+            udp->peers[id] = address;
+        }
+        if (id == -1) continue;
+
+        *peer = id;
+        return size;
+    }
+}
+
+// Open UDP transport: server binds port, clients (serverHost not NULL, dotted IPv4) use an ephemeral port
+// NOTE: Returns NULL on socket errors, the socket is non-blocking
+NetUdp *OpenNetUdp(const char *serverHost, int port)
+{
+#if defined(_WIN32)
+    if (netUdpSockets == 0)
+    {
+        static long long wsaData[64];       // WSADATA, 8 byte aligned and larger than the struct
+        if (WSAStartup(0x0202, wsaData) != 0) { TRACELOG(LOG_WARNING, "NET: Failed to start winsock"); return NULL; }
+    }
+    netUdpSockets++;
+#endif
+
+    NetSocket fd = socket(AF_INET, SOCK_DGRAM, 0);
+    bool success = (fd != INVALID_SOCKET);
+    if (!success) TRACELOG(LOG_WARNING, "NET: Failed to create UDP socket");
+
+    struct sockaddr_in local = { 0 };
+    local.sin_family = AF_INET;
+    local.sin_addr.s_addr = htonl(INADDR_ANY);
+    local.sin_port = (serverHost == NULL)? htons((unsigned short)port) : 0;
+
+    if (success && (bind(fd, (struct sockaddr *)&local, sizeof(local)) != 0))
+    {
+        TRACELOG(LOG_WARNING, "NET: Failed to bind UDP port %i", port);
+        CloseNetSocket(fd);
+        success = false;
+    }
+
+    if (!success)
+    {
+#if defined(_WIN32)
+        if (--netUdpSockets == 0) WSACleanup();
+#endif
+        return NULL;
+    }
+
+#if defined(_WIN32)
+    unsigned long nonblocking = 1;
+    ioctlsocket(fd, FIONBIO, &nonblocking);
+#else
+    fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+#endif
+
+    NetUdp *udp = (NetUdp *)RL_CALLOC(1, sizeof(NetUdp));
+    udp->socket = fd;
+    udp->peerCount = 1;         // Server side: peer 0 is the server itself and never used
+
+    if (serverHost != NULL)
+    {
+        udp->peers[0].sin_family = AF_INET;
+        udp->peers[0].sin_port = htons((unsigned short)port);
+        udp->peers[0].sin_addr.s_addr = inet_addr(serverHost);
+        if (udp->peers[0].sin_addr.s_addr == INADDR_NONE) TRACELOG(LOG_WARNING, "NET: Invalid server address %s", serverHost);
+    }
+
+    return udp;
+}
+
+// Close UDP transport
+void CloseNetUdp(NetUdp *udp)
+{
+    if (udp == NULL) return;
+
+    CloseNetSocket(udp->socket);
+    RL_FREE(udp);
+
+#if defined(_WIN32)
+    if (--netUdpSockets == 0) WSACleanup();
+#endif
+}
+
+// Get transport of a UDP socket
+NetTransport GetNetUdpTransport(NetUdp *udp)
+{
+    return (NetTransport){ SendNetUdp, ReceiveNetUdp, udp };
+}
+
+//----------------------------------------------------------------------------------
+// Benchmark
+//----------------------------------------------------------------------------------
+
+// Benchmark replication of playerCount players (one client each) over a lossy loopback
+// NOTE: Runs headless. Players walk around at 4 units/s turning randomly, a quarter of them stand still.
+// Every decoded snapshot is checked against the server snapshot of the same tick, returns mismatches plus
+// decode errors (plus one if no snapshot got through)
+int BenchmarkReplication(int playerCount, int ticks, float latency, float loss)
+{
+    const float tickTime = 1.0f/30.0f;
+    NetLoopback *loopback = LoadNetLoopback(4096, latency, 0.25f*latency, loss);
+    NetServer *server = LoadNetServer(GetNetLoopbackTransport(loopback, 0), tickTime);
+    NetClient *clients[MAX_NET_PLAYERS] = { 0 };
+
+    for (int i = 0; i < playerCount; i++) clients[i] = LoadNetClient(GetNetLoopbackTransport(loopback, i + 1), tickTime);
+
+    Camera cameras[MAX_NET_PLAYERS] = { 0 };
+    float headings[MAX_NET_PLAYERS] = { 0 };
+
+    srand(1234);
+    for (int i = 0; i < playerCount; i++)
+    {
+        cameras[i].position = (Vector3){ (float)(rand()%100), 1.7f, (float)(rand()%100) };
+        headings[i] = (rand()%628)/100.0f;
+    }
+
+    Vector3 truth[NET_SNAPSHOT_HISTORY] = { 0 };     // Player 1 server positions per tick
+    int mismatches = 0;
+    double interpolationError = 0.0;
+    int interpolationSamples = 0;
+    SimInput input = { 0 };
+
+    for (int t = 0; t < ticks; t++)
+    {
+        // Server: move players (slot i is owned by client i, connected in order)
+        for (int i = 0; i < playerCount; i++)
+        {
+            if (i%4 != 3)
+            {
+                headings[i] += ((rand()%100) - 50)/500.0f;
+                cameras[i].position = Vector3Add(cameras[i].position, (Vector3){ sinf(headings[i])*4.0f*tickTime, 0.0f, cosf(headings[i])*4.0f*tickTime });
+            }
+            cameras[i].target = Vector3Add(cameras[i].position, (Vector3){ sinf(headings[i]), -0.1f, cosf(headings[i]) });
+
+            if (server->clients[i].connected) SetNetServerPlayer(server, i, GetNetPlayerState(cameras[i], (t/20)%3));
+        }
+
+        UpdateNetServer(server);
+
+        // Clients run two frames per tick
+        for (int frame = 0; frame < 2; frame++)
+        {
+            UpdateNetLoopback(loopback, 0.5f*tickTime);
+
+            for (int i = 0; i < playerCount; i++)
+            {
+                unsigned int before = clients[i]->latestTick;
+                UpdateNetClient(clients[i], 0.5f*tickTime, input);
+
+                NetClient *client = clients[i];
+                if ((client->latestTick != before) && (server->tick - client->latestTick < NET_SNAPSHOT_HISTORY))
+                {
+                    const NetSnapshot *sent = &server->history[client->latestTick & (NET_SNAPSHOT_HISTORY - 1)];
+                    const NetSnapshot *received = &client->history[client->latestTick & (NET_SNAPSHOT_HISTORY - 1)];
+                    for (int k = 0; k < MAX_NET_PLAYERS; k++)
+                    {
+                        if (!IsNetPlayerStateEqual(&sent->players[k], &received->players[k])) { mismatches++; break; }
+                    }
+                }
+            }
+        }
+
+        // Interpolated remote player vs its true position at the client render time (client 0 looking at player 1)
+        if (playerCount > 1)
+        {
+            truth[server->tick & (NET_SNAPSHOT_HISTORY - 1)] = cameras[1].position;
+
+            NetClient *client = clients[0];
+            NetPlayerPose pose = GetNetClientPlayer(client, 1);
+            double renderTick = (client->time + client->serverOffset - client->interpolationDelay)/tickTime;
+            unsigned int tick = (unsigned int)renderTick;
+
+            if (pose.active && (t > 60) && (tick < server->tick) && (server->tick - tick < NET_SNAPSHOT_HISTORY - 1))
+            {
+                Vector3 position = Vector3Lerp(truth[tick & (NET_SNAPSHOT_HISTORY - 1)], truth[(tick + 1) & (NET_SNAPSHOT_HISTORY - 1)], (float)(renderTick - tick));
+                interpolationError += Vector3Distance(pose.position, position);
+                interpolationSamples++;
+            }
+        }
+    }
+
+    NetStats clientStats = { 0 };
+    for (int i = 0; i < playerCount; i++)
+    {
+        clientStats.bytesReceived += clients[i]->stats.bytesReceived;
+        clientStats.snapshots += clients[i]->stats.snapshots;
+        clientStats.deltaSnapshots += clients[i]->stats.deltaSnapshots;
+        clientStats.players += clients[i]->stats.players;
+        clientStats.time += clients[i]->stats.time;
+        clientStats.errors += clients[i]->stats.errors;
+    }
+
+    int snapshots = (server->stats.snapshots > 0)? server->stats.snapshots : 1;
+    TRACELOG(LOG_INFO, "NET: %i players, %i ticks, %.0f ms latency, %.0f%% loss: %.1f bytes/snapshot (%.1f KB/s per client, %i%% delta), server tick %.3f ms",
+        playerCount, ticks, latency*1000.0f, loss*100.0f, (float)server->stats.bytesSent/snapshots, server->stats.bytesSent/(ticks*tickTime)/playerCount/1024.0f,
+        100*server->stats.deltaSnapshots/snapshots, server->stats.time*1000.0/ticks);
+    int failures = mismatches + clientStats.errors + ((clientStats.snapshots == 0)? 1 : 0);
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "NET:     encode %.3f us/player, decode %.3f us/player, %i decoded snapshots, %i mismatches, %i errors, interpolation error %.3f units",
+        server->stats.time*1e6/((server->stats.players > 0)? server->stats.players : 1), clientStats.time*1e6/((clientStats.players > 0)? clientStats.players : 1),
+        clientStats.snapshots, mismatches, clientStats.errors, (interpolationSamples > 0)? interpolationError/interpolationSamples : 0.0);
+
+    for (int i = 0; i < playerCount; i++) UnloadNetClient(clients[i]);
+    UnloadNetServer(server);
+    UnloadNetLoopback(loopback);
+
+    return failures;
+}
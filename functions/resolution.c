@@ -0,0 +1,370 @@
+#include "raylib.h"         // Declares module functions
+#include "rlgl.h"           // Required for: rlViewport()
+
+#include <stdio.h>          // Required for: snprintf()
+#include <stdlib.h>         // Required for: strtof(), rand(), srand()
+#include <math.h>           // Required for: fabsf(), floorf()
+
+// Dynamic resolution: the 3D scene renders into an offscreen target at a scale driven by frame time
+// NOTE: A PI controller tracks a frame time budget from an exponentially smoothed frame time, errors
+// inside a dead band are ignored and the output scale is quantized with a wider step up than down,
+// so it drops quickly on load spikes. A step up is only taken if the frame time predicted at the
+// higher scale is on target, so the scale does not oscillate between two steps around the budget. The controller has no
+// GL dependency and can be replayed headless against recorded frame time traces.
+// The target is allocated at window size, lower scales render into its bottom left corner, then the
+// used part is stretched to the window. The HUD is drawn afterwards at native resolution.
+
+#define MAX_RESOLUTION_TRACE    3600        // Recorded frames (one minute at 60 fps)
+
+typedef struct ResolutionController {
+    float budget;               // Frame time budget (seconds)
+    float headroom;             // Tracked frame time is this budget fraction below the budget, absorbs frame noise
+    float minScale;             // Scale range, per axis
+    float maxScale;
+    float kp;                   // Proportional gain, scale per relative error
+    float ki;                   // Integral gain, scale per relative error per frame
+    float deadBand;             // Relative errors below this are ignored (hysteresis)
+    float step;                 // Output scale quantization
+    float smoothing;            // Frame time smoothing factor per frame [0..1]
+
+    float filtered;             // Smoothed frame time, 0 before the first frame
+    float integral;
+    float rawScale;             // Unquantized controller output
+    float scale;                // Applied scale
+} ResolutionController;
+
+// Replay results of a frame time trace
+typedef struct ResolutionTraceStats {
+    int frames;
+    int overBudget;             // Frames over budget
+    int settledOverBudget;      // Frames over budget after the last scale change
+    int scaleChanges;
+    int reversals;              // Scale changes opposite to the previous change (oscillation)
+    int lastChange;             // Frame of the last scale change, -1 if the scale never changed
+    float meanFrameTime;
+    float meanScale;
+    float minScale;
+    float maxScale;
+} ResolutionTraceStats;
+
+typedef struct DynamicResolution {
+    RenderTexture2D target;     // Window sized, the scaled viewport uses its bottom left part
+    int width;                  // Window size
+    int height;
+    int renderWidth;            // Scaled viewport size
+    int renderHeight;
+    ResolutionController controller;
+
+    float traceTimes[MAX_RESOLUTION_TRACE];     // Recorded frame times and scales (ring)
+    float traceScales[MAX_RESOLUTION_TRACE];
+    int traceCount;
+    int traceNext;
+} DynamicResolution;
+
+// Get default controller settings for a frame time budget
+ResolutionController GetResolutionControllerDefaults(float budget)
+{
+    ResolutionController controller = { 0 };
+
+    controller.budget = budget;
+    controller.headroom = 0.1f;
+    controller.minScale = 0.5f;
+    controller.maxScale = 1.0f;
+    controller.kp = 0.1f;
+    controller.ki = 0.02f;
+    controller.deadBand = 0.05f;
+    controller.step = 0.05f;
+    controller.smoothing = 0.2f;
+    controller.rawScale = controller.maxScale;
+    controller.scale = controller.maxScale;
+
+    return controller;
+}
+
+// Update controller with the last frame time, returns the scale for the next frame
+float UpdateResolutionController(ResolutionController *controller, float frameTime)
+{
+    controller->filtered = (controller->filtered == 0.0f)? frameTime : controller->filtered + controller->smoothing*(frameTime - controller->filtered);
+
+    // Positive error: headroom, scale can go up
+    float target = controller->budget*(1.0f - controller->headroom);
+    float error = (target - controller->filtered)/target;
+    if (fabsf(error) < controller->deadBand) error = 0.0f;
+
+    // Integral holds the steady state scale below max, clamped to the scale range (anti-windup)
+    float range = controller->maxScale - controller->minScale;
+    controller->integral += error;
+    if (controller->ki*controller->integral > 0.0f) controller->integral = 0.0f;
+    if (controller->ki*controller->integral < -range) controller->integral = -range/controller->ki;
+
+    float raw = controller->maxScale + controller->kp*error + controller->ki*controller->integral;
+    if (raw < controller->minScale) raw = controller->minScale;
+    if (raw > controller->maxScale) raw = controller->maxScale;
+    controller->rawScale = raw;
+
+    // Quantized output: step down as soon as raw is half a step below, step up only a full step above
+    // and only if the frame time predicted at the higher scale (cost proportional to pixels) stays on
+    // target, otherwise the integral is held so it does not wind up towards the next step
+    if ((raw < controller->scale - 0.5f*controller->step) || (raw >= controller->scale + controller->step))
+    {
+        float scale = floorf(raw/controller->step + 0.5f)*controller->step;
+        if (scale < controller->minScale) scale = controller->minScale;
+        if (scale > controller->maxScale) scale = controller->maxScale;
+
+        float ratio = scale/controller->scale;
+        if ((scale > controller->scale) && (controller->filtered*ratio*ratio > target)) controller->integral -= error;
+        else controller->scale = scale;
+    }
+
+    return controller->scale;
+}
+
+// Replay a frame time trace: frame cost is assumed proportional to rendered pixels
+// NOTE: scales are the scales the trace was recorded at (NULL: native), the trace is converted to
+// native cost per frame and replayed with the scales the controller picks
+ResolutionTraceStats SimulateResolutionTrace(ResolutionController controller, const float *frameTimes, const float *scales, int count)
+{
+    ResolutionTraceStats stats = { 0 };
+    stats.lastChange = -1;
+    stats.minScale = controller.scale;
+    stats.maxScale = controller.scale;
+
+    float scale = controller.scale;
+    float lastStep = 0.0f;
+    double timeSum = 0.0, scaleSum = 0.0;
+
+    for (int i = 0; i < count; i++)
+    {
+        float recorded = (scales != NULL)? scales[i] : 1.0f;
+        float frameTime = frameTimes[i]*(scale*scale)/(recorded*recorded);
+
+        if (frameTime > controller.budget)
+        {
+            stats.overBudget++;
+            stats.settledOverBudget++;
+        }
+        timeSum += frameTime;
+        scaleSum += scale;
+
+        float next = UpdateResolutionController(&controller, frameTime);
+        if (next != scale)
+        {
+            if (lastStep*(next - scale) < 0.0f) stats.reversals++;
+            lastStep = next - scale;
+            stats.scaleChanges++;
+            stats.settledOverBudget = 0;
+            stats.lastChange = i;
+        }
+        if (next < stats.minScale) stats.minScale = next;
+        if (next > stats.maxScale) stats.maxScale = next;
+        scale = next;
+    }
+
+    stats.frames = count;
+    stats.meanFrameTime = (count > 0)? (float)(timeSum/count) : 0.0f;
+    stats.meanScale = (count > 0)? (float)(scaleSum/count) : 0.0f;
+
+    return stats;
+}
+
+// Load frame time trace (text, one "milliseconds scale" pair per line), returns frame count
+// NOTE: Arrays are allocated, free them with RL_FREE()
+int LoadFrameTimeTrace(const char *fileName, float **frameTimes, float **scales)
+{
+    char *text = LoadFileText(fileName);
+    if (text == NULL) return 0;
+
+    int lines = 1;
+    for (char *c = text; *c != '\0'; c++) if (*c == '\n') lines++;
+
+    *frameTimes = (float *)RL_MALLOC(lines*sizeof(float));
+    *scales = (float *)RL_MALLOC(lines*sizeof(float));
+
+    int count = 0;
+    char *cursor = text;
+    while (*cursor != '\0')
+    {
+        char *end = NULL;
+        float milliseconds = strtof(cursor, &end);
+        if (end == cursor) break;
+
+        cursor = end;
+        float scale = strtof(cursor, &end);
+        if (end == cursor) scale = 1.0f;
+        cursor = end;
+
+        (*frameTimes)[count] = milliseconds/1000.0f;
+        (*scales)[count] = scale;
+        count++;
+
+        while ((*cursor != '\0') && (*cursor != '\n')) cursor++;
+        while (*cursor == '\n') cursor++;
+    }
+
+    UnloadFileText(text);
+
+    return count;
+}
+
+// Load dynamic resolution target at window size
+DynamicResolution *LoadDynamicResolution(int width, int height, float budget)
+{
+    DynamicResolution *resolution = (DynamicResolution *)RL_CALLOC(1, sizeof(DynamicResolution));
+
+    resolution->target = LoadRenderTexture(width, height);
+    SetTextureFilter(resolution->target.texture, TEXTURE_FILTER_BILINEAR);
+    resolution->width = width;
+    resolution->height = height;
+    resolution->renderWidth = width;
+    resolution->renderHeight = height;
+    resolution->controller = GetResolutionControllerDefaults(budget);
+
+    return resolution;
+}
+
+// Unload dynamic resolution target
+void UnloadDynamicResolution(DynamicResolution *resolution)
+{
+    if (resolution == NULL) return;
+
+    UnloadRenderTexture(resolution->target);
+    RL_FREE(resolution);
+}
+
+// Update scale from the last frame work time (without frame pacing wait), reallocates on window resize
+void UpdateDynamicResolution(DynamicResolution *resolution, float frameTime, int width, int height)
+{
+    if ((width != resolution->width) || (height != resolution->height))
+    {
+        UnloadRenderTexture(resolution->target);
+        resolution->target = LoadRenderTexture(width, height);
+        SetTextureFilter(resolution->target.texture, TEXTURE_FILTER_BILINEAR);
+        resolution->width = width;
+        resolution->height = height;
+    }
+
+    resolution->traceTimes[resolution->traceNext] = frameTime;
+    resolution->traceScales[resolution->traceNext] = resolution->controller.scale;
+    resolution->traceNext = (resolution->traceNext + 1)%MAX_RESOLUTION_TRACE;
+    if (resolution->traceCount < MAX_RESOLUTION_TRACE) resolution->traceCount++;
+
+    float scale = UpdateResolutionController(&resolution->controller, frameTime);
+    resolution->renderWidth = (int)(width*scale + 0.5f);
+    resolution->renderHeight = (int)(height*scale + 0.5f);
+}
+
+// Begin scene drawing into the scaled viewport
+void BeginDynamicResolution(DynamicResolution *resolution)
+{
+    BeginTextureMode(resolution->target);
+    rlViewport(0, 0, resolution->renderWidth, resolution->renderHeight);
+}
+
+// End scene drawing
+void EndDynamicResolution(void)
+{
+    EndTextureMode();
+}
+
+// Draw the scaled scene stretched to the window
+void DrawDynamicResolution(const DynamicResolution *resolution)
+{
+    // Render textures are stored bottom up: the viewport part starts at the bottom, flip vertically
+    Rectangle source = { 0.0f, 0.0f, (float)resolution->renderWidth, -(float)resolution->renderHeight };
+    Rectangle dest = { 0.0f, 0.0f, (float)resolution->width, (float)resolution->height };
+
+    DrawTexturePro(resolution->target.texture, source, dest, (Vector2){ 0.0f, 0.0f }, 0.0f, WHITE);
+}
+
+// Export recorded frames as a frame time trace, oldest first
+// NOTE: Text is built in frame memory, exporting from a running level does not touch the heap
+// WARNING: Main thread only
+bool ExportFrameTimeTrace(const DynamicResolution *resolution, const char *fileName)
+{
+    char *text = (char *)FrameAlloc(resolution->traceCount*32 + 1);
+    int length = 0;
+    int first = (resolution->traceCount < MAX_RESOLUTION_TRACE)? 0 : resolution->traceNext;
+
+    text[0] = '\0';
+    for (int i = 0; i < resolution->traceCount; i++)
+    {
+        int index = (first + i)%MAX_RESOLUTION_TRACE;
+        length += snprintf(text + length, 32, "%.3f %.3f\n", resolution->traceTimes[index]*1000.0f, resolution->traceScales[index]);
+    }
+
+    bool success = SaveFileText(fileName, text);
+
+    return success;
+}
+
+// Benchmark controller on synthetic traces and a recorded trace, returns the number of failed checks
+// NOTE: Runs headless at a 60 fps budget. Light load must stay at full scale with no frame over budget,
+// heavy load must settle in the first half and not change scale after that, overload must stop at the
+// minimum scale, load spikes must not make the scale oscillate and no trace may leave the scale range
+int BenchmarkResolutionController(const char *traceFileName, int frames)
+{
+    const char *names[5] = { "light", "heavy", "overload", "ramp", "spikes" };
+    float *trace = (float *)RL_MALLOC(frames*sizeof(float));
+    ResolutionController controller = GetResolutionControllerDefaults(1.0f/60.0f);
+    int failures = 0;
+
+    srand(4321);
+    for (int t = 0; t < 5; t++)
+    {
+        // Native resolution frame times with +-10% noise
+        for (int i = 0; i < frames; i++)
+        {
+            float native = 0.008f;
+            if (t == 1) native = 0.030f;
+            else if (t == 2) native = 0.100f;
+            else if (t == 3) native = 0.008f + 0.022f*(float)i/frames;
+            else if ((t == 4) && (i%120 == 60)) native = 0.050f;
+
+            trace[i] = native*(0.9f + 0.2f*(rand()%1000)/1000.0f);
+        }
+
+        double start = GetTimerSeconds();
+        ResolutionTraceStats stats = SimulateResolutionTrace(controller, trace, NULL, frames);
+        double time = GetTimerSeconds() - start;
+
+        int failed = 0;
+        if ((stats.minScale < controller.minScale) || (stats.maxScale > controller.maxScale)) failed++;
+        if ((t == 0) && ((stats.overBudget > 0) || (stats.minScale < controller.maxScale))) failed++;
+        if ((t == 1) && ((stats.lastChange >= frames/2) || (stats.reversals > 0) || (stats.settledOverBudget > 0))) failed++;
+        if ((t == 2) && ((stats.lastChange >= frames/2) || (stats.minScale != controller.minScale))) failed++;
+        if ((t == 4) && (stats.reversals > 0)) failed++;
+        failures += failed;
+
+        TRACELOG((failed == 0)? LOG_INFO : LOG_WARNING, "RESOLUTION: [%s] %i frames: %i over budget (%i settled), mean %.2f ms, scale mean %.2f range %.2f..%.2f, %i scale changes, %i reversals (%.3f us/frame)",
+            names[t], stats.frames, stats.overBudget, stats.settledOverBudget, stats.meanFrameTime*1000.0f, stats.meanScale, stats.minScale, stats.maxScale,
+            stats.scaleChanges, stats.reversals, time*1e6/frames);
+    }
+
+    RL_FREE(trace);
+
+    // Recorded trace: replayed from the scales it was recorded at, under 3% of frames may go over budget
+    float *frameTimes = NULL;
+    float *scales = NULL;
+    int count = LoadFrameTimeTrace(traceFileName, &frameTimes, &scales);
+
+    if (count == 0)
+    {
+        TRACELOG(LOG_WARNING, "RESOLUTION: [%s] Failed to load frame time trace", traceFileName);
+        return failures + 1;
+    }
+
+    ResolutionTraceStats stats = SimulateResolutionTrace(controller, frameTimes, scales, count);
+
+    int failed = 0;
+    if ((stats.minScale < controller.minScale) || (stats.maxScale > controller.maxScale)) failed++;
+    if (stats.overBudget*100 > stats.frames*3) failed++;
+    failures += failed;
+
+    TRACELOG((failed == 0)? LOG_INFO : LOG_WARNING, "RESOLUTION: [%s] %i frames: %i over budget, mean %.2f ms, scale mean %.2f range %.2f..%.2f, %i scale changes, %i reversals",
+        traceFileName, stats.frames, stats.overBudget, stats.meanFrameTime*1000.0f, stats.meanScale, stats.minScale, stats.maxScale, stats.scaleChanges, stats.reversals);
+
+    RL_FREE(frameTimes);
+    RL_FREE(scales);
+
+    return failures;
+}
@@ -0,0 +1,272 @@
+#include "raylib.h"         // Declares module functions
+
+#include <string.h>         // Required for: strcmp(), strncpy(), memset()
+
+// Resources: reference counted raylib assets shared between scenes
+// NOTE: Every scene lists the assets it needs, a transition acquires the assets of the new scene
+// before releasing the old one, so shared assets stay loaded and the rest is unloaded. The next
+// scene can be prefetched a few assets per frame, prefetched assets are held until the next transition.
+// WARNING: Loads upload to GPU, main thread only
+
+#define MAX_RESOURCES           64
+#define MAX_RESOURCE_PATH       256
+
+typedef enum ResourceType {
+    RESOURCE_MODEL = 0,
+    RESOURCE_TEXTURE,
+    RESOURCE_IMAGE,             // CPU only image (cubicmaps, heightmaps)
+    RESOURCE_SOUND
+} ResourceType;
+
+// Scene asset declaration
+typedef struct SceneResource {
+    int type;
+    const char *path;
+} SceneResource;
+
+typedef struct Scene {
+    const char *name;
+    const SceneResource *resources;
+    int resourceCount;
+} Scene;
+
+typedef struct Resource {
+    int type;
+    char path[MAX_RESOURCE_PATH];
+    int refCount;               // Loaded while refCount > 0
+    bool prefetched;            // Holds one reference until the next transition
+    long long bytes;            // Tracked memory size
+
+    Model model;
+    Texture2D texture;
+    Image image;
+    Sound sound;
+} Resource;
+
+typedef struct ResourceManager {
+    Resource resources[MAX_RESOURCES];
+    int count;                  // Used entries, unloaded entries are reused
+
+    const Scene *prefetch;      // Scene being prefetched, NULL if none
+    int prefetchNext;           // Next scene resource to prefetch
+} ResourceManager;
+
+// Find resource entry, returns -1 if not found
+static int FindResource(const ResourceManager *manager, int type, const char *path)
+{
+    for (int i = 0; i < manager->count; i++)
+    {
+        if ((manager->resources[i].type == type) && (manager->resources[i].refCount > 0) && (strcmp(manager->resources[i].path, path) == 0)) return i;
+    }
+
+    return -1;
+}
+
+// Load resource data and charge it to the memory tag of its type
+static void LoadResourceData(Resource *resource)
+{
+    switch (resource->type)
+    {
+        case RESOURCE_MODEL:
+        {
+            resource->model = LoadModel(resource->path);
+            resource->bytes = GetModelMemorySize(resource->model);
+            TrackMemory(MEMORY_TAG_MODELS, resource->bytes);
+        } break;
+        case RESOURCE_TEXTURE:
+        {
+            resource->texture = LoadTexture(resource->path);
+            resource->bytes = GetTextureMemorySize(resource->texture);
+            TrackMemory(MEMORY_TAG_TEXTURES, resource->bytes);
+        } break;
+        case RESOURCE_IMAGE:
+        {
+            resource->image = LoadImage(resource->path);
+            resource->bytes = GetPixelDataSize(resource->image.width, resource->image.height, resource->image.format);
+            TrackMemory(MEMORY_TAG_TEXTURES, resource->bytes);
+        } break;
+        case RESOURCE_SOUND:
+        {
+            resource->sound = LoadSound(resource->path);
+            resource->bytes = GetSoundMemorySize(resource->sound);
+            TrackMemory(MEMORY_TAG_AUDIO, resource->bytes);
+        } break;
+        default: break;
+    }
+
+    TRACELOG(LOG_INFO, "RESOURCES: [%s] Loaded (%lld KB)", resource->path, resource->bytes/1024);
+}
+
+// Unload resource data
+static void UnloadResourceData(Resource *resource)
+{
+    switch (resource->type)
+    {
+        case RESOURCE_MODEL: UnloadModel(resource->model); TrackMemory(MEMORY_TAG_MODELS, -resource->bytes); break;
+        case RESOURCE_TEXTURE: UnloadTexture(resource->texture); TrackMemory(MEMORY_TAG_TEXTURES, -resource->bytes); break;
+        case RESOURCE_IMAGE: UnloadImage(resource->image); TrackMemory(MEMORY_TAG_TEXTURES, -resource->bytes); break;
+        case RESOURCE_SOUND: UnloadSound(resource->sound); TrackMemory(MEMORY_TAG_AUDIO, -resource->bytes); break;
+        default: break;
+    }
+
+    TRACELOG(LOG_INFO, "RESOURCES: [%s] Unloaded", resource->path);
+}
+
+// Acquire resource, loads it if it is not resident, returns resource index (-1 if the table is full)
+int AcquireResource(ResourceManager *manager, int type, const char *path)
+{
+    int index = FindResource(manager, type, path);
+
+    if (index == -1)
+    {
+        // Reuse an unloaded entry before growing the table
+        for (int i = 0; (i < manager->count) && (index == -1); i++) if (manager->resources[i].refCount == 0) index = i;
+
+        if (index == -1)
+        {
+            if (manager->count == MAX_RESOURCES)
+            {
+                TRACELOG(LOG_WARNING, "RESOURCES: [%s] Resource table full", path);
+                return -1;
+            }
+
+            index = manager->count++;
+        }
+
+        Resource *resource = &manager->resources[index];
+        memset(resource, 0, sizeof(Resource));
+        resource->type = type;
+        strncpy(resource->path, path, MAX_RESOURCE_PATH - 1);
+
+        LoadResourceData(resource);
+    }
+
+    manager->resources[index].refCount++;
+
+    return index;
+}
+
+// Release resource, unloads it when no reference is left
+void ReleaseResource(ResourceManager *manager, int index)
+{
+    if ((index < 0) || (index >= manager->count) || (manager->resources[index].refCount == 0)) return;
+
+    Resource *resource = &manager->resources[index];
+    resource->refCount--;
+
+    if (resource->refCount == 0)
+    {
+        UnloadResourceData(resource);
+        resource->prefetched = false;
+    }
+}
+
+// Acquire all resources of a scene
+void AcquireSceneResources(ResourceManager *manager, const Scene *scene)
+{
+    for (int i = 0; i < scene->resourceCount; i++) AcquireResource(manager, scene->resources[i].type, scene->resources[i].path);
+}
+
+// Release all resources of a scene
+void ReleaseSceneResources(ResourceManager *manager, const Scene *scene)
+{
+    for (int i = 0; i < scene->resourceCount; i++) ReleaseResource(manager, FindResource(manager, scene->resources[i].type, scene->resources[i].path));
+}
+
+// Drop references held by prefetching
+static void ReleasePrefetchedResources(ResourceManager *manager)
+{
+    for (int i = 0; i < manager->count; i++)
+    {
+        if (manager->resources[i].prefetched)
+        {
+            manager->resources[i].prefetched = false;
+            ReleaseResource(manager, i);
+        }
+    }
+
+    manager->prefetch = NULL;
+    manager->prefetchNext = 0;
+}
+
+// Transition between scenes: new scene resources are acquired first, so shared ones are never reloaded
+void TransitionScene(ResourceManager *manager, const Scene *from, const Scene *to)
+{
+    if (to != NULL) AcquireSceneResources(manager, to);
+    if (from != NULL) ReleaseSceneResources(manager, from);
+
+    ReleasePrefetchedResources(manager);
+
+    TRACELOG(LOG_INFO, "RESOURCES: Scene '%s' active", (to != NULL)? to->name : "none");
+}
+
+// Start prefetching a scene, resources are loaded by UpdateResourceManager()
+void PrefetchScene(ResourceManager *manager, const Scene *scene)
+{
+    ReleasePrefetchedResources(manager);
+
+    manager->prefetch = scene;
+    manager->prefetchNext = 0;
+}
+
+// Update resource manager: prefetch up to maxLoads missing resources of the prefetched scene
+void UpdateResourceManager(ResourceManager *manager, int maxLoads)
+{
+    const Scene *scene = manager->prefetch;
+    if (scene == NULL) return;
+
+    while ((manager->prefetchNext < scene->resourceCount) && (maxLoads > 0))
+    {
+        const SceneResource *entry = &scene->resources[manager->prefetchNext++];
+
+        // Already resident resources need no prefetch reference, they stay loaded through the transition
+        if (FindResource(manager, entry->type, entry->path) != -1) continue;
+
+        int index = AcquireResource(manager, entry->type, entry->path);
+        if (index != -1) manager->resources[index].prefetched = true;
+        maxLoads--;
+    }
+}
+
+// Unload resource manager, unloads every resident resource
+void UnloadResourceManager(ResourceManager *manager)
+{
+    for (int i = 0; i < manager->count; i++)
+    {
+        if (manager->resources[i].refCount > 0) UnloadResourceData(&manager->resources[i]);
+    }
+
+    memset(manager, 0, sizeof(ResourceManager));
+}
+
+// Get resident model, empty model if it is not loaded
+Model GetResourceModel(const ResourceManager *manager, const char *path)
+{
+    int index = FindResource(manager, RESOURCE_MODEL, path);
+
+    return (index != -1)? manager->resources[index].model : (Model){ 0 };
+}
+
+// Get resident texture, empty texture if it is not loaded
+Texture2D GetResourceTexture(const ResourceManager *manager, const char *path)
+{
+    int index = FindResource(manager, RESOURCE_TEXTURE, path);
+
+    return (index != -1)? manager->resources[index].texture : (Texture2D){ 0 };
+}
+
+// Get resident image, empty image if it is not loaded
+Image GetResourceImage(const ResourceManager *manager, const char *path)
+{
+    int index = FindResource(manager, RESOURCE_IMAGE, path);
+
+    return (index != -1)? manager->resources[index].image : (Image){ 0 };
+}
+
+// Get resident sound, empty sound if it is not loaded
+Sound GetResourceSound(const ResourceManager *manager, const char *path)
+{
+    int index = FindResource(manager, RESOURCE_SOUND, path);
+
+    return (index != -1)? manager->resources[index].sound : (Sound){ 0 };
+}
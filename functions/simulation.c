@@ -0,0 +1,404 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <time.h>           // Required for: nanosleep()
+#include <pthread.h>        // Required for: pthread_create(), pthread_join()
+#include <string.h>         // Required for: memcmp()
+#include <math.h>           // Required for: sinf(), cosf()
+
+// Simulation: fixed timestep game update on its own thread, decoupled from rendering
+// NOTE: The render thread pushes timestamped input every frame and reads the latest complete
+// snapshot, the simulation thread steps while it has input covering the whole step. Each step
+// consumes exactly the inputs stamped inside it, so the same input list gives the same snapshots
+// on the thread or stepped headless with StepSimulation(), however the threads are scheduled.
+// Snapshots are handed over with a lock-free triple buffer, input with a single producer ring.
+// WARNING: The step callback runs on the simulation thread, no raylib input, window or GL calls
+
+#define MAX_SIM_INPUTS          256         // Input ring capacity, power of two
+#define MAX_SIM_AGENTS          256         // Agent positions in a snapshot
+#define MAX_SIM_BODIES          256         // Rigid body poses in a snapshot
+
+#define SIM_SNAPSHOT_FRESH      4           // Middle buffer flag, set when it holds an unread snapshot
+
+// Simulation input actions, bit flags
+typedef enum SimAction {
+    SIM_ACTION_FORWARD = 1,
+    SIM_ACTION_BACK = 2,
+    SIM_ACTION_LEFT = 4,
+    SIM_ACTION_RIGHT = 8,
+    SIM_ACTION_SPRINT = 16,
+    SIM_ACTION_CROUCH = 32,
+    SIM_ACTION_FIRE = 64
+} SimAction;
+
+typedef struct SimInput {
+    double time;                // Seconds since simulation start
+    unsigned int down;          // SimAction flags held
+    unsigned int pressed;       // SimAction flags pressed since the previous input
+    Vector2 mouseDelta;
+} SimInput;
+
+// Immutable frame state read by the render thread
+typedef struct SimSnapshot {
+    unsigned int tick;
+    double time;
+    Camera camera;
+    int agentCount;
+    Vector3 agents[MAX_SIM_AGENTS];
+    int bodyCount;
+    Vector3 bodyPositions[MAX_SIM_BODIES];
+    Quaternion bodyRotations[MAX_SIM_BODIES];
+} SimSnapshot;
+
+// Step callback, must write every snapshot field (buffers are reused)
+typedef void (*SimStepCallback)(void *state, const SimInput *input, float dt, SimSnapshot *snapshot);
+
+typedef struct Simulation {
+    SimStepCallback step;
+    void *state;
+    float dt;
+    double startTime;
+
+    SimInput inputs[MAX_SIM_INPUTS];
+    unsigned int inputHead;     // Consumer position, simulation thread
+    unsigned int inputTail;     // Producer position, render thread
+    SimInput current;           // Input accumulated for the next step
+    unsigned int tick;
+
+    SimSnapshot snapshots[3];
+    int back;                   // Written by the simulation thread
+    int middle;                 // Shared, buffer index | SIM_SNAPSHOT_FRESH
+    int front;                  // Read by the render thread
+
+    pthread_t thread;
+    int running;
+} Simulation;
+
+// Load simulation, initial snapshot is written by a zero length step
+Simulation *LoadSimulation(SimStepCallback step, void *state, float dt)
+{
+    Simulation *sim = (Simulation *)RL_CALLOC(1, sizeof(Simulation));
+
+    sim->step = step;
+    sim->state = state;
+    sim->dt = dt;
+    sim->back = 0;
+    sim->middle = 1;
+    sim->front = 2;
+
+    step(state, &sim->current, 0.0f, &sim->snapshots[sim->front]);
+
+    return sim;
+}
+
+// Push render thread input, time must not decrease
+// NOTE: Returns false if the simulation is MAX_SIM_INPUTS inputs behind, input is dropped
+bool PushSimInput(Simulation *sim, SimInput input)
+{
+    unsigned int tail = sim->inputTail;
+
+    if ((tail - __atomic_load_n(&sim->inputHead, __ATOMIC_ACQUIRE)) == MAX_SIM_INPUTS) return false;
+
+    sim->inputs[tail & (MAX_SIM_INPUTS - 1)] = input;
+    __atomic_store_n(&sim->inputTail, tail + 1, __ATOMIC_RELEASE);
+
+    return true;
+}
+
+// Capture current raylib input, stamped with the simulation clock (render thread)
+SimInput CaptureSimInput(const Simulation *sim)
+{
+    SimInput input = { 0 };
+
+    input.time = GetTimerSeconds() - sim->startTime;
+    input.mouseDelta = GetMouseDelta();
+
+    if (IsKeyDown(KEY_W)) input.down |= SIM_ACTION_FORWARD;
+    if (IsKeyDown(KEY_S)) input.down |= SIM_ACTION_BACK;
+    if (IsKeyDown(KEY_A)) input.down |= SIM_ACTION_LEFT;
+    if (IsKeyDown(KEY_D)) input.down |= SIM_ACTION_RIGHT;
+    if (IsKeyDown(KEY_LEFT_SHIFT)) input.down |= SIM_ACTION_SPRINT;
+    if (IsKeyPressed(KEY_LEFT_CONTROL)) input.pressed |= SIM_ACTION_CROUCH;
+    if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT)) input.pressed |= SIM_ACTION_FIRE;
+
+    return input;
+}
+
+// Run all steps covered by pushed input, returns steps done
+// NOTE: A step runs only once input past its end arrived, headless callers push a final input to flush
+int StepSimulation(Simulation *sim)
+{
+    int steps = 0;
+
+    while (true)
+    {
+        double stepEnd = (sim->tick + 1)*(double)sim->dt;
+        unsigned int tail = __atomic_load_n(&sim->inputTail, __ATOMIC_ACQUIRE);
+
+        // Accumulate inputs stamped inside this step: held keys from the latest, presses and mouse summed
+        while ((sim->inputHead != tail) && (sim->inputs[sim->inputHead & (MAX_SIM_INPUTS - 1)].time < stepEnd))
+        {
+            const SimInput *input = &sim->inputs[sim->inputHead & (MAX_SIM_INPUTS - 1)];
+            sim->current.down = input->down;
+            sim->current.pressed |= input->pressed;
+            sim->current.mouseDelta.x += input->mouseDelta.x;
+            sim->current.mouseDelta.y += input->mouseDelta.y;
+            __atomic_store_n(&sim->inputHead, sim->inputHead + 1, __ATOMIC_RELEASE);
+        }
+
+        // No input beyond the step end yet, more input for this step may still come
+        if (sim->inputHead == tail) break;
+
+        sim->current.time = stepEnd;
+        sim->step(sim->state, &sim->current, sim->dt, &sim->snapshots[sim->back]);
+        sim->snapshots[sim->back].tick = sim->tick + 1;
+        sim->snapshots[sim->back].time = stepEnd;
+
+        // Publish: swap back buffer with middle, marking it fresh
+        sim->back = __atomic_exchange_n(&sim->middle, sim->back | SIM_SNAPSHOT_FRESH, __ATOMIC_ACQ_REL) & ~SIM_SNAPSHOT_FRESH;
+
+        sim->current.pressed = 0;
+        sim->current.mouseDelta = (Vector2){ 0 };
+        sim->tick++;
+        steps++;
+    }
+
+    return steps;
+}
+
+// Get latest complete snapshot (render thread), valid until the next call
+const SimSnapshot *GetSimSnapshot(Simulation *sim)
+{
+    if (__atomic_load_n(&sim->middle, __ATOMIC_ACQUIRE) & SIM_SNAPSHOT_FRESH)
+    {
+        sim->front = __atomic_exchange_n(&sim->middle, sim->front, __ATOMIC_ACQ_REL) & ~SIM_SNAPSHOT_FRESH;
+    }
+
+    return &sim->snapshots[sim->front];
+}
+
+// Simulation thread: step whenever input is available, sleep briefly otherwise
+static void *SimulationThread(void *arg)
+{
+    Simulation *sim = (Simulation *)arg;
+    struct timespec idle = { 0, 500000 };
+
+    while (__atomic_load_n(&sim->running, __ATOMIC_ACQUIRE))
+    {
+        if (StepSimulation(sim) == 0) nanosleep(&idle, NULL);
+    }
+
+    return NULL;
+}
+
+// Start simulation thread, simulation clock starts now
+void StartSimulation(Simulation *sim)
+{
+    sim->startTime = GetTimerSeconds();
+    sim->running = 1;
+
+    if (pthread_create(&sim->thread, NULL, SimulationThread, sim) != 0)
+    {
+        TRACELOG(LOG_WARNING, "SIMULATION: Failed to start simulation thread");
+        sim->running = 0;
+    }
+}
+
+// Stop simulation thread, pending input is not consumed
+void StopSimulation(Simulation *sim)
+{
+    if (!sim->running) return;
+
+    __atomic_store_n(&sim->running, 0, __ATOMIC_RELEASE);
+    pthread_join(sim->thread, NULL);
+}
+
+// Unload simulation, stops the thread if running
+void UnloadSimulation(Simulation *sim)
+{
+    if (sim == NULL) return;
+
+    StopSimulation(sim);
+    RL_FREE(sim);
+}
+
+// Benchmark step state: input driven camera, agents chasing it, checksum of every stepped snapshot
+typedef struct SimBenchmarkState {
+    float yaw;
+    Vector3 position;
+    bool crouched;
+    int agentCount;
+    Vector3 agents[MAX_SIM_AGENTS];
+    Vector3 velocities[MAX_SIM_AGENTS];
+    unsigned int checksums[4096];       // First 4096 ticks
+    int tickCount;                      // Written by the simulation thread
+} SimBenchmarkState;
+
+// Compute FNV-1a checksum of snapshot camera and agents
+static unsigned int GetSimSnapshotChecksum(const SimSnapshot *snapshot)
+{
+    unsigned int hash = 2166136261u;
+    const unsigned char *bytes[2] = { (const unsigned char *)&snapshot->camera, (const unsigned char *)snapshot->agents };
+    size_t sizes[2] = { sizeof(Camera), snapshot->agentCount*sizeof(Vector3) };
+
+    for (int b = 0; b < 2; b++)
+    {
+        for (size_t i = 0; i < sizes[b]; i++) hash = (hash ^ bytes[b][i])*16777619u;
+    }
+
+    return hash;
+}
+
+// Benchmark step: move and turn with input, fire pushes agents away, agents steer towards the camera
+static void UpdateSimBenchmark(void *data, const SimInput *input, float dt, SimSnapshot *snapshot)
+{
+    SimBenchmarkState *state = (SimBenchmarkState *)data;
+
+    state->yaw += input->mouseDelta.x*0.003f;
+    if (input->pressed & SIM_ACTION_CROUCH) state->crouched = !state->crouched;
+
+    Vector3 forward = { sinf(state->yaw), 0.0f, cosf(state->yaw) };
+    Vector3 right = { forward.z, 0.0f, -forward.x };
+    Vector3 move = { 0 };
+    float speed = ((input->down & SIM_ACTION_SPRINT)? 8.0f : 4.0f)*dt;
+
+    if (input->down & SIM_ACTION_FORWARD) move = Vector3Add(move, forward);
+    if (input->down & SIM_ACTION_BACK) move = Vector3Subtract(move, forward);
+    if (input->down & SIM_ACTION_RIGHT) move = Vector3Add(move, right);
+    if (input->down & SIM_ACTION_LEFT) move = Vector3Subtract(move, right);
+    state->position = Vector3Add(state->position, Vector3Scale(Vector3Normalize(move), speed));
+
+    for (int i = 0; i < state->agentCount; i++)
+    {
+        Vector3 toCamera = Vector3Subtract(state->position, state->agents[i]);
+        Vector3 steer = Vector3Scale(Vector3Normalize(toCamera), 3.0f);
+
+        if ((input->pressed & SIM_ACTION_FIRE) && (Vector3LengthSqr(toCamera) < 25.0f)) state->velocities[i] = Vector3Scale(steer, -4.0f);
+
+        state->velocities[i] = Vector3Lerp(state->velocities[i], steer, 2.0f*dt);
+        state->agents[i] = Vector3Add(state->agents[i], Vector3Scale(state->velocities[i], dt));
+    }
+
+    snapshot->camera = (Camera){ 0 };
+    snapshot->camera.position = (Vector3){ state->position.x, state->crouched? 1.0f : 1.8f, state->position.z };
+    snapshot->camera.target = Vector3Add(snapshot->camera.position, forward);
+    snapshot->camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+    snapshot->camera.fovy = 60.0f;
+    snapshot->agentCount = state->agentCount;
+    memcpy(snapshot->agents, state->agents, state->agentCount*sizeof(Vector3));
+    snapshot->bodyCount = 0;
+
+    // Zero length initial step is not a tick
+    if (dt > 0.0f)
+    {
+        if (state->tickCount < 4096) state->checksums[state->tickCount] = GetSimSnapshotChecksum(snapshot);
+        __atomic_store_n(&state->tickCount, state->tickCount + 1, __ATOMIC_RELEASE);
+    }
+}
+
+// Generate benchmark input stream: irregular frame times, changing held keys, presses and mouse motion
+static int GenSimBenchmarkInputs(SimInput *inputs, int maxInputs, double duration)
+{
+    unsigned int seed = 12345;
+    double time = 0.0;
+    unsigned int down = 0;
+    int count = 0;
+
+    while ((count < maxInputs - 1) && (time < duration))
+    {
+        seed = seed*1664525u + 1013904223u;
+        time += (1.0 + (seed >> 24)%5)/144.0;
+
+        SimInput input = { 0 };
+        input.time = time;
+        if ((seed >> 8)%16 == 0) down = (seed >> 12) & (SIM_ACTION_FORWARD | SIM_ACTION_BACK | SIM_ACTION_LEFT | SIM_ACTION_RIGHT | SIM_ACTION_SPRINT);
+        input.down = down;
+        if ((seed >> 16)%32 == 0) input.pressed |= SIM_ACTION_FIRE;
+        if ((seed >> 20)%64 == 0) input.pressed |= SIM_ACTION_CROUCH;
+        input.mouseDelta = (Vector2){ (float)((int)((seed >> 4) & 31) - 15), (float)((int)((seed >> 9) & 15) - 7) };
+
+        inputs[count++] = input;
+    }
+
+    return count;
+}
+
+// Run simulation on an input stream, stepped headless or on its thread, every batch inputs the caller steps
+// (headless) or sleeps like a render thread so the simulation thread catches up and waits for input
+// NOTE: When the input ring is full the simulation has to catch up first
+static void RunSimBenchmark(SimBenchmarkState *state, const SimInput *inputs, int inputCount, float dt, int batch, bool threaded, SimSnapshot *last)
+{
+    struct timespec wait = { 0, 100000 };
+
+    memset(state, 0, sizeof(SimBenchmarkState));
+    state->agentCount = 64;
+    for (int i = 0; i < state->agentCount; i++) state->agents[i] = (Vector3){ (float)(i%8)*3.0f - 10.0f, 0.0f, (float)(i/8)*3.0f + 5.0f };
+
+    Simulation *sim = LoadSimulation(UpdateSimBenchmark, state, dt);
+    if (threaded) StartSimulation(sim);
+
+    for (int i = 0; i < inputCount; i++)
+    {
+        while (!PushSimInput(sim, inputs[i]))
+        {
+            if (threaded) nanosleep(&wait, NULL);
+            else StepSimulation(sim);
+        }
+
+        if ((i + 1)%batch == 0)
+        {
+            if (threaded) nanosleep(&wait, NULL);
+            else StepSimulation(sim);
+        }
+    }
+
+    // Wait until every step covered by the stream has run
+    int ticks = (int)(inputs[inputCount - 1].time/dt);
+    while (__atomic_load_n(&state->tickCount, __ATOMIC_ACQUIRE) < ticks)
+    {
+        if (threaded) nanosleep(&wait, NULL);
+        else StepSimulation(sim);
+    }
+
+    StopSimulation(sim);
+    *last = *GetSimSnapshot(sim);
+    UnloadSimulation(sim);
+}
+
+// Benchmark simulation determinism, the same input stream is fed twice and the snapshots are compared
+// NOTE: Runs headless, first stepped every 7 inputs, then on the simulation thread fed 3 inputs at a time.
+// Returns 1 if any tick snapshot, the tick count or the last snapshot differ
+int BenchmarkSimulation(double duration, float dt)
+{
+    static SimInput inputs[8192];
+    static SimBenchmarkState states[2];
+    SimSnapshot last[2];
+
+    int inputCount = GenSimBenchmarkInputs(inputs, 8192, duration);
+
+    // Final input past the stream flushes its last step
+    inputs[inputCount] = inputs[inputCount - 1];
+    inputs[inputCount].time += dt;
+    inputs[inputCount].pressed = 0;
+    inputCount++;
+
+    double start = GetTimerSeconds();
+    RunSimBenchmark(&states[0], inputs, inputCount, dt, 7, false, &last[0]);
+    double headlessTime = GetTimerSeconds() - start;
+
+    start = GetTimerSeconds();
+    RunSimBenchmark(&states[1], inputs, inputCount, dt, 3, true, &last[1]);
+    double threadTime = GetTimerSeconds() - start;
+
+    int ticks = states[0].tickCount;
+    int differences = 0;
+    for (int t = 0; (t < ticks) && (t < 4096); t++) if (states[0].checksums[t] != states[1].checksums[t]) differences++;
+
+    bool same = (ticks > 0) && (states[1].tickCount == ticks) && (differences == 0) && (last[0].tick == last[1].tick) &&
+        (GetSimSnapshotChecksum(&last[0]) == GetSimSnapshotChecksum(&last[1]));
+
+    TRACELOG(same? LOG_INFO : LOG_WARNING, "SIMULATION: %i inputs, %i/%i ticks, %i differing snapshots, last tick %u/%u, headless %.2f ms, thread %.2f ms",
+        inputCount, ticks, states[1].tickCount, differences, last[0].tick, last[1].tick, headlessTime*1000.0, threadTime*1000.0);
+
+    return same? 0 : 1;
+}
@@ -0,0 +1,402 @@
+#include "raylib.h"         // Declares module functions
+#include "raymath.h"        // Required for: Vector3 functionality, MatrixTranslate()
+
+#include <stdlib.h>         // Required for: malloc(), free()
+#include <stdio.h>          // Required for: snprintf()
+#include <math.h>           // Required for: floorf()
+#include <pthread.h>        // Required for: pthread_create(), pthread_join(), pthread_mutex_t, pthread_cond_t
+
+// World streaming: cubicmap regions around the camera are generated on a worker thread and uploaded
+// as compact meshes, least recently used regions are evicted when over the GPU memory budget
+// NOTE: Region states, request queue and active list are shared with the worker, always accessed with mutex locked
+
+#define STREAM_QUEUE_SIZE           256         // Max pending region requests
+#define STREAM_MAX_ACTIVE           1024        // Max regions generated or resident at the same time
+#define STREAM_READY_TIMEOUT        60          // Frames a generated region waits out of range before its geometry is dropped
+
+typedef enum {
+    STREAM_REGION_UNLOADED = 0,
+    STREAM_REGION_QUEUED,       // Waiting in request queue
+    STREAM_REGION_LOADING,      // Worker is generating geometry
+    STREAM_REGION_READY,        // CPU geometry generated, waiting for upload
+    STREAM_REGION_RESIDENT      // Uploaded to GPU
+} StreamRegionState;
+
+typedef struct StreamRegion {
+    int state;
+    Mesh mesh;                  // CPU geometry, valid while READY
+    CompactMesh gpu;            // GPU geometry, valid while RESIDENT
+    BoundingBox bounds;         // Mesh space bounds
+    unsigned int lastUsed;      // Last frame the region was in load range
+} StreamRegion;
+
+typedef struct WorldStreamStats {
+    int resident;               // Regions on GPU
+    int pending;                // Regions queued or being generated
+    int ready;                  // Regions generated, waiting for upload
+    long long gpuBytes;         // GPU memory used by resident regions
+    int uploads;                // Regions uploaded last update
+    int loads;                  // Regions generated since load
+    int evictions;              // Regions evicted since load
+} WorldStreamStats;
+
+typedef struct WorldStream {
+    const CubicmapGrid *grid;   // Source cells, must outlive the stream
+    Vector3 position;           // World position of mesh space origin
+    int regionSize;             // Region size in cells
+    int regionsX;
+    int regionsZ;
+    StreamRegion *regions;
+
+    // Tuning, can be changed any time
+    int loadRadius;             // Load range around camera region, in regions
+    int prefetchRadius;         // Load range around predicted camera region, in regions
+    float prefetchTime;         // Camera velocity lookahead, in seconds
+    int uploadBudget;           // Max bytes uploaded per frame (one region is always allowed)
+    long long gpuBudget;        // Max GPU bytes before least recently used regions are evicted
+    bool bakeLighting;          // Bake vertex light of regions on the worker thread
+    CubicmapBakeSettings bake;
+    const char *bakeCache;      // Bake cache file prefix, regions are saved as <prefix>_<region>.bake (NULL bakes on every load)
+
+    int queue[STREAM_QUEUE_SIZE];   // Requests, closest region first
+    int queueCount;
+    int queueNext;                  // Next request taken by the worker
+    int active[STREAM_MAX_ACTIVE];  // Regions READY or RESIDENT
+    int activeCount;
+
+    Vector3 lastCamera;
+    bool hasLastCamera;
+    unsigned int frame;
+    WorldStreamStats stats;
+
+    pthread_t thread;
+    pthread_mutex_t mutex;
+    pthread_cond_t wake;
+    bool quit;
+} WorldStream;
+
+// Worker thread: generate geometry of requested regions
+static void *WorldStreamWorker(void *data)
+{
+    WorldStream *stream = (WorldStream *)data;
+
+    PushMemoryTag(MEMORY_TAG_STREAMING);     // Region meshes and bake data
+    pthread_mutex_lock(&stream->mutex);
+
+    while (!stream->quit)
+    {
+        if (stream->queueNext >= stream->queueCount)
+        {
+            pthread_cond_wait(&stream->wake, &stream->mutex);
+            continue;
+        }
+
+        int index = stream->queue[stream->queueNext++];
+        stream->regions[index].state = STREAM_REGION_LOADING;
+
+        pthread_mutex_unlock(&stream->mutex);
+
+        int size = stream->regionSize;
+        int x = (index%stream->regionsX)*size, z = (index/stream->regionsX)*size;
+        Mesh mesh = GenMeshCubicmapGridRegion(stream->grid, x, z, size, size);
+
+        // NOTE: Settings are read without lock, set them before the first update
+        if (stream->bakeLighting)
+        {
+            CubicmapBakeSettings bake = stream->bake;
+            bake.threads = 1;
+
+            // Regions reloaded after eviction read their bake back from the cache
+            if (stream->bakeCache != NULL)
+            {
+                char fileName[256] = { 0 };
+                snprintf(fileName, sizeof(fileName), "%s_%i.bake", stream->bakeCache, index);
+                LoadOrBakeCubicmapLighting(fileName, stream->grid, &mesh, bake, GetCubicmapBakeRegionKey(stream->grid, bake, x, z, size, size));
+            }
+            else BakeCubicmapLighting(stream->grid, &mesh, bake);
+        }
+
+        pthread_mutex_lock(&stream->mutex);
+
+        stream->regions[index].mesh = mesh;
+        stream->regions[index].state = STREAM_REGION_READY;
+        stream->active[stream->activeCount++] = index;
+        stream->stats.loads++;
+    }
+
+    pthread_mutex_unlock(&stream->mutex);
+
+    return NULL;
+}
+
+// Load world stream for a cubicmap grid and start its worker thread
+// NOTE: Stream is heap allocated, worker thread keeps a pointer to it
+WorldStream *LoadWorldStream(const CubicmapGrid *grid, Vector3 position, int regionSize)
+{
+    WorldStream *stream = (WorldStream *)RL_CALLOC(1, sizeof(WorldStream));
+
+    stream->grid = grid;
+    stream->position = position;
+    stream->regionSize = (regionSize > 0)? regionSize : 32;
+    stream->regionsX = (grid->width + stream->regionSize - 1)/stream->regionSize;
+    stream->regionsZ = (grid->height + stream->regionSize - 1)/stream->regionSize;
+    stream->regions = (StreamRegion *)RL_CALLOC((size_t)stream->regionsX*stream->regionsZ, sizeof(StreamRegion));
+
+    stream->loadRadius = 2;
+    stream->prefetchRadius = 1;
+    stream->prefetchTime = 1.0f;
+    stream->uploadBudget = 256*1024;
+    stream->gpuBudget = 32*1024*1024;
+    stream->bakeLighting = true;
+    stream->bake = GetCubicmapBakeDefaults();
+
+    Vector3 cube = grid->cubeSize;
+    for (int z = 0; z < stream->regionsZ; z++)
+    {
+        for (int x = 0; x < stream->regionsX; x++)
+        {
+            StreamRegion *region = &stream->regions[z*stream->regionsX + x];
+
+            region->bounds.min = (Vector3){ cube.x*((float)(x*stream->regionSize) - 0.5f), 0.0f, cube.z*((float)(z*stream->regionSize) - 0.5f) };
+            region->bounds.max = (Vector3){ cube.x*((float)((x + 1)*stream->regionSize) - 0.5f), cube.y, cube.z*((float)((z + 1)*stream->regionSize) - 0.5f) };
+        }
+    }
+
+    pthread_mutex_init(&stream->mutex, NULL);
+    pthread_cond_init(&stream->wake, NULL);
+    pthread_create(&stream->thread, NULL, WorldStreamWorker, stream);
+
+    TRACELOG(LOG_INFO, "STREAM: World stream loaded [%i x %i] regions of %i cells", stream->regionsX, stream->regionsZ, stream->regionSize);
+
+    return stream;
+}
+
+// Unload region CPU/GPU geometry
+static void UnloadStreamRegion(WorldStream *stream, StreamRegion *region)
+{
+    if (region->state == STREAM_REGION_READY)
+    {
+        RL_FREE(region->mesh.vertices);
+        RL_FREE(region->mesh.normals);
+        RL_FREE(region->mesh.texcoords);
+        RL_FREE(region->mesh.colors);
+    }
+    else if (region->state == STREAM_REGION_RESIDENT)
+    {
+        if (region->gpu.vaoId > 0) UnloadCompactMesh(region->gpu);
+        stream->stats.gpuBytes -= (long long)region->gpu.vertexCount*sizeof(CompactMapVertex);
+    }
+
+    region->mesh = (Mesh){ 0 };
+    region->gpu = (CompactMesh){ 0 };
+    region->state = STREAM_REGION_UNLOADED;
+}
+
+// Stop worker thread and unload all regions
+void UnloadWorldStream(WorldStream *stream)
+{
+    pthread_mutex_lock(&stream->mutex);
+    stream->quit = true;
+    pthread_cond_signal(&stream->wake);
+    pthread_mutex_unlock(&stream->mutex);
+
+    pthread_join(stream->thread, NULL);
+
+    for (int i = 0; i < stream->activeCount; i++) UnloadStreamRegion(stream, &stream->regions[stream->active[i]]);
+
+    pthread_cond_destroy(&stream->wake);
+    pthread_mutex_destroy(&stream->mutex);
+
+    RL_FREE(stream->regions);
+    RL_FREE(stream);
+}
+
+// Request regions in square rings around a region, closest ring first
+static void RequestStreamRings(WorldStream *stream, int centerX, int centerZ, int radius)
+{
+    for (int d = 0; d <= radius; d++)
+    {
+        for (int dz = -d; dz <= d; dz++)
+        {
+            for (int dx = -d; dx <= d; dx++)
+            {
+                if ((abs(dx) != d) && (abs(dz) != d)) continue;
+
+                int x = centerX + dx;
+                int z = centerZ + dz;
+
+                if ((x < 0) || (z < 0) || (x >= stream->regionsX) || (z >= stream->regionsZ)) continue;
+
+                StreamRegion *region = &stream->regions[z*stream->regionsX + x];
+                region->lastUsed = stream->frame;
+
+                // Keep one slot for the region being generated
+                if ((region->state == STREAM_REGION_UNLOADED) && (stream->queueCount < STREAM_QUEUE_SIZE) &&
+                    (stream->activeCount + stream->queueCount + 1 < STREAM_MAX_ACTIVE))
+                {
+                    region->state = STREAM_REGION_QUEUED;
+                    stream->queue[stream->queueCount++] = z*stream->regionsX + x;
+                }
+            }
+        }
+    }
+}
+
+// Upload region geometry as a compact mesh, CPU geometry is freed
+static void UploadStreamRegion(WorldStream *stream, StreamRegion *region)
+{
+    Mesh mesh = region->mesh;
+
+    region->gpu = (CompactMesh){ 0 };
+
+    if (mesh.vertexCount > 0)
+    {
+        Vector3 unit = GetCompactMeshUnit(stream->grid->cubeSize);
+        // Staging data only lives until upload, frame memory keeps uploads off the heap
+        CompactMapVertex *vertices = (CompactMapVertex *)FrameAlloc((size_t)mesh.vertexCount*sizeof(CompactMapVertex));
+
+        EncodeCompactVertices(&mesh, 0, mesh.vertexCount, region->bounds.min, unit, vertices);
+        region->gpu = LoadCompactMesh(vertices, mesh.vertexCount, region->bounds.min, unit);
+    }
+
+    RL_FREE(mesh.vertices);
+    RL_FREE(mesh.normals);
+    RL_FREE(mesh.texcoords);
+    RL_FREE(mesh.colors);
+
+    region->mesh = (Mesh){ 0 };
+    region->state = STREAM_REGION_RESIDENT;
+    stream->stats.gpuBytes += (long long)region->gpu.vertexCount*sizeof(CompactMapVertex);
+}
+
+// Update streaming: request regions around camera, upload generated regions and evict over budget
+void UpdateWorldStream(WorldStream *stream, Camera camera, float deltaTime)
+{
+    // Camera velocity from last update, used to prefetch regions ahead
+    Vector3 velocity = { 0 };
+    if (stream->hasLastCamera && (deltaTime > 0.0f)) velocity = Vector3Scale(Vector3Subtract(camera.position, stream->lastCamera), 1.0f/deltaTime);
+    stream->lastCamera = camera.position;
+    stream->hasLastCamera = true;
+
+    Vector3 local = Vector3Subtract(camera.position, stream->position);
+    Vector3 predicted = Vector3Add(local, Vector3Scale(velocity, stream->prefetchTime));
+
+    // Mesh space cell (x, z) covers [w*(x - 0.5), w*(x + 0.5)]
+    Vector3 cube = stream->grid->cubeSize;
+    int regionX = (int)floorf((local.x/cube.x + 0.5f)/stream->regionSize);
+    int regionZ = (int)floorf((local.z/cube.z + 0.5f)/stream->regionSize);
+    int prefetchX = (int)floorf((predicted.x/cube.x + 0.5f)/stream->regionSize);
+    int prefetchZ = (int)floorf((predicted.z/cube.z + 0.5f)/stream->regionSize);
+
+    pthread_mutex_lock(&stream->mutex);
+
+    stream->frame++;
+
+    // Requests not taken by the worker yet are dropped, queue is rebuilt in distance order every update
+    for (int i = stream->queueNext; i < stream->queueCount; i++)
+    {
+        StreamRegion *region = &stream->regions[stream->queue[i]];
+        if (region->state == STREAM_REGION_QUEUED) region->state = STREAM_REGION_UNLOADED;
+    }
+    stream->queueCount = 0;
+    stream->queueNext = 0;
+
+    RequestStreamRings(stream, regionX, regionZ, stream->loadRadius);
+    if ((prefetchX != regionX) || (prefetchZ != regionZ)) RequestStreamRings(stream, prefetchX, prefetchZ, stream->prefetchRadius);
+
+    if (stream->queueCount > 0) pthread_cond_signal(&stream->wake);
+
+    // Upload regions in range within budget, drop geometry of regions out of range for too long
+    int uploadedBytes = 0;
+    stream->stats.uploads = 0;
+
+    for (int i = 0; i < stream->activeCount; i++)
+    {
+        StreamRegion *region = &stream->regions[stream->active[i]];
+
+        if (region->state != STREAM_REGION_READY) continue;
+
+        if ((stream->frame - region->lastUsed) > STREAM_READY_TIMEOUT)
+        {
+            UnloadStreamRegion(stream, region);
+            stream->active[i--] = stream->active[--stream->activeCount];
+        }
+        else if ((region->lastUsed == stream->frame) && ((stream->stats.uploads == 0) || (uploadedBytes < stream->uploadBudget)))
+        {
+            uploadedBytes += region->mesh.vertexCount*(int)sizeof(CompactMapVertex);
+            UploadStreamRegion(stream, region);
+            stream->stats.uploads++;
+        }
+    }
+
+    // Evict least recently used regions over GPU budget, regions in range are never evicted
+    while (stream->stats.gpuBytes > stream->gpuBudget)
+    {
+        int lru = -1;
+
+        for (int i = 0; i < stream->activeCount; i++)
+        {
+            StreamRegion *region = &stream->regions[stream->active[i]];
+
+            if ((region->state != STREAM_REGION_RESIDENT) || (region->lastUsed == stream->frame)) continue;
+            if ((lru == -1) || (region->lastUsed < stream->regions[stream->active[lru]].lastUsed)) lru = i;
+        }
+
+        if (lru == -1) break;
+
+        UnloadStreamRegion(stream, &stream->regions[stream->active[lru]]);
+        stream->active[lru] = stream->active[--stream->activeCount];
+        stream->stats.evictions++;
+    }
+
+    // Refresh counters
+    stream->stats.resident = 0;
+    stream->stats.ready = 0;
+    for (int i = 0; i < stream->activeCount; i++)
+    {
+        int state = stream->regions[stream->active[i]].state;
+
+        if (state == STREAM_REGION_RESIDENT) stream->stats.resident++;
+        else if (state == STREAM_REGION_READY) stream->stats.ready++;
+    }
+    stream->stats.pending = stream->queueCount - stream->queueNext;
+    for (int i = 0; i < stream->queueNext; i++)
+    {
+        if (stream->regions[stream->queue[i]].state == STREAM_REGION_LOADING) stream->stats.pending++;
+    }
+
+    pthread_mutex_unlock(&stream->mutex);
+}
+
+// Submit visible resident regions to a render queue
+// NOTE: occlusion can be NULL, otherwise it must be updated for the same camera
+void SubmitWorldStream(WorldStream *stream, RenderQueue *queue, CompactMapShader shader, Texture2D texture, Camera camera, OcclusionCuller *occlusion)
+{
+    Frustum frustum = GetCameraFrustum(camera, (float)GetScreenWidth()/GetScreenHeight());
+    Matrix transform = MatrixTranslate(stream->position.x, stream->position.y, stream->position.z);
+
+    pthread_mutex_lock(&stream->mutex);
+
+    for (int i = 0; i < stream->activeCount; i++)
+    {
+        StreamRegion *region = &stream->regions[stream->active[i]];
+
+        if ((region->state != STREAM_REGION_RESIDENT) || (region->gpu.vertexCount == 0)) continue;
+
+        BoundingBox bounds = { Vector3Add(region->bounds.min, stream->position), Vector3Add(region->bounds.max, stream->position) };
+        Vector3 center = Vector3Scale(Vector3Add(bounds.min, bounds.max), 0.5f);
+        if (CheckFrustumBox(&frustum, bounds) && CheckOcclusionBox(occlusion, bounds)) SubmitRenderCompactMesh(queue, RENDER_PASS_OPAQUE, region->gpu, shader, texture, transform, center);
+    }
+
+    pthread_mutex_unlock(&stream->mutex);
+}
+
+// Get streaming counters
+WorldStreamStats GetWorldStreamStats(WorldStream *stream)
+{
+    pthread_mutex_lock(&stream->mutex);
+    WorldStreamStats stats = stream->stats;
+    pthread_mutex_unlock(&stream->mutex);
+
+    return stats;
+}
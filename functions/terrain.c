@@ -0,0 +1,577 @@
+#include "raylib.h"         // Declares module functions
+#include "rlgl.h"           // Required for: rlEnableShader(), rlDrawVertexArrayElements()
+#include "raymath.h"        // Required for: Vector3 functionality
+
+#include <stdlib.h>         // Required for: malloc(), free(), abs()
+#include <string.h>         // Required for: memset()
+#include <math.h>           // Required for: sqrtf(), sqrt(), floorf(), sinf(), cosf()
+
+#if defined(__SSE2__)
+    #include <emmintrin.h>  // Required for: SSE2 normals kernel
+#endif
+
+// Height-field terrain: 16-bit height grid rendered with a quadtree of patches (CDLOD)
+// NOTE: Every patch draws the same grid mesh, the vertex shader samples heights and morphs vertices
+// towards the next coarser grid with distance, so LOD is continuous and patch seams don't crack
+
+#define TERRAIN_GRID_SIZE           32      // Quads per patch side
+#define TERRAIN_MAX_LODS            12
+#define TERRAIN_MAX_NODES           4096    // Max selected patches per frame
+#define TERRAIN_LOD_RANGE_SCALE     2.5f    // Level 0 range, in level 0 patch sizes
+#define TERRAIN_MORPH_START         0.7f    // Fraction of a level range where morphing starts
+
+typedef struct TerrainNode {
+    int x;                  // Patch origin, in samples
+    int z;
+    int level;              // Patch covers (TERRAIN_GRID_SIZE << level) samples
+} TerrainNode;
+
+typedef struct Terrain {
+    int width;                                  // Samples on X
+    int height;                                 // Samples on Z
+    unsigned short *heights;                    // Height samples, 0..65535 maps to 0..size.y
+
+    Vector3 position;                           // World position of sample (0, 0) at height 0
+    Vector3 size;                               // World extent
+
+    int lodCount;
+    float lodRange[TERRAIN_MAX_LODS];           // Max camera distance of each level
+    unsigned short *minMax[TERRAIN_MAX_LODS];   // Min/max height of every patch, per level
+    int nodesX[TERRAIN_MAX_LODS];
+    int nodesZ[TERRAIN_MAX_LODS];
+
+    TerrainNode nodes[TERRAIN_MAX_NODES];       // Patches selected by last DrawTerrain()
+    int nodeCount;
+
+    Texture2D texture;                          // RGBA8: height high byte, height low byte, normal x, normal z
+    Mesh grid;                                  // Shared patch grid, [0..1] on X/Z
+    Shader shader;
+    int nodeLoc;
+    int morphLoc;
+    int terrainLoc;
+    int spacingLoc;
+    int cameraLoc;
+    int textureLoc;
+} Terrain;
+
+// Compute packed normal of one sample, x/z components mapped to 0..255, y is reconstructed in shader
+static void GenTerrainNormal(const unsigned short *row, const unsigned short *up, const unsigned short *down, int x, int w, float kx, float kz, unsigned char *out)
+{
+    int left = (x > 0)? x - 1 : x;
+    int right = (x < w - 1)? x + 1 : x;
+
+    // One sided difference on borders covers a single step
+    float nx = (row[right] - row[left])*-kx*((right - left == 2)? 1.0f : 2.0f);
+    float nz = (down[x] - up[x])*-kz;
+    float inv = 1.0f/sqrtf(nx*nx + 1.0f + nz*nz);
+
+    out[x*4 + 2] = (unsigned char)(int)(nx*inv*127.5f + 128.0f);
+    out[x*4 + 3] = (unsigned char)(int)(nz*inv*127.5f + 128.0f);
+}
+
+// Compute packed normals for rows [z0, z1) into RGBA8 pixels (bytes 2 and 3) with central differences
+// NOTE: Interior samples are processed 4 at a time with SSE2, borders and remainder use the scalar path
+static void GenTerrainNormals(const Terrain *terrain, unsigned char *pixels, int z0, int z1)
+{
+    int w = terrain->width;
+    int h = terrain->height;
+    float kx = terrain->size.y/65535.0f/(2.0f*terrain->size.x/(w - 1));
+    float kz = terrain->size.y/65535.0f/(2.0f*terrain->size.z/(h - 1));
+
+    for (int z = z0; z < z1; z++)
+    {
+        const unsigned short *row = &terrain->heights[z*w];
+        const unsigned short *up = &terrain->heights[((z > 0)? z - 1 : z)*w];
+        const unsigned short *down = &terrain->heights[((z < h - 1)? z + 1 : z)*w];
+        unsigned char *out = &pixels[z*w*4];
+        float rowKz = ((z > 0) && (z < h - 1))? kz : 2.0f*kz;
+        int x = 0;
+
+        GenTerrainNormal(row, up, down, x++, w, kx, rowKz, out);
+
+#if defined(__SSE2__)
+        const __m128i zero = _mm_setzero_si128();
+        const __m128 vkx = _mm_set1_ps(-kx);
+        const __m128 vkz = _mm_set1_ps(-rowKz);
+        const __m128 one = _mm_set1_ps(1.0f);
+        const __m128 scale = _mm_set1_ps(127.5f);
+        const __m128 bias = _mm_set1_ps(128.0f);
+
+        for (; x + 4 < w; x += 4)
+        {
+            __m128 left = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&row[x - 1]), zero));
+            __m128 right = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&row[x + 1]), zero));
+            __m128 top = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&up[x]), zero));
+            __m128 bottom = _mm_cvtepi32_ps(_mm_unpacklo_epi16(_mm_loadl_epi64((const __m128i *)&down[x]), zero));
+
+            __m128 nx = _mm_mul_ps(_mm_sub_ps(right, left), vkx);
+            __m128 nz = _mm_mul_ps(_mm_sub_ps(bottom, top), vkz);
+            __m128 inv = _mm_div_ps(one, _mm_sqrt_ps(_mm_add_ps(_mm_add_ps(_mm_mul_ps(nx, nx), one), _mm_mul_ps(nz, nz))));
+
+            int ix[4], iz[4];
+            _mm_storeu_si128((__m128i *)ix, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(nx, inv), scale), bias)));
+            _mm_storeu_si128((__m128i *)iz, _mm_cvttps_epi32(_mm_add_ps(_mm_mul_ps(_mm_mul_ps(nz, inv), scale), bias)));
+
+            for (int k = 0; k < 4; k++)
+            {
+                out[(x + k)*4 + 2] = (unsigned char)ix[k];
+                out[(x + k)*4 + 3] = (unsigned char)iz[k];
+            }
+        }
+#endif
+
+        for (; x < w; x++) GenTerrainNormal(row, up, down, x, w, kx, rowKz, out);
+    }
+}
+
+// Build min/max height pyramid of patches, level 0 from samples and every next level from 2x2 children
+static void GenTerrainMinMax(Terrain *terrain)
+{
+    for (int l = 0; l < terrain->lodCount; l++)
+    {
+        int nodeSize = TERRAIN_GRID_SIZE << l;
+        int nx = (terrain->width - 2)/nodeSize + 1;
+        int nz = (terrain->height - 2)/nodeSize + 1;
+
+        terrain->nodesX[l] = nx;
+        terrain->nodesZ[l] = nz;
+        terrain->minMax[l] = (unsigned short *)RL_MALLOC(nx*nz*2*sizeof(unsigned short));
+
+        for (int j = 0; j < nz; j++)
+        {
+            for (int i = 0; i < nx; i++)
+            {
+                unsigned short lo = 65535, hi = 0;
+
+                if (l == 0)
+                {
+                    int x1 = (i + 1)*nodeSize, z1 = (j + 1)*nodeSize;
+                    if (x1 > terrain->width - 1) x1 = terrain->width - 1;
+                    if (z1 > terrain->height - 1) z1 = terrain->height - 1;
+
+                    for (int z = j*nodeSize; z <= z1; z++)
+                    {
+                        for (int x = i*nodeSize; x <= x1; x++)
+                        {
+                            unsigned short v = terrain->heights[z*terrain->width + x];
+                            if (v < lo) lo = v;
+                            if (v > hi) hi = v;
+                        }
+                    }
+                }
+                else
+                {
+                    for (int c = 0; c < 4; c++)
+                    {
+                        int ci = i*2 + (c & 1), cj = j*2 + (c >> 1);
+                        if ((ci >= terrain->nodesX[l - 1]) || (cj >= terrain->nodesZ[l - 1])) continue;
+
+                        const unsigned short *child = &terrain->minMax[l - 1][(cj*terrain->nodesX[l - 1] + ci)*2];
+                        if (child[0] < lo) lo = child[0];
+                        if (child[1] > hi) hi = child[1];
+                    }
+                }
+
+                terrain->minMax[l][(j*nx + i)*2] = lo;
+                terrain->minMax[l][(j*nx + i)*2 + 1] = hi;
+            }
+        }
+    }
+}
+
+// Generate patch grid mesh, (TERRAIN_GRID_SIZE + 1)^2 vertices in [0..1] on X/Z
+static Mesh GenTerrainGrid(void)
+{
+    Mesh mesh = { 0 };
+    int n = TERRAIN_GRID_SIZE + 1;
+
+    mesh.vertexCount = n*n;
+    mesh.triangleCount = TERRAIN_GRID_SIZE*TERRAIN_GRID_SIZE*2;
+    mesh.vertices = (float *)RL_MALLOC(mesh.vertexCount*3*sizeof(float));
+    mesh.indices = (unsigned short *)RL_MALLOC(mesh.triangleCount*3*sizeof(unsigned short));
+
+    for (int z = 0; z < n; z++)
+    {
+        for (int x = 0; x < n; x++)
+        {
+            mesh.vertices[(z*n + x)*3] = (float)x/TERRAIN_GRID_SIZE;
+            mesh.vertices[(z*n + x)*3 + 1] = 0.0f;
+            mesh.vertices[(z*n + x)*3 + 2] = (float)z/TERRAIN_GRID_SIZE;
+        }
+    }
+
+    int k = 0;
+    for (int z = 0; z < TERRAIN_GRID_SIZE; z++)
+    {
+        for (int x = 0; x < TERRAIN_GRID_SIZE; x++)
+        {
+            unsigned short a = z*n + x, b = a + 1, c = a + n, d = c + 1;
+
+            mesh.indices[k++] = a; mesh.indices[k++] = c; mesh.indices[k++] = b;
+            mesh.indices[k++] = b; mesh.indices[k++] = c; mesh.indices[k++] = d;
+        }
+    }
+
+    UploadMesh(&mesh, false);
+
+    return mesh;
+}
+
+// Generate terrain heights, LOD ranges and min/max pyramid from a grayscale image (CPU only)
+// NOTE: Heightmaps need at least 2x2 samples, sample spacing is size/(samples - 1)
+static bool GenTerrainHeights(Terrain *terrain, Image image)
+{
+    if ((image.data == NULL) || (image.width < 2) || (image.height < 2)) return false;
+
+    terrain->width = image.width;
+    terrain->height = image.height;
+    terrain->heights = (unsigned short *)RL_MALLOC(terrain->width*terrain->height*sizeof(unsigned short));
+
+    // Expand 8-bit gray to full 16-bit range
+    const unsigned char *gray = (const unsigned char *)image.data;
+    for (int i = 0; i < terrain->width*terrain->height; i++) terrain->heights[i] = gray[i]*257;
+
+    // Levels until a single patch covers the whole map
+    terrain->lodCount = 1;
+    while ((terrain->lodCount < TERRAIN_MAX_LODS) && ((TERRAIN_GRID_SIZE << (terrain->lodCount - 1)) < ((terrain->width > terrain->height)? terrain->width : terrain->height) - 1)) terrain->lodCount++;
+
+    float patchSize = TERRAIN_GRID_SIZE*terrain->size.x/(terrain->width - 1);
+    for (int l = 0; l < terrain->lodCount; l++) terrain->lodRange[l] = patchSize*TERRAIN_LOD_RANGE_SCALE*(float)(1 << l);
+
+    GenTerrainMinMax(terrain);
+
+    return true;
+}
+
+// Generate height and normals texture pixels, heights are split in two bytes to keep 16-bit precision
+static unsigned char *GenTerrainPixels(const Terrain *terrain)
+{
+    unsigned char *pixels = (unsigned char *)RL_MALLOC(terrain->width*terrain->height*4);
+
+    for (int i = 0; i < terrain->width*terrain->height; i++)
+    {
+        pixels[i*4] = terrain->heights[i] >> 8;
+        pixels[i*4 + 1] = terrain->heights[i] & 0xff;
+    }
+
+    GenTerrainNormals(terrain, pixels, 0, terrain->height);
+
+    return pixels;
+}
+
+// Load terrain from a grayscale heightmap image
+// NOTE: On a failed or degenerate heightmap an empty terrain is returned, it is never drawn and reports base height
+Terrain LoadTerrain(const char *fileName, Vector3 position, Vector3 size)
+{
+    Terrain terrain = { 0 };
+
+    terrain.position = position;
+    terrain.size = size;
+
+    Image image = LoadImage(fileName);
+    ImageFormat(&image, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE);
+
+    bool loaded = GenTerrainHeights(&terrain, image);
+    UnloadImage(image);
+
+    if (!loaded)
+    {
+        TRACELOG(LOG_WARNING, "TERRAIN: [%s] Failed to load heightmap, needs at least 2x2 samples", fileName);
+        return terrain;
+    }
+
+    unsigned char *pixels = GenTerrainPixels(&terrain);
+
+    Image packed = { pixels, terrain.width, terrain.height, 1, PIXELFORMAT_UNCOMPRESSED_R8G8B8A8 };
+    terrain.texture = LoadTextureFromImage(packed);
+    SetTextureFilter(terrain.texture, TEXTURE_FILTER_BILINEAR);
+    RL_FREE(pixels);
+
+    terrain.grid = GenTerrainGrid();
+
+    terrain.shader = LoadShader("shaders/terrain.vs", "shaders/terrain.fs");
+    terrain.nodeLoc = GetShaderLocation(terrain.shader, "node");
+    terrain.morphLoc = GetShaderLocation(terrain.shader, "morph");
+    terrain.terrainLoc = GetShaderLocation(terrain.shader, "terrain");
+    terrain.spacingLoc = GetShaderLocation(terrain.shader, "spacing");
+    terrain.cameraLoc = GetShaderLocation(terrain.shader, "cameraPosition");
+    terrain.textureLoc = GetShaderLocation(terrain.shader, "terrainMap");
+
+    TRACELOG(LOG_INFO, "TERRAIN: Loaded %ix%i heightmap, %i LOD levels", terrain.width, terrain.height, terrain.lodCount);
+
+    return terrain;
+}
+
+// Unload terrain data from RAM and GPU
+void UnloadTerrain(Terrain *terrain)
+{
+    if (terrain->heights == NULL) return;
+
+    RL_FREE(terrain->heights);
+    for (int l = 0; l < terrain->lodCount; l++) RL_FREE(terrain->minMax[l]);
+
+    UnloadTexture(terrain->texture);
+    UnloadMesh(terrain->grid);
+    UnloadShader(terrain->shader);
+
+    memset(terrain, 0, sizeof(Terrain));
+}
+
+// Check if world position is above or below the terrain area
+bool IsPointOnTerrain(const Terrain *terrain, float x, float z)
+{
+    return ((x >= terrain->position.x) && (z >= terrain->position.z) &&
+            (x <= terrain->position.x + terrain->size.x) && (z <= terrain->position.z + terrain->size.z));
+}
+
+// Get terrain ground height at world position (bilinear), returns terrain base height outside of it
+float GetTerrainHeight(const Terrain *terrain, float x, float z)
+{
+    if (terrain->heights == NULL) return terrain->position.y;
+
+    float fx = (x - terrain->position.x)/terrain->size.x*(terrain->width - 1);
+    float fz = (z - terrain->position.z)/terrain->size.z*(terrain->height - 1);
+
+    if ((fx < 0.0f) || (fz < 0.0f) || (fx > terrain->width - 1) || (fz > terrain->height - 1)) return terrain->position.y;
+
+    int x0 = (int)fx, z0 = (int)fz;
+    int x1 = (x0 < terrain->width - 1)? x0 + 1 : x0;
+    int z1 = (z0 < terrain->height - 1)? z0 + 1 : z0;
+    float tx = fx - x0, tz = fz - z0;
+
+    const unsigned short *h = terrain->heights;
+    int w = terrain->width;
+    float top = h[z0*w + x0] + (h[z0*w + x1] - h[z0*w + x0])*tx;
+    float bottom = h[z1*w + x0] + (h[z1*w + x1] - h[z1*w + x0])*tx;
+
+    return terrain->position.y + (top + (bottom - top)*tz)*terrain->size.y/65535.0f;
+}
+
+// Get world bounds of a patch
+static BoundingBox GetTerrainNodeBounds(const Terrain *terrain, int x, int z, int level)
+{
+    int nodeSize = TERRAIN_GRID_SIZE << level;
+    const unsigned short *minMax = &terrain->minMax[level][((z/nodeSize)*terrain->nodesX[level] + x/nodeSize)*2];
+    float spacingX = terrain->size.x/(terrain->width - 1);
+    float spacingZ = terrain->size.z/(terrain->height - 1);
+    float x1 = fminf((float)(x + nodeSize), (float)(terrain->width - 1));
+    float z1 = fminf((float)(z + nodeSize), (float)(terrain->height - 1));
+
+    BoundingBox box = {
+        { terrain->position.x + x*spacingX, terrain->position.y + minMax[0]*terrain->size.y/65535.0f, terrain->position.z + z*spacingZ },
+        { terrain->position.x + x1*spacingX, terrain->position.y + minMax[1]*terrain->size.y/65535.0f, terrain->position.z + z1*spacingZ }
+    };
+
+    return box;
+}
+
+// Check if a sphere intersects a bounding box
+static bool CheckTerrainRange(BoundingBox box, Vector3 center, float radius)
+{
+    float dx = fmaxf(fmaxf(box.min.x - center.x, 0.0f), center.x - box.max.x);
+    float dy = fmaxf(fmaxf(box.min.y - center.y, 0.0f), center.y - box.max.y);
+    float dz = fmaxf(fmaxf(box.min.z - center.z, 0.0f), center.z - box.max.z);
+
+    return (dx*dx + dy*dy + dz*dz) <= radius*radius;
+}
+
+// Select patches recursively, a patch is split while its children are inside the next finer range
+static void SelectTerrainNode(Terrain *terrain, const Frustum *frustum, Vector3 camera, int x, int z, int level)
+{
+    if ((x >= terrain->width - 1) || (z >= terrain->height - 1)) return;
+
+    BoundingBox box = GetTerrainNodeBounds(terrain, x, z, level);
+
+    if (!CheckFrustumBox(frustum, box)) return;
+
+    if ((level == 0) || !CheckTerrainRange(box, camera, terrain->lodRange[level - 1]))
+    {
+        if (terrain->nodeCount < TERRAIN_MAX_NODES) terrain->nodes[terrain->nodeCount++] = (TerrainNode){ x, z, level };
+        return;
+    }
+
+    int half = TERRAIN_GRID_SIZE << (level - 1);
+
+    SelectTerrainNode(terrain, frustum, camera, x, z, level - 1);
+    SelectTerrainNode(terrain, frustum, camera, x + half, z, level - 1);
+    SelectTerrainNode(terrain, frustum, camera, x, z + half, level - 1);
+    SelectTerrainNode(terrain, frustum, camera, x + half, z + half, level - 1);
+}
+
+// Select visible patches for a camera, returns number of patches
+int SelectTerrainNodes(Terrain *terrain, Camera camera, float aspect)
+{
+    terrain->nodeCount = 0;
+    if (terrain->heights == NULL) return 0;
+
+    Frustum frustum = GetCameraFrustum(camera, aspect);
+    int top = terrain->lodCount - 1;
+    int topSize = TERRAIN_GRID_SIZE << top;
+
+    for (int z = 0; z < terrain->height - 1; z += topSize)
+    {
+        for (int x = 0; x < terrain->width - 1; x += topSize) SelectTerrainNode(terrain, &frustum, camera.position, x, z, top);
+    }
+
+    return terrain->nodeCount;
+}
+
+// Draw terrain (must be called inside BeginMode3D)
+void DrawTerrain(Terrain *terrain, Camera camera, Color tint)
+{
+    if (SelectTerrainNodes(terrain, camera, (float)GetScreenWidth()/GetScreenHeight()) == 0) return;
+
+    rlDrawRenderBatchActive();
+
+    Matrix matModelViewProjection = MatrixMultiply(rlGetMatrixModelview(), rlGetMatrixProjection());
+    float color[4] = { tint.r/255.0f, tint.g/255.0f, tint.b/255.0f, tint.a/255.0f };
+    float terrainInfo[4] = { terrain->position.x, terrain->position.y, terrain->position.z, terrain->size.y };
+    float spacing[4] = { terrain->size.x/(terrain->width - 1), terrain->size.z/(terrain->height - 1), (float)(terrain->width - 1), (float)(terrain->height - 1) };
+    int textureSlot = 0;
+
+    rlEnableShader(terrain->shader.id);
+    rlSetUniformMatrix(terrain->shader.locs[SHADER_LOC_MATRIX_MVP], matModelViewProjection);
+    rlSetUniform(terrain->shader.locs[SHADER_LOC_COLOR_DIFFUSE], color, SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(terrain->terrainLoc, terrainInfo, SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(terrain->spacingLoc, spacing, SHADER_UNIFORM_VEC4, 1);
+    rlSetUniform(terrain->cameraLoc, &camera.position, SHADER_UNIFORM_VEC3, 1);
+    rlSetUniform(terrain->textureLoc, &textureSlot, SHADER_UNIFORM_INT, 1);
+
+    rlActiveTextureSlot(0);
+    rlEnableTexture(terrain->texture.id);
+    rlEnableVertexArray(terrain->grid.vaoId);
+
+    for (int i = 0; i < terrain->nodeCount; i++)
+    {
+        TerrainNode node = terrain->nodes[i];
+        float range = terrain->lodRange[node.level];
+        float previous = (node.level > 0)? terrain->lodRange[node.level - 1] : 0.0f;
+        float morphStart = previous + (range - previous)*TERRAIN_MORPH_START;
+        float nodeInfo[3] = { (float)node.x, (float)node.z, (float)(TERRAIN_GRID_SIZE << node.level) };
+        float morph[3] = { morphStart, 1.0f/(range - morphStart), (float)TERRAIN_GRID_SIZE };
+
+        rlSetUniform(terrain->nodeLoc, nodeInfo, SHADER_UNIFORM_VEC3, 1);
+        rlSetUniform(terrain->morphLoc, morph, SHADER_UNIFORM_VEC3, 1);
+        rlDrawVertexArrayElements(0, terrain->grid.triangleCount*3, 0);
+    }
+
+    rlDisableVertexArray();
+    rlDisableTexture();
+    rlDisableShader();
+}
+
+// Benchmark terrain generation, checks heights and packed normals of a generated heightmap against the source
+// NOTE: Runs headless, normals are compared with world space central differences (one sided on borders),
+// returns the number of failed checks including a failed heightmap load that must give an empty terrain
+int BenchmarkTerrain(int size)
+{
+    int failures = 0;
+    Terrain terrain = { 0 };
+    terrain.position = (Vector3){ -10.0f, 2.0f, 5.0f };
+    terrain.size = (Vector3){ 100.0f, 8.0f, 60.0f };
+
+    // Half exact ramp on X (gray steps 1 every 2 samples), half smooth bumps
+    Image image = { RL_MALLOC(size*size), size, size, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE };
+    unsigned char *gray = (unsigned char *)image.data;
+
+    for (int z = 0; z < size; z++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            if (z < size/2) gray[z*size + x] = (unsigned char)((x/2)%256);
+            else gray[z*size + x] = (unsigned char)(127.5f + 127.0f*sinf(x*0.05f)*cosf(z*0.07f));
+        }
+    }
+
+    if (!GenTerrainHeights(&terrain, image))
+    {
+        RL_FREE(image.data);
+        TRACELOG(LOG_WARNING, "TERRAIN: Benchmark heightmap rejected");
+        return 1;
+    }
+
+    double start = GetTimerSeconds();
+    unsigned char *pixels = GenTerrainPixels(&terrain);
+    double time = GetTimerSeconds() - start;
+
+    // Heights: 16-bit expansion, packed bytes, bilinear lookups and the min/max pyramid top
+    int heightErrors = 0;
+    int lo = 255, hi = 0;
+    float spacingX = terrain.size.x/(size - 1), spacingZ = terrain.size.z/(size - 1);
+
+    for (int z = 0; z < size; z++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            int i = z*size + x;
+
+            if ((terrain.heights[i] != gray[i]*257) || (((pixels[i*4] << 8) | pixels[i*4 + 1]) != terrain.heights[i])) heightErrors++;
+            if (gray[i] < lo) lo = gray[i];
+            if (gray[i] > hi) hi = gray[i];
+
+            if ((x < size - 1) && (z < size - 1))
+            {
+                float center = (gray[i] + gray[i + 1] + gray[i + size] + gray[i + size + 1])/4.0f/255.0f*terrain.size.y + terrain.position.y;
+                float height = GetTerrainHeight(&terrain, terrain.position.x + (x + 0.5f)*spacingX, terrain.position.z + (z + 0.5f)*spacingZ);
+
+                if (fabsf(height - center) > 1e-4f*terrain.size.y) heightErrors++;
+            }
+        }
+    }
+
+    const unsigned short *top = terrain.minMax[terrain.lodCount - 1];
+    if ((terrain.nodesX[terrain.lodCount - 1] != 1) || (terrain.nodesZ[terrain.lodCount - 1] != 1) || (top[0] != lo*257) || (top[1] != hi*257)) heightErrors++;
+
+    if (heightErrors > 0) failures++;
+
+    // Normals: decode x/z, compare with slopes of the source samples in world units
+    int normalErrors = 0;
+    int maxError = 0;
+    double unit = terrain.size.y/255.0;
+
+    for (int z = 0; z < size; z++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            int left = (x > 0)? x - 1 : x, right = (x < size - 1)? x + 1 : x;
+            int up = (z > 0)? z - 1 : z, down = (z < size - 1)? z + 1 : z;
+            double dx = (gray[z*size + right] - gray[z*size + left])*unit/((right - left)*spacingX);
+            double dz = (gray[down*size + x] - gray[up*size + x])*unit/((down - up)*spacingZ);
+            double length = sqrt(dx*dx + 1.0 + dz*dz);
+
+            int expectedX = (int)(-dx/length*127.5 + 128.0);
+            int expectedZ = (int)(-dz/length*127.5 + 128.0);
+            int errorX = abs(pixels[(z*size + x)*4 + 2] - expectedX);
+            int errorZ = abs(pixels[(z*size + x)*4 + 3] - expectedZ);
+            int error = (errorX > errorZ)? errorX : errorZ;
+
+            if (error > maxError) maxError = error;
+            if (error > 1) normalErrors++;
+        }
+    }
+
+    // Ramp rises on +X (away from its wrap at 512 samples), its normals must lean to -X and have no Z component
+    const unsigned char *ramp = &pixels[((size/4)*size + 100)*4];
+    if ((ramp[2] >= 128) || (ramp[3] != 128)) normalErrors++;
+
+    if (normalErrors > 0) failures++;
+
+    TRACELOG(((heightErrors + normalErrors) == 0)? LOG_INFO : LOG_WARNING, "TERRAIN: %ix%i heightmap, %i height errors, %i normal errors (max %i units), normals %.2f ms",
+        size, size, heightErrors, normalErrors, maxError, time*1000.0);
+
+    RL_FREE(pixels);
+    RL_FREE(image.data);
+    UnloadTerrain(&terrain);
+
+    // Failed and degenerate heightmaps give an empty terrain that is safe to query
+    Terrain empty = LoadTerrain("textures/missing_heightmap.png", (Vector3){ 1.0f, 3.0f, 1.0f }, (Vector3){ 10.0f, 1.0f, 10.0f });
+    Image line = { gray, 1, 1, 1, PIXELFORMAT_UNCOMPRESSED_GRAYSCALE };
+    Camera camera = { { 5.0f, 5.0f, 5.0f }, { 6.0f, 5.0f, 6.0f }, { 0.0f, 1.0f, 0.0f }, 60.0f, CAMERA_PERSPECTIVE };
+
+    if ((empty.heights != NULL) || (GetTerrainHeight(&empty, 5.0f, 5.0f) != 3.0f) || (SelectTerrainNodes(&empty, camera, 1.0f) != 0) ||
+        GenTerrainHeights(&empty, line)) failures++;
+
+    UnloadTerrain(&empty);
+
+    return failures;
+}
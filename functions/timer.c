@@ -0,0 +1,29 @@
+// High resolution timer for headless benchmarks
+// NOTE: GetTime() needs an initialized window, this one works before InitWindow()
+
+#if defined(_WIN32)
+    // Declared here to avoid windows.h, it conflicts with raylib symbols
+    __declspec(dllimport) int __stdcall QueryPerformanceCounter(long long *lpPerformanceCount);
+    __declspec(dllimport) int __stdcall QueryPerformanceFrequency(long long *lpFrequency);
+#else
+    #include <time.h>       // Required for: clock_gettime()
+#endif
+
+// Get monotonic time in seconds
+double GetTimerSeconds(void)
+{
+#if defined(_WIN32)
+    static long long frequency = 0;
+    long long counter = 0;
+
+    if (frequency == 0) QueryPerformanceFrequency(&frequency);
+    QueryPerformanceCounter(&counter);
+
+    return (double)counter/(double)frequency;
+#else
+    struct timespec ts = { 0 };
+    clock_gettime(CLOCK_MONOTONIC, &ts);
+
+    return (double)ts.tv_sec + (double)ts.tv_nsec*1e-9;
+#endif
+}
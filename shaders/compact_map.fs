@@ -0,0 +1,53 @@
+#version 330
+
+in vec2 fragTexCoord;
+in vec3 fragNormal;
+in float fragLight;
+in vec3 fragPosition;
+in vec4 fragClip;
+
+uniform sampler2D texture0;
+uniform vec4 colDiffuse;
+
+// Clustered point lights (see functions/lightclusters.c), unbound lights leave clusterGrid at zero
+uniform vec3 clusterGrid;           // Tiles X, tiles Y, depth slices
+uniform vec2 clusterDepth;          // First slice boundary, slices/log(far/near)
+uniform sampler2D lightData;        // Row 0: position + radius, row 1: color + intensity
+uniform sampler2D clusterData;      // Index list offset + count
+uniform sampler2D lightIndices;
+
+const int LIGHT_INDEX_TEXTURE_WIDTH = 1024;
+
+out vec4 finalColor;
+
+void main()
+{
+    vec3 light = vec3(fragLight);
+
+    // Fragment cluster: screen tile from NDC, exponential slice from view depth (clip w)
+    vec2 tile = clamp(floor((fragClip.xy/fragClip.w*0.5 + 0.5)*clusterGrid.xy), vec2(0.0), clusterGrid.xy - 1.0);
+    float slice = max(floor(log(fragClip.w/clusterDepth.x)*clusterDepth.y), 0.0);
+
+    if (slice < clusterGrid.z)
+    {
+        vec2 cluster = texelFetch(clusterData, ivec2(int(tile.x + tile.y*clusterGrid.x), int(slice)), 0).xy;
+        int offset = int(cluster.x);
+        int count = int(cluster.y);
+
+        for (int i = 0; i < count; i++)
+        {
+            int index = offset + i;
+            int l = int(texelFetch(lightIndices, ivec2(index%LIGHT_INDEX_TEXTURE_WIDTH, index/LIGHT_INDEX_TEXTURE_WIDTH), 0).r);
+            vec4 positionRadius = texelFetch(lightData, ivec2(l, 0), 0);
+            vec4 colorIntensity = texelFetch(lightData, ivec2(l, 1), 0);
+
+            vec3 toLight = positionRadius.xyz - fragPosition;
+            float distance = length(toLight);
+            float falloff = clamp(1.0 - distance/positionRadius.w, 0.0, 1.0);
+
+            light += colorIntensity.rgb*colorIntensity.a*falloff*falloff*max(dot(fragNormal, toLight/max(distance, 0.0001)), 0.0);
+        }
+    }
+
+    finalColor = texture(texture0, fragTexCoord)*colDiffuse*vec4(light, 1.0);
+}
@@ -0,0 +1,37 @@
+#version 330
+
+// Compact map vertex: int16 position, face index, unorm8 baked light, unorm16 texcoord (see functions/compactmesh.c)
+in vec3 vertexPosition;
+in float vertexNormal;
+in float vertexColor;
+in vec2 vertexTexCoord;
+
+uniform mat4 mvp;
+uniform mat4 matModel;
+uniform vec3 regionOrigin;
+uniform vec3 positionUnit;
+
+out vec2 fragTexCoord;
+out vec3 fragNormal;
+out float fragLight;
+out vec3 fragPosition;
+out vec4 fragClip;
+
+const vec3 faceNormals[6] = vec3[6](
+    vec3(1.0, 0.0, 0.0), vec3(-1.0, 0.0, 0.0),
+    vec3(0.0, 1.0, 0.0), vec3(0.0, -1.0, 0.0),
+    vec3(0.0, 0.0, -1.0), vec3(0.0, 0.0, 1.0)
+);
+
+void main()
+{
+    vec3 position = regionOrigin + vertexPosition*positionUnit;
+
+    fragTexCoord = vertexTexCoord;
+    fragNormal = faceNormals[int(vertexNormal)];
+    fragLight = vertexColor;
+    fragPosition = vec3(matModel*vec4(position, 1.0));
+
+    gl_Position = mvp*vec4(position, 1.0);
+    fragClip = gl_Position;
+}
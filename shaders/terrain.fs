@@ -0,0 +1,21 @@
+#version 330
+
+in vec2 fragTexCoord;
+
+uniform sampler2D terrainMap;
+uniform vec4 colDiffuse;
+
+out vec4 finalColor;
+
+const vec3 lightDirection = vec3(0.37, 0.86, 0.35);
+
+void main()
+{
+    vec2 packed = texture(terrainMap, fragTexCoord).ba;
+    vec2 nxz = (packed*255.0 - 128.0)/127.5;
+    vec3 normal = vec3(nxz.x, sqrt(max(1.0 - dot(nxz, nxz), 0.0)), nxz.y);
+
+    float diffuse = 0.25 + 0.75*max(dot(normal, lightDirection), 0.0);
+
+    finalColor = vec4(colDiffuse.rgb*diffuse, colDiffuse.a);
+}
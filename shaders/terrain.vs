@@ -0,0 +1,55 @@
+#version 330
+
+// Terrain patch grid vertex, [0..1] on X/Z (see functions/terrain.c)
+in vec3 vertexPosition;
+
+uniform mat4 mvp;
+uniform vec3 node;              // Patch origin x, z and size, in samples
+uniform vec3 morph;             // Morph start distance, 1/(end - start), grid size
+uniform vec4 terrain;           // World origin, height scale
+uniform vec4 spacing;           // Sample spacing x, z, last sample x, z
+uniform vec3 cameraPosition;
+uniform sampler2D terrainMap;   // Height high byte, height low byte, normal x, normal z
+
+out vec2 fragTexCoord;
+
+float DecodeHeight(ivec2 p)
+{
+    vec4 t = texelFetch(terrainMap, clamp(p, ivec2(0), ivec2(spacing.zw)), 0);
+
+    return (t.r*65280.0 + t.g*255.0)/65535.0;
+}
+
+// Bilinear height, hardware filtering would mix the split bytes
+float SampleHeight(vec2 s)
+{
+    vec2 i = floor(s);
+    vec2 f = s - i;
+    ivec2 p = ivec2(i);
+
+    float h00 = DecodeHeight(p);
+    float h10 = DecodeHeight(p + ivec2(1, 0));
+    float h01 = DecodeHeight(p + ivec2(0, 1));
+    float h11 = DecodeHeight(p + ivec2(1, 1));
+
+    return mix(mix(h00, h10, f.x), mix(h01, h11, f.x), f.y);
+}
+
+vec3 GetWorldPosition(vec2 s)
+{
+    return vec3(terrain.x + s.x*spacing.x, terrain.y + SampleHeight(s)*terrain.w, terrain.z + s.y*spacing.y);
+}
+
+void main()
+{
+    vec2 grid = vertexPosition.xz;
+    vec2 s = clamp(node.xy + grid*node.z, vec2(0.0), spacing.zw);
+
+    // Morph odd grid vertices onto the next coarser grid as distance approaches the level range
+    float k = clamp((distance(GetWorldPosition(s), cameraPosition) - morph.x)*morph.y, 0.0, 1.0);
+    grid -= fract(grid*morph.z*0.5)*2.0/morph.z*k;
+    s = clamp(node.xy + grid*node.z, vec2(0.0), spacing.zw);
+
+    fragTexCoord = (s + 0.5)/(spacing.zw + 1.0);
+    gl_Position = mvp*vec4(GetWorldPosition(s), 1.0);
+}
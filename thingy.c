@@ -1,28 +1,239 @@
+#include "./functions/memory.c"     // Must come first, hooks RL_MALLOC/RL_FREE for all modules
 #include "raylib.h"
 #include "raymath.h"
 #include "rcamera.h"
 #include "math.h"
 #include "stdio.h"
+#include "string.h"
 #include "./functions/3dfunctions.c"
+#include "./functions/meshlod.c"
+#include "./functions/compactmesh.c"
+#include "./functions/frustum.c"
+#include "./functions/occlusion.c"
+#include "./functions/renderqueue.c"
+#include "./functions/terrain.c"
+#include "./functions/entities.c"
+#include "./functions/lightbake.c"
+#include "./functions/lightclusters.c"
+#include "./functions/raycast.c"
+#include "./functions/streaming.c"
+#include "./functions/navigation.c"
+#include "./functions/crowd.c"
+#include "./functions/physics.c"
+#include "./functions/simulation.c"
+#include "./functions/replication.c"
+#include "./functions/particles.c"
+#include "./functions/decals.c"
+#include "./functions/resources.c"
+#include "./functions/hud.c"
+#include "./functions/resolution.c"
 
 #define RCAMERA_IMPLEMENTATION
 
 //Define types and structures
 //------------------------------------------------------------------------------------
+#define MAX_PROPS 4096
+
 typedef enum GameScreen { TITLE, LEVELSELECT, EPISODE1 } GameScreen;
 
+#define MICROWAVE_MODEL "models/kitchen-microwave-appliance/microwave.glb"
+#define KITCHENCOUNTER_MODEL "models/kitchen counter/counter.glb"
+#define MICROWAVE_SOUND "sounds/microwave.ogg"
+#define MAP01_CUBICMAP "textures/testimage.png"
+#define MAP01_ATLAS "textures/map_atlas.png"
+
+// Assets each screen needs, assets shared with the next screen stay loaded on transition
+static const SceneResource titleresources[] = {
+    { RESOURCE_MODEL, MICROWAVE_MODEL },
+    { RESOURCE_MODEL, KITCHENCOUNTER_MODEL },
+    { RESOURCE_SOUND, MICROWAVE_SOUND },
+};
+
+static const SceneResource levelselectresources[] = {
+    { RESOURCE_MODEL, MICROWAVE_MODEL },
+    { RESOURCE_MODEL, KITCHENCOUNTER_MODEL },
+};
+
+static const SceneResource episode1resources[] = {
+    { RESOURCE_IMAGE, MAP01_CUBICMAP },
+    { RESOURCE_TEXTURE, MAP01_ATLAS },
+};
+
+// Indexed by GameScreen
+static const Scene scenes[] = {
+    { "title", titleresources, sizeof(titleresources)/sizeof(SceneResource) },
+    { "levelselect", levelselectresources, sizeof(levelselectresources)/sizeof(SceneResource) },
+    { "episode1", episode1resources, sizeof(episode1resources)/sizeof(SceneResource) },
+};
+
+// EPISODE1 simulation state, owned by the simulation thread while it runs
+typedef struct Episode1State {
+    Camera camera;
+    bool crouching;
+    Vector3 mapPosition;            // Map01 draw offset
+    const CubicmapGrid *grid;
+    NavGrid *nav;
+    NavFlowField *flow;
+    Crowd *crowd;
+    const Terrain *terrain;
+    PhysicsWorld *physics;
+} Episode1State;
+
+// EPISODE1 simulation step: player movement, flow field towards the player, crowd and props
+static void UpdateEpisode1(void *data, const SimInput *input, float dt, SimSnapshot *snapshot)
+{
+    Episode1State *state = (Episode1State *)data;
+    Camera *camera = &state->camera;
+    
+    if (input->pressed & SIM_ACTION_CROUCH)
+    {
+        state->crouching = !state->crouching;
+        camera->position.y += state->crouching? -1.0f : 1.0f;
+        camera->target.y += state->crouching? -1.0f : 1.0f;
+    }
+    
+    float playerspeed = ((input->down & SIM_ACTION_SPRINT)? 12.0f : 6.0f)*dt;
+    if (state->crouching) playerspeed = playerspeed/10;
+    
+    Vector3 playermove = { 0 };
+    if (input->down & SIM_ACTION_FORWARD) playermove.x += playerspeed;
+    if (input->down & SIM_ACTION_BACK) playermove.x -= playerspeed;
+    if (input->down & SIM_ACTION_RIGHT) playermove.y += playerspeed;
+    if (input->down & SIM_ACTION_LEFT) playermove.y -= playerspeed;
+    
+    // Same mouse sensitivity as CAMERA_FIRST_PERSON (0.003 rad per pixel)
+    Vector3 playerrotate = { input->mouseDelta.x*0.003f*RAD2DEG, input->mouseDelta.y*0.003f*RAD2DEG, 0.0f };
+    UpdateCameraPro(camera, playermove, playerrotate, 0.0f);
+    
+    // Keep eye height above terrain ground
+    if (IsPointOnTerrain(state->terrain, camera->position.x, camera->position.z))
+    {
+        float groundheight = GetTerrainHeight(state->terrain, camera->position.x, camera->position.z) + 2.0f;
+        if (camera->position.y < groundheight)
+        {
+            camera->target.y += groundheight - camera->position.y;
+            camera->position.y = groundheight;
+        }
+    }
+    
+    // Flow field only changes when the player enters another cell
+    int playercellx = (int)floorf((camera->position.x - state->mapPosition.x)/state->grid->cubeSize.x + 0.5f);
+    int playercellz = (int)floorf((camera->position.z - state->mapPosition.z)/state->grid->cubeSize.z + 0.5f);
+    if ((playercellx != state->flow->goalX) || (playercellz != state->flow->goalZ)) UpdateNavFlowField(state->nav, state->flow, playercellx, playercellz, 2);
+    UpdateCrowd(state->crowd, state->nav, state->flow, dt);
+    
+    // Weapon fire pushes the prop under the crosshair
+    if (input->pressed & SIM_ACTION_FIRE)
+    {
+        Ray fireray = { camera->position, Vector3Normalize(Vector3Subtract(camera->target, camera->position)) };
+        RayCollision firehit = { 0 };
+        int body = GetPhysicsRayHit(state->physics, fireray, 100.0f, &firehit);
+        if (body != -1) ApplyPhysicsImpulse(state->physics, body, Vector3Scale(fireray.direction, 4.0f), firehit.point);
+    }
+    UpdatePhysicsWorld(state->physics, dt);
+    
+    snapshot->camera = *camera;
+    snapshot->agentCount = (state->crowd->count < MAX_SIM_AGENTS)? state->crowd->count : MAX_SIM_AGENTS;
+    for (int i = 0; i < snapshot->agentCount; i++) snapshot->agents[i] = GetCrowdAgentPosition(state->crowd, i);
+    snapshot->bodyCount = (state->physics->count < MAX_SIM_BODIES)? state->physics->count : MAX_SIM_BODIES;
+    for (int i = 0; i < snapshot->bodyCount; i++)
+    {
+        snapshot->bodyPositions[i] = state->physics->bodies[i].position;
+        snapshot->bodyRotations[i] = state->physics->bodies[i].rotation;
+    }
+}
+
+// Benchmark map: rooms of 8 cells joined by doors, with half height floor blocks and low ceilings
+static CubicmapGrid GenBenchmarkGrid(int size, Vector3 cubeSize)
+{
+    CubicmapGrid grid = { 0 };
+    grid.width = size;
+    grid.height = size;
+    grid.cubeSize = cubeSize;
+    grid.floor = (unsigned char *)RL_CALLOC(size*size, 1);
+    grid.ceiling = (unsigned char *)RL_MALLOC(size*size);
+    memset(grid.ceiling, 255, size*size);
+    
+    srand(99);
+    for (int z = 0; z < size; z++)
+    {
+        for (int x = 0; x < size; x++)
+        {
+            int cell = z*size + x;
+            bool border = (x == 0) || (z == 0) || (x == size - 1) || (z == size - 1);
+            bool wall = border || (x%8 == 0) || (z%8 == 0);
+            bool door = ((x%8 == 4) && (z%8 == 0)) || ((z%8 == 4) && (x%8 == 0));
+            
+            if (wall && (border || !door)) grid.floor[cell] = 255;
+            else if (rand()%16 == 0) grid.floor[cell] = 128;
+            else if (rand()%16 == 0) grid.ceiling[cell] = 128;
+        }
+    }
+    
+    return grid;
+}
+
+// Headless benchmarks and self checks (thingy --bench), returns the number of failed checks
+// NOTE: Every module benchmark logs its timings and counts output that disagrees with its reference path
+static int RunBenchmarks(void)
+{
+    int failures = 0;
+    CubicmapGrid grid = GenBenchmarkGrid(256, (Vector3){ 3.0f, 3.0f, 3.0f });
+    
+    failures += BenchmarkCubicmapGridEmit(&grid, 5);
+    failures += BenchmarkCubicmapTiled(&grid, 32);
+    failures += BenchmarkMeshLod(64, 128);
+    failures += BenchmarkTerrain(1024);
+    failures += BenchmarkGridRaycast(&grid, 1 << 20, 256, 100.0f);
+    failures += BenchmarkOcclusionCuller(&grid, 8, 1000, 32, 0.001f);
+    failures += BenchmarkRenderQueue(4096, 1000);
+    failures += BenchmarkLightClusters(64, 1000, 16);
+    failures += BenchmarkLightClusters(256, 1000, 16);
+    failures += BenchmarkLightClusters(1024, 1000, 16);
+    
+    NavGrid nav = LoadNavGrid(&grid, 16, 1.8f, 0.5f);
+    failures += BenchmarkNavigation(&nav, 1000, 8, 4, 0.0002f, 0.02f);
+    
+    // Navigation target size: queries stay in microseconds, flow field rebuilds in a few frames
+    CubicmapGrid largeGrid = GenBenchmarkGrid(1024, (Vector3){ 3.0f, 3.0f, 3.0f });
+    NavGrid largeNav = LoadNavGrid(&largeGrid, 16, 1.8f, 0.5f);
+    failures += BenchmarkNavigation(&largeNav, 1000, 4, 4, 0.0004f, 0.2f);
+    UnloadNavGrid(&largeNav);
+    UnloadCubicmapGrid(&largeGrid);
+    
+    failures += BenchmarkCrowd(&grid, &nav, 10000, 600, 0.004f);
+    failures += BenchmarkParticles(100000, 300);
+    failures += BenchmarkPhysics(1000, 300);
+    failures += BenchmarkSimulation(20.0, 1.0f/60.0f);
+    failures += BenchmarkReplication(32, 600, 0.1f, 0.2f);
+    failures += BenchmarkResolutionController("traces/episode1.txt", 3600);
+    
+    UnloadNavGrid(&nav);
+    UnloadCubicmapGrid(&grid);
+    
+    TRACELOG((failures == 0)? LOG_INFO : LOG_WARNING, "BENCH: %i failed checks", failures);
+    
+    return failures;
+}
+
 //------------------------------------------------------------------------------------
 // Program main entry point
 //------------------------------------------------------------------------------------
-int main(void)
+int main(int argc, char *argv[])
 {
+    // Benchmarks run without a window
+    if ((argc > 1) && (strcmp(argv[1], "--bench") == 0)) return (RunBenchmarks() == 0)? 0 : 1;
+    
     // Initialization
     //--------------------------------------------------------------------------------------
     
-    SetConfigFlags(FLAG_MSAA_4X_HINT);
     InitWindow(800, 450, "microwave simulator");
     
-    SetTargetFPS(60);
+    // NOTE: No SetTargetFPS(), its wait is counted in the frame time and would hide the headroom
+    // dynamic resolution scales up into, frames are paced at the end of the main loop instead
+    const float frametarget = 1.0f/60.0f;
+    
+    InitFrameMemory(4*1024*1024);
     
     InitAudioDevice();
     
@@ -32,23 +243,15 @@ int main(void)
     //--------------------------------------------------------------------------------------
     int currentmonitor = 0;
     
-    float playerspeed;
-    float playersprint;
-    Vector3 playermove = {0, 0, 0};
-    Vector3 playerrotate = {0, 0, 0};
-    
     bool fullscreen = false;
-    bool moving = false;
     bool Tutorial_Interact_Completed = false;
     bool levelstarted = false;
+    bool levelloaded = false;
     
-    Vector3 microwaveposition = { 0.0f, 1.2f, 0.0f };
-    Vector3 microwavesize = {4.5f, 4.5f, 4.5f};
     Vector2 mapPosition = {-2, -2};
-      
-    Sound microwavesfx = LoadSound("sounds/microwave.ogg");
     
     GameScreen currentscreen = TITLE;
+    GameScreen previousscreen = TITLE;
 
     Ray InteractRay = { 0 };
     
@@ -68,45 +271,118 @@ int main(void)
     
     //Load Models/Textures
     //--------------------------------------------------------------------------------------   
-    Model microwave = LoadModel("models/kitchen-microwave-appliance/microwave.glb");
+    // Memory is charged to the tag on top of the tag stack, raylib owned data is tracked by size
+    // Screen assets are owned by the resource manager, only the active screen assets are resident
+    static ResourceManager resources = { 0 };
+    TransitionScene(&resources, NULL, &scenes[currentscreen]);
+    
+    Model microwave = GetResourceModel(&resources, MICROWAVE_MODEL);
     //microwave.transform = microwave.transform * MatrixScale(4.5f, 4.5f, 4.5f);
-    BoundingBox microwave_collision;
     
-    Model kitchencounter = LoadModel("models/kitchen counter/counter.glb");   
+    Model kitchencounter = GetResourceModel(&resources, KITCHENCOUNTER_MODEL);
     
-    Image testimage = LoadImage("textures/testimage.png");      // Load cubicmap image (RAM)
-    Texture2D cubicmap = LoadTextureFromImage(testimage);       // Convert image to texture to display (VRAM)
-    Color *mapPixels = LoadImageColors(testimage);
-    UnloadImage(testimage);
-
-    Mesh map01_mesh = GenMeshCubicmapEx(testimage, (Vector3){ 3.0f, 3.0f, 3.0f });
-    Model map01 = LoadModelFromMesh(map01_mesh);
-    BoundingBox map01_collision = GetModelBoundingBox(map01);
+    PushMemoryTag(MEMORY_TAG_MODELS);
+    ModelLod microwave_lod = GenModelLod(microwave, MAX_LOD_LEVELS);
+    ModelLod kitchencounter_lod = GenModelLod(kitchencounter, MAX_LOD_LEVELS);
+    PopMemoryTag();
+    
+    //Spawn Props
+    //--------------------------------------------------------------------------------------
+    PushMemoryTag(MEMORY_TAG_ENTITIES);
+    EntityStore props = LoadEntityStore(MAX_PROPS);
+    PopMemoryTag();
+    int microwave_model = AddEntityModel(&props, microwave);
+    int kitchencounter_model = AddEntityModel(&props, kitchencounter);
+    
+    SetEntityModelLod(&props, microwave_model, &microwave_lod);
+    SetEntityModelLod(&props, kitchencounter_model, &kitchencounter_lod);
     
+    EntityHandle microwave_entity = CreateEntity(&props, microwave_model, (Vector3){ 0.0f, 1.2f, 0.0f }, (Vector3){ 4.5f, 4.5f, 4.5f }, true);
+    CreateEntity(&props, kitchencounter_model, (Vector3){ 0, 0, 0 }, (Vector3){ 1, 1, 1 }, false);
     
-    Texture2D map01_diffuse = LoadTexture("textures/map_atlas.png");
-    map01.materials[0].maps[MATERIAL_MAP_DIFFUSE].texture = map01_diffuse;
+    // Map01 level data is built when EPISODE1 starts, from the resident episode assets
+    CubicmapGrid map01_grid = { 0 };
+    WorldStream *map01_stream = NULL;
+    OcclusionCuller map01_occlusion = { 0 };
+    LightClusters map01_lights = { 0 };
+    int muzzleflash = -1;
+    NavGrid map01_nav = { 0 };
+    NavFlowField map01_flow = { 0 };
+    Crowd map01_crowd = { 0 };
+    PhysicsWorld map01_physics = { 0 };
+    DecalBatch map01_decals = { 0 };
+    Texture2D decalatlas = { 0 };
+    Terrain terrain01 = { 0 };
+    Texture2D map01_diffuse = { 0 };
+    Episode1State episode1state = { 0 };
+    Simulation *episode1sim = NULL;
+    const SimSnapshot *episode1snapshot = NULL;
+    
+    // Player state is replicated by a 30 Hz server, on loopback until there is a lobby, remote players are drawn interpolated
+    NetLoopback *map01_loopback = NULL;
+    NetServer *map01_server = NULL;
+    NetClient *map01_client = NULL;
+    float nettime = 0.0f;
+    CompactMapShader compactshader = LoadCompactMapShader();
+    
+    // Props and map regions are drawn through a sorted queue, grouped by shader and texture
+    RenderQueue renderqueue = LoadRenderQueue(4096);
+    
+    // HUD widgets are laid out once and redrawn into the HUD texture only when a bound value changes
+    Hud hud = LoadHud(GetScreenWidth(), GetScreenHeight());
+    int hud_fps = AddHudText(&hud, "%i FPS", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 10.0f }, HUD_ALIGN_LEFT, 20, LIME);
+    int hud_welcome = AddHudText(&hud, "welcome to microwave game", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 30.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_start = AddHudText(&hud, "press space to start", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 50.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_interact = AddHudText(&hud, "Press 'E' to interact.", (Vector2){ 0.5f, 0.8f }, (Vector2){ 0.0f, 0.0f }, HUD_ALIGN_CENTER, 20, RED);
+    int hud_regions = AddHudText(&hud, "Regions: %i resident, %i pending, %i evicted", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 40.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_campos = AddHudText(&hud, "Cam Pos: %.2f, %.2f", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 60.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_mappos = AddHudText(&hud, "Map Pos: %i, %i", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 80.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_occlusion = AddHudText(&hud, "Occlusion: %i%% culled (%.2f ms)", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 100.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_lights = AddHudText(&hud, "Lights: %i visible, %i indices (%.2f ms)", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 120.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_net = AddHudText(&hud, "Net: %.1f bytes/snapshot, %i players", (Vector2){ 0.0f, 0.0f }, (Vector2){ 10.0f, 140.0f }, HUD_ALIGN_LEFT, 20, WHITE);
+    int hud_resolution = AddHudText(&hud, "Scale: %.2f (%.1f ms)", (Vector2){ 1.0f, 0.0f }, (Vector2){ -10.0f, 10.0f }, HUD_ALIGN_RIGHT, 20, LIME);
+    
+    // Timings change every frame, their widgets are refreshed 4 times a second with the mean over that time
+    float hudtimingtime = 0.0f;
+    float hudframework = 0.0f;
+    int hudframes = 0;
+    
+    // 3D scene renders offscreen at a scale that tracks the frame budget, the HUD stays native
+    DynamicResolution *resolution = LoadDynamicResolution(GetScreenWidth(), GetScreenHeight(), frametarget);
+    float framework = 0.0f;
+    
+    // Effects: microwave sparks and bullet impacts (impacts bounce on map01 floors)
+    Image sparkimage = GenImageGradientRadial(16, 16, 0.0f, WHITE, BLANK);
+    Texture2D sparktexture = LoadTextureFromImage(sparkimage);
+    TrackMemory(MEMORY_TAG_TEXTURES, GetTextureMemorySize(sparktexture));
+    UnloadImage(sparkimage);
+    
+    PushMemoryTag(MEMORY_TAG_EFFECTS);
+    
+    ParticleType sparktype = { sparktexture, YELLOW, (Color){ 255, 80, 0, 0 }, 0.12f, 0.02f, (Vector3){ 0.0f, -9.8f, 0.0f }, 0.5f, 0.4f, 0.7f };
+    ParticlePool sparks = LoadParticlePool(4096, sparktype);
+    ParticleType impacttype = { sparktexture, ORANGE, (Color){ 80, 80, 80, 0 }, 0.08f, 0.2f, (Vector3){ 0.0f, -6.0f, 0.0f }, 1.0f, 0.3f, 0.5f };
+    ParticlePool impacts = LoadParticlePool(8192, impacttype);
+    PopMemoryTag();
 
     
     // Main game loop
     while (!WindowShouldClose())    // Detect window close button or ESC key
     {
+        double framestart = GetTimerSeconds();
+        
         // Update
         //----------------------------------------------------------------------------------
         Vector3 oldcameraposition = camera.position;
-        Vector3 cameraforward = GetCameraForward(&camera);
         
         //int playerCellX = camera.position.x - mapPosition.x;
         //int playerCellY = camera.position.y - mapPosition.y;
         
-        float playerspeed = 6.0f*GetFrameTime();
-        float playersprint = 12.0f*GetFrameTime();
-        
 
         RayCollision InteractRayCollision = { 0 };
         InteractRayCollision.hit = false;        
         InteractRay = GetMouseRay((Vector2){(GetScreenWidth()/2), (GetScreenHeight()/2)}, camera);        
-        RayCollision MicrowaveHitInfo = GetRayCollisionBox(InteractRay, microwave_collision);
+        EntityHandle InteractTarget = GetEntityRayHit(&props, InteractRay, &InteractRayCollision);
         
         
         switch(currentscreen)
@@ -114,6 +390,7 @@ int main(void)
             case TITLE:
             {
                 cameraMode = CAMERA_ORBITAL;
+                Sound microwavesfx = GetResourceSound(&resources, MICROWAVE_SOUND);
                 bool sfxplaying = IsSoundPlaying(microwavesfx);
                 if(!sfxplaying) PlaySound(microwavesfx);
                 
@@ -124,12 +401,12 @@ int main(void)
             
             case LEVELSELECT: 
             {
-                StopSound(microwavesfx);
                 cameraMode = CAMERA_FIRST_PERSON;
                 UpdateCamera(&camera, cameraMode); 
                 
-                if (IsKeyPressed(KEY_E) && MicrowaveHitInfo.hit)
+                if (IsKeyPressed(KEY_E) && (InteractTarget.id == microwave_entity.id))
                 {
+                    EmitParticles(&sparks, InteractRayCollision.point, InteractRayCollision.normal, 3.0f, 0.8f, 1.0f, 200);
                     currentscreen = EPISODE1;
                     Tutorial_Interact_Completed = true;
                 }
@@ -137,105 +414,251 @@ int main(void)
             
             case EPISODE1: 
             {
-                if (!levelstarted) 
+                levelstarted = true;
+                
+                // Player, flow field, crowd and props run on the simulation thread, we draw its latest snapshot
+                cameraMode = CAMERA_FIRST_PERSON;
+                SimInput episode1input = CaptureSimInput(episode1sim);
+                PushSimInput(episode1sim, episode1input);
+                episode1snapshot = GetSimSnapshot(episode1sim);
+                camera = episode1snapshot->camera;
+                UpdateWorldStream(map01_stream, camera, GetFrameTime());
+                
+                // Server ticks take the player state from the latest snapshot, the client acks and interpolates every frame
+                nettime += GetFrameTime();
+                while (nettime >= map01_server->tickTime)
                 {
-                    camera.position = (Vector3){0.0f, 2.0f, 4.0f};
-                    levelstarted = true;
+                    if (map01_client->slot >= 0) SetNetServerPlayer(map01_server, map01_client->slot, GetNetPlayerState(camera, episode1input.down));
+                    UpdateNetServer(map01_server);
+                    nettime -= map01_server->tickTime;
                 }
+                UpdateNetLoopback(map01_loopback, GetFrameTime());
+                UpdateNetClient(map01_client, GetFrameTime(), episode1input);
                 
-                cameraMode = CAMERA_FIRST_PERSON;
-                UpdateCamera(&camera, cameraMode);
+                // Weapon fire: impact particles and a bullet hole where the crosshair ray hits the map
+                if (IsMouseButtonPressed(MOUSE_BUTTON_LEFT))
+                {
+                    Ray fireray = { Vector3Subtract(InteractRay.position, map01_stream->position), InteractRay.direction };
+                    GridRayHit firehit = GetGridRayCollision(&map01_grid, fireray, 100.0f);
+                    map01_lights.lights[muzzleflash].position = Vector3Add(InteractRay.position, InteractRay.direction);
+                    map01_lights.lights[muzzleflash].intensity = 2.0f;
+                    if (firehit.hit)
+                    {
+                        EmitParticles(&impacts, Vector3Add(Vector3Add(firehit.point, map01_stream->position), Vector3Scale(firehit.normal, 0.02f)), firehit.normal, 2.5f, 0.7f, 0.8f, 64);
+                        SpawnDecal(&map01_decals, firehit, 0.15f, DECAL_BULLET_HOLE, GetRandomValue(0, 3), WHITE);
+                    }
+                }
+                
+                // Alternate fire leaves a scorch mark
+                if (IsMouseButtonPressed(MOUSE_BUTTON_RIGHT))
+                {
+                    Ray fireray = { Vector3Subtract(InteractRay.position, map01_stream->position), InteractRay.direction };
+                    GridRayHit firehit = GetGridRayCollision(&map01_grid, fireray, 100.0f);
+                    SpawnDecal(&map01_decals, firehit, 1.2f, DECAL_SCORCH, GetRandomValue(0, 3), WHITE);
+                }
+                
+                UpdateDecalBatch(&map01_decals);
+                
+                // Muzzle flash fades out in 0.1 s
+                map01_lights.lights[muzzleflash].intensity = fmaxf(map01_lights.lights[muzzleflash].intensity - 20.0f*GetFrameTime(), 0.0f);
             } break;
         }
-
-
-        camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
-        
-        Vector3 movevector = Vector3Multiply(Vector3Normalize(cameraforward), (Vector3){GetFrameTime()*playerspeed, 0, GetFrameTime()*playerspeed});
         
-        //Key Presses
-        //----------------------------------------------------------------------------------
-        if (IsKeyPressed(KEY_F11))
+        // Screen transitions swap resident assets: shared ones stay loaded, the rest is released
+        if (currentscreen != previousscreen)
         {
-            fullscreen = !fullscreen;            
-            if(fullscreen){MaximizeWindow();}
-            else{RestoreWindow();}            
-            ToggleBorderlessWindowed();
-        }
-        if (currentscreen == EPISODE1) 
-        {
-            if (IsKeyDown(KEY_W) || IsKeyDown(KEY_S) || IsKeyDown(KEY_S) || IsKeyDown(KEY_D))
+            if (currentscreen == EPISODE1)
             {
-                moving = true;
-            }
-            else
-            {
-                moving = false;
+                // Props reference the title/levelselect models, remove them before the models are released
+                UnloadEntityStore(&props);
+                UnloadModelLod(&microwave_lod);
+                UnloadModelLod(&kitchencounter_lod);
             }
             
-            if(IsKeyDown(KEY_W)) 
-            {
-                if (playermove.x < playerspeed) playermove.x += 0.01f;
-                else playermove.x = playerspeed;
-                if(IsKeyDown(KEY_LEFT_SHIFT)) playermove.x = playersprint;                
-            }
-            
-            if(IsKeyDown(KEY_A)) 
-            {
-                playermove.y = -playerspeed;   
-                if(IsKeyDown(KEY_LEFT_SHIFT)) playermove.y = -playersprint;
-            }
-            
-            if (IsKeyDown(KEY_S)) 
-            {
-                playermove.x = -playerspeed;
-            }
-            
-            if(IsKeyDown(KEY_D)) 
-            {
-                playermove.y = playerspeed;
-                if(IsKeyDown(KEY_LEFT_SHIFT)) playermove.y = playersprint;                
-            }
+            TransitionScene(&resources, &scenes[previousscreen], &scenes[currentscreen]);
+            previousscreen = currentscreen;
             
+            // Next screen assets load in the background, one per frame
+            if (currentscreen == LEVELSELECT) PrefetchScene(&resources, &scenes[EPISODE1]);
             
-            if (!IsKeyDown(KEY_W) && !IsKeyDown(KEY_S)) playermove.x = 0;
-            if (!IsKeyDown(KEY_A) && !IsKeyDown(KEY_D)) playermove.y = 0;
-            
-            if (IsKeyPressed(KEY_LEFT_CONTROL)) 
+            if ((currentscreen == EPISODE1) && !levelloaded)
             {
-                bool crouching = !crouching; 
-                if (crouching)
+                PushMemoryTag(MEMORY_TAG_MAP);
+                map01_grid = LoadCubicmapGrid(GetResourceImage(&resources, MAP01_CUBICMAP), (Vector3){ 3.0f, 3.0f, 3.0f }, CUBICMAP_LEGACY_COLORS);
+                map01_diffuse = GetResourceTexture(&resources, MAP01_ATLAS);
+                
+                // Outdoor area next to map01
+                terrain01 = LoadTerrain("textures/depthmap.png", (Vector3){ 46.0f, 0.0f, -3.5f }, (Vector3){ 48.0f, 6.0f, 48.0f });
+                PopMemoryTag();
+                
+                // Map is streamed in regions around the camera
+                PushMemoryTag(MEMORY_TAG_STREAMING);
+                map01_stream = LoadWorldStream(&map01_grid, (Vector3){ -2.0f, 0.0f, -2.0f }, 8);
+                map01_stream->bakeCache = "map01";
+                PopMemoryTag();
+                
+                // Regions and props hidden behind the nearest map walls are not submitted
+                PushMemoryTag(MEMORY_TAG_MAP);
+                map01_occlusion = LoadOcclusionCuller(&map01_grid, map01_stream->position, 256, 128);
+                
+                // Ceiling lamps every 4 cells, plus one muzzle flash light lit when firing
+                map01_lights = LoadLightClusters(16, 9, 24, 1024);
+                PopMemoryTag();
+                for (int cellz = 2; cellz < map01_grid.height; cellz += 4)
+                {
+                    for (int cellx = 2; cellx < map01_grid.width; cellx += 4)
+                    {
+                        int cell = cellz*map01_grid.width + cellx;
+                        if (map01_grid.floor[cell] >= map01_grid.ceiling[cell]) continue;
+                        
+                        float lampy = map01_grid.ceiling[cell]*map01_grid.cubeSize.y/255.0f - 0.3f;
+                        AddPointLight(&map01_lights, Vector3Add(map01_stream->position, (Vector3){ cellx*map01_grid.cubeSize.x, lampy, cellz*map01_grid.cubeSize.z }), 7.0f, (Color){ 255, 200, 140, 255 }, 0.6f);
+                    }
+                }
+                muzzleflash = AddPointLight(&map01_lights, camera.position, 5.0f, ORANGE, 0.0f);
+                
+                // Map agents follow a flow field towards the player
+                PushMemoryTag(MEMORY_TAG_NAVIGATION);
+                map01_nav = LoadNavGrid(&map01_grid, 16, 1.8f, 0.5f);
+                map01_flow = LoadNavFlowField(&map01_nav);
+                map01_crowd = LoadCrowd(&map01_grid, map01_stream->position, 32, GetCrowdDefaults());
+                for (int i = 0; (i < 1000) && (map01_crowd.count < map01_crowd.capacity); i++)
                 {
-                    camera.position.y = camera.position.y - 1;
-                    camera.target.y = camera.target.y - 1;
-                    playerspeed = playerspeed/10;
+                    int cellx = GetRandomValue(0, map01_grid.width - 1);
+                    int cellz = GetRandomValue(0, map01_grid.height - 1);
+                    if (IsNavCellWalkable(&map01_nav, cellx, cellz)) AddCrowdAgent(&map01_crowd, Vector3Add(map01_stream->position, (Vector3){ cellx*map01_grid.cubeSize.x, 0.0f, cellz*map01_grid.cubeSize.z }));
                 }
-                else
+                PopMemoryTag();
+                
+                // Crates and balls lying around map01, settled props sleep until something hits them
+                PushMemoryTag(MEMORY_TAG_ENTITIES);
+                map01_physics = LoadPhysicsWorld(64);
+                
+                // Local client joins the loopback server like a remote one would
+                map01_loopback = LoadNetLoopback(256, 0.0f, 0.0f, 0.0f);
+                map01_server = LoadNetServer(GetNetLoopbackTransport(map01_loopback, 0), 1.0f/30.0f);
+                map01_client = LoadNetClient(GetNetLoopbackTransport(map01_loopback, 1), 1.0f/30.0f);
+                PopMemoryTag();
+                SetPhysicsWorldGrid(&map01_physics, &map01_grid, map01_stream->position);
+                for (int i = 0; (i < 1000) && (map01_physics.count < map01_physics.capacity); i++)
                 {
-                    camera.position.y = camera.position.y + 1;
-                    camera.target.y = camera.target.y + 1;
-                    playerspeed = playerspeed*10;
+                    int cellx = GetRandomValue(0, map01_grid.width - 1);
+                    int cellz = GetRandomValue(0, map01_grid.height - 1);
+                    if (!IsNavCellWalkable(&map01_nav, cellx, cellz)) continue;
+                    
+                    float floory = map01_grid.floor[cellz*map01_grid.width + cellx]*map01_grid.cubeSize.y/255.0f;
+                    Vector3 spawn = Vector3Add(map01_stream->position, (Vector3){ cellx*map01_grid.cubeSize.x, floory + 1.0f, cellz*map01_grid.cubeSize.z });
+                    if (map01_physics.count%3 == 2) AddPhysicsSphere(&map01_physics, spawn, 0.3f, 2.0f);
+                    else AddPhysicsBox(&map01_physics, spawn, (Vector3){ 0.4f, 0.4f, 0.4f }, 4.0f);
                 }
+                
+                // Impacts bounce on map01 floors, hits leave decals on the map faces
+                SetParticlePoolGrid(&impacts, &map01_grid, map01_stream->position);
+                Image decalimage = GenImageDecalAtlas(64);
+                decalatlas = LoadTextureFromImage(decalimage);
+                TrackMemory(MEMORY_TAG_TEXTURES, GetTextureMemorySize(decalatlas));
+                UnloadImage(decalimage);
+                PushMemoryTag(MEMORY_TAG_EFFECTS);
+                map01_decals = LoadDecalBatch(&map01_grid, map01_stream->position, 4096, decalatlas);
+                PopMemoryTag();
+                
+                episode1state.camera = camera;
+                episode1state.camera.position = (Vector3){ 0.0f, 2.0f, 4.0f };
+                episode1state.mapPosition = map01_stream->position;
+                episode1state.grid = &map01_grid;
+                episode1state.nav = &map01_nav;
+                episode1state.flow = &map01_flow;
+                episode1state.crowd = &map01_crowd;
+                episode1state.terrain = &terrain01;
+                episode1state.physics = &map01_physics;
+                episode1sim = LoadSimulation(UpdateEpisode1, &episode1state, 1.0f/60.0f);
+                StartSimulation(episode1sim);
+                episode1snapshot = GetSimSnapshot(episode1sim);
+                camera = episode1snapshot->camera;
+                levelloaded = true;
             }
-            
-            Vector3ClampValue(playermove, 0, playersprint);
-            UpdateCameraPro(&camera, playermove, playerrotate, 0);
         }
+        UpdateResourceManager(&resources, 1);
+
+
+        camera.up = (Vector3){ 0.0f, 1.0f, 0.0f };
+        
+        //Key Presses
+        //----------------------------------------------------------------------------------
+        if (IsKeyPressed(KEY_F11))
+        {
+            fullscreen = !fullscreen;            
+            if(fullscreen){MaximizeWindow();}
+            else{RestoreWindow();}            
+            ToggleBorderlessWindowed();
+        }
+        if (IsKeyPressed(KEY_F2)) TraceMemoryReport();
+        if (IsKeyPressed(KEY_F3)) ExportFrameTimeTrace(resolution, "frametrace.txt");
+        if (IsKeyPressed(KEY_F4)) map01_occlusion.enabled = !map01_occlusion.enabled;
             
         // TODO: Update your variables here
         //----------------------------------------------------------------------------------        
         
 
         
-        microwave_collision = GetMeshBoundingBox(microwave.meshes[0]);
-        microwave_collision.min = Vector3Scale(microwave_collision.min, microwavesize.x);
-        microwave_collision.max = Vector3Scale(microwave_collision.max, microwavesize.x);
-        microwave_collision.min = Vector3Add(microwave_collision.min, microwaveposition);
-        microwave_collision.max = Vector3Add(microwave_collision.max, microwaveposition);
+        UpdateParticles(&sparks, GetFrameTime());
+        UpdateParticles(&impacts, GetFrameTime());
+        UpdateEntityLods(&props, camera);
+        
+        // HUD: only changed values are formatted, the HUD texture is redrawn only when something changed
+        SetHudVisible(&hud, hud_fps, currentscreen != LEVELSELECT);
+        SetHudVisible(&hud, hud_welcome, currentscreen == TITLE);
+        SetHudVisible(&hud, hud_start, currentscreen == TITLE);
+        SetHudVisible(&hud, hud_interact, (currentscreen == LEVELSELECT) && !Tutorial_Interact_Completed);
+        SetHudVisible(&hud, hud_regions, currentscreen == EPISODE1);
+        SetHudVisible(&hud, hud_campos, currentscreen == EPISODE1);
+        SetHudVisible(&hud, hud_mappos, currentscreen == EPISODE1);
+        SetHudVisible(&hud, hud_occlusion, currentscreen == EPISODE1);
+        SetHudVisible(&hud, hud_lights, currentscreen == EPISODE1);
+        SetHudVisible(&hud, hud_net, currentscreen == EPISODE1);
+        SetHudValues(&hud, hud_fps, GetFPS(), 0, 0);
+        
+        hudtimingtime += GetFrameTime();
+        hudframework += framework;
+        hudframes++;
+        bool hudtimings = (hudtimingtime >= 0.25f);
+        if (hudtimings)
+        {
+            SetHudValues(&hud, hud_resolution, resolution->controller.scale, hudframework*1000.0f/hudframes, 0);
+            hudtimingtime = 0.0f;
+            hudframework = 0.0f;
+            hudframes = 0;
+        }
+        if (currentscreen == EPISODE1)
+        {
+            WorldStreamStats streamstats = GetWorldStreamStats(map01_stream);
+            SetHudValues(&hud, hud_regions, streamstats.resident, streamstats.pending, streamstats.evictions);
+            SetHudValues(&hud, hud_campos, camera.position.x, camera.position.y, 0);
+            SetHudValues(&hud, hud_mappos, mapPosition.x, mapPosition.y, 0);
+            
+            // Counters of the last frame, the update below resets them
+            if (hudtimings)
+            {
+                OcclusionStats occlusionstats = GetOcclusionStats(&map01_occlusion);
+                SetHudValues(&hud, hud_occlusion, (occlusionstats.tested > 0)? 100*occlusionstats.culled/occlusionstats.tested : 0, occlusionstats.time*1000.0f, 0);
+                SetHudValues(&hud, hud_lights, map01_lights.stats.visibleLights, map01_lights.stats.indices, map01_lights.stats.time*1000.0f);
+            }
+            
+            int netplayers = 0;
+            for (int i = 0; i < MAX_NET_PLAYERS; i++) if (map01_server->players[i].active) netplayers++;
+            SetHudValues(&hud, hud_net, (map01_server->stats.packetsSent > 0)? (float)map01_server->stats.bytesSent/map01_server->stats.packetsSent : 0.0f, netplayers, 0);
+        }
+        UpdateHud(&hud, GetScreenWidth(), GetScreenHeight());
+        UpdateDynamicResolution(resolution, framework, GetScreenWidth(), GetScreenHeight());
+        if (currentscreen == EPISODE1)
+        {
+            UpdateOcclusionCuller(&map01_occlusion, camera, (float)GetScreenWidth()/GetScreenHeight());
+            UpdateLightClusters(&map01_lights, camera, (float)GetScreenWidth()/GetScreenHeight());
+        }
                 
         // Draw
         //----------------------------------------------------------------------------------
-        BeginDrawing();
+        BeginDynamicResolution(resolution);
         
             ClearBackground(BLACK);                  
             
@@ -243,20 +666,15 @@ int main(void)
             {
                 case TITLE:
                 {
-                    DrawText("welcome to microwave game", 10, 30, 20, WHITE);
-                    DrawText("press space to start", 10, 50, 20, WHITE);
-
-                    
                     BeginMode3D(camera); // begin 3d drawing
                     
-                    DrawModelEx(microwave, microwaveposition, (Vector3){0, 1, 0}, 0.0f, microwavesize, WHITE);
-                    DrawModelEx(kitchencounter, (Vector3){0, 0, 0}, (Vector3){0, 1, 0}, 0.0f, (Vector3){1, 1, 1}, WHITE);
+                    BeginRenderQueue(&renderqueue, camera);
+                    SubmitEntities(&props, &renderqueue, NULL);
+                    DrawRenderQueue(&renderqueue);
                 
                     DrawGrid(10, 1.0f);
                     
                     EndMode3D(); // end 3d drawing
-                    
-                    DrawFPS(10, 10);                   
                 } break;
                 
                 
@@ -264,43 +682,121 @@ int main(void)
                 {
                     BeginMode3D(camera);
                     
-                    DrawModelEx(microwave, microwaveposition, (Vector3){0, 1, 0}, 0.0f, microwavesize, WHITE);
-                    DrawModelEx(kitchencounter, (Vector3){0, 0, 0}, (Vector3){0, 1, 0}, 0.0f, (Vector3){1, 1, 1}, WHITE);
+                    BeginRenderQueue(&renderqueue, camera);
+                    SubmitEntities(&props, &renderqueue, NULL);
+                    DrawRenderQueue(&renderqueue);
                     
-                    EndMode3D();
+                    BeginBlendMode(BLEND_ADDITIVE);
+                    DrawParticles(&sparks, camera);
+                    EndBlendMode();
                     
-                    if(!Tutorial_Interact_Completed)
-                    { 
-                        float temp_01_float = GetScreenWidth()/2-MeasureText("Press 'E' to interact.", 20)/2;
-                        float temp_02_float = GetScreenHeight()-GetScreenHeight()*0.2f;
-                        DrawText("Press 'E' to interact.", temp_01_float, temp_02_float, 20, RED);
-                    }
+                    EndMode3D();
                 } break;
                 
                 case EPISODE1:
                 {                    
                     BeginMode3D(camera);
                     
-                    DrawModel(map01, (Vector3){-2, 0, -2}, 1, WHITE);
+                    BeginRenderQueue(&renderqueue, camera);
+                    SubmitWorldStream(map01_stream, &renderqueue, compactshader, map01_diffuse, camera, &map01_occlusion);
+                    BindLightClusters(&map01_lights, compactshader);
+                    DrawRenderQueue(&renderqueue);
+                    UnbindLightClusters();
+                    DrawTerrain(&terrain01, camera, DARKGRAY);
+                    DrawDecalBatch(&map01_decals);
+                    DrawCrowdPositions(episode1snapshot->agents, episode1snapshot->agentCount, map01_crowd.settings, MAROON);
                     
-                    EndMode3D();   
+                    // Body shapes never change after spawn, poses come from the snapshot
+                    for (int i = 0; i < episode1snapshot->bodyCount; i++)
+                    {
+                        const PhysicsBody *body = &map01_physics.bodies[i];
+                        float radius = Vector3Length(body->halfSize);
+                        BoundingBox bodybounds = { Vector3SubtractValue(episode1snapshot->bodyPositions[i], radius), Vector3AddValue(episode1snapshot->bodyPositions[i], radius) };
+                        if (!CheckOcclusionBox(&map01_occlusion, bodybounds)) continue;
+                        
+                        DrawPhysicsShape(body->shape, body->halfSize, episode1snapshot->bodyPositions[i], episode1snapshot->bodyRotations[i], (body->shape == PHYSICS_SPHERE)? BLUE : BROWN);
+                    }
+                    
+                    // Remote players at their interpolated pose, eye height above the feet
+                    for (int i = 0; i < MAX_NET_PLAYERS; i++)
+                    {
+                        if (i == map01_client->slot) continue;
+                        
+                        NetPlayerPose pose = GetNetClientPlayer(map01_client, i);
+                        if (!pose.active) continue;
+                        
+                        DrawCylinder(Vector3Subtract(pose.position, (Vector3){ 0.0f, 1.7f, 0.0f }), 0.35f, 0.35f, 1.8f, 8, DARKGREEN);
+                        DrawLine3D(pose.position, Vector3Add(pose.position, GetNetPoseDirection(pose)), GREEN);
+                    }
                     
-                    //DrawText(playerCellX, 10, 20, 20, WHITE);
-                    //DrawText(playerCellY, 10, 40, 20, WHITE);
-                    DrawText(TextFormat("Cam Pos: %f, %f", camera.position.x, camera.position.y), 10, 60, 20, WHITE);
-                    DrawText(TexFormat("%d", mapPosition), 10, 70, 100, WHITE);
+                    // Hitscan marker where the crosshair ray hits the map (map mesh space is offset by the draw position)
+                    Ray crosshairray = { Vector3Subtract(InteractRay.position, map01_stream->position), InteractRay.direction };
+                    GridRayHit crosshairhit = GetGridRayCollision(&map01_grid, crosshairray, 100.0f);
+                    if (crosshairhit.hit) DrawSphere(Vector3Add(crosshairhit.point, map01_stream->position), 0.05f, RED);
                     
-                    DrawFPS(10, 10); 
+                    BeginBlendMode(BLEND_ADDITIVE);
+                    DrawParticles(&sparks, camera);
+                    DrawParticles(&impacts, camera);
+                    EndBlendMode();
+                    
+                    EndMode3D();   
                 } break;
             }     
+            
+        EndDynamicResolution();
+        
+        BeginDrawing();
+        
+            DrawDynamicResolution(resolution);
+            DrawHud(&hud);
  
         EndDrawing();
+        
+        // Frame pacing: the controller sees the work time, the wait fills the rest of the frame
+        framework = (float)(GetTimerSeconds() - framestart);
+        if (framework < frametarget) WaitTime(frametarget - framework);
+        
+        // Frame temporaries are released here, a running level must not touch the heap
+        ResetFrameMemory((currentscreen == EPISODE1) && levelstarted);
         //----------------------------------------------------------------------------------
     
     }
 
     // De-Initialization
     //--------------------------------------------------------------------------------------
+    TraceMemoryReport();
+    
+    UnloadEntityStore(&props);
+    UnloadModelLod(&microwave_lod);
+    UnloadModelLod(&kitchencounter_lod);
+    UnloadParticlePool(&sparks);
+    UnloadParticlePool(&impacts);
+    UnloadTexture(sparktexture);
+    if (levelloaded)
+    {
+        UnloadSimulation(episode1sim);
+        UnloadNetClient(map01_client);
+        UnloadNetServer(map01_server);
+        UnloadNetLoopback(map01_loopback);
+        UnloadPhysicsWorld(&map01_physics);
+        UnloadDecalBatch(&map01_decals);
+        UnloadTexture(decalatlas);
+        UnloadCrowd(&map01_crowd);
+        UnloadNavFlowField(&map01_flow);
+        UnloadNavGrid(&map01_nav);
+        UnloadOcclusionCuller(&map01_occlusion);
+        UnloadLightClusters(&map01_lights);
+        UnloadWorldStream(map01_stream);
+        UnloadTerrain(&terrain01);
+        UnloadCubicmapGrid(&map01_grid);
+    }
+    UnloadShader(compactshader.shader);
+    UnloadRenderQueue(&renderqueue);
+    UnloadHud(&hud);
+    UnloadDynamicResolution(resolution);
+    UnloadResourceManager(&resources);
+    
+    CloseFrameMemory();
     CloseWindow();        // Close window and OpenGL context
     //--------------------------------------------------------------------------------------
 